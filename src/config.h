@@ -123,6 +123,12 @@
 // Show OpenGL extensions and capabilities detailed logs on init
 //#define RLGL_SHOW_GL_DETAILS_INFO              1
 
+// Record rendering statistics per frame (draw calls, batch flushes, vertices, timings), see rlGetFrameStats()
+//#define RLGL_ENABLE_FRAME_STATS                1
+
+// Enable command lists recording from any thread (immediate-mode vertex API and Draw*() functions), see rlBeginCommandList()
+//#define RLGL_ENABLE_COMMAND_LISTS              1
+
 #define RL_SUPPORT_MESH_GPU_SKINNING           1      // GPU skinning, comment if your GPU does not support more than 8 VBOs
 
 //#define RL_DEFAULT_BATCH_BUFFER_ELEMENTS    4096    // Default internal render batch elements limits
@@ -207,6 +213,9 @@
 // Support multiple image editing functions to scale, adjust colors, flip, draw on images, crop...
 // If not defined, still some functions are supported: ImageFormat(), ImageCrop(), ImageToPOT()
 #define SUPPORT_IMAGE_MANIPULATION      1
+// Support multithreaded image processing (ImageBlurGaussian(), ImageKernelConvolution()), rows are split between threads
+// NOTE: Requires pthreads, available on MinGW-w64 through winpthreads
+//#define SUPPORT_IMAGE_THREADS           1
 
 //------------------------------------------------------------------------------------
 // Module: rtext - Configuration Flags
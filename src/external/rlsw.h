@@ -12,6 +12,9 @@
 *       - Rendering to custom internal framebuffer with multiple color modes supported:
 *           - Color buffer: RGB - 8-bit (3:3:2) | RGB - 16-bit (5:6:5) | RGB - 24-bit (8:8:8)
 *           - Depth buffer: D - 8-bit (unorm) | D - 16-bit (unorm) | D - 24-bit (unorm)
+*           - Color and depth stored in separate planes, sharing the same row stride
+*           - Color plane can be external RGBA/BGRA memory (swBindFramebufferMemory), no copy to present
+*       - Render targets (framebuffer objects): color texture and depth renderbuffer attachments
 *       - Rendering modes supported: POINT, LINES, TRIANGLE, QUADS
 *           - Additional features: Polygon modes, Point width, Line width
 *       - Clipping support for all rendering modes
@@ -19,16 +22,27 @@
 *           - All uncompressed texture formats supported by raylib
 *           - Texture Minification/Magnification checks
 *           - Point and Bilinear filtering
+*           - Mipmaps (uploaded or generated) with nearest/linear mipmap filtering
+*           - Tiled texture storage (4x4 texel blocks), mask based wrapping for POT textures
+*           - Sub-rectangle updates and read back, textures sampled from external RGBA memory (swBindTextureMemory)
+*           - Compressed textures (DXT1/3/5, ETC1, ETC2, ETC2 EAC) decoded on upload, DXT1 optionally kept compressed
 *           - Texture Wrap Modes with separate checks for S/T coordinates
 *       - Vertex Arrays support with direct primitive drawing mode
+*           - Batched vertex transform, shared vertices of indexed draws transformed once
+*       - Optional tile-binned multithreaded rasterization (deferred mode)
+*       - Optional fixed-point half-space triangle rasterization (top-left fill rule)
+*       - Optional 4x multisample anti-aliasing (rotated grid), shaded once per pixel, resolved on copy
+*       - Optional runtime CPU dispatch (cpuid) of framebuffer clear/copy/blit kernels: SSE2, AVX2
 *       - Matrix Stack support (Matrix Push/Pop)
 *       - Other GL misc features:
 *           - GL-style getter functions
 *           - Framebuffer resizing
+*           - Dirty rectangles tracking, to present only the regions written (swGetDirtyRects())
 *           - Perspective correction
 *           - Scissor clipping
-*           - Depth testing
-*           - Blend modes
+*           - Depth testing (coarse per-tile max depth rejection, Hi-Z), depth functions and write mask
+*           - Color write mask, with a depth-only raster path when all channels are masked
+*           - Blend modes (RGBA8 integer path for alpha, additive and multiply modes)
 *           - Face culling
 *
 *   ADDITIONAL NOTES:
@@ -48,6 +62,34 @@
 *           recommended under specific situations and only if the developers know
 *           what are they doing; this flag is not defined by default
 *
+*       #define RLSW_USE_CPU_DISPATCH
+*           Compile the framebuffer kernels (clears, copies and blits) for several instruction
+*           set levels (scalar, SSE2, AVX2) and select the best one supported by the running CPU
+*           at swInit(), so a program built for a baseline target still uses the wider vector
+*           instructions when available; the selected level is reported by swGetString(SW_RENDERER)
+*           Only available on x86 with GCC, Clang or MSVC; this flag is not defined by default
+*
+*       #define RLSW_USE_THREADS
+*           Enable the deferred rasterization mode: triangles and quads are transformed and clipped
+*           on the calling thread, recorded into a command buffer and binned into screen tiles,
+*           then tiles are rasterized in parallel by a worker pool when the command buffer is flushed
+*           Flush happens automatically on swClear(), swCopyFramebuffer(), swBlitFramebuffer()
+*           and on any state change that affects rasterization (blending, textures...)
+*           NOTE: Requires pthreads (available on MinGW-w64 through winpthreads)
+*
+*       #define RLSW_USE_COMMAND_BUFFER
+*           Record triangles and quads into the deferred command buffer even without raster threads,
+*           every primitive references a compact snapshot of the raster state it was submitted with;
+*           on flush, primitives are moved next to previous ones sharing the same state when they
+*           don't overlap any primitive submitted in between, so draws interleaving a few states
+*           (e.g. text and shapes) are rasterized in fewer state runs with the same result
+*           Can be combined with RLSW_USE_THREADS, groups are binned in their replay order
+*
+*       #define RLSW_USE_STATS
+*           Count the work done by the pipeline (vertices, primitives culled and clipped, pixels shaded,
+*           blended and rejected by the depth test) and the time spent on deferred flushes,
+*           retrieved with swGetStats(); when not defined the counters compile to nothing
+*
 *       rlsw capabilities could be customized just defining some internal
 *       values before library inclusion (default values listed):
 *
@@ -59,6 +101,21 @@
 *           #define SW_MAX_MODELVIEW_STACK_SIZE     8
 *           #define SW_MAX_TEXTURE_STACK_SIZE       2
 *           #define SW_MAX_TEXTURES                 128
+*           #define SW_MAX_MIPMAP_LEVELS            16
+*           #define SW_TEXTURE_TILED                true
+*           #define SW_TEXTURE_KEEP_DXT1            false   // Keep DXT1 textures compressed, texels decoded on sampling
+*           #define SW_VERTEX_BATCH_SIZE            256
+*           #define SW_HIZ_TILE_SIZE                8
+*           #define SW_MAX_DIRTY_RECTS              8
+*           #define SW_MAX_FRAMEBUFFERS             16
+*           #define SW_MAX_RENDERBUFFERS            16
+*           #define SW_RASTER_THREADS               0       // 0: Use the number of online CPUs
+*           #define SW_MAX_RASTER_THREADS           64
+*           #define SW_RASTER_TILE_SIZE             64
+*           #define SW_MAX_DEFERRED_PRIMITIVES      16384
+*           #define SW_MAX_DEFERRED_STATES          64
+*           #define SW_TRIANGLE_RASTER_HALF_SPACE   false   // Can be changed later with swEnable/swDisable(SW_RASTER_HALF_SPACE)
+*           #define SW_HALF_SPACE_SUBPIXEL_BITS     4
 *
 *
 *   LICENSE: MIT
@@ -145,6 +202,66 @@
     #define SW_MAX_TEXTURES                 128
 #endif
 
+#ifndef SW_MAX_MIPMAP_LEVELS
+    #define SW_MAX_MIPMAP_LEVELS            16  //< Max mipmap levels per texture, including the base level
+#endif
+
+#ifndef SW_TEXTURE_TILED
+    #define SW_TEXTURE_TILED                true    //< Store texture texels in 4x4 blocks instead of rows
+#endif
+
+#ifndef SW_TEXTURE_KEEP_DXT1
+    #define SW_TEXTURE_KEEP_DXT1            false   //< Keep DXT1 textures compressed (4 bpp), texels decoded on sampling
+#endif
+
+#ifndef SW_VERTEX_BATCH_SIZE
+    #define SW_VERTEX_BATCH_SIZE            256     //< Number of vertices fetched and transformed per batch by vertex arrays
+#endif
+
+#ifndef SW_HIZ_TILE_SIZE
+    #define SW_HIZ_TILE_SIZE                8   //< Tile size (in pixels) of the coarse depth buffer (power of two)
+#endif
+
+#ifndef SW_MAX_DIRTY_RECTS
+    #define SW_MAX_DIRTY_RECTS              8   //< Max rectangles tracking the framebuffer regions written (merged when exceeded)
+#endif
+
+#ifndef SW_MAX_FRAMEBUFFERS
+    #define SW_MAX_FRAMEBUFFERS             16  //< Max framebuffer objects, including the default framebuffer (id 0)
+#endif
+
+#ifndef SW_MAX_RENDERBUFFERS
+    #define SW_MAX_RENDERBUFFERS            16
+#endif
+
+#ifndef SW_RASTER_THREADS
+    #define SW_RASTER_THREADS               0   //< Number of raster threads (0: number of online CPUs)
+#endif
+
+#ifndef SW_MAX_RASTER_THREADS
+    #define SW_MAX_RASTER_THREADS           64
+#endif
+
+#ifndef SW_RASTER_TILE_SIZE
+    #define SW_RASTER_TILE_SIZE             64  //< Screen tile size (in pixels) used for binning
+#endif
+
+#ifndef SW_MAX_DEFERRED_PRIMITIVES
+    #define SW_MAX_DEFERRED_PRIMITIVES      16384
+#endif
+
+#ifndef SW_MAX_DEFERRED_STATES
+    #define SW_MAX_DEFERRED_STATES          64  //< Raster state snapshots referenced by the recorded primitives
+#endif
+
+#ifndef SW_TRIANGLE_RASTER_HALF_SPACE
+    #define SW_TRIANGLE_RASTER_HALF_SPACE   false   //< Use the half-space rasterizer for triangles by default
+#endif
+
+#ifndef SW_HALF_SPACE_SUBPIXEL_BITS
+    #define SW_HALF_SPACE_SUBPIXEL_BITS     4   //< Subpixel precision of the half-space rasterizer (max 8)
+#endif
+
 // Under normal circumstances, clipping a polygon can add at most one vertex per clipping plane
 // Considering the largest polygon involved is a quadrilateral (4 vertices),
 // and that clipping occurs against both the frustum (6 planes) and the scissors (4 planes),
@@ -189,6 +306,7 @@ typedef double              GLclampd;
 #define GL_DEPTH_TEST                       0x0B71
 #define GL_CULL_FACE                        0x0B44
 #define GL_BLEND                            0x0BE2
+#define GL_MULTISAMPLE                      0x809D
 
 #define GL_VENDOR                           0x1F00
 #define GL_RENDERER                         0x1F01
@@ -271,6 +389,10 @@ typedef double              GLclampd;
 
 #define GL_NEAREST                          0x2600
 #define GL_LINEAR                           0x2601
+#define GL_NEAREST_MIPMAP_NEAREST           0x2700
+#define GL_LINEAR_MIPMAP_NEAREST            0x2701
+#define GL_NEAREST_MIPMAP_LINEAR            0x2702
+#define GL_LINEAR_MIPMAP_LINEAR             0x2703
 
 #define GL_REPEAT                           0x2901
 #define GL_CLAMP                            0x2900
@@ -294,6 +416,7 @@ typedef double              GLclampd;
 #define GL_LUMINANCE_ALPHA                  0x190A
 #define GL_RGB                              0x1907
 #define GL_RGBA                             0x1908
+#define GL_BGRA                             0x80E1
 
 #define GL_BYTE                             0x1400
 #define GL_UNSIGNED_BYTE                    0x1401
@@ -303,15 +426,38 @@ typedef double              GLclampd;
 #define GL_UNSIGNED_INT                     0x1405
 #define GL_FLOAT                            0x1406
 
-// OpenGL Definitions NOT USED
-#define GL_PERSPECTIVE_CORRECTION_HINT      0x0C50
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT     0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT    0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT    0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT    0x83F3
+#define GL_ETC1_RGB8_OES                    0x8D64
+#define GL_COMPRESSED_RGB8_ETC2             0x9274
+#define GL_COMPRESSED_RGBA8_ETC2_EAC        0x9278
+
+#define GL_PACK_ROW_LENGTH                  0x0D02
 #define GL_PACK_ALIGNMENT                   0x0D05
 #define GL_UNPACK_ALIGNMENT                 0x0CF5
-#define GL_LINE_SMOOTH                      0x0B20
-#define GL_SMOOTH                           0x1D01
-#define GL_NICEST                           0x1102
-#define GL_CCW                              0x0901
-#define GL_CW                               0x0900
+
+#define GL_NONE                             0
+#define GL_FRAMEBUFFER                      0x8D40
+#define GL_RENDERBUFFER                     0x8D41
+#define GL_FRAMEBUFFER_BINDING              0x8CA6
+#define GL_DRAW_FRAMEBUFFER_BINDING         0x8CA6
+#define GL_RENDERBUFFER_BINDING             0x8CA7
+#define GL_COLOR_ATTACHMENT0                0x8CE0
+#define GL_DEPTH_ATTACHMENT                 0x8D00
+#define GL_DEPTH_COMPONENT                  0x1902
+#define GL_DEPTH_COMPONENT16                0x81A5
+#define GL_DEPTH_COMPONENT24                0x81A6
+#define GL_DEPTH_COMPONENT32                0x81A7
+#define GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE           0x8CD0
+#define GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME           0x8CD1
+#define GL_FRAMEBUFFER_COMPLETE                         0x8CD5
+#define GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT            0x8CD6
+#define GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT    0x8CD7
+#define GL_FRAMEBUFFER_INCOMPLETE_DIMENSIONS            0x8CD9
+#define GL_FRAMEBUFFER_UNSUPPORTED                      0x8CDD
+
 #define GL_NEVER                            0x0200
 #define GL_LESS                             0x0201
 #define GL_EQUAL                            0x0202
@@ -321,12 +467,21 @@ typedef double              GLclampd;
 #define GL_GEQUAL                           0x0206
 #define GL_ALWAYS                           0x0207
 
+// OpenGL Definitions NOT USED
+#define GL_PERSPECTIVE_CORRECTION_HINT      0x0C50
+#define GL_LINE_SMOOTH                      0x0B20
+#define GL_SMOOTH                           0x1D01
+#define GL_NICEST                           0x1102
+#define GL_CCW                              0x0901
+#define GL_CW                               0x0900
+
 //----------------------------------------------------------------------------------
 // OpenGL Bindings to rlsw
 //----------------------------------------------------------------------------------
 #define glReadPixels(x, y, w, h, f, t, p)           swCopyFramebuffer((x), (y), (w), (h), (f), (t), (p))
 #define glEnable(state)                             swEnable((state))
 #define glDisable(state)                            swDisable((state))
+#define glGetIntegerv(pname, params)                swGetIntegerv((pname), (params))
 #define glGetFloatv(pname, params)                  swGetFloatv((pname), (params))
 #define glGetString(pname)                          swGetString((pname))
 #define glGetError()                                swGetError()
@@ -335,7 +490,12 @@ typedef double              GLclampd;
 #define glClearColor(r, g, b, a)                    swClearColor((r), (g), (b), (a))
 #define glClearDepth(d)                             swClearDepth((d))
 #define glClear(bitmask)                            swClear((bitmask))
+#define glFinish()                                  swFinish()
+#define glPixelStorei(pname, param)                 swPixelStorei((pname), (param))
 #define glBlendFunc(sfactor, dfactor)               swBlendFunc((sfactor), (dfactor))
+#define glDepthFunc(func)                           swDepthFunc((func))
+#define glDepthMask(flag)                           swDepthMask((flag))
+#define glColorMask(r, g, b, a)                     swColorMask((r), (g), (b), (a))
 #define glPolygonMode(face, mode)                   swPolygonMode((mode))
 #define glCullFace(face)                            swCullFace((face))
 #define glPointSize(size)                           swPointSize((size))
@@ -381,20 +541,29 @@ typedef double              GLclampd;
 #define glDrawElements(m,c,t,i)                     swDrawElements((m),(c),(t),(i))
 #define glGenTextures(c, v)                         swGenTextures((c), (v))
 #define glDeleteTextures(c, v)                      swDeleteTextures((c), (v))
-#define glTexImage2D(tr, l, if, w, h, b, f, t, p)   swTexImage2D((w), (h), (f), (t), (p))
+#define glTexImage2D(tr, l, if, w, h, b, f, t, p)   swTexImage2DLevel((l), (w), (h), (f), (t), (p))
+#define glTexSubImage2D(tr, l, x, y, w, h, f, t, p) swTexSubImage2D((l), (x), (y), (w), (h), (f), (t), (p))
+#define glGetTexImage(tr, l, f, t, p)               swGetTexImage((l), (f), (t), (p))
+#define glCompressedTexImage2D(tr, l, if, w, h, b, sz, p) swCompressedTexImage2D((l), (if), (w), (h), (sz), (p))
+#define glGenerateMipmap(tr)                        swGenerateMipmap()
 #define glTexParameteri(tr, pname, param)           swTexParameteri((pname), (param))
 #define glBindTexture(tr, id)                       swBindTexture((id))
+#define glGenFramebuffers(c, v)                     swGenFramebuffers((c), (v))
+#define glDeleteFramebuffers(c, v)                  swDeleteFramebuffers((c), (v))
+#define glBindFramebuffer(tr, id)                   swBindFramebuffer((id))
+#define glFramebufferTexture2D(tr, a, tt, id, l)    swFramebufferTexture2D((a), (id), (l))
+#define glFramebufferRenderbuffer(tr, a, rt, id)    swFramebufferRenderbuffer((a), (id))
+#define glCheckFramebufferStatus(tr)                swCheckFramebufferStatus()
+#define glGetFramebufferAttachmentParameteriv(tr, a, pname, params) swGetFramebufferAttachmentParameteriv((a), (pname), (params))
+#define glGenRenderbuffers(c, v)                    swGenRenderbuffers((c), (v))
+#define glDeleteRenderbuffers(c, v)                 swDeleteRenderbuffers((c), (v))
+#define glBindRenderbuffer(tr, id)                  swBindRenderbuffer((id))
+#define glRenderbufferStorage(tr, f, w, h)          swRenderbufferStorage((f), (w), (h))
 
 // OpenGL functions NOT IMPLEMENTED by rlsw
-#define glDepthMask(X)                          ((void)(X))
-#define glColorMask(X,Y,Z,W)                    ((void)(X),(void)(Y),(void)(Z),(void)(W))
-#define glPixelStorei(X,Y)                      ((void)(X),(void)(Y))
 #define glHint(X,Y)                             ((void)(X),(void)(Y))
 #define glShadeModel(X)                         ((void)(X))
 #define glFrontFace(X)                          ((void)(X))
-#define glDepthFunc(X)                          ((void)(X))
-#define glTexSubImage2D(X,Y,Z,W,A,B,C,D,E)      ((void)(X),(void)(Y),(void)(Z),(void)(W),(void)(A),(void)(B),(void)(C),(void)(D),(void)(E))
-#define glGetTexImage(X,Y,Z,W,A)                ((void)(X),(void)(Y),(void)(Z),(void)(W),(void)(A))
 #define glNormal3f(X,Y,Z)                       ((void)(X),(void)(Y),(void)(Z))
 #define glNormal3fv(X)                          ((void)(X))
 #define glNormalPointer(X,Y,Z)                  ((void)(X),(void)(Y),(void)(Z))
@@ -407,7 +576,9 @@ typedef enum {
     SW_TEXTURE_2D = GL_TEXTURE_2D,
     SW_DEPTH_TEST = GL_DEPTH_TEST,
     SW_CULL_FACE = GL_CULL_FACE,
-    SW_BLEND = GL_BLEND
+    SW_BLEND = GL_BLEND,
+    SW_MULTISAMPLE = GL_MULTISAMPLE,    // 4x coverage-based anti-aliasing, triangles and quads only
+    SW_RASTER_HALF_SPACE = 0x10000      // rlsw specific: Use the half-space triangle rasterizer
 } SWstate;
 
 typedef enum {
@@ -427,9 +598,17 @@ typedef enum {
     SW_PROJECTION_STACK_DEPTH = GL_PROJECTION_STACK_DEPTH,
     SW_TEXTURE_MATRIX = GL_TEXTURE_MATRIX,
     SW_TEXTURE_STACK_DEPTH = GL_TEXTURE_STACK_DEPTH,
-    SW_VIEWPORT = GL_VIEWPORT
+    SW_VIEWPORT = GL_VIEWPORT,
+    SW_FRAMEBUFFER_BINDING = GL_FRAMEBUFFER_BINDING,
+    SW_RENDERBUFFER_BINDING = GL_RENDERBUFFER_BINDING
 } SWget;
 
+typedef enum {
+    SW_PACK_ROW_LENGTH = GL_PACK_ROW_LENGTH,
+    SW_PACK_ALIGNMENT = GL_PACK_ALIGNMENT,
+    SW_UNPACK_ALIGNMENT = GL_UNPACK_ALIGNMENT
+} SWpixelstore;
+
 typedef enum {
     SW_COLOR_BUFFER_BIT = GL_COLOR_BUFFER_BIT,
     SW_DEPTH_BUFFER_BIT = GL_DEPTH_BUFFER_BIT
@@ -479,13 +658,35 @@ typedef enum {
     SW_SRC_ALPHA_SATURATE = GL_SRC_ALPHA_SATURATE
 } SWfactor;
 
+typedef enum {
+    SW_NEVER = GL_NEVER,
+    SW_LESS = GL_LESS,
+    SW_EQUAL = GL_EQUAL,
+    SW_LEQUAL = GL_LEQUAL,
+    SW_GREATER = GL_GREATER,
+    SW_NOTEQUAL = GL_NOTEQUAL,
+    SW_GEQUAL = GL_GEQUAL,
+    SW_ALWAYS = GL_ALWAYS
+} SWdepthfunc;
+
 typedef enum {
     SW_LUMINANCE = GL_LUMINANCE,
     SW_LUMINANCE_ALPHA = GL_LUMINANCE_ALPHA,
     SW_RGB = GL_RGB,
     SW_RGBA = GL_RGBA,
+    SW_BGRA = GL_BGRA,
 } SWformat;
 
+typedef enum {
+    SW_COMPRESSED_RGB_DXT1 = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+    SW_COMPRESSED_RGBA_DXT1 = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+    SW_COMPRESSED_RGBA_DXT3 = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
+    SW_COMPRESSED_RGBA_DXT5 = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+    SW_COMPRESSED_RGB_ETC1 = GL_ETC1_RGB8_OES,
+    SW_COMPRESSED_RGB_ETC2 = GL_COMPRESSED_RGB8_ETC2,
+    SW_COMPRESSED_RGBA_ETC2_EAC = GL_COMPRESSED_RGBA8_ETC2_EAC
+} SWcompressed;
+
 typedef enum {
     SW_UNSIGNED_BYTE = GL_UNSIGNED_BYTE,
     SW_BYTE = GL_BYTE,
@@ -498,7 +699,11 @@ typedef enum {
 
 typedef enum {
     SW_NEAREST = GL_NEAREST,
-    SW_LINEAR = GL_LINEAR
+    SW_LINEAR = GL_LINEAR,
+    SW_NEAREST_MIPMAP_NEAREST = GL_NEAREST_MIPMAP_NEAREST,
+    SW_LINEAR_MIPMAP_NEAREST = GL_LINEAR_MIPMAP_NEAREST,
+    SW_NEAREST_MIPMAP_LINEAR = GL_NEAREST_MIPMAP_LINEAR,
+    SW_LINEAR_MIPMAP_LINEAR = GL_LINEAR_MIPMAP_LINEAR
 } SWfilter;
 
 typedef enum {
@@ -513,6 +718,23 @@ typedef enum {
     SW_TEXTURE_WRAP_T = GL_TEXTURE_WRAP_T
 } SWtexparam;
 
+typedef enum {
+    SW_COLOR_ATTACHMENT0 = GL_COLOR_ATTACHMENT0,
+    SW_DEPTH_ATTACHMENT = GL_DEPTH_ATTACHMENT
+} SWattachment;
+
+typedef enum {
+    SW_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE = GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE,
+    SW_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME = GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME
+} SWattachmentparam;
+
+typedef enum {
+    SW_FRAMEBUFFER_COMPLETE = GL_FRAMEBUFFER_COMPLETE,
+    SW_FRAMEBUFFER_INCOMPLETE_ATTACHMENT = GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT,
+    SW_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT = GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT,
+    SW_FRAMEBUFFER_INCOMPLETE_DIMENSIONS = GL_FRAMEBUFFER_INCOMPLETE_DIMENSIONS
+} SWfbstatus;
+
 typedef enum {
     SW_NO_ERROR = GL_NO_ERROR,
     SW_INVALID_ENUM = GL_INVALID_ENUM,
@@ -522,6 +744,19 @@ typedef enum {
     SW_INVALID_OPERATION = GL_INVALID_OPERATION,
 } SWerrcode;
 
+// Pipeline statistics, accumulated until swResetStats() (requires RLSW_USE_STATS)
+typedef struct {
+    unsigned int vertices;              // Vertices submitted
+    unsigned int primitives;            // Primitives assembled (points, lines, triangles, quads)
+    unsigned int primitivesCulled;      // Triangles and quads rejected by face culling
+    unsigned int primitivesClipped;     // Triangles and quads entirely outside of the clip volume
+    unsigned int pixelsShaded;          // Fragments written to the color buffer
+    unsigned int pixelsBlended;         // Fragments written with blending (also counted as shaded)
+    unsigned int pixelsDepthRejected;   // Fragments rejected by the depth test, Hi-Z rejections included
+    unsigned int flushes;               // Deferred command buffer flushes (RLSW_USE_THREADS, RLSW_USE_COMMAND_BUFFER)
+    double flushTime;                   // Time spent rasterizing deferred primitives, in seconds
+} SWstats;
+
 //------------------------------------------------------------------------------------
 // Functions Declaration - Public API
 //------------------------------------------------------------------------------------
@@ -531,10 +766,18 @@ SWAPI void swClose(void);
 SWAPI bool swResizeFramebuffer(int w, int h);
 SWAPI void swCopyFramebuffer(int x, int y, int w, int h, SWformat format, SWtype type, void *pixels);
 SWAPI void swBlitFramebuffer(int xDst, int yDst, int wDst, int hDst, int xSrc, int ySrc, int wSrc, int hSrc, SWformat format, SWtype type, void *pixels);
+SWAPI bool swBindFramebufferMemory(void *pixels, int w, int h, int stride, SWformat format); // Render color into external RGBA/BGRA memory, stride in bytes (0: packed rows), NULL restores the internal buffer
+SWAPI void swFinish(void);
+SWAPI int swGetDirtyRects(int *rects, int maxCount);   // Get the regions written since last reset, as { x, y, w, h } (returns count, or required count if rects is NULL)
+SWAPI void swResetDirtyRects(void);
+SWAPI void swGetStats(SWstats *stats);                  // Get the pipeline statistics, pending deferred primitives are rasterized first
+SWAPI void swResetStats(void);
+SWAPI void swPixelStorei(SWpixelstore pname, int param);
 
 SWAPI void swEnable(SWstate state);
 SWAPI void swDisable(SWstate state);
 
+SWAPI void swGetIntegerv(SWget name, int *v);
 SWAPI void swGetFloatv(SWget name, float *v);
 SWAPI const char *swGetString(SWget name);
 SWAPI SWerrcode swGetError(void);
@@ -547,6 +790,9 @@ SWAPI void swClearDepth(float depth);
 SWAPI void swClear(uint32_t bitmask);
 
 SWAPI void swBlendFunc(SWfactor sfactor, SWfactor dfactor);
+SWAPI void swDepthFunc(SWdepthfunc func);                   // Set the depth test comparison, SW_LEQUAL by default
+SWAPI void swDepthMask(bool flag);                          // Enable or disable depth writes
+SWAPI void swColorMask(bool r, bool g, bool b, bool a);     // Enable or disable color writes per channel
 SWAPI void swPolygonMode(SWpoly mode);
 SWAPI void swCullFace(SWface face);
 
@@ -597,9 +843,29 @@ SWAPI void swGenTextures(int count, uint32_t *textures);
 SWAPI void swDeleteTextures(int count, uint32_t *textures);
 
 SWAPI void swTexImage2D(int width, int height, SWformat format, SWtype type, const void *data);
+SWAPI void swTexImage2DLevel(int level, int width, int height, SWformat format, SWtype type, const void *data);
+SWAPI void swTexSubImage2D(int level, int xOffset, int yOffset, int width, int height, SWformat format, SWtype type, const void *data);
+SWAPI void swGetTexImage(int level, SWformat format, SWtype type, void *pixels);
+SWAPI bool swBindTextureMemory(void *pixels, int width, int height);  // Sample the bound texture from external RGBA memory (packed rows), no copy, NULL releases it
+SWAPI void swCompressedTexImage2D(int level, SWcompressed format, int width, int height, int size, const void *data);
+SWAPI bool swDecompressImage(SWcompressed format, int width, int height, const void *data, void *pixels); // Decode compressed blocks into RGBA pixels (packed rows)
+SWAPI void swGenerateMipmap(void);
 SWAPI void swTexParameteri(int param, int value);
 SWAPI void swBindTexture(uint32_t id);
 
+SWAPI void swGenFramebuffers(int count, uint32_t *framebuffers);
+SWAPI void swDeleteFramebuffers(int count, uint32_t *framebuffers);
+SWAPI void swBindFramebuffer(uint32_t id);                     // Bind a framebuffer object as render target, 0 restores the default framebuffer
+SWAPI void swFramebufferTexture2D(SWattachment attachment, uint32_t texture, int level);
+SWAPI void swFramebufferRenderbuffer(SWattachment attachment, uint32_t renderbuffer);
+SWAPI SWfbstatus swCheckFramebufferStatus(void);
+SWAPI void swGetFramebufferAttachmentParameteriv(SWattachment attachment, SWattachmentparam pname, int *v);
+
+SWAPI void swGenRenderbuffers(int count, uint32_t *renderbuffers);
+SWAPI void swDeleteRenderbuffers(int count, uint32_t *renderbuffers);
+SWAPI void swBindRenderbuffer(uint32_t id);
+SWAPI void swRenderbufferStorage(int format, int width, int height);
+
 #endif // RLSW_H
 
 /***********************************************************************************
@@ -612,8 +878,24 @@ SWAPI void swBindTexture(uint32_t id);
 
 #include <stdlib.h>         // Required for: malloc(), free()
 #include <stddef.h>         // Required for: NULL, size_t, uint8_t, uint16_t, uint32_t...
+#include <string.h>         // Required for: memcpy(), memset()
 #include <math.h>           // Required for: sinf(), cosf(), floorf(), fabsf(), sqrtf(), roundf()
 
+#if defined(RLSW_USE_THREADS)
+    #include <pthread.h>    // Required for: pthread_create(), pthread_join(), pthread_mutex_*(), pthread_cond_*()
+    #if !defined(_WIN32)
+        #include <unistd.h> // Required for: sysconf()
+    #endif
+#endif
+
+#if defined(RLSW_USE_STATS)
+    #if defined(__APPLE__)
+        #include <mach/mach_time.h> // Required for: mach_absolute_time()
+    #else
+        #include <time.h>   // Required for: clock_gettime(), timespec_get()
+    #endif
+#endif
+
 // Simple log system to avoid printf() calls if required
 // NOTE: Avoiding those calls, also avoids const strings memory usage
 #define SW_SUPPORT_LOG_INFO
@@ -697,6 +979,23 @@ SWAPI void swBindTexture(uint32_t id);
     #endif
 #endif  // RLSW_USE_SIMD_INTRINSICS
 
+#if defined(RLSW_USE_CPU_DISPATCH) && (defined(SW_ARCH_X86_64) || defined(SW_ARCH_X86))
+    // Runtime selection of the framebuffer kernels instruction set, detected with cpuid
+    // NOTE: Kernels for wider instruction sets are compiled with target attributes,
+    // no compiler flags are required and the rest of the library keeps the baseline target
+    #if defined(__GNUC__) || defined(__clang__)
+        #define SW_HAS_CPU_DISPATCH
+        #define SW_TARGET(isa) __attribute__((target(isa)))
+        #include <cpuid.h>
+        #include <immintrin.h>
+    #elif defined(_MSC_VER)
+        #define SW_HAS_CPU_DISPATCH
+        #define SW_TARGET(isa)
+        #include <intrin.h>
+        #include <immintrin.h>
+    #endif
+#endif
+
 #ifdef __cplusplus
     #define SW_CURLY_INIT(name) name
 #else
@@ -713,12 +1012,37 @@ SWAPI void swBindTexture(uint32_t id);
 
 #define SW_COLOR_PIXEL_SIZE     (SW_COLOR_BUFFER_BITS >> 3)
 #define SW_DEPTH_PIXEL_SIZE     (SW_DEPTH_BUFFER_BITS >> 3)
-#define SW_PIXEL_SIZE           (SW_COLOR_PIXEL_SIZE + SW_DEPTH_PIXEL_SIZE)
 
-#if (SW_PIXEL_SIZE <= 4)
-    #define SW_PIXEL_ALIGNMENT 4
-#else // if (SW_PIXEL_SIZE <= 8)
-    #define SW_PIXEL_ALIGNMENT 8
+#define SW_HIZ_MIN_COVER_AREA   (4*SW_HIZ_TILE_SIZE*SW_HIZ_TILE_SIZE)   // Min screen area of primitives lowering the tiles they cover
+#define SW_HIZ_DEPTH_EPSILON    1e-5f                                   // Margin for the interpolation error of fragments depth
+
+#if defined(RLSW_USE_THREADS) && ((SW_RASTER_TILE_SIZE % SW_HIZ_TILE_SIZE) != 0)
+    #error "RLSW: SW_RASTER_TILE_SIZE must be a multiple of SW_HIZ_TILE_SIZE"
+#endif
+
+// Primitives are recorded into a command buffer with raster threads or when requested
+#if defined(RLSW_USE_THREADS) || defined(RLSW_USE_COMMAND_BUFFER)
+    #define SW_HAS_DEFERRED
+#endif
+
+#define SW_DEFERRED_GROUP_WINDOW 32     // State groups searched back when moving a primitive to its group
+
+// Pipeline statistics counters, every raster thread accumulates into its own slot
+#if defined(RLSW_USE_STATS)
+    #if defined(RLSW_USE_THREADS)
+        #if defined(_MSC_VER)
+            #define SW_THREAD_LOCAL __declspec(thread)
+        #else
+            #define SW_THREAD_LOCAL __thread
+        #endif
+        #define SW_STATS_SLOTS SW_MAX_RASTER_THREADS
+        #define SW_STATS_ADD(field, n) (RLSW.stats[swStatsSlot].counters.field += (n))
+    #else
+        #define SW_STATS_SLOTS 1
+        #define SW_STATS_ADD(field, n) (RLSW.stats[0].counters.field += (n))
+    #endif
+#else
+    #define SW_STATS_ADD(field, n) ((void)0)
 #endif
 
 #if (SW_COLOR_BUFFER_BITS == 8)
@@ -726,6 +1050,7 @@ SWAPI void swBindTexture(uint32_t id);
     #define SW_COLOR_IS_PACKED  1
     #define SW_COLOR_PACK_COMP  1
     #define SW_PACK_COLOR(r,g,b) ((((uint8_t)((r)*7+0.5f))&0x07)<<5 | (((uint8_t)((g)*7+0.5f))&0x07)<<2 | ((uint8_t)((b)*3+0.5f))&0x03)
+    #define SW_PACK_BITS(r,g,b) ((SW_COLOR_TYPE)(((r)<<5) | ((g)<<2) | (b)))
     #define SW_UNPACK_R(p)      (((p)>>5)&0x07)
     #define SW_UNPACK_G(p)      (((p)>>2)&0x07)
     #define SW_UNPACK_B(p)      ((p)&0x03)
@@ -740,6 +1065,7 @@ SWAPI void swBindTexture(uint32_t id);
     #define SW_COLOR_IS_PACKED  1
     #define SW_COLOR_PACK_COMP  1
     #define SW_PACK_COLOR(r,g,b) ((((uint16_t)((r)*31+0.5f))&0x1F)<<11 | (((uint16_t)((g)*63+0.5f))&0x3F)<<5 | ((uint16_t)((b)*31+0.5f))&0x1F)
+    #define SW_PACK_BITS(r,g,b) ((SW_COLOR_TYPE)(((r)<<11) | ((g)<<5) | (b)))
     #define SW_UNPACK_R(p)      (((p)>>11)&0x1F)
     #define SW_UNPACK_G(p)      (((p)>>5)&0x3F)
     #define SW_UNPACK_B(p)      ((p)&0x1F)
@@ -791,6 +1117,15 @@ SWAPI void swBindTexture(uint32_t id);
 #define SW_STATE_DEPTH_TEST     (1 << 2)
 #define SW_STATE_CULL_FACE      (1 << 3)
 #define SW_STATE_BLEND          (1 << 4)
+#define SW_STATE_HALF_SPACE     (1 << 5)
+#define SW_STATE_NO_COLOR       (1 << 6)    // Raster state only: all color channels masked, depth-only rendering
+#define SW_STATE_MULTISAMPLE    (1 << 7)
+
+#define SW_COLOR_MASK_ALL       0xF         // Color write mask with the four channels (R: bit 0, G: bit 1, B: bit 2, A: bit 3)
+
+#define SW_SUBPIXEL_ONE         (1 << SW_HALF_SPACE_SUBPIXEL_BITS)
+
+#define SW_MSAA_SAMPLES         4           // Samples per pixel of the multisampled framebuffers
 
 //----------------------------------------------------------------------------------
 // Module Types and Structures Definition
@@ -820,6 +1155,17 @@ typedef void (*sw_factor_f)(
     const float *SW_RESTRICT dst
 );
 
+// Blend factors combinations with a specialized RGBA8 integer path
+// NOTE: Only used with 32 bits color buffers, other combinations are blended with floats
+typedef enum {
+    SW_BLEND_GENERIC = 0,       // Any other combination
+    SW_BLEND_ALPHA,             // SW_SRC_ALPHA, SW_ONE_MINUS_SRC_ALPHA
+    SW_BLEND_ADDITIVE,          // SW_SRC_ALPHA, SW_ONE
+    SW_BLEND_MULTIPLIED,        // SW_DST_COLOR, SW_ONE_MINUS_SRC_ALPHA
+    SW_BLEND_ADD_COLORS,        // SW_ONE, SW_ONE
+    SW_BLEND_ALPHA_PREMULTIPLY  // SW_ONE, SW_ONE_MINUS_SRC_ALPHA
+} sw_blend_mode_t;
+
 typedef float sw_matrix_t[4*4];
 typedef uint16_t sw_half_t;
 
@@ -833,10 +1179,19 @@ typedef struct {
 } sw_vertex_t;
 
 typedef struct {
-    uint8_t *pixels;            // Texture pixels (RGBA32)
+    uint8_t *pixels;            // Level pixels (RGBA32), row-major or in 4x4 blocks
 
-    int width, height;          // Dimensions of the texture
+    int width, height;          // Dimensions of the level
     int wMinus1, hMinus1;       // Dimensions minus one
+    int blockStride;            // Number of 4x4 blocks per row (0 for row-major levels)
+    bool isPOT;                 // Power of two dimensions, wrapped with masks
+    bool isExternal;            // Pixels are user memory (swBindTextureMemory()), not freed
+    SWcompressed compressed;    // Format of the blocks kept in pixels (SW_TEXTURE_KEEP_DXT1), 0 for RGBA32 texels
+} sw_mipmap_t;
+
+typedef struct {
+    sw_mipmap_t levels[SW_MAX_MIPMAP_LEVELS];   // Mipmap levels, level 0 is the base texture
+    int levelCount;             // Number of consecutive levels available from the base
 
     SWfilter minFilter;         // Minification filter
     SWfilter magFilter;         // Magnification filter
@@ -848,25 +1203,203 @@ typedef struct {
     float ty;                   // Texel height
 } sw_texture_t;
 
-// Pixel data type
-typedef SW_ALIGN(SW_PIXEL_ALIGNMENT) struct {
+// Pixel data types, color and depth are stored in separate planes
+typedef struct {
     SW_COLOR_TYPE color[SW_COLOR_PACK_COMP];
+} sw_color_t;
+
+typedef struct {
     SW_DEPTH_TYPE depth[SW_DEPTH_PACK_COMP];
-#if (SW_PIXEL_SIZE % SW_PIXEL_ALIGNMENT != 0)
-    uint8_t padding[SW_PIXEL_ALIGNMENT - SW_PIXEL_SIZE % SW_PIXEL_ALIGNMENT];
-#endif
-} sw_pixel_t;
+} sw_depth_t;
+
+// Instruction set levels of the framebuffer kernels
+typedef enum {
+    SW_CPU_LEVEL_SCALAR = 0,
+    SW_CPU_LEVEL_SSE2,
+    SW_CPU_LEVEL_AVX2
+} sw_cpu_level_t;
+
+// Framebuffer kernels, processing spans of consecutive pixels
+// NOTE: Fill kernels are used for 16 and 32 bits planes, copy and blit convert 32 bits color
+// planes to RGBA/BGRA, swapping the R and B channels if required; blit scales with nearest
+// sampling, 'xScale' being the source step per destination pixel in 16.16 fixed point;
+// resolve averages the color of the SW_MSAA_SAMPLES sample planes, 'planeSize' pixels apart
+typedef void (*sw_fill16_f)(uint16_t *dst, int count, uint16_t value);
+typedef void (*sw_fill32_f)(uint32_t *dst, int count, uint32_t value);
+typedef void (*sw_copy_color32_f)(uint32_t *dst, const uint32_t *src, int count, bool swapRB);
+typedef void (*sw_blit_color32_f)(uint32_t *dst, const uint32_t *src, int count, uint32_t xScale, bool swapRB);
+typedef void (*sw_resolve_color32_f)(uint32_t *dst, const uint32_t *src, int count, int planeSize);
+
+typedef struct {
+    sw_cpu_level_t level;           // Instruction set level the kernels have been selected for
+    sw_fill16_f fill16;
+    sw_fill32_f fill32;
+    sw_copy_color32_f copyColor32;
+    sw_blit_color32_f blitColor32;
+    sw_resolve_color32_f resolveColor32;
+} sw_kernels_t;
+
+typedef struct {
+    float *maxDepth;            // Upper bound of the depth of each tile
+    int tilesX, tilesY;         // Number of tiles in each axis
+    int allocSz;
+} sw_hiz_t;
+
+typedef struct {
+    int rects[SW_MAX_DIRTY_RECTS][4];   // Rectangles { xMin, yMin, xMax, yMax } (max exclusive)
+    int count;
+} sw_region_t;
+
+// Multisampled planes, allocated on first use of SW_MULTISAMPLE with a framebuffer
+// NOTE: Sample planes share the stride of the framebuffer, depth[0] is the framebuffer depth plane;
+// the color plane only holds the resolved colors of the regions not listed as unresolved
+typedef struct {
+    sw_color_t *color[SW_MSAA_SAMPLES]; // Color plane of each sample, color[0] owns the allocation
+    sw_depth_t *depth[SW_MSAA_SAMPLES]; // Depth plane of each sample, depth[1] owns the allocation
+    int allocSz;                        // Allocated pixels of each sample plane
+    sw_region_t unresolved;             // Regions written since the last resolve
+    bool isEnabled;                     // Rasterization goes to the sample planes
+} sw_msaa_t;
 
 typedef struct {
-    sw_pixel_t *pixels;
+    sw_color_t *color;          // Color plane, internal or external memory (swBindFramebufferMemory())
+    sw_color_t *colorTarget;    // Color plane written by the rasterizers, first sample plane when multisampled
+    sw_depth_t *depth;          // Depth plane, always internal
     int width;
     int height;
-    int allocSz;
+    int stride;                 // Distance in pixels between rows, shared by both planes
+    int colorAllocSz;           // Allocated pixels of the internal color plane
+    int depthAllocSz;           // Allocated pixels of the depth plane
+
+    bool isExternal;            // Color plane is external memory, owned by the caller
+    bool isBGRA;                // Color plane stores BGRA8 colors instead of RGBA8 (external only)
+
+    sw_hiz_t hiz;               // Coarse depth buffer, tiles of SW_HIZ_TILE_SIZE pixels
+    sw_msaa_t msaa;             // Sample planes, used with SW_MULTISAMPLE
+
+    sw_region_t dirty;          // Color regions written since the last swResetDirtyRects()
+    sw_region_t drawn;          // Color regions written since the last full clear
+    sw_color_t lastClear;       // Color of the last full clear, valid if hasLastClear
+    bool hasLastClear;
 } sw_framebuffer_t;
 
+typedef struct {
+    int width, height;          // Dimensions of the depth attachment, set by swRenderbufferStorage()
+    bool isUsed;
+} sw_renderbuffer_t;
+
+// Framebuffer object, rendered into its own planes
+// NOTE: The color plane is copied into the attached texture when the framebuffer is unbound,
+// only the regions written since the last copy; the depth plane always belongs to the object,
+// depth renderbuffers only define its dimensions
+typedef struct {
+    sw_framebuffer_t fb;        // Planes and framebuffer state, moved into the context while bound
+    uint32_t colorTexture;      // Color attachment texture id (0: none)
+    uint32_t depthRenderbuffer; // Depth attachment renderbuffer id (0: none)
+    bool isStale;               // Color plane has to be loaded from the attached texture
+    bool isUsed;
+} sw_render_target_t;
+
+// Triangle and quad raster functions
+// NOTE: Bounds define the destination rectangle to rasterize { xMin, yMin, xMax, yMax } (max exclusive)
+typedef void (*sw_raster_triangle_f)(const sw_vertex_t *v0, const sw_vertex_t *v1, const sw_vertex_t *v2, const sw_texture_t *tex, const int bounds[4]);
+typedef void (*sw_raster_quad_f)(const sw_vertex_t *vertices, const sw_texture_t *tex, const int bounds[4]);
+
+// Raster state snapshot, raster functions and texture selected for the current state
+typedef struct {
+    sw_raster_triangle_f triangle;
+    sw_raster_quad_f quad;
+    const sw_texture_t *tex;
+} sw_raster_state_t;
+
+#if defined(SW_HAS_DEFERRED)
+typedef enum {
+    SW_RASTER_CMD_TRIANGLE = 0,
+    SW_RASTER_CMD_QUAD
+} sw_raster_cmd_type_t;
+
+// Deferred primitive, already clipped and projected to screen space
+typedef struct {
+    sw_vertex_t vertices[4];
+    int bounds[4];                  // Conservative screen bounds { xMin, yMin, xMax, yMax } (inclusive)
+    sw_raster_cmd_type_t type;
+    uint32_t state;                 // Index of the raster state snapshot
+} sw_raster_cmd_t;
+
+#if defined(RLSW_USE_COMMAND_BUFFER)
+// Primitives sharing a raster state, replayed together
+typedef struct {
+    uint32_t state;                 // Index of the raster state snapshot
+    int bounds[4];                  // Union of the primitives bounds
+    uint32_t first;                 // First primitive of the group
+    uint32_t last;                  // Last primitive of the group
+} sw_raster_group_t;
+#endif
+
+#if defined(RLSW_USE_THREADS)
+// Job run by the raster threads for each index of a range (tiles, texture block rows...)
+typedef void (*sw_job_f)(void *data, int index);
+
+// Screen tile bin, list of primitives overlapping the tile (in replay order)
+typedef struct {
+    uint32_t *cmds;
+    int count;
+    int capacity;
+} sw_tile_bin_t;
+#endif
+
+typedef struct {
+#if defined(RLSW_USE_THREADS)
+    pthread_t threads[SW_MAX_RASTER_THREADS];   // Worker threads
+    int threadCount;                            // Number of raster threads, main thread included
+    bool workersReady;                          // Worker threads have been created
+
+    pthread_mutex_t mutex;
+    pthread_cond_t wakeCond;                    // Signaled when a new flush is ready
+    pthread_cond_t doneCond;                    // Signaled when the last worker finishes a flush
+    uint32_t generation;                        // Flush counter, used by workers to detect new work
+    int pendingWorkers;                         // Workers still processing the current jobs
+    sw_job_f job;                               // Job being processed (tile rasterization on flush)
+    void *jobData;                              // Data passed to the job
+    int jobCount;                               // Number of job indices to process
+    int nextJob;                                // Next job index to be processed
+    bool quit;                                  // Request workers termination
+
+    sw_tile_bin_t *bins;                        // Tile bins, row-major
+    int tilesX, tilesY;                         // Number of tiles in each axis
+    int binCount;                               // Number of allocated bins
+#endif
+    bool enabled;                               // Triangles and quads are recorded and rasterized on flush
+
+    sw_raster_cmd_t *cmds;                      // Recorded primitives
+    int cmdCount;                               // Number of recorded primitives
+
+    sw_raster_state_t states[SW_MAX_DEFERRED_STATES];   // Raster state snapshots, without duplicates
+    int stateCount;                             // Number of raster state snapshots
+    int currentState;                           // Snapshot of the current raster state (-1: not recorded yet)
+
+#if defined(RLSW_USE_COMMAND_BUFFER)
+    sw_raster_group_t *groups;                  // Primitives grouped by raster state, in replay order
+    uint32_t *nextCmd;                          // Next primitive in the same group, for each primitive
+    uint32_t *order;                            // Primitives replay order
+#endif
+} sw_deferred_t;
+#endif
+
+#if defined(RLSW_USE_STATS)
+// Statistics counters padded to a cache line, so raster threads don't write to the same one
+typedef struct {
+    SWstats counters;
+    uint8_t padding[64 - sizeof(SWstats)%64];
+} sw_stats_slot_t;
+#endif
+
 typedef struct {
     sw_framebuffer_t framebuffer;   // Main framebuffer
-    sw_pixel_t clearValue;          // Clear value of the framebuffer
+    float clearColor[4];            // Clear color of the framebuffer
+    float clearDepth;               // Clear depth of the framebuffer
+    sw_kernels_t kernels;           // Framebuffer kernels, selected for the running CPU
+    int packRowLength;              // Row length (in pixels) of the memory written by swCopyFramebuffer(), 0: copy width
 
     float vpCenter[2];              // Viewport center
     float vpHalf[2];                // Viewport half dimensions
@@ -874,6 +1407,8 @@ typedef struct {
     int vpMin[2];                   // Viewport minimum renderable point (top-left)
     int vpMax[2];                   // Viewport maximum renderable point (bottom-right)
 
+    int vpRect[4];                  // Viewport as set { x, y, w, h }, clamped again when the framebuffer changes
+    int scRect[4];                  // Scissor as set { x, y, w, h }, clamped again when the framebuffer changes
     int scMin[2];                   // Scissor rectangle minimum renderable point (top-left)
     int scMax[2];                   // Scissor rectangle maximum renderable point (bottom-right)
     float scClipMin[2];             // Scissor rectangle minimum renderable point in clip space
@@ -895,6 +1430,9 @@ typedef struct {
     sw_vertex_t vertexBuffer[SW_MAX_CLIPPED_POLYGON_VERTICES];  // Buffer used for storing primitive vertices, used for processing and rendering
     int vertexCounter;                                          // Number of vertices in 'ctx.vertexBuffer'
 
+    sw_vertex_t *vertexCache;                                   // Post-transform vertices of the vertex arrays draw being processed
+    int vertexCacheSize;                                        // Number of vertices allocated in 'ctx.vertexCache'
+
     SWdraw drawMode;                                            // Current primitive mode (e.g., lines, triangles)
     SWpoly polyMode;                                            // Current polygon filling mode (e.g., lines, triangles)
     int reqVertices;                                            // Number of vertices required for the primitive being drawn
@@ -917,6 +1455,11 @@ typedef struct {
 
     sw_factor_f srcFactorFunc;
     sw_factor_f dstFactorFunc;
+    sw_blend_mode_t blendMode;                                  // Integer blending path for the current factors
+
+    SWdepthfunc depthFunc;                                      // Depth test comparison
+    bool depthMask;                                             // Depth writes enabled
+    uint32_t colorMask;                                         // Color channels written, SW_COLOR_MASK_ALL by default
 
     SWface cullFace;                                            // Faces to cull
     SWerrcode errCode;                                          // Last error code
@@ -928,6 +1471,21 @@ typedef struct {
     int freeTextureIdCount;
 
     uint32_t stateFlags;
+
+    sw_raster_state_t rasterState;                              // Raster functions and texture of the current state
+    bool isDirtyRasterState;                                    // Indicates if the raster state should be selected again
+
+    sw_render_target_t renderTargets[SW_MAX_FRAMEBUFFERS];      // Framebuffer objects, [0] holds the default framebuffer while another one is bound
+    sw_renderbuffer_t renderbuffers[SW_MAX_RENDERBUFFERS];      // Depth renderbuffers
+    uint32_t currentFramebuffer;                                // Bound framebuffer id, its state is in 'framebuffer'
+    uint32_t currentRenderbuffer;                               // Bound renderbuffer id
+
+#if defined(SW_HAS_DEFERRED)
+    sw_deferred_t deferred;                                     // Deferred rasterization command buffer
+#endif
+#if defined(RLSW_USE_STATS)
+    sw_stats_slot_t stats[SW_STATS_SLOTS];                      // Pipeline statistics, one slot per raster thread
+#endif
 } sw_context_t;
 
 //----------------------------------------------------------------------------------
@@ -935,6 +1493,10 @@ typedef struct {
 //----------------------------------------------------------------------------------
 static sw_context_t RLSW = { 0 };
 
+#if defined(RLSW_USE_STATS) && defined(RLSW_USE_THREADS)
+static SW_THREAD_LOCAL int swStatsSlot = 0;                     // Statistics slot of the current thread, 0 for the calling thread
+#endif
+
 //----------------------------------------------------------------------------------
 // Module Functions Declaration
 //----------------------------------------------------------------------------------
@@ -1005,6 +1567,16 @@ static inline float sw_fract(float x)
     return (x - floorf(x));
 }
 
+// Fast base-2 logarithm approximation (piecewise linear between powers of two)
+// NOTE: Only used for texture level of detail selection, where this precision is enough
+static inline float sw_fast_log2(float x)
+{
+    union { float f; uint32_t u; } fb;
+    fb.f = x;
+
+    return (float)fb.u*(1.0f/(1 << 23)) - 127.0f;
+}
+
 static inline int sw_clampi(int v, int min, int max)
 {
     if (v < min) return min;
@@ -1012,6 +1584,16 @@ static inline int sw_clampi(int v, int min, int max)
     return v;
 }
 
+static inline int sw_mini(int a, int b)
+{
+    return (a < b)? a : b;
+}
+
+static inline int sw_maxi(int a, int b)
+{
+    return (a > b)? a : b;
+}
+
 static inline void sw_lerp_vertex_PTCH(sw_vertex_t *SW_RESTRICT out, const sw_vertex_t *SW_RESTRICT a, const sw_vertex_t *SW_RESTRICT b, float t)
 {
     const float tInv = 1.0f - t;
@@ -1265,202 +1847,615 @@ static inline sw_half_t sw_half_from_float(float i)
     return sw_half_from_float_ui(v.i);
 }
 
-// Framebuffer management functions
+// Framebuffer kernels and CPU dispatch functions
+// NOTE: Kernels are selected by swInit() for the instruction set of the running CPU,
+// the scalar versions are always available and are the only ones compiled without
+// RLSW_USE_CPU_DISPATCH, where the compiler target decides the instructions used
 //-------------------------------------------------------------------------------------------
-static inline bool sw_framebuffer_load(int w, int h)
+static void sw_fill16_scalar(uint16_t *dst, int count, uint16_t value)
 {
-    int size = w*h;
+    for (int i = 0; i < count; i++) dst[i] = value;
+}
 
-    RLSW.framebuffer.pixels = SW_MALLOC(sizeof(sw_pixel_t)*size);
-    if (RLSW.framebuffer.pixels == NULL) return false;
+static void sw_fill32_scalar(uint32_t *dst, int count, uint32_t value)
+{
+    for (int i = 0; i < count; i++) dst[i] = value;
+}
 
-    RLSW.framebuffer.width = w;
-    RLSW.framebuffer.height = h;
-    RLSW.framebuffer.allocSz = size;
+static inline void sw_color32_convert(uint32_t *dst, const uint32_t *src, bool swapRB)
+{
+    const uint8_t *c = (const uint8_t *)src;
+    uint8_t *d = (uint8_t *)dst;
 
-    return true;
+    if (swapRB) d[0] = c[2], d[1] = c[1], d[2] = c[0], d[3] = c[3];
+    else *dst = *src;
 }
 
-static inline bool sw_framebuffer_resize(int w, int h)
+static void sw_copy_color32_scalar(uint32_t *dst, const uint32_t *src, int count, bool swapRB)
 {
-    int newSize = w*h;
-
-    if (newSize <= RLSW.framebuffer.allocSz)
+    if (!swapRB)
     {
-        RLSW.framebuffer.width = w;
-        RLSW.framebuffer.height = h;
-        return true;
+        memcpy(dst, src, count*sizeof(uint32_t));
+        return;
     }
 
-    void *newPixels = SW_REALLOC(RLSW.framebuffer.pixels, sizeof(sw_pixel_t)*newSize);
-    if (newPixels == NULL) return false;
-
-    RLSW.framebuffer.pixels = newPixels;
-
-    RLSW.framebuffer.width = w;
-    RLSW.framebuffer.height = h;
-    RLSW.framebuffer.allocSz = newSize;
+    for (int i = 0; i < count; i++) sw_color32_convert(&dst[i], &src[i], true);
+}
 
-    return true;
+static void sw_blit_color32_scalar(uint32_t *dst, const uint32_t *src, int count, uint32_t xScale, bool swapRB)
+{
+    for (int i = 0; i < count; i++) sw_color32_convert(&dst[i], &src[((uint32_t)i*xScale) >> 16], swapRB);
 }
 
-static inline void sw_framebuffer_read_color(float dst[4], const sw_pixel_t *src)
+static void sw_resolve_color32_scalar(uint32_t *dst, const uint32_t *src, int count, int planeSize)
 {
-#if SW_COLOR_IS_PACKED
-    SW_COLOR_TYPE pixel = src->color[0];
-    dst[0] = SW_TO_FLOAT_R(SW_UNPACK_R(pixel));
-    dst[1] = SW_TO_FLOAT_G(SW_UNPACK_G(pixel));
-    dst[2] = SW_TO_FLOAT_B(SW_UNPACK_B(pixel));
-    dst[3] = 1.0f;
-#else
-    sw_float_from_unorm8_simd(dst, src->color);
-#endif
+    for (int i = 0; i < count; i++)
+    {
+        // Channels summed two at a time in 16 bits lanes, rounded to nearest
+        uint32_t rb = 0x00020002, ga = 0x00020002;
+        for (int s = 0; s < SW_MSAA_SAMPLES; s++)
+        {
+            uint32_t pixel = src[i + s*planeSize];
+            rb += pixel & 0x00FF00FF;
+            ga += (pixel >> 8) & 0x00FF00FF;
+        }
+
+        dst[i] = ((rb >> 2) & 0x00FF00FF) | (((ga >> 2) & 0x00FF00FF) << 8);
+    }
 }
 
-static inline void sw_framebuffer_read_color8(uint8_t dst[4], const sw_pixel_t *src)
+#if defined(SW_HAS_CPU_DISPATCH)
+SW_TARGET("sse2") static void sw_fill16_sse2(uint16_t *dst, int count, uint16_t value)
 {
-#if SW_COLOR_IS_PACKED
-    SW_COLOR_TYPE pixel = src->color[0];
-    dst[0] = SW_SCALE_R(SW_UNPACK_R(pixel));
-    dst[1] = SW_SCALE_G(SW_UNPACK_G(pixel));
-    dst[2] = SW_SCALE_B(SW_UNPACK_B(pixel));
-    dst[3] = 255;
-#else
-    const SW_COLOR_TYPE *p = src->color;
-    dst[0] = p[0];
-    dst[1] = p[1];
-    dst[2] = p[2];
-    dst[3] = p[3];
-#endif
+    const __m128i v = _mm_set1_epi16((short)value);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) _mm_storeu_si128((__m128i *)(dst + i), v);
+
+    sw_fill16_scalar(dst + i, count - i, value);
 }
 
-static inline float sw_framebuffer_read_depth(const sw_pixel_t *src)
+SW_TARGET("sse2") static void sw_fill32_sse2(uint32_t *dst, int count, uint32_t value)
 {
-#if SW_DEPTH_IS_PACKED
-    return src->depth[0]*SW_DEPTH_SCALE;
-#else
-    return SW_UNPACK_DEPTH(src->depth)*SW_DEPTH_SCALE;
-#endif
+    const __m128i v = _mm_set1_epi32((int)value);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) _mm_storeu_si128((__m128i *)(dst + i), v);
+
+    sw_fill32_scalar(dst + i, count - i, value);
 }
 
-static inline void sw_framebuffer_write_color(sw_pixel_t *dst, const float src[4])
+SW_TARGET("avx2") static void sw_fill16_avx2(uint16_t *dst, int count, uint16_t value)
 {
-#if SW_COLOR_IS_PACKED
-    dst->color[0] = SW_PACK_COLOR(src[0], src[1], src[2]);
-#else
-    sw_float_to_unorm8_simd(dst->color, src);
-#endif
+    const __m256i v = _mm256_set1_epi16((short)value);
+    int i = 0;
+
+    for (; i + 16 <= count; i += 16) _mm256_storeu_si256((__m256i *)(dst + i), v);
+
+    sw_fill16_scalar(dst + i, count - i, value);
 }
 
-static inline void sw_framebuffer_write_depth(sw_pixel_t *dst, float depth)
+SW_TARGET("avx2") static void sw_fill32_avx2(uint32_t *dst, int count, uint32_t value)
 {
-    depth = sw_saturate(depth); // REVIEW: An overflow can occur in certain circumstances with clipping, and needs to be reviewed...
+    const __m256i v = _mm256_set1_epi32((int)value);
+    int i = 0;
 
-#if SW_DEPTH_IS_PACKED
-    dst->depth[0] = SW_PACK_DEPTH(depth);
-#else
-    dst->depth[0] = SW_PACK_DEPTH_0(depth);
-    dst->depth[1] = SW_PACK_DEPTH_1(depth);
-    dst->depth[2] = SW_PACK_DEPTH_2(depth);
-#endif
+    for (; i + 8 <= count; i += 8) _mm256_storeu_si256((__m256i *)(dst + i), v);
+
+    sw_fill32_scalar(dst + i, count - i, value);
 }
 
-static inline void sw_framebuffer_fill_color(sw_pixel_t *ptr, int size, const SW_COLOR_TYPE color[SW_COLOR_PACK_COMP])
+SW_TARGET("sse2") static void sw_copy_color32_sse2(uint32_t *dst, const uint32_t *src, int count, bool swapRB)
 {
-    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    if (!swapRB)
     {
-        int w = RLSW.scMax[0] - RLSW.scMin[0] + 1;
-        for (int y = RLSW.scMin[1]; y <= RLSW.scMax[1]; y++)
-        {
-            sw_pixel_t *row = ptr + y*RLSW.framebuffer.width + RLSW.scMin[0];
-            for (int x = 0; x < w; x++, row++)
-            {
-                for (int i = 0; i < SW_COLOR_PACK_COMP; i++) row->color[i] = color[i];
-            }
-        }
+        memcpy(dst, src, count*sizeof(uint32_t));
+        return;
     }
-    else
+
+    const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
     {
-        for (int i = 0; i < size; i++, ptr++)
-        {
-            for (int j = 0; j < SW_COLOR_PACK_COMP; j++) ptr->color[j] = color[j];
-        }
+        __m128i colors = _mm_loadu_si128((const __m128i *)(src + i));
+
+        // Swap R and B, exchanging the 16 bits halves of each masked R/B pair
+        __m128i rb = _mm_and_si128(colors, maskRB);
+        __m128i ga = _mm_andnot_si128(maskRB, colors);
+        rb = _mm_shufflehi_epi16(_mm_shufflelo_epi16(rb, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(rb, ga));
     }
+
+    sw_copy_color32_scalar(dst + i, src + i, count - i, swapRB);
 }
 
-static inline void sw_framebuffer_fill_depth(sw_pixel_t *ptr, int size, const SW_DEPTH_TYPE depth[SW_DEPTH_PACK_COMP])
+SW_TARGET("sse2") static void sw_resolve_color32_sse2(uint32_t *dst, const uint32_t *src, int count, int planeSize)
 {
-    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(2);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4)
     {
-        int w = RLSW.scMax[0] - RLSW.scMin[0] + 1;
-        for (int y = RLSW.scMin[1]; y <= RLSW.scMax[1]; y++)
+        __m128i lo = round, hi = round;
+        for (int s = 0; s < SW_MSAA_SAMPLES; s++)
         {
-            sw_pixel_t *row = ptr + y*RLSW.framebuffer.width + RLSW.scMin[0];
-            for (int x = 0; x < w; x++, row++)
-            {
-                for (int i = 0; i < SW_DEPTH_PACK_COMP; i++) row->depth[i] = depth[i];
-            }
+            __m128i colors = _mm_loadu_si128((const __m128i *)(src + i + s*planeSize));
+            lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(colors, zero));
+            hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(colors, zero));
         }
+
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(_mm_srli_epi16(lo, 2), _mm_srli_epi16(hi, 2)));
     }
-    else
-    {
-        for (int i = 0; i < size; i++, ptr++)
-        {
-            for (int j = 0; j < SW_DEPTH_PACK_COMP; j++) ptr->depth[j] = depth[j];
+
+    sw_resolve_color32_scalar(dst + i, src + i, count - i, planeSize);
+}
+
+SW_TARGET("avx2") static inline __m256i sw_color32_swap_rb_avx2(__m256i colors)
+{
+    const __m256i swizzle = _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    return _mm256_shuffle_epi8(colors, swizzle);
+}
+
+SW_TARGET("avx2") static void sw_copy_color32_avx2(uint32_t *dst, const uint32_t *src, int count, bool swapRB)
+{
+    if (!swapRB)
+    {
+        memcpy(dst, src, count*sizeof(uint32_t));
+        return;
+    }
+
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i colors = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), sw_color32_swap_rb_avx2(colors));
+    }
+
+    sw_copy_color32_sse2(dst + i, src + i, count - i, swapRB);
+}
+
+SW_TARGET("avx2") static void sw_blit_color32_avx2(uint32_t *dst, const uint32_t *src, int count, uint32_t xScale, bool swapRB)
+{
+    const __m256i step = _mm256_set1_epi32((int)(8*xScale));
+    __m256i xFix = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32((int)xScale));
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i colors = _mm256_i32gather_epi32((const int *)src, _mm256_srli_epi32(xFix, 16), 4);
+        if (swapRB) colors = sw_color32_swap_rb_avx2(colors);
+
+        _mm256_storeu_si256((__m256i *)(dst + i), colors);
+        xFix = _mm256_add_epi32(xFix, step);
+    }
+
+    for (; i < count; i++) sw_color32_convert(&dst[i], &src[((uint32_t)i*xScale) >> 16], swapRB);
+}
+
+SW_TARGET("avx2") static void sw_resolve_color32_avx2(uint32_t *dst, const uint32_t *src, int count, int planeSize)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi16(2);
+    int i = 0;
+
+    // NOTE: Unpacking and packing both work within 128 bits lanes, so the pixels order is kept
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i lo = round, hi = round;
+        for (int s = 0; s < SW_MSAA_SAMPLES; s++)
+        {
+            __m256i colors = _mm256_loadu_si256((const __m256i *)(src + i + s*planeSize));
+            lo = _mm256_add_epi16(lo, _mm256_unpacklo_epi8(colors, zero));
+            hi = _mm256_add_epi16(hi, _mm256_unpackhi_epi8(colors, zero));
+        }
+
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_packus_epi16(_mm256_srli_epi16(lo, 2), _mm256_srli_epi16(hi, 2)));
+    }
+
+    sw_resolve_color32_sse2(dst + i, src + i, count - i, planeSize);
+}
+
+static inline void sw_cpuid(uint32_t regs[4], uint32_t leaf, uint32_t subleaf)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuidex(info, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) regs[i] = (uint32_t)info[i];
+#else
+    unsigned int a, b, c, d;
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+    regs[0] = a, regs[1] = b, regs[2] = c, regs[3] = d;
+#endif
+}
+
+// Get the extended control register 0, state components saved by the OS
+static inline uint64_t sw_xgetbv0(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ __volatile__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+#endif
+}
+#endif // SW_HAS_CPU_DISPATCH
+
+// Get the highest instruction set level of the framebuffer kernels supported by the CPU
+static inline sw_cpu_level_t sw_cpu_get_level(void)
+{
+    sw_cpu_level_t level = SW_CPU_LEVEL_SCALAR;
+
+#if defined(SW_HAS_CPU_DISPATCH)
+    uint32_t regs[4] = { 0 };   // eax, ebx, ecx, edx
+    sw_cpuid(regs, 0, 0);
+    uint32_t maxLeaf = regs[0];
+
+    if (maxLeaf >= 1)
+    {
+        sw_cpuid(regs, 1, 0);
+        bool hasSSE2 = (regs[3] & (1u << 26)) != 0;
+        bool hasOSXSAVE = (regs[2] & (1u << 27)) != 0;
+        bool hasAVX = (regs[2] & (1u << 28)) != 0;
+
+        if (hasSSE2) level = SW_CPU_LEVEL_SSE2;
+
+        // NOTE: AVX registers must also be saved by the OS on context switches (XCR0 bits 1 and 2)
+        if (hasSSE2 && hasOSXSAVE && hasAVX && ((sw_xgetbv0() & 0x6) == 0x6) && (maxLeaf >= 7))
+        {
+            sw_cpuid(regs, 7, 0);
+            if (regs[1] & (1u << 5)) level = SW_CPU_LEVEL_AVX2;
         }
     }
+#endif
+
+    return level;
+}
+
+static inline void sw_kernels_init(void)
+{
+    sw_kernels_t *kernels = &RLSW.kernels;
+
+    kernels->level = sw_cpu_get_level();
+    kernels->fill16 = sw_fill16_scalar;
+    kernels->fill32 = sw_fill32_scalar;
+    kernels->copyColor32 = sw_copy_color32_scalar;
+    kernels->blitColor32 = sw_blit_color32_scalar;
+    kernels->resolveColor32 = sw_resolve_color32_scalar;
+
+#if defined(SW_HAS_CPU_DISPATCH)
+    switch (kernels->level)
+    {
+        case SW_CPU_LEVEL_AVX2:
+        {
+            kernels->fill16 = sw_fill16_avx2;
+            kernels->fill32 = sw_fill32_avx2;
+            kernels->copyColor32 = sw_copy_color32_avx2;
+            kernels->blitColor32 = sw_blit_color32_avx2;
+            kernels->resolveColor32 = sw_resolve_color32_avx2;
+        } break;
+        case SW_CPU_LEVEL_SSE2:
+        {
+            // NOTE: No gather instructions before AVX2, blit keeps the scalar kernel
+            kernels->fill16 = sw_fill16_sse2;
+            kernels->fill32 = sw_fill32_sse2;
+            kernels->copyColor32 = sw_copy_color32_sse2;
+            kernels->resolveColor32 = sw_resolve_color32_sse2;
+        } break;
+        default: break;
+    }
+#endif
+}
+//-------------------------------------------------------------------------------------------
+
+// Framebuffer management functions
+//-------------------------------------------------------------------------------------------
+// Resize the sample planes, 'size' being the pixels of a framebuffer plane
+// NOTE: The first depth sample is the framebuffer depth plane, set by the caller
+static inline bool sw_msaa_resize(sw_msaa_t *msaa, int size)
+{
+    if (size > msaa->allocSz)
+    {
+        void *newColor = SW_REALLOC(msaa->color[0], sizeof(sw_color_t)*size*SW_MSAA_SAMPLES);
+        if (newColor == NULL) return false;
+        msaa->color[0] = newColor;
+
+        void *newDepth = SW_REALLOC(msaa->depth[1], sizeof(sw_depth_t)*size*(SW_MSAA_SAMPLES - 1));
+        if (newDepth == NULL) return false;
+        msaa->depth[1] = newDepth;
+
+        msaa->allocSz = size;
+    }
+
+    for (int i = 1; i < SW_MSAA_SAMPLES; i++)
+    {
+        msaa->color[i] = msaa->color[0] + i*msaa->allocSz;
+        msaa->depth[i] = msaa->depth[1] + (i - 1)*msaa->allocSz;
+    }
+
+    return true;
+}
+
+// Copy the color and depth planes of a framebuffer into all its samples
+static inline void sw_msaa_load(sw_framebuffer_t *fb)
+{
+    sw_msaa_t *msaa = &fb->msaa;
+    int size = fb->stride*(fb->height - 1) + fb->width;
+
+    for (int i = 0; i < SW_MSAA_SAMPLES; i++)
+    {
+        memcpy(msaa->color[i], fb->color, sizeof(sw_color_t)*size);
+        if (i > 0) memcpy(msaa->depth[i], fb->depth, sizeof(sw_depth_t)*size);
+    }
+
+    msaa->unresolved.count = 0;
+}
+
+// Resize the planes of a framebuffer, external color planes are not reallocated
+// NOTE: Stride is given in pixels, internal planes have no padding between rows
+static inline bool sw_framebuffer_resize(sw_framebuffer_t *fb, int w, int h, int stride)
+{
+    int size = stride*h;
+
+    if (!fb->isExternal && (size > fb->colorAllocSz))
+    {
+        void *newColor = SW_REALLOC(fb->color, sizeof(sw_color_t)*size);
+        if (newColor == NULL) return false;
+
+        fb->color = newColor;
+        fb->colorAllocSz = size;
+    }
+
+    if (size > fb->depthAllocSz)
+    {
+        void *newDepth = SW_REALLOC(fb->depth, sizeof(sw_depth_t)*size);
+        if (newDepth == NULL) return false;
+
+        fb->depth = newDepth;
+        fb->depthAllocSz = size;
+    }
+
+    // Sample planes follow the framebuffer size once allocated
+    if ((fb->msaa.allocSz > 0) && !sw_msaa_resize(&fb->msaa, size)) return false;
+
+    fb->width = w;
+    fb->height = h;
+    fb->stride = stride;
+
+    fb->msaa.depth[0] = fb->depth;
+    if (fb->msaa.isEnabled) sw_msaa_load(fb);
+
+    fb->colorTarget = fb->msaa.isEnabled? fb->msaa.color[0] : fb->color;
+
+    return true;
+}
+
+static inline void sw_color8_swap_rb(uint8_t color[4])
+{
+    uint8_t r = color[0];
+    color[0] = color[2];
+    color[2] = r;
+}
+
+static inline void sw_framebuffer_read_color(float dst[4], const sw_color_t *src)
+{
+#if SW_COLOR_IS_PACKED
+    SW_COLOR_TYPE pixel = src->color[0];
+    dst[0] = SW_TO_FLOAT_R(SW_UNPACK_R(pixel));
+    dst[1] = SW_TO_FLOAT_G(SW_UNPACK_G(pixel));
+    dst[2] = SW_TO_FLOAT_B(SW_UNPACK_B(pixel));
+    dst[3] = 1.0f;
+#else
+    sw_float_from_unorm8_simd(dst, src->color);
+
+    if (RLSW.framebuffer.isBGRA)
+    {
+        float r = dst[0];
+        dst[0] = dst[2];
+        dst[2] = r;
+    }
+#endif
+}
+
+static inline void sw_framebuffer_read_color8(uint8_t dst[4], const sw_color_t *src)
+{
+#if SW_COLOR_IS_PACKED
+    SW_COLOR_TYPE pixel = src->color[0];
+    dst[0] = SW_SCALE_R(SW_UNPACK_R(pixel));
+    dst[1] = SW_SCALE_G(SW_UNPACK_G(pixel));
+    dst[2] = SW_SCALE_B(SW_UNPACK_B(pixel));
+    dst[3] = 255;
+#else
+    const SW_COLOR_TYPE *p = src->color;
+    dst[0] = p[0];
+    dst[1] = p[1];
+    dst[2] = p[2];
+    dst[3] = p[3];
+
+    if (RLSW.framebuffer.isBGRA) sw_color8_swap_rb(dst);
+#endif
+}
+
+static inline void sw_framebuffer_write_color8(sw_color_t *dst, const uint8_t src[4])
+{
+#if SW_COLOR_IS_PACKED
+    dst->color[0] = SW_PACK_COLOR(src[0]*SW_INV_255, src[1]*SW_INV_255, src[2]*SW_INV_255);
+#else
+    SW_COLOR_TYPE *p = dst->color;
+    p[0] = src[0];
+    p[1] = src[1];
+    p[2] = src[2];
+    p[3] = src[3];
+
+    if (RLSW.framebuffer.isBGRA) sw_color8_swap_rb(p);
+#endif
+}
+
+static inline float sw_framebuffer_read_depth(const sw_depth_t *src)
+{
+#if SW_DEPTH_IS_PACKED
+    return src->depth[0]*SW_DEPTH_SCALE;
+#else
+    return SW_UNPACK_DEPTH(src->depth)*SW_DEPTH_SCALE;
+#endif
+}
+
+static inline void sw_framebuffer_write_color(sw_color_t *dst, const float src[4])
+{
+#if SW_COLOR_IS_PACKED
+    dst->color[0] = SW_PACK_COLOR(src[0], src[1], src[2]);
+#else
+    sw_float_to_unorm8_simd(dst->color, src);
+
+    if (RLSW.framebuffer.isBGRA) sw_color8_swap_rb(dst->color);
+#endif
+}
+
+static inline void sw_framebuffer_write_depth(sw_depth_t *dst, float depth)
+{
+    depth = sw_saturate(depth); // REVIEW: An overflow can occur in certain circumstances with clipping, and needs to be reviewed...
+
+#if SW_DEPTH_IS_PACKED
+    dst->depth[0] = SW_PACK_DEPTH(depth);
+#else
+    dst->depth[0] = SW_PACK_DEPTH_0(depth);
+    dst->depth[1] = SW_PACK_DEPTH_1(depth);
+    dst->depth[2] = SW_PACK_DEPTH_2(depth);
+#endif
+}
+
+// Get the value a depth is stored with in the depth buffer
+static inline float sw_depth_quantize(float depth)
+{
+    sw_depth_t pixel;
+    sw_framebuffer_write_depth(&pixel, depth);
+    return sw_framebuffer_read_depth(&pixel);
+}
+
+// Compare a fragment depth with the depth buffer value, at the depth buffer precision
+// NOTE: Same geometry drawn again gets the same stored depth, so a depth pre-pass
+// can be followed by a SW_EQUAL or SW_LEQUAL shading pass
+static inline bool sw_depth_test(SWdepthfunc func, float z, float depth)
+{
+    z = sw_depth_quantize(z);
+
+    switch (func)
+    {
+        case SW_LEQUAL: return (z <= depth);
+        case SW_LESS: return (z < depth);
+        case SW_EQUAL: return (z == depth);
+        case SW_GEQUAL: return (z >= depth);
+        case SW_GREATER: return (z > depth);
+        case SW_NOTEQUAL: return (z != depth);
+        case SW_ALWAYS: return true;
+        case SW_NEVER:
+        default: break;
+    }
+
+    return false;
+}
+
+// Fill a span of consecutive pixels of a framebuffer plane, 'size' being the pixel size
+static inline void sw_framebuffer_fill_span(void *dst, int count, const void *value, int size)
+{
+    switch (size)
+    {
+        case 1: memset(dst, *(const uint8_t *)value, count); break;
+        case 2:
+        {
+            uint16_t value16;
+            memcpy(&value16, value, sizeof(uint16_t));
+            RLSW.kernels.fill16((uint16_t *)dst, count, value16);
+        } break;
+        case 4:
+        {
+            uint32_t value32;
+            memcpy(&value32, value, sizeof(uint32_t));
+            RLSW.kernels.fill32((uint32_t *)dst, count, value32);
+        } break;
+        default:
+        {
+            // NOTE: Only 24 bits depth planes, there are no kernels for 3 bytes pixels
+            uint8_t *ptr = (uint8_t *)dst;
+            for (int i = 0; i < count; i++, ptr += size) memcpy(ptr, value, size);
+        } break;
+    }
 }
 
-static inline void sw_framebuffer_fill(sw_pixel_t *ptr, int size, sw_pixel_t value)
+// Fill a framebuffer plane (or its scissor rectangle) with a pixel value
+static inline void sw_framebuffer_fill(void *plane, const void *value, int size)
 {
+    uint8_t *base = (uint8_t *)plane;
+    int rowSize = RLSW.framebuffer.stride*size;
+
     if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
     {
         int w = RLSW.scMax[0] - RLSW.scMin[0] + 1;
         for (int y = RLSW.scMin[1]; y <= RLSW.scMax[1]; y++)
         {
-            sw_pixel_t *row = ptr + y*RLSW.framebuffer.width + RLSW.scMin[0];
-            for (int x = 0; x < w; x++, row++) *row = value;
+            sw_framebuffer_fill_span(base + y*rowSize + RLSW.scMin[0]*size, w, value, size);
         }
     }
+    else if (RLSW.framebuffer.stride == RLSW.framebuffer.width)
+    {
+        sw_framebuffer_fill_span(base, RLSW.framebuffer.width*RLSW.framebuffer.height, value, size);
+    }
     else
     {
-        for (int i = 0; i < size; i++, ptr++) *ptr = value;
+        for (int y = 0; y < RLSW.framebuffer.height; y++)
+        {
+            sw_framebuffer_fill_span(base + y*rowSize, RLSW.framebuffer.width, value, size);
+        }
     }
 }
 
 static inline void sw_framebuffer_copy_fast(void* dst)
 {
-    int size = RLSW.framebuffer.width*RLSW.framebuffer.height;
-    const sw_pixel_t *pixels = RLSW.framebuffer.pixels;
+    const int w = RLSW.framebuffer.width;
+    const int h = RLSW.framebuffer.height;
+    const int stride = RLSW.framebuffer.stride;
+    const sw_color_t *color = RLSW.framebuffer.color;
 
 #if SW_COLOR_BUFFER_BITS == 8
     uint8_t *dst8 = (uint8_t*)dst;
-    for (int i = 0; i < size; i++) dst8[i] = pixels[i].color[0];
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++) *dst8++ = color[y*stride + x].color[0];
+    }
 #elif SW_COLOR_BUFFER_BITS == 16
     uint16_t *dst16 = (uint16_t*)dst;
-    for (int i = 0; i < size; i++) dst16[i] = *(uint16_t*)pixels[i].color;
+    for (int y = 0; y < h; y++) memcpy(dst16 + y*w, color + y*stride, sizeof(uint16_t)*w);
 #else // 32 bits
+    bool swapRB = (RLSW.framebuffer.isBGRA != (bool)SW_GL_FRAMEBUFFER_COPY_BGRA);
     uint32_t *dst32 = (uint32_t*)dst;
-    #if SW_GL_FRAMEBUFFER_COPY_BGRA
-        for (int i = 0; i < size; i++)
+
+    if (stride == w) RLSW.kernels.copyColor32(dst32, (const uint32_t*)color, w*h, swapRB);
+    else
+    {
+        for (int y = 0; y < h; y++)
         {
-            const uint8_t *c = pixels[i].color;
-            dst32[i] = (uint32_t)c[2] | ((uint32_t)c[1] << 8) | ((uint32_t)c[0] << 16) | ((uint32_t)c[3] << 24);
+            RLSW.kernels.copyColor32(dst32 + y*w, (const uint32_t*)(color + y*stride), w, swapRB);
         }
-    #else // RGBA
-        for (int i = 0; i < size; i++) dst32[i] = *(uint32_t*)pixels[i].color;
-    #endif
+    }
 #endif
 }
 
-#define DEFINE_FRAMEBUFFER_COPY_BEGIN(name, DST_PTR_T)                          \
+#define DEFINE_FRAMEBUFFER_COPY_BEGIN(name, DST_PTR_T, DST_COMPONENTS)          \
 static inline void sw_framebuffer_copy_to_##name(int x, int y, int w, int h, DST_PTR_T *dst) \
 {                                                                               \
-    const int stride = RLSW.framebuffer.width;                                  \
-    const sw_pixel_t *src = RLSW.framebuffer.pixels + (y*stride + x);           \
+    const int stride = RLSW.framebuffer.stride;                                 \
+    const sw_color_t *src = RLSW.framebuffer.color + (y*stride + x);            \
+    const int dstSkip = sw_maxi(RLSW.packRowLength - w, 0)*DST_COMPONENTS;      \
                                                                                 \
     for (int iy = 0; iy < h; iy++) {                                            \
-        const sw_pixel_t *line = src;                                           \
+        const sw_color_t *line = src;                                           \
         for (int ix = 0; ix < w; ix++) {                                        \
             uint8_t color[4];                                                   \
             sw_framebuffer_read_color8(color, line);                            \
@@ -1469,10 +2464,11 @@ static inline void sw_framebuffer_copy_to_##name(int x, int y, int w, int h, DST
             ++line;                                                             \
         }                                                                       \
         src += stride;                                                          \
+        dst += dstSkip;                                                         \
     }                                                                           \
 }
 
-DEFINE_FRAMEBUFFER_COPY_BEGIN(GRAYSCALE, uint8_t)
+DEFINE_FRAMEBUFFER_COPY_BEGIN(GRAYSCALE, uint8_t, 1)
 {
     // NTSC grayscale conversion: Y = 0.299R + 0.587G + 0.114B
     uint8_t gray = (uint8_t)((color[0]*299 + color[1]*587 + color[2]*114 + 500)/1000);
@@ -1480,7 +2476,7 @@ DEFINE_FRAMEBUFFER_COPY_BEGIN(GRAYSCALE, uint8_t)
 }
 DEFINE_FRAMEBUFFER_COPY_END()
 
-DEFINE_FRAMEBUFFER_COPY_BEGIN(GRAYALPHA, uint8_t)
+DEFINE_FRAMEBUFFER_COPY_BEGIN(GRAYALPHA, uint8_t, 2)
 {
     // Convert RGB to grayscale using NTSC formula
     uint8_t gray = (uint8_t)((color[0]*299 + color[1]*587 + color[2]*114 + 500)/1000);
@@ -1492,7 +2488,7 @@ DEFINE_FRAMEBUFFER_COPY_BEGIN(GRAYALPHA, uint8_t)
 }
 DEFINE_FRAMEBUFFER_COPY_END()
 
-DEFINE_FRAMEBUFFER_COPY_BEGIN(R5G6B5, uint16_t)
+DEFINE_FRAMEBUFFER_COPY_BEGIN(R5G6B5, uint16_t, 1)
 {
     // Convert 8-bit RGB to 5:6:5 format
     uint8_t r5 = (color[0]*31 + 127)/255;
@@ -1509,7 +2505,7 @@ DEFINE_FRAMEBUFFER_COPY_BEGIN(R5G6B5, uint16_t)
 }
 DEFINE_FRAMEBUFFER_COPY_END()
 
-DEFINE_FRAMEBUFFER_COPY_BEGIN(R8G8B8, uint8_t)
+DEFINE_FRAMEBUFFER_COPY_BEGIN(R8G8B8, uint8_t, 3)
 {
 #if SW_GL_FRAMEBUFFER_COPY_BGRA
     dst[0] = color[2];
@@ -1525,7 +2521,7 @@ DEFINE_FRAMEBUFFER_COPY_BEGIN(R8G8B8, uint8_t)
 }
 DEFINE_FRAMEBUFFER_COPY_END()
 
-DEFINE_FRAMEBUFFER_COPY_BEGIN(R5G5B5A1, uint16_t)
+DEFINE_FRAMEBUFFER_COPY_BEGIN(R5G5B5A1, uint16_t, 1)
 {
     uint8_t r5 = (color[0]*31 + 127)/255;
     uint8_t g5 = (color[1]*31 + 127)/255;
@@ -1542,7 +2538,7 @@ DEFINE_FRAMEBUFFER_COPY_BEGIN(R5G5B5A1, uint16_t)
 }
 DEFINE_FRAMEBUFFER_COPY_END()
 
-DEFINE_FRAMEBUFFER_COPY_BEGIN(R4G4B4A4, uint16_t)
+DEFINE_FRAMEBUFFER_COPY_BEGIN(R4G4B4A4, uint16_t, 1)
 {
     uint8_t r4 = (color[0]*15 + 127)/255;
     uint8_t g4 = (color[1]*15 + 127)/255;
@@ -1559,7 +2555,7 @@ DEFINE_FRAMEBUFFER_COPY_BEGIN(R4G4B4A4, uint16_t)
 }
 DEFINE_FRAMEBUFFER_COPY_END()
 
-DEFINE_FRAMEBUFFER_COPY_BEGIN(R8G8B8A8, uint8_t)
+DEFINE_FRAMEBUFFER_COPY_BEGIN(R8G8B8A8, uint8_t, 4)
 {
 #if SW_GL_FRAMEBUFFER_COPY_BGRA
     dst[0] = color[2];
@@ -1582,8 +2578,8 @@ static inline void sw_framebuffer_blit_to_##name(
     int xSrc, int ySrc, int wSrc, int hSrc,                                     \
     DST_PTR_T *dst)                                                             \
 {                                                                               \
-    const sw_pixel_t *srcBase = RLSW.framebuffer.pixels;                        \
-    const int fbWidth = RLSW.framebuffer.width;                                 \
+    const sw_color_t *srcBase = RLSW.framebuffer.color;                         \
+    const int fbWidth = RLSW.framebuffer.stride;                                \
                                                                                 \
     const uint32_t xScale = ((uint32_t)wSrc << 16)/(uint32_t)wDst;              \
     const uint32_t yScale = ((uint32_t)hSrc << 16)/(uint32_t)hDst;              \
@@ -1591,13 +2587,13 @@ static inline void sw_framebuffer_blit_to_##name(
     for (int dy = 0; dy < hDst; dy++) {                                         \
         uint32_t yFix = ((uint32_t)ySrc << 16) + dy*yScale;                     \
         int sy = yFix >> 16;                                                    \
-        const sw_pixel_t *srcLine = srcBase + sy*fbWidth + xSrc;                \
+        const sw_color_t *srcLine = srcBase + sy*fbWidth + xSrc;                \
                                                                                 \
-        const sw_pixel_t *srcPtr = srcLine;                                     \
+        const sw_color_t *srcPtr = srcLine;                                     \
         for (int dx = 0; dx < wDst; dx++) {                                     \
             uint32_t xFix = dx*xScale;                                          \
             int sx = xFix >> 16;                                                \
-            const sw_pixel_t *pixel = srcPtr + sx;                              \
+            const sw_color_t *pixel = srcPtr + sx;                              \
             uint8_t color[4];                                                   \
             sw_framebuffer_read_color8(color, pixel);
 
@@ -1706,49 +2702,491 @@ DEFINE_FRAMEBUFFER_BLIT_BEGIN(R8G8B8A8, uint8_t)
     dst += 4;
 }
 DEFINE_FRAMEBUFFER_BLIT_END()
-//-------------------------------------------------------------------------------------------
 
-// Pixel format management functions
-//-------------------------------------------------------------------------------------------
-static inline int sw_get_pixel_format(SWformat format, SWtype type)
+#if (SW_COLOR_BUFFER_BITS == 32)
+// Copy to RGBA/BGRA 32 bits, same as sw_framebuffer_copy_to_R8G8B8A8() but with the framebuffer kernels
+static inline void sw_framebuffer_copy_color32(int x, int y, int w, int h, uint32_t *dst)
 {
-    int channels = 0;
-    int bitsPerChannel = 8; // Default: 8 bits per channel
+    const bool swapRB = (RLSW.framebuffer.isBGRA != (bool)SW_GL_FRAMEBUFFER_COPY_BGRA);
+    const int dstStride = sw_maxi(RLSW.packRowLength, w);
+    const sw_color_t *src = RLSW.framebuffer.color + (y*RLSW.framebuffer.stride + x);
 
-    // Determine the number of channels (format)
-    switch (format)
+    for (int iy = 0; iy < h; iy++, src += RLSW.framebuffer.stride, dst += dstStride)
     {
-        case SW_LUMINANCE:        channels = 1; break;
-        case SW_LUMINANCE_ALPHA:  channels = 2; break;
-        case SW_RGB:              channels = 3; break;
-        case SW_RGBA:             channels = 4; break;
-        default: return SW_PIXELFORMAT_UNKNOWN;
+        RLSW.kernels.copyColor32(dst, (const uint32_t *)src, w, swapRB);
     }
+}
 
-    // Determine the depth of each channel (type)
-    switch (type)
+// Blit to RGBA/BGRA 32 bits, same as sw_framebuffer_blit_to_R8G8B8A8() but with the framebuffer kernels
+static inline void sw_framebuffer_blit_color32(int wDst, int hDst, int xSrc, int ySrc, int wSrc, int hSrc, uint32_t *dst)
+{
+    const uint32_t xScale = ((uint32_t)wSrc << 16)/(uint32_t)wDst;
+    const uint32_t yScale = ((uint32_t)hSrc << 16)/(uint32_t)hDst;
+    const bool swapRB = (RLSW.framebuffer.isBGRA != (bool)SW_GL_FRAMEBUFFER_COPY_BGRA);
+
+    for (int dy = 0; dy < hDst; dy++, dst += wDst)
     {
-        case SW_UNSIGNED_BYTE:    bitsPerChannel = 8;  break;
-        case SW_BYTE:             bitsPerChannel = 8;  break;
-        case SW_UNSIGNED_SHORT:   bitsPerChannel = 16; break;
-        case SW_SHORT:            bitsPerChannel = 16; break;
-        case SW_UNSIGNED_INT:     bitsPerChannel = 32; break;
-        case SW_INT:              bitsPerChannel = 32; break;
-        case SW_FLOAT:            bitsPerChannel = 32; break;
-        default: return SW_PIXELFORMAT_UNKNOWN;
+        uint32_t yFix = ((uint32_t)ySrc << 16) + dy*yScale;
+        const sw_color_t *srcLine = RLSW.framebuffer.color + (int)(yFix >> 16)*RLSW.framebuffer.stride + xSrc;
+
+        RLSW.kernels.blitColor32(dst, (const uint32_t *)srcLine, wDst, xScale, swapRB);
     }
+}
+#endif
+//-------------------------------------------------------------------------------------------
 
-    // Map the format and type to the correct internal format
-    if (bitsPerChannel == 8)
+// Coarse depth buffer (Hi-Z) management functions
+// NOTE: Each tile stores an upper bound of the depth of its pixels, any fragment farther
+// than it fails the depth test, so primitives (or parts of them) hidden behind the depth
+// already written can be skipped without touching the depth buffer
+//-------------------------------------------------------------------------------------------
+static inline bool sw_hiz_resize(sw_hiz_t *hiz, int w, int h)
+{
+    int tilesX = (w + SW_HIZ_TILE_SIZE - 1)/SW_HIZ_TILE_SIZE;
+    int tilesY = (h + SW_HIZ_TILE_SIZE - 1)/SW_HIZ_TILE_SIZE;
+    int count = tilesX*tilesY;
+
+    if (count > hiz->allocSz)
     {
-        if (channels == 1) return SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
-        if (channels == 2) return SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA;
-        if (channels == 3) return SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8;
-        if (channels == 4) return SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        float *maxDepth = SW_REALLOC(hiz->maxDepth, count*sizeof(float));
+        if (maxDepth == NULL) return false;
+
+        hiz->maxDepth = maxDepth;
+        hiz->allocSz = count;
     }
-    else if (bitsPerChannel == 16)
-    {
-        if (channels == 1) return SW_PIXELFORMAT_UNCOMPRESSED_R16;
+
+    hiz->tilesX = tilesX;
+    hiz->tilesY = tilesY;
+
+    // The content of the depth buffer is unknown, use the farthest depth
+    for (int i = 0; i < count; i++) hiz->maxDepth[i] = 1.0f;
+
+    return true;
+}
+
+// Get the max depth stored in the depth buffer by fragments up to a given depth
+static inline float sw_hiz_depth_bound(float depth)
+{
+    return sw_depth_quantize(depth + SW_HIZ_DEPTH_EPSILON);
+}
+
+// Check if the depth written with the current state can be higher than the tiles max depth
+static inline bool sw_hiz_depth_can_rise(bool depthTest)
+{
+    if (!RLSW.depthMask) return false;
+    if (!depthTest) return true;
+
+    return (RLSW.depthFunc == SW_GREATER) || (RLSW.depthFunc == SW_GEQUAL) ||
+           (RLSW.depthFunc == SW_NOTEQUAL) || (RLSW.depthFunc == SW_ALWAYS);
+}
+
+// Raise the max depth of the tiles overlapping a screen rect, [xMin, xMax) x [yMin, yMax)
+static inline void sw_hiz_raise_rect(int xMin, int yMin, int xMax, int yMax, float depth)
+{
+    sw_hiz_t *hiz = &RLSW.framebuffer.hiz;
+
+    xMin = sw_maxi(xMin, 0);
+    yMin = sw_maxi(yMin, 0);
+    xMax = sw_mini(xMax, RLSW.framebuffer.width);
+    yMax = sw_mini(yMax, RLSW.framebuffer.height);
+    if ((xMin >= xMax) || (yMin >= yMax)) return;
+
+    for (int ty = yMin/SW_HIZ_TILE_SIZE; ty <= (yMax - 1)/SW_HIZ_TILE_SIZE; ty++)
+    {
+        float *row = &hiz->maxDepth[ty*hiz->tilesX];
+        for (int tx = xMin/SW_HIZ_TILE_SIZE; tx <= (xMax - 1)/SW_HIZ_TILE_SIZE; tx++)
+        {
+            if (row[tx] < depth) row[tx] = depth;
+        }
+    }
+}
+
+// Check if a tile is entirely behind a given depth (quantized, see sw_hiz_begin_primitive())
+static inline bool sw_hiz_tile_is_hidden(int index, float zMin)
+{
+    return (zMin > RLSW.framebuffer.hiz.maxDepth[index]);
+}
+
+// Get the number of tiles overlapping a screen rect that are entirely behind a given depth
+static inline int sw_hiz_count_hidden(int xMin, int yMin, int xMax, int yMax, float zMin)
+{
+    const sw_hiz_t *hiz = &RLSW.framebuffer.hiz;
+    int count = 0;
+
+    for (int ty = yMin/SW_HIZ_TILE_SIZE; ty <= (yMax - 1)/SW_HIZ_TILE_SIZE; ty++)
+    {
+        for (int tx = xMin/SW_HIZ_TILE_SIZE; tx <= (xMax - 1)/SW_HIZ_TILE_SIZE; tx++)
+        {
+            count += sw_hiz_tile_is_hidden(ty*hiz->tilesX + tx, zMin);
+        }
+    }
+
+    return count;
+}
+
+// Get the number of pixels from x, on the row y, that are in hidden tiles (up to xEnd)
+static inline int sw_hiz_hidden_run(float zMin, int x, int y, int xEnd)
+{
+    int index = (y/SW_HIZ_TILE_SIZE)*RLSW.framebuffer.hiz.tilesX + x/SW_HIZ_TILE_SIZE;
+    int xRun = x;
+
+    while ((xRun < xEnd) && sw_hiz_tile_is_hidden(index, zMin))
+    {
+        xRun = (xRun/SW_HIZ_TILE_SIZE + 1)*SW_HIZ_TILE_SIZE;
+        index++;
+    }
+
+    return sw_mini(xRun, xEnd) - x;
+}
+
+// Prepare the coarse depth buffer for a triangle or quad writing depth in a screen rect
+// Returns false if the primitive is entirely hidden and can be skipped, otherwise gets the
+// depth its spans have to be tested against the tiles with (-INFINITY if no tile is hidden)
+// NOTE: Once a depth tested primitive is drawn, the pixels of the tiles it fully covers
+// have a depth lower than its max depth, so these tiles are lowered before rasterization;
+// primitives only access the tiles inside their raster bounds, so this is safe to call
+// from the deferred raster threads
+// Tiles can only be skipped with the SW_LESS, SW_LEQUAL and SW_EQUAL depth functions,
+// and lowered when depth writes are enabled and the function is SW_LESS or SW_LEQUAL
+static inline bool sw_hiz_begin_primitive(const sw_vertex_t *vertices[], int count, int xMin, int yMin, int xMax, int yMax, bool depthTest, float *spanDepth)
+{
+    *spanDepth = -INFINITY;
+    if ((xMin >= xMax) || (yMin >= yMax)) return false;
+    if (depthTest && (RLSW.depthFunc == SW_NEVER)) return false;
+
+    float zMin = vertices[0]->homogeneous[2];
+    float zMax = vertices[0]->homogeneous[2];
+    for (int i = 1; i < count; i++)
+    {
+        zMin = fminf(zMin, vertices[i]->homogeneous[2]);
+        zMax = fmaxf(zMax, vertices[i]->homogeneous[2]);
+    }
+
+    if (sw_hiz_depth_can_rise(depthTest))
+    {
+        // Depth can be written without test or by farther fragments, higher than the tiles max depth
+        sw_hiz_raise_rect(xMin, yMin, xMax, yMax, sw_hiz_depth_bound(zMax));
+        return true;
+    }
+
+    if (!depthTest || (RLSW.depthFunc == SW_ALWAYS) || (RLSW.depthFunc == SW_GREATER) ||
+        (RLSW.depthFunc == SW_GEQUAL) || (RLSW.depthFunc == SW_NOTEQUAL)) return true;
+
+    // Fragments are tested at the depth buffer precision, the nearest one of the primitive
+    // (with a margin for the interpolation error) fails the test if stored higher than a tile max depth
+    float zTest = sw_depth_quantize(zMin - SW_HIZ_DEPTH_EPSILON);
+
+    int tileCount = ((xMax - 1)/SW_HIZ_TILE_SIZE - xMin/SW_HIZ_TILE_SIZE + 1)*((yMax - 1)/SW_HIZ_TILE_SIZE - yMin/SW_HIZ_TILE_SIZE + 1);
+    int hiddenCount = sw_hiz_count_hidden(xMin, yMin, xMax, yMax, zTest);
+
+    if (hiddenCount == tileCount) return false;
+    if (hiddenCount > 0) *spanDepth = zTest;
+
+    // Without depth writes or with SW_EQUAL, failing pixels keep a depth that can be higher
+    if (!RLSW.depthMask || (RLSW.depthFunc == SW_EQUAL)) return true;
+
+    // Small primitives can't cover a whole tile, not worth checking
+    if ((xMax - xMin)*(yMax - yMin) < SW_HIZ_MIN_COVER_AREA) return true;
+
+    // Get the edge functions of the (convex) polygon, oriented to be positive inside
+    float edges[4][3] = { 0 };
+    float area = 0.0f;
+    for (int i = 0; i < count; i++)
+    {
+        const float *a = vertices[i]->screen, *b = vertices[(i + 1)%count]->screen;
+        area += a[0]*b[1] - b[0]*a[1];
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const float *a = vertices[i]->screen, *b = vertices[(i + 1)%count]->screen;
+        float sign = (area > 0.0f)? 1.0f : -1.0f;
+        edges[i][0] = -(b[1] - a[1])*sign;
+        edges[i][1] = (b[0] - a[0])*sign;
+        edges[i][2] = -(edges[i][0]*a[0] + edges[i][1]*a[1]);
+    }
+
+    // Lower the tiles entirely inside the polygon, with a margin of one pixel
+    sw_hiz_t *hiz = &RLSW.framebuffer.hiz;
+    float depth = sw_hiz_depth_bound(zMax);
+
+    for (int ty = yMin/SW_HIZ_TILE_SIZE; ty <= (yMax - 1)/SW_HIZ_TILE_SIZE; ty++)
+    {
+        float y0 = (float)(ty*SW_HIZ_TILE_SIZE - 1);
+        float y1 = (float)(sw_mini((ty + 1)*SW_HIZ_TILE_SIZE, RLSW.framebuffer.height) + 1);
+
+        for (int tx = xMin/SW_HIZ_TILE_SIZE; tx <= (xMax - 1)/SW_HIZ_TILE_SIZE; tx++)
+        {
+            float x0 = (float)(tx*SW_HIZ_TILE_SIZE - 1);
+            float x1 = (float)(sw_mini((tx + 1)*SW_HIZ_TILE_SIZE, RLSW.framebuffer.width) + 1);
+
+            bool covered = true;
+            for (int i = 0; (i < count) && covered; i++)
+            {
+                // The corner of the tile with the lowest edge value is enough
+                float x = (edges[i][0] < 0.0f)? x1 : x0;
+                float y = (edges[i][1] < 0.0f)? y1 : y0;
+                covered = (edges[i][0]*x + edges[i][1]*y + edges[i][2] >= 0.0f);
+            }
+
+            float *maxDepth = &hiz->maxDepth[ty*hiz->tilesX + tx];
+            if (covered && (depth < *maxDepth)) *maxDepth = depth;
+        }
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------
+
+// Dirty rectangles management functions
+// NOTE: Color writes are tracked as a few rectangles so only the regions written have to be
+// presented; a full clear with the same color as the previous one only dirties the regions
+// drawn since then, the pixels outside of them already have that color
+//-------------------------------------------------------------------------------------------
+static inline int sw_rect_union_area(const int a[4], const int b[4])
+{
+    return (sw_maxi(a[2], b[2]) - sw_mini(a[0], b[0]))*(sw_maxi(a[3], b[3]) - sw_mini(a[1], b[1]));
+}
+
+// Add a screen rect to a region, [xMin, xMax) x [yMin, yMax)
+static inline void sw_region_add(sw_region_t *region, int xMin, int yMin, int xMax, int yMax)
+{
+    int rect[4] = {
+        sw_maxi(xMin, 0), sw_maxi(yMin, 0),
+        sw_mini(xMax, RLSW.framebuffer.width), sw_mini(yMax, RLSW.framebuffer.height)
+    };
+
+    if ((rect[0] >= rect[2]) || (rect[1] >= rect[3])) return;
+
+    // Merge with the rects the new one touches, or the one growing the least when the list is full
+    while (true)
+    {
+        int merged = -1;
+
+        for (int i = 0; i < region->count; i++)
+        {
+            const int *other = region->rects[i];
+            if ((rect[0] <= other[2]) && (rect[2] >= other[0]) && (rect[1] <= other[3]) && (rect[3] >= other[1])) { merged = i; break; }
+        }
+
+        if ((merged < 0) && (region->count == SW_MAX_DIRTY_RECTS))
+        {
+            int minGrowth = 0;
+            for (int i = 0; i < region->count; i++)
+            {
+                const int *other = region->rects[i];
+                int growth = sw_rect_union_area(rect, other) - (other[2] - other[0])*(other[3] - other[1]);
+                if ((merged < 0) || (growth < minGrowth)) { merged = i; minGrowth = growth; }
+            }
+        }
+
+        if (merged < 0) break;
+
+        const int *other = region->rects[merged];
+        rect[0] = sw_mini(rect[0], other[0]);
+        rect[1] = sw_mini(rect[1], other[1]);
+        rect[2] = sw_maxi(rect[2], other[2]);
+        rect[3] = sw_maxi(rect[3], other[3]);
+
+        region->count--;
+        for (int i = 0; i < 4; i++) region->rects[merged][i] = region->rects[region->count][i];
+    }
+
+    for (int i = 0; i < 4; i++) region->rects[region->count][i] = rect[i];
+    region->count++;
+}
+
+// Mark a screen rect as written, [xMin, xMax) x [yMin, yMax)
+static inline void sw_framebuffer_mark_dirty(int xMin, int yMin, int xMax, int yMax)
+{
+    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    {
+        xMin = sw_maxi(xMin, RLSW.scMin[0]);
+        yMin = sw_maxi(yMin, RLSW.scMin[1]);
+        xMax = sw_mini(xMax, RLSW.scMax[0] + 1);
+        yMax = sw_mini(yMax, RLSW.scMax[1] + 1);
+    }
+
+    sw_region_add(&RLSW.framebuffer.dirty, xMin, yMin, xMax, yMax);
+    sw_region_add(&RLSW.framebuffer.drawn, xMin, yMin, xMax, yMax);
+
+    if (RLSW.framebuffer.msaa.isEnabled) sw_region_add(&RLSW.framebuffer.msaa.unresolved, xMin, yMin, xMax, yMax);
+}
+
+// Mark the screen bounds of the clipped polygon stored in the vertex buffer as written
+static inline void sw_framebuffer_mark_dirty_polygon(void)
+{
+    float xMin = RLSW.vertexBuffer[0].screen[0], xMax = xMin;
+    float yMin = RLSW.vertexBuffer[0].screen[1], yMax = yMin;
+
+    for (int i = 1; i < RLSW.vertexCounter; i++)
+    {
+        xMin = fminf(xMin, RLSW.vertexBuffer[i].screen[0]);
+        xMax = fmaxf(xMax, RLSW.vertexBuffer[i].screen[0]);
+        yMin = fminf(yMin, RLSW.vertexBuffer[i].screen[1]);
+        yMax = fmaxf(yMax, RLSW.vertexBuffer[i].screen[1]);
+    }
+
+    sw_framebuffer_mark_dirty((int)xMin - 1, (int)yMin - 1, (int)xMax + 2, (int)yMax + 2);
+}
+
+// Update the dirty regions for a color clear, with the clear color in the color buffer format
+static inline void sw_framebuffer_mark_cleared(const sw_color_t *color)
+{
+    sw_framebuffer_t *fb = &RLSW.framebuffer;
+
+    // Scissored clears are tracked like any other write
+    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    {
+        sw_framebuffer_mark_dirty(RLSW.scMin[0], RLSW.scMin[1], RLSW.scMax[0] + 1, RLSW.scMax[1] + 1);
+        return;
+    }
+
+    if (fb->hasLastClear && (memcmp(&fb->lastClear, color, sizeof(sw_color_t)) == 0))
+    {
+        for (int i = 0; i < fb->drawn.count; i++)
+        {
+            const int *rect = fb->drawn.rects[i];
+            sw_region_add(&fb->dirty, rect[0], rect[1], rect[2], rect[3]);
+        }
+    }
+    else
+    {
+        fb->dirty.count = 0;
+        sw_region_add(&fb->dirty, 0, 0, fb->width, fb->height);
+        fb->lastClear = *color;
+        fb->hasLastClear = true;
+    }
+
+    fb->drawn.count = 0;
+}
+
+// Mark the whole framebuffer as written, its content is unknown
+static inline void sw_framebuffer_mark_invalid(void)
+{
+    RLSW.framebuffer.dirty.count = 0;
+    RLSW.framebuffer.drawn.count = 0;
+    RLSW.framebuffer.hasLastClear = false;
+
+    sw_region_add(&RLSW.framebuffer.dirty, 0, 0, RLSW.framebuffer.width, RLSW.framebuffer.height);
+    sw_region_add(&RLSW.framebuffer.drawn, 0, 0, RLSW.framebuffer.width, RLSW.framebuffer.height);
+}
+//-------------------------------------------------------------------------------------------
+
+// Multisampling management functions
+// NOTE: With SW_MULTISAMPLE, triangles are rasterized into SW_MSAA_SAMPLES color and depth planes,
+// the pixels are shaded once and only the coverage and depth are evaluated per sample;
+// the regions written are averaged into the framebuffer color plane before it is read
+//-------------------------------------------------------------------------------------------
+// Average the samples of the regions written since the last resolve into the color plane
+static inline void sw_msaa_resolve(sw_framebuffer_t *fb)
+{
+    sw_msaa_t *msaa = &fb->msaa;
+
+    for (int i = 0; i < msaa->unresolved.count; i++)
+    {
+        const int *rect = msaa->unresolved.rects[i];
+        int count = rect[2] - rect[0];
+
+        for (int y = rect[1]; y < rect[3]; y++)
+        {
+            int offset = y*fb->stride + rect[0];
+
+        #if SW_COLOR_IS_PACKED
+            for (int x = 0; x < count; x++)
+            {
+                int r = 2, g = 2, b = 2;
+                for (int s = 0; s < SW_MSAA_SAMPLES; s++)
+                {
+                    SW_COLOR_TYPE pixel = msaa->color[s][offset + x].color[0];
+                    r += SW_UNPACK_R(pixel);
+                    g += SW_UNPACK_G(pixel);
+                    b += SW_UNPACK_B(pixel);
+                }
+                fb->color[offset + x].color[0] = SW_PACK_BITS(r >> 2, g >> 2, b >> 2);
+            }
+        #else
+            // NOTE: Channels are averaged alike, BGRA planes don't need any swizzle
+            RLSW.kernels.resolveColor32((uint32_t *)(fb->color + offset), (const uint32_t *)(msaa->color[0] + offset), count, msaa->allocSz);
+        #endif
+        }
+    }
+
+    msaa->unresolved.count = 0;
+}
+
+// Switch the bound framebuffer to its sample planes, or resolve them back into its color plane
+static inline bool sw_framebuffer_set_multisample(bool enabled)
+{
+    sw_framebuffer_t *fb = &RLSW.framebuffer;
+
+    if (fb->msaa.isEnabled == enabled) return true;
+
+    if (enabled)
+    {
+        if (!sw_msaa_resize(&fb->msaa, fb->stride*fb->height))
+        {
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+            return false;
+        }
+
+        fb->msaa.depth[0] = fb->depth;
+        fb->msaa.isEnabled = true;
+        sw_msaa_load(fb);
+    }
+    else
+    {
+        sw_msaa_resolve(fb);
+        fb->msaa.isEnabled = false;
+    }
+
+    fb->colorTarget = enabled? fb->msaa.color[0] : fb->color;
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------
+
+// Pixel format management functions
+//-------------------------------------------------------------------------------------------
+static inline int sw_get_pixel_format(SWformat format, SWtype type)
+{
+    int channels = 0;
+    int bitsPerChannel = 8; // Default: 8 bits per channel
+
+    // Determine the number of channels (format)
+    switch (format)
+    {
+        case SW_LUMINANCE:        channels = 1; break;
+        case SW_LUMINANCE_ALPHA:  channels = 2; break;
+        case SW_RGB:              channels = 3; break;
+        case SW_RGBA:             channels = 4; break;
+        default: return SW_PIXELFORMAT_UNKNOWN;
+    }
+
+    // Determine the depth of each channel (type)
+    switch (type)
+    {
+        case SW_UNSIGNED_BYTE:    bitsPerChannel = 8;  break;
+        case SW_BYTE:             bitsPerChannel = 8;  break;
+        case SW_UNSIGNED_SHORT:   bitsPerChannel = 16; break;
+        case SW_SHORT:            bitsPerChannel = 16; break;
+        case SW_UNSIGNED_INT:     bitsPerChannel = 32; break;
+        case SW_INT:              bitsPerChannel = 32; break;
+        case SW_FLOAT:            bitsPerChannel = 32; break;
+        default: return SW_PIXELFORMAT_UNKNOWN;
+    }
+
+    // Map the format and type to the correct internal format
+    if (bitsPerChannel == 8)
+    {
+        if (channels == 1) return SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+        if (channels == 2) return SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA;
+        if (channels == 3) return SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8;
+        if (channels == 4) return SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    }
+    else if (bitsPerChannel == 16)
+    {
+        if (channels == 1) return SW_PIXELFORMAT_UNCOMPRESSED_R16;
         if (channels == 3) return SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16;
         if (channels == 4) return SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16;
     }
@@ -1896,72 +3334,729 @@ static inline void sw_get_pixel(uint8_t *color, const void *pixels, uint32_t off
         }
     }
 }
+
+// Get the size in bytes of one pixel of a format
+static inline int sw_get_pixel_bytes(sw_pixelformat_t format)
+{
+    switch (format)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: return 1;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16: return 2;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: return 3;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32: return 4;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16: return 6;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16: return 8;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32: return 12;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32: return 16;
+        default: return 0;
+    }
+}
 //-------------------------------------------------------------------------------------------
 
-// Texture sampling functionality
+// Compressed texture decoding functions
+// NOTE: Blocks are decoded into 16 RGBA32 texels in row-major order, which is
+// also the texel order of a 4x4 block of the tiled texture storage
 //-------------------------------------------------------------------------------------------
-static inline void sw_texture_fetch(float* color, const sw_texture_t* tex, int x, int y)
+static const int sw_etc1ModifierTable[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+static const int sw_etc2DistanceTable[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+static const int sw_eacModifierTable[16][8] = {
+    { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 }, { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 }, { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 }, { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 }, { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+// Get the size in bytes of a 4x4 block of a compressed format (0 if not supported)
+static inline int sw_get_block_bytes(SWcompressed format)
 {
-    sw_float_from_unorm8_simd(color, &tex->pixels[4*(y*tex->width + x)]);
+    switch (format)
+    {
+        case SW_COMPRESSED_RGB_DXT1:
+        case SW_COMPRESSED_RGBA_DXT1:
+        case SW_COMPRESSED_RGB_ETC1:
+        case SW_COMPRESSED_RGB_ETC2: return 8;
+        case SW_COMPRESSED_RGBA_DXT3:
+        case SW_COMPRESSED_RGBA_DXT5:
+        case SW_COMPRESSED_RGBA_ETC2_EAC: return 16;
+        default: return 0;
+    }
 }
 
-static inline void sw_texture_sample_nearest(float *color, const sw_texture_t *tex, float u, float v)
+static inline uint8_t sw_clamp_unorm8(int v)
 {
-    u = (tex->sWrap == SW_REPEAT)? sw_fract(u) : sw_saturate(u);
-    v = (tex->tWrap == SW_REPEAT)? sw_fract(v) : sw_saturate(v);
+    return (uint8_t)((v < 0)? 0 : (v > 255)? 255 : v);
+}
 
-    int x = u*tex->width;
-    int y = v*tex->height;
+static inline void sw_decode_rgb565(uint8_t *color, uint16_t v)
+{
+    int r = (v >> 11) & 0x1F, g = (v >> 5) & 0x3F, b = v & 0x1F;
 
-    sw_texture_fetch(color, tex, x, y);
+    color[0] = (uint8_t)((r << 3) | (r >> 2));
+    color[1] = (uint8_t)((g << 2) | (g >> 4));
+    color[2] = (uint8_t)((b << 3) | (b >> 2));
+    color[3] = 255;
 }
 
-static inline void sw_texture_sample_linear(float *color, const sw_texture_t *tex, float u, float v)
+// Get the palette color of a DXT color block
+// NOTE: With c0 <= c1 (only allowed in DXT1) the block has 3 colors plus black, transparent for DXT1 RGBA
+static inline void sw_decode_dxt_palette(uint8_t *color, const uint8_t *block, int index, bool allow3Colors, bool alpha)
 {
-    // TODO: With a bit more cleverness we could clearly reduce the
-    // number of operations here, but for now it works fine
+    uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+    uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
 
-    float xf = (u*tex->width) - 0.5f;
-    float yf = (v*tex->height) - 0.5f;
+    uint8_t e0[4], e1[4];
+    sw_decode_rgb565(e0, c0);
+    sw_decode_rgb565(e1, c1);
 
-    float fx = sw_fract(xf);
-    float fy = sw_fract(yf);
+    bool fourColors = (c0 > c1) || !allow3Colors;
 
-    int x0 = (int)xf;
-    int y0 = (int)yf;
+    switch (index)
+    {
+        case 0: memcpy(color, e0, 4); break;
+        case 1: memcpy(color, e1, 4); break;
+        case 2:
+        {
+            for (int i = 0; i < 3; i++) color[i] = fourColors? (uint8_t)((2*e0[i] + e1[i])/3) : (uint8_t)((e0[i] + e1[i])/2);
+            color[3] = 255;
+        } break;
+        default:
+        {
+            if (fourColors)
+            {
+                for (int i = 0; i < 3; i++) color[i] = (uint8_t)((e0[i] + 2*e1[i])/3);
+                color[3] = 255;
+            }
+            else
+            {
+                color[0] = color[1] = color[2] = 0;
+                color[3] = alpha? 0 : 255;
+            }
+        } break;
+    }
+}
 
-    int x1 = x0 + 1;
-    int y1 = y0 + 1;
+// Decode a single texel of a DXT1 block, used to sample textures kept compressed
+static inline void sw_decode_dxt1_texel(uint8_t *color, const uint8_t *block, int x, int y, bool alpha)
+{
+    int index = (block[4 + y] >> (2*x)) & 3;
+    sw_decode_dxt_palette(color, block, index, true, alpha);
+}
 
-    // NOTE: If the textures are POT we could avoid the division for SW_REPEAT
+static inline void sw_decode_dxt_color_block(uint8_t *out, const uint8_t *block, bool allow3Colors, bool alpha)
+{
+    uint8_t palette[4][4];
+    for (int i = 0; i < 4; i++) sw_decode_dxt_palette(palette[i], block, i, allow3Colors, alpha);
+
+    uint32_t indices = (uint32_t)block[4] | ((uint32_t)block[5] << 8) | ((uint32_t)block[6] << 16) | ((uint32_t)block[7] << 24);
+
+    for (int i = 0; i < 16; i++, indices >>= 2) memcpy(&out[4*i], palette[indices & 3], 4);
+}
+
+// Decode DXT3 explicit alpha, 4 bits per texel
+static inline void sw_decode_dxt3_alpha(uint8_t *out, const uint8_t *block)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        int a = (block[i/2] >> (4*(i & 1))) & 0x0F;
+        out[4*i + 3] = (uint8_t)(a*17);
+    }
+}
+
+// Decode DXT5 interpolated alpha, 3 bits index per texel
+static inline void sw_decode_dxt5_alpha(uint8_t *out, const uint8_t *block)
+{
+    int a0 = block[0], a1 = block[1];
+    uint8_t palette[8] = { (uint8_t)a0, (uint8_t)a1 };
+
+    if (a0 > a1) for (int i = 1; i < 7; i++) palette[i + 1] = (uint8_t)(((7 - i)*a0 + i*a1)/7);
+    else
+    {
+        for (int i = 1; i < 5; i++) palette[i + 1] = (uint8_t)(((5 - i)*a0 + i*a1)/5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++) indices |= (uint64_t)block[2 + i] << (8*i);
+
+    for (int i = 0; i < 16; i++, indices >>= 3) out[4*i + 3] = palette[indices & 7];
+}
+
+// Decode an ETC2 RGB block, ETC1 blocks are decoded the same way
+// NOTE: ETC texels indices are stored by columns, the differential mode
+// with out of range base colors selects the ETC2 T, H and planar modes
+static inline void sw_decode_etc2_color_block(uint8_t *out, const uint8_t *block)
+{
+    const uint8_t *b = block;
+    uint32_t indices = ((uint32_t)b[4] << 24) | ((uint32_t)b[5] << 16) | ((uint32_t)b[6] << 8) | (uint32_t)b[7];
+    bool diff = (b[3] & 0x02) != 0;
+
+    int base[2][3] = { 0 };
+
+    if (!diff)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            base[0][i] = (b[i] >> 4)*17;
+            base[1][i] = (b[i] & 0x0F)*17;
+        }
+    }
+    else
+    {
+        int c1[3], c2[3];
+
+        for (int i = 0; i < 3; i++)
+        {
+            int d = b[i] & 0x07;
+            c1[i] = b[i] >> 3;
+            c2[i] = c1[i] + ((d >= 4)? d - 8 : d);
+        }
+
+        if ((c2[0] < 0) || (c2[0] > 31))
+        {
+            // T mode
+            int r1 = ((b[0] & 0x18) >> 1) | (b[0] & 0x03), g1 = b[1] >> 4, b1 = b[1] & 0x0F;
+            int r2 = b[2] >> 4, g2 = b[2] & 0x0F, b2 = b[3] >> 4;
+            int d = sw_etc2DistanceTable[((b[3] & 0x0C) >> 1) | (b[3] & 0x01)];
+            int paint[4][3] = {
+                { r1*17, g1*17, b1*17 },
+                { r2*17 + d, g2*17 + d, b2*17 + d },
+                { r2*17, g2*17, b2*17 },
+                { r2*17 - d, g2*17 - d, b2*17 - d }
+            };
+
+            for (int i = 0; i < 16; i++)
+            {
+                int x = i/4, y = i%4;
+                int index = (((indices >> (i + 16)) & 1) << 1) | ((indices >> i) & 1);
+                uint8_t *texel = &out[4*(y*4 + x)];
+                for (int c = 0; c < 3; c++) texel[c] = sw_clamp_unorm8(paint[index][c]);
+                texel[3] = 255;
+            }
+            return;
+        }
+
+        if ((c2[1] < 0) || (c2[1] > 31))
+        {
+            // H mode
+            int r1 = (b[0] & 0x78) >> 3, g1 = ((b[0] & 0x07) << 1) | ((b[1] & 0x10) >> 4);
+            int b1 = (b[1] & 0x08) | ((b[1] & 0x03) << 1) | ((b[2] & 0x80) >> 7);
+            int r2 = (b[2] & 0x78) >> 3, g2 = ((b[2] & 0x07) << 1) | ((b[3] & 0x80) >> 7);
+            int b2 = (b[3] & 0x78) >> 3;
+            int di = (b[3] & 0x04) | ((b[3] & 0x01) << 1);
+            if (((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2)) di |= 1;
+            int d = sw_etc2DistanceTable[di];
+            int paint[4][3] = {
+                { r1*17 + d, g1*17 + d, b1*17 + d },
+                { r1*17 - d, g1*17 - d, b1*17 - d },
+                { r2*17 + d, g2*17 + d, b2*17 + d },
+                { r2*17 - d, g2*17 - d, b2*17 - d }
+            };
+
+            for (int i = 0; i < 16; i++)
+            {
+                int x = i/4, y = i%4;
+                int index = (((indices >> (i + 16)) & 1) << 1) | ((indices >> i) & 1);
+                uint8_t *texel = &out[4*(y*4 + x)];
+                for (int c = 0; c < 3; c++) texel[c] = sw_clamp_unorm8(paint[index][c]);
+                texel[3] = 255;
+            }
+            return;
+        }
+
+        if ((c2[2] < 0) || (c2[2] > 31))
+        {
+            // Planar mode, colors interpolated from origin, horizontal and vertical colors
+            int o[3], h[3], v[3];
+            o[0] = (b[0] >> 1) & 0x3F;
+            o[1] = ((b[0] & 0x01) << 6) | ((b[1] >> 1) & 0x3F);
+            o[2] = ((b[1] & 0x01) << 5) | (b[2] & 0x18) | ((b[2] & 0x03) << 1) | (b[3] >> 7);
+            h[0] = ((b[3] >> 1) & 0x3E) | (b[3] & 0x01);
+            h[1] = (b[4] >> 1) & 0x7F;
+            h[2] = ((b[4] & 0x01) << 5) | (b[5] >> 3);
+            v[0] = ((b[5] & 0x07) << 3) | (b[6] >> 5);
+            v[1] = ((b[6] & 0x1F) << 2) | (b[7] >> 6);
+            v[2] = b[7] & 0x3F;
+
+            // Expand to 8 bits, green uses 7 bits
+            o[0] = (o[0] << 2) | (o[0] >> 4); h[0] = (h[0] << 2) | (h[0] >> 4); v[0] = (v[0] << 2) | (v[0] >> 4);
+            o[1] = (o[1] << 1) | (o[1] >> 6); h[1] = (h[1] << 1) | (h[1] >> 6); v[1] = (v[1] << 1) | (v[1] >> 6);
+            o[2] = (o[2] << 2) | (o[2] >> 4); h[2] = (h[2] << 2) | (h[2] >> 4); v[2] = (v[2] << 2) | (v[2] >> 4);
+
+            for (int y = 0; y < 4; y++)
+            {
+                for (int x = 0; x < 4; x++)
+                {
+                    uint8_t *texel = &out[4*(y*4 + x)];
+                    for (int c = 0; c < 3; c++) texel[c] = sw_clamp_unorm8((x*(h[c] - o[c]) + y*(v[c] - o[c]) + 4*o[c] + 2) >> 2);
+                    texel[3] = 255;
+                }
+            }
+            return;
+        }
+
+        for (int i = 0; i < 3; i++)
+        {
+            base[0][i] = (c1[i] << 3) | (c1[i] >> 2);
+            base[1][i] = (c2[i] << 3) | (c2[i] >> 2);
+        }
+    }
+
+    // Individual or differential mode, two sub-blocks with their own base color and modifiers
+    const int *modifiers[2] = { sw_etc1ModifierTable[b[3] >> 5], sw_etc1ModifierTable[(b[3] >> 2) & 0x07] };
+    bool flip = (b[3] & 0x01) != 0;
+
+    for (int i = 0; i < 16; i++)
+    {
+        int x = i/4, y = i%4;
+        int sub = flip? (y >= 2) : (x >= 2);
+        int msb = (indices >> (i + 16)) & 1, lsb = (indices >> i) & 1;
+        int m = modifiers[sub][lsb];
+        if (msb) m = -m;
+
+        uint8_t *texel = &out[4*(y*4 + x)];
+        for (int c = 0; c < 3; c++) texel[c] = sw_clamp_unorm8(base[sub][c] + m);
+        texel[3] = 255;
+    }
+}
+
+// Decode ETC2 EAC alpha, 3 bits index per texel (stored by columns)
+static inline void sw_decode_eac_alpha(uint8_t *out, const uint8_t *block)
+{
+    int base = block[0];
+    int multiplier = block[1] >> 4;
+    const int *modifiers = sw_eacModifierTable[block[1] & 0x0F];
+
+    uint64_t indices = 0;
+    for (int i = 2; i < 8; i++) indices = (indices << 8) | block[i];
+
+    for (int i = 0; i < 16; i++)
+    {
+        int x = i/4, y = i%4;
+        int index = (int)((indices >> (45 - 3*i)) & 7);
+        out[4*(y*4 + x) + 3] = sw_clamp_unorm8(base + modifiers[index]*multiplier);
+    }
+}
+
+static inline void sw_decode_block(uint8_t *out, const uint8_t *block, SWcompressed format)
+{
+    switch (format)
+    {
+        case SW_COMPRESSED_RGB_DXT1: sw_decode_dxt_color_block(out, block, true, false); break;
+        case SW_COMPRESSED_RGBA_DXT1: sw_decode_dxt_color_block(out, block, true, true); break;
+        case SW_COMPRESSED_RGBA_DXT3:
+        {
+            sw_decode_dxt_color_block(out, block + 8, false, false);
+            sw_decode_dxt3_alpha(out, block);
+        } break;
+        case SW_COMPRESSED_RGBA_DXT5:
+        {
+            sw_decode_dxt_color_block(out, block + 8, false, false);
+            sw_decode_dxt5_alpha(out, block);
+        } break;
+        case SW_COMPRESSED_RGB_ETC1:
+        case SW_COMPRESSED_RGB_ETC2: sw_decode_etc2_color_block(out, block); break;
+        case SW_COMPRESSED_RGBA_ETC2_EAC:
+        {
+            sw_decode_etc2_color_block(out, block + 8);
+            sw_decode_eac_alpha(out, block);
+        } break;
+        default: memset(out, 0, 64); break;
+    }
+}
+
+// Decoding of a compressed image, one job per row of blocks
+typedef struct {
+    SWcompressed format;
+    const uint8_t *data;        // Compressed blocks, row-major
+    int blocksX;                // Number of blocks per row
+    int width, height;          // Image dimensions
+    sw_mipmap_t *level;         // Destination level (NULL to decode into pixels)
+    uint8_t *pixels;            // Destination RGBA32 pixels, packed rows
+} sw_decode_job_t;
+
+static void sw_decode_block_row(void *data, int by)
+{
+    const sw_decode_job_t *job = (const sw_decode_job_t *)data;
+    const int blockBytes = sw_get_block_bytes(job->format);
+    const uint8_t *block = job->data + (size_t)by*job->blocksX*blockBytes;
+
+    for (int bx = 0; bx < job->blocksX; bx++, block += blockBytes)
+    {
+        // Tiled levels store a block as is, even partially outside the level
+        if ((job->level != NULL) && (job->level->blockStride > 0))
+        {
+            sw_decode_block(&job->level->pixels[64*(by*job->level->blockStride + bx)], block, job->format);
+            continue;
+        }
+
+        uint8_t texels[64];
+        sw_decode_block(texels, block, job->format);
+
+        int w = sw_mini(4, job->width - 4*bx);
+        int h = sw_mini(4, job->height - 4*by);
+        uint8_t *dst = (job->level != NULL)? job->level->pixels : job->pixels;
+
+        for (int y = 0; y < h; y++) memcpy(&dst[4*((size_t)(4*by + y)*job->width + 4*bx)], &texels[16*y], 4*w);
+    }
+}
+//-------------------------------------------------------------------------------------------
+
+// Texture sampling functionality
+//-------------------------------------------------------------------------------------------
+// Free the mipmap levels of a texture, from the given level to the last one
+// NOTE: Textures without uploaded data share the pixels of the default texture
+static inline void sw_texture_free_levels(sw_texture_t *texture, int firstLevel)
+{
+    const uint8_t *defaultPixels = RLSW.loadedTextures[0].levels[0].pixels;
+
+    for (int i = firstLevel; i < SW_MAX_MIPMAP_LEVELS; i++)
+    {
+        sw_mipmap_t *level = &texture->levels[i];
+        if ((level->pixels != NULL) && (level->pixels != defaultPixels) && !level->isExternal) SW_FREE(level->pixels);
+        *level = SW_CURLY_INIT(sw_mipmap_t) { 0 };
+    }
+
+    if (texture->levelCount > firstLevel) texture->levelCount = firstLevel;
+}
+
+// Get the offset (in texels) of a texel in the level storage
+// NOTE: Tiled levels store texels in 4x4 blocks so that 2x2 footprints
+// (bilinear filtering) and vertical neighbors usually share a cache line
+static inline int sw_texture_texel_offset(const sw_mipmap_t *level, int x, int y)
+{
+    if (level->blockStride == 0) return y*level->width + x;
+    return (((y >> 2)*level->blockStride + (x >> 2)) << 4) | ((y & 3) << 2) | (x & 3);
+}
+
+// Get a texel of a level, DXT1 levels kept compressed decode it into the provided storage
+static inline const uint8_t *sw_texture_texel(const sw_mipmap_t *level, int x, int y, uint8_t *decoded)
+{
+#if SW_TEXTURE_KEEP_DXT1
+    if (level->compressed != 0)
+    {
+        const uint8_t *block = &level->pixels[8*((y >> 2)*level->blockStride + (x >> 2))];
+        sw_decode_dxt1_texel(decoded, block, x & 3, y & 3, (level->compressed == SW_COMPRESSED_RGBA_DXT1));
+        return decoded;
+    }
+#else
+    (void)decoded;
+#endif
+
+    return &level->pixels[4*sw_texture_texel_offset(level, x, y)];
+}
+
+// Allocate the storage of a level and setup its dimensions
+static inline bool sw_texture_alloc_level(sw_mipmap_t *level, int width, int height)
+{
+    level->width = width;
+    level->height = height;
+    level->wMinus1 = width - 1;
+    level->hMinus1 = height - 1;
+    level->isPOT = (((width & (width - 1)) == 0) && ((height & (height - 1)) == 0));
+    level->blockStride = SW_TEXTURE_TILED? (width + 3)/4 : 0;
+
+    int size = SW_TEXTURE_TILED? 16*level->blockStride*((height + 3)/4) : width*height;
+    level->pixels = SW_MALLOC(4*size);
+
+    return (level->pixels != NULL);
+}
+
+// Replace a level of a texture by new storage, for RGBA32 texels or kept compressed blocks
+// NOTE: A new base level discards the previous mipmap chain
+static inline sw_mipmap_t *sw_texture_define_level(sw_texture_t *texture, int level, int width, int height, SWcompressed compressed)
+{
+    // Mipmap levels must follow the dimensions of the base level
+    if ((level > 0) && ((width != sw_maxi(texture->levels[0].width >> level, 1)) ||
+                        (height != sw_maxi(texture->levels[0].height >> level, 1))))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return NULL;
+    }
+
+    if (level == 0) sw_texture_free_levels(texture, 0);
+    else
+    {
+        sw_mipmap_t *prev = &texture->levels[level];
+        if ((prev->pixels != NULL) && !prev->isExternal) SW_FREE(prev->pixels);
+        *prev = SW_CURLY_INIT(sw_mipmap_t) { 0 };
+    }
+
+    sw_mipmap_t *mipmap = &texture->levels[level];
+    bool allocated = sw_texture_alloc_level(mipmap, width, height);
+
+    if (allocated && (compressed != 0))
+    {
+        // Compressed blocks are stored as uploaded, one 8 bytes DXT1 block per 4x4 texels
+        SW_FREE(mipmap->pixels);
+        mipmap->blockStride = (width + 3)/4;
+        mipmap->compressed = compressed;
+        mipmap->pixels = SW_MALLOC(8*mipmap->blockStride*((height + 3)/4));
+        allocated = (mipmap->pixels != NULL);
+    }
+
+    if (!allocated)
+    {
+        *mipmap = SW_CURLY_INIT(sw_mipmap_t) { 0 };
+        RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+        return NULL;
+    }
+
+    return mipmap;
+}
+
+// Convert a run of source pixels into consecutive RGBA32 texels
+// NOTE: The common 8 bit formats use tight loops the compiler can vectorize,
+// the other formats go through sw_get_pixel()
+static inline void sw_texture_convert_span(uint8_t *dst, const uint8_t *src, int count, sw_pixelformat_t format)
+{
+    switch (format)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: memcpy(dst, src, 4*count); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+        {
+            for (int i = 0; i < count; i++, dst += 4, src += 3)
+            {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = 255;
+            }
+        } break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+        {
+            for (int i = 0; i < count; i++, dst += 4)
+            {
+                dst[0] = dst[1] = dst[2] = src[i];
+                dst[3] = 255;
+            }
+        } break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        {
+            for (int i = 0; i < count; i++, dst += 4, src += 2)
+            {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = src[1];
+            }
+        } break;
+        default:
+        {
+            for (int i = 0; i < count; i++) sw_get_pixel(&dst[4*i], src, i, format);
+        } break;
+    }
+}
+
+// Write a rectangle of tightly packed source pixels into a level
+static inline void sw_texture_write_rect(sw_mipmap_t *level, int xOffset, int yOffset, int w, int h, const void *data, sw_pixelformat_t format)
+{
+    const int pixelBytes = sw_get_pixel_bytes(format);
+    const uint8_t *src = (const uint8_t *)data;
+
+    for (int y = yOffset; y < yOffset + h; y++)
+    {
+        if (level->blockStride == 0)
+        {
+            sw_texture_convert_span(&level->pixels[4*(y*level->width + xOffset)], src, w, format);
+            src += w*pixelBytes;
+            continue;
+        }
+
+        // Texels of a row are consecutive up to the end of their 4x4 block
+        for (int x = xOffset; x < xOffset + w;)
+        {
+            uint8_t *dst = &level->pixels[4*sw_texture_texel_offset(level, x, y)];
+            int run = sw_mini(4 - (x & 3), xOffset + w - x);
+
+            // NOTE: A constant count for whole block rows lets the conversion be unrolled
+            if (run == 4) sw_texture_convert_span(dst, src, 4, format);
+            else sw_texture_convert_span(dst, src, run, format);
+
+            src += run*pixelBytes;
+            x += run;
+        }
+    }
+}
+
+// Read a rectangle of a level into tightly packed pixels
+// NOTE: Only 8 bit formats are supported, luminance is read from the red channel
+static inline bool sw_texture_read_rect(const sw_mipmap_t *level, int xOffset, int yOffset, int w, int h, void *pixels, sw_pixelformat_t format)
+{
+    const int pixelBytes = sw_get_pixel_bytes(format);
+    uint8_t *dst = (uint8_t *)pixels;
+
+    if ((format != SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) && (format != SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8) &&
+        (format != SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) && (format != SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA)) return false;
+
+    for (int y = yOffset; y < yOffset + h; y++)
+    {
+        for (int x = xOffset; x < xOffset + w;)
+        {
+            uint8_t decoded[4];
+            const uint8_t *src = sw_texture_texel(level, x, y, decoded);
+            int run = (level->compressed != 0)? 1 : (level->blockStride == 0)? (xOffset + w - x) : sw_mini(4 - (x & 3), xOffset + w - x);
+
+            if (format == SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) memcpy(dst, src, 4*run);
+            else
+            {
+                for (int i = 0; i < run; i++, src += 4)
+                {
+                    uint8_t *out = &dst[i*pixelBytes];
+                    out[0] = src[0];
+                    if (pixelBytes == 2) out[1] = src[3];
+                    else if (pixelBytes == 3) { out[1] = src[1]; out[2] = src[2]; }
+                }
+            }
+
+            dst += run*pixelBytes;
+            x += run;
+        }
+    }
+
+    return true;
+}
+
+// Downsample a level into the next one with a 2x2 box filter
+static inline void sw_texture_downsample(sw_mipmap_t *dst, const sw_mipmap_t *src)
+{
+    for (int y = 0; y < dst->height; y++)
+    {
+        int y0 = sw_mini(2*y, src->hMinus1);
+        int y1 = sw_mini(2*y + 1, src->hMinus1);
+
+        for (int x = 0; x < dst->width; x++)
+        {
+            int x0 = sw_mini(2*x, src->wMinus1);
+            int x1 = sw_mini(2*x + 1, src->wMinus1);
+
+            uint8_t t00[4], t10[4], t01[4], t11[4];
+            const uint8_t *c00 = sw_texture_texel(src, x0, y0, t00);
+            const uint8_t *c10 = sw_texture_texel(src, x1, y0, t10);
+            const uint8_t *c01 = sw_texture_texel(src, x0, y1, t01);
+            const uint8_t *c11 = sw_texture_texel(src, x1, y1, t11);
+            uint8_t *out = &dst->pixels[4*sw_texture_texel_offset(dst, x, y)];
+
+            for (int i = 0; i < 4; i++) out[i] = (uint8_t)((c00[i] + c10[i] + c01[i] + c11[i] + 2) >> 2);
+        }
+    }
+}
+
+static inline void sw_texture_fetch(float* color, const sw_mipmap_t* level, int x, int y)
+{
+    uint8_t decoded[4];
+    sw_float_from_unorm8_simd(color, sw_texture_texel(level, x, y, decoded));
+}
+
+// Get the texel of a level nearest to the coordinates
+static inline const uint8_t *sw_texture_nearest_texel(const sw_texture_t *tex, const sw_mipmap_t *level, float u, float v, uint8_t *decoded)
+{
+    u = (tex->sWrap == SW_REPEAT)? sw_fract(u) : sw_saturate(u);
+    v = (tex->tWrap == SW_REPEAT)? sw_fract(v) : sw_saturate(v);
+
+    // NOTE: Coordinates equal to 1.0f must map to the last texel
+    int x = sw_mini((int)(u*level->width), level->wMinus1);
+    int y = sw_mini((int)(v*level->height), level->hMinus1);
+
+    return sw_texture_texel(level, x, y, decoded);
+}
+
+static inline void sw_texture_sample_nearest(float *color, const sw_texture_t *tex, const sw_mipmap_t *level, float u, float v)
+{
+    uint8_t decoded[4];
+    sw_float_from_unorm8_simd(color, sw_texture_nearest_texel(tex, level, u, v, decoded));
+}
+
+// Get the base level texel nearest to the coordinates, used by the RGBA8 integer paths
+static inline const uint8_t *sw_texture_sample_nearest8(const sw_texture_t *tex, float u, float v, uint8_t *decoded)
+{
+    return sw_texture_nearest_texel(tex, &tex->levels[0], u, v, decoded);
+}
+
+static inline void sw_texture_sample_linear(float *color, const sw_texture_t *tex, const sw_mipmap_t *level, float u, float v)
+{
+    // TODO: With a bit more cleverness we could clearly reduce the
+    // number of operations here, but for now it works fine
+
+    float xf = (u*level->width) - 0.5f;
+    float yf = (v*level->height) - 0.5f;
+
+    float fx = sw_fract(xf);
+    float fy = sw_fract(yf);
+
+    int x0 = (int)(xf - fx);    // floor(xf)
+    int y0 = (int)(yf - fy);    // floor(yf)
+
+    int x1 = x0 + 1;
+    int y1 = y0 + 1;
 
     if (tex->sWrap == SW_CLAMP)
     {
-        x0 = (x0 > tex->wMinus1)? tex->wMinus1 : x0;
-        x1 = (x1 > tex->wMinus1)? tex->wMinus1 : x1;
+        x0 = sw_clampi(x0, 0, level->wMinus1);
+        x1 = sw_clampi(x1, 0, level->wMinus1);
+    }
+    else if (level->isPOT)
+    {
+        x0 &= level->wMinus1;
+        x1 &= level->wMinus1;
     }
     else
     {
-        x0 = (x0%tex->width + tex->width)%tex->width;
-        x1 = (x1%tex->width + tex->width)%tex->width;
+        x0 = (x0%level->width + level->width)%level->width;
+        x1 = (x1%level->width + level->width)%level->width;
     }
 
     if (tex->tWrap == SW_CLAMP)
     {
-        y0 = (y0 > tex->hMinus1)? tex->hMinus1 : y0;
-        y1 = (y1 > tex->hMinus1)? tex->hMinus1 : y1;
+        y0 = sw_clampi(y0, 0, level->hMinus1);
+        y1 = sw_clampi(y1, 0, level->hMinus1);
+    }
+    else if (level->isPOT)
+    {
+        y0 &= level->hMinus1;
+        y1 &= level->hMinus1;
+    }
+    else
+    {
+        y0 = (y0%level->height + level->height)%level->height;
+        y1 = (y1%level->height + level->height)%level->height;
+    }
+
+    const uint8_t *p00, *p10, *p01, *p11;
+    uint8_t t00[4], t10[4], t01[4], t11[4];
+
+    if ((level->blockStride > 0) && (level->compressed == 0) && (x1 == x0 + 1) && (y1 == y0 + 1) && ((x0 & 3) != 3) && ((y0 & 3) != 3))
+    {
+        // The 2x2 footprint lies in a single 4x4 block
+        p00 = &level->pixels[4*sw_texture_texel_offset(level, x0, y0)];
+        p10 = p00 + 4;
+        p01 = p00 + 16;
+        p11 = p00 + 20;
     }
     else
     {
-        y0 = (y0%tex->height + tex->height)%tex->height;
-        y1 = (y1%tex->height + tex->height)%tex->height;
+        p00 = sw_texture_texel(level, x0, y0, t00);
+        p10 = sw_texture_texel(level, x1, y0, t10);
+        p01 = sw_texture_texel(level, x0, y1, t01);
+        p11 = sw_texture_texel(level, x1, y1, t11);
     }
 
     float c00[4], c10[4], c01[4], c11[4];
-    sw_texture_fetch(c00, tex, x0, y0);
-    sw_texture_fetch(c10, tex, x1, y0);
-    sw_texture_fetch(c01, tex, x0, y1);
-    sw_texture_fetch(c11, tex, x1, y1);
+    sw_float_from_unorm8_simd(c00, p00);
+    sw_float_from_unorm8_simd(c10, p10);
+    sw_float_from_unorm8_simd(c01, p01);
+    sw_float_from_unorm8_simd(c11, p11);
 
     for (int i = 0; i < 4; i++)
     {
@@ -1971,6 +4066,12 @@ static inline void sw_texture_sample_linear(float *color, const sw_texture_t *te
     }
 }
 
+static inline void sw_texture_sample_level(float *color, const sw_texture_t *tex, int level, bool linear, float u, float v)
+{
+    if (linear) sw_texture_sample_linear(color, tex, &tex->levels[level], u, v);
+    else sw_texture_sample_nearest(color, tex, &tex->levels[level], u, v);
+}
+
 static inline void sw_texture_sample(float *color, const sw_texture_t *tex, float u, float v, float dUdx, float dUdy, float dVdx, float dVdy)
 {
     // Previous method: There is no need to compute the square root
@@ -1979,17 +4080,51 @@ static inline void sw_texture_sample(float *color, const sw_texture_t *tex, floa
     //float dv = sqrtf(dVdx*dVdx + dVdy*dVdy);
     //float L = (du > dv)? du : dv;
 
-    // Calculate the derivatives for each axis
-    float dU2 = dUdx*dUdx + dUdy*dUdy;
-    float dV2 = dVdx*dVdx + dVdy*dVdy;
+    // Calculate the derivatives for each axis, in texels of the base level
+    float w = (float)tex->levels[0].width;
+    float h = (float)tex->levels[0].height;
+    float dU2 = (dUdx*dUdx + dUdy*dUdy)*w*w;
+    float dV2 = (dVdx*dVdx + dVdy*dVdy)*h*h;
     float L2 = (dU2 > dV2)? dU2 : dV2;
 
     SWfilter filter = (L2 > 1.0f)? tex->minFilter : tex->magFilter;
 
     switch (filter)
     {
-        case SW_NEAREST: sw_texture_sample_nearest(color, tex, u, v); break;
-        case SW_LINEAR: sw_texture_sample_linear(color, tex, u, v); break;
+        case SW_NEAREST: sw_texture_sample_nearest(color, tex, &tex->levels[0], u, v); break;
+        case SW_LINEAR: sw_texture_sample_linear(color, tex, &tex->levels[0], u, v); break;
+        case SW_NEAREST_MIPMAP_NEAREST:
+        case SW_LINEAR_MIPMAP_NEAREST:
+        case SW_NEAREST_MIPMAP_LINEAR:
+        case SW_LINEAR_MIPMAP_LINEAR:
+        {
+            // Level of detail: log2(sqrt(L2)), clamped to the available levels
+            float lod = 0.5f*sw_fast_log2(L2);
+            float maxLod = (float)(tex->levelCount - 1);
+            if (lod > maxLod) lod = maxLod;
+
+            bool linear = ((filter == SW_LINEAR_MIPMAP_NEAREST) || (filter == SW_LINEAR_MIPMAP_LINEAR));
+
+            if ((filter == SW_NEAREST_MIPMAP_NEAREST) || (filter == SW_LINEAR_MIPMAP_NEAREST))
+            {
+                sw_texture_sample_level(color, tex, (int)(lod + 0.5f), linear, u, v);
+            }
+            else
+            {
+                // Trilinear filtering, blend between the two closest levels
+                int level = (int)lod;
+                float t = lod - (float)level;
+
+                sw_texture_sample_level(color, tex, level, linear, u, v);
+
+                if (t > 0.0f)
+                {
+                    float next[4];
+                    sw_texture_sample_level(next, tex, level + 1, linear, u, v);
+                    for (int i = 0; i < 4; i++) color[i] += t*(next[i] - color[i]);
+                }
+            }
+        } break;
         default: break;
     }
 }
@@ -2069,6 +4204,239 @@ static inline void sw_blend_colors(float *SW_RESTRICT dst/*[4]*/, const float *S
     dst[2] = srcFactor[2]*src[2] + dstFactor[2]*dst[2];
     dst[3] = srcFactor[3]*src[3] + dstFactor[3]*dst[3];
 }
+
+static inline sw_blend_mode_t sw_get_blend_mode(SWfactor sfactor, SWfactor dfactor)
+{
+    sw_blend_mode_t mode = SW_BLEND_GENERIC;
+
+#if !SW_COLOR_IS_PACKED
+    if ((sfactor == SW_SRC_ALPHA) && (dfactor == SW_ONE_MINUS_SRC_ALPHA)) mode = SW_BLEND_ALPHA;
+    else if ((sfactor == SW_SRC_ALPHA) && (dfactor == SW_ONE)) mode = SW_BLEND_ADDITIVE;
+    else if ((sfactor == SW_DST_COLOR) && (dfactor == SW_ONE_MINUS_SRC_ALPHA)) mode = SW_BLEND_MULTIPLIED;
+    else if ((sfactor == SW_ONE) && (dfactor == SW_ONE)) mode = SW_BLEND_ADD_COLORS;
+    else if ((sfactor == SW_ONE) && (dfactor == SW_ONE_MINUS_SRC_ALPHA)) mode = SW_BLEND_ALPHA_PREMULTIPLY;
+#endif
+
+    return mode;
+}
+
+// Multiply two normalized 8-bit values, (a*b)/255 correctly rounded
+static inline uint32_t sw_mul_unorm8(uint32_t a, uint32_t b)
+{
+    uint32_t t = a*b + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+static inline void sw_modulate_colors8(uint8_t *SW_RESTRICT dst/*[4]*/, const uint8_t *SW_RESTRICT src/*[4]*/)
+{
+    dst[0] = (uint8_t)sw_mul_unorm8(dst[0], src[0]);
+    dst[1] = (uint8_t)sw_mul_unorm8(dst[1], src[1]);
+    dst[2] = (uint8_t)sw_mul_unorm8(dst[2], src[2]);
+    dst[3] = (uint8_t)sw_mul_unorm8(dst[3], src[3]);
+}
+
+// Blend RGBA8 colors with the current blend mode, using 16 bits intermediate values
+// NOTE: Must only be called when RLSW.blendMode is not SW_BLEND_GENERIC
+// NOTE: A single blend is within 1 unit per channel of the float path (2 for multiplied),
+// but differences add up over stacked blends, additive blending keeps them unattenuated
+static inline void sw_blend_colors8(uint8_t *SW_RESTRICT dst/*[4]*/, const uint8_t *SW_RESTRICT src/*[4]*/)
+{
+#if defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i max = _mm_set1_epi16(255);
+
+    uint32_t srcPacked, dstPacked;
+    memcpy(&srcPacked, src, 4);
+    memcpy(&dstPacked, dst, 4);
+
+    __m128i s = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)srcPacked), zero);
+    __m128i d = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)dstPacked), zero);
+    __m128i a = _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i invA = _mm_sub_epi16(max, a);
+    __m128i sum;
+
+    // NOTE: (t + (t >> 8)) >> 8 with t = x*y + 128 divides by 255, correctly rounded
+    #define SW_DIV255_EPU16(t) _mm_srli_epi16(_mm_add_epi16((t), _mm_srli_epi16((t), 8)), 8)
+
+    switch (RLSW.blendMode)
+    {
+        case SW_BLEND_ALPHA:
+        {
+            // NOTE: s*a + d*(255 - a) never exceeds 255*255, so it fits in 16 bits unsigned
+            __m128i t = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, invA)), bias);
+            sum = SW_DIV255_EPU16(t);
+        } break;
+        case SW_BLEND_ADDITIVE:
+        {
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(s, a), bias);
+            sum = _mm_add_epi16(d, SW_DIV255_EPU16(t));
+        } break;
+        case SW_BLEND_MULTIPLIED:
+        {
+            __m128i t0 = _mm_add_epi16(_mm_mullo_epi16(s, d), bias);
+            __m128i t1 = _mm_add_epi16(_mm_mullo_epi16(d, invA), bias);
+            sum = _mm_add_epi16(SW_DIV255_EPU16(t0), SW_DIV255_EPU16(t1));
+        } break;
+        case SW_BLEND_ADD_COLORS: sum = _mm_add_epi16(s, d); break;
+        case SW_BLEND_ALPHA_PREMULTIPLY:
+        {
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(d, invA), bias);
+            sum = _mm_add_epi16(s, SW_DIV255_EPU16(t));
+        } break;
+        default: return;
+    }
+
+    #undef SW_DIV255_EPU16
+
+    dstPacked = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(sum, sum));   // u16 -> u8 (saturated > 255 to 255)
+    memcpy(dst, &dstPacked, 4);
+#elif defined(SW_HAS_NEON) || defined(SW_HAS_NEON_FMA)
+    const uint16x4_t bias = vdup_n_u16(128);
+
+    uint32_t srcPacked, dstPacked;
+    memcpy(&srcPacked, src, 4);
+    memcpy(&dstPacked, dst, 4);
+
+    uint16x4_t s = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(srcPacked))));
+    uint16x4_t d = vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(dstPacked))));
+    uint16x4_t a = vdup_n_u16(src[3]);
+    uint16x4_t invA = vdup_n_u16(255 - src[3]);
+    uint16x4_t sum;
+
+    // NOTE: (t + (t >> 8)) >> 8 with t = x*y + 128 divides by 255, correctly rounded
+    #define SW_DIV255_U16(t) vshr_n_u16(vsra_n_u16((t), (t), 8), 8)
+
+    switch (RLSW.blendMode)
+    {
+        case SW_BLEND_ALPHA:
+        {
+            // NOTE: s*a + d*(255 - a) never exceeds 255*255, so it fits in 16 bits unsigned
+            uint16x4_t t = vadd_u16(vmla_u16(vmul_u16(s, a), d, invA), bias);
+            sum = SW_DIV255_U16(t);
+        } break;
+        case SW_BLEND_ADDITIVE:
+        {
+            uint16x4_t t = vadd_u16(vmul_u16(s, a), bias);
+            sum = vadd_u16(d, SW_DIV255_U16(t));
+        } break;
+        case SW_BLEND_MULTIPLIED:
+        {
+            uint16x4_t t0 = vadd_u16(vmul_u16(s, d), bias);
+            uint16x4_t t1 = vadd_u16(vmul_u16(d, invA), bias);
+            sum = vadd_u16(SW_DIV255_U16(t0), SW_DIV255_U16(t1));
+        } break;
+        case SW_BLEND_ADD_COLORS: sum = vadd_u16(s, d); break;
+        case SW_BLEND_ALPHA_PREMULTIPLY:
+        {
+            uint16x4_t t = vadd_u16(vmul_u16(d, invA), bias);
+            sum = vadd_u16(s, SW_DIV255_U16(t));
+        } break;
+        default: return;
+    }
+
+    #undef SW_DIV255_U16
+
+    uint8x8_t result = vqmovn_u16(vcombine_u16(sum, sum));              // u16 -> u8 (saturated > 255 to 255)
+    vst1_lane_u32(&dstPacked, vreinterpret_u32_u8(result), 0);
+    memcpy(dst, &dstPacked, 4);
+#else
+    uint32_t a = src[3];
+    uint32_t invA = 255 - a;
+    uint32_t sum[4];
+
+    switch (RLSW.blendMode)
+    {
+        case SW_BLEND_ALPHA:
+        {
+            // NOTE: Single rounding, the result never exceeds 255
+            for (int i = 0; i < 4; i++)
+            {
+                uint32_t t = src[i]*a + dst[i]*invA + 128;
+                dst[i] = (uint8_t)((t + (t >> 8)) >> 8);
+            }
+        } return;
+        case SW_BLEND_ADDITIVE: for (int i = 0; i < 4; i++) sum[i] = dst[i] + sw_mul_unorm8(src[i], a); break;
+        case SW_BLEND_MULTIPLIED: for (int i = 0; i < 4; i++) sum[i] = sw_mul_unorm8(src[i], dst[i]) + sw_mul_unorm8(dst[i], invA); break;
+        case SW_BLEND_ADD_COLORS: for (int i = 0; i < 4; i++) sum[i] = src[i] + dst[i]; break;
+        case SW_BLEND_ALPHA_PREMULTIPLY: for (int i = 0; i < 4; i++) sum[i] = src[i] + sw_mul_unorm8(dst[i], invA); break;
+        default: return;
+    }
+
+    for (int i = 0; i < 4; i++) dst[i] = (sum[i] > 255)? 255 : (uint8_t)sum[i];
+#endif
+}
+
+// Write a color into a framebuffer pixel, only the channels enabled by swColorMask()
+// NOTE: Partially masked primitives are rasterized with the blending variants, so blending
+// is only applied here if it's enabled in the current state
+static inline void sw_framebuffer_write_color_masked(sw_color_t *dst, const float src[4])
+{
+    float dstColor[4];
+    sw_framebuffer_read_color(dstColor, dst);
+
+    float result[4] = { src[0], src[1], src[2], src[3] };
+    if (SW_STATE_CHECK(SW_STATE_BLEND))
+    {
+        for (int i = 0; i < 4; i++) result[i] = dstColor[i];
+        sw_blend_colors(result, src);
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (RLSW.colorMask & (1 << i)) dstColor[i] = result[i];
+    }
+
+    sw_framebuffer_write_color(dst, dstColor);
+}
+
+// Blend a color into a framebuffer pixel, using the integer path when available
+// NOTE: The integer blend modes treat R, G and B alike, so BGRA pixels only need the source swizzled
+static inline void sw_framebuffer_blend_color(sw_color_t *dst, const float src[4])
+{
+    if (RLSW.colorMask != SW_COLOR_MASK_ALL)
+    {
+        sw_framebuffer_write_color_masked(dst, src);
+        return;
+    }
+
+#if !SW_COLOR_IS_PACKED
+    if (RLSW.blendMode != SW_BLEND_GENERIC)
+    {
+        uint8_t src8[4];
+        sw_float_to_unorm8_simd(src8, src);
+        if (RLSW.framebuffer.isBGRA) sw_color8_swap_rb(src8);
+        sw_blend_colors8(dst->color, src8);
+        return;
+    }
+#endif
+
+    float dstColor[4];
+    sw_framebuffer_read_color(dstColor, dst);
+    sw_blend_colors(dstColor, src);
+    sw_framebuffer_write_color(dst, dstColor);
+}
+
+static inline void sw_framebuffer_blend_color8(sw_color_t *dst, const uint8_t src[4])
+{
+#if !SW_COLOR_IS_PACKED
+    if ((RLSW.blendMode != SW_BLEND_GENERIC) && (RLSW.colorMask == SW_COLOR_MASK_ALL))
+    {
+        if (RLSW.framebuffer.isBGRA)
+        {
+            uint8_t srcBGRA[4] = { src[2], src[1], src[0], src[3] };
+            sw_blend_colors8(dst->color, srcBGRA);
+        }
+        else sw_blend_colors8(dst->color, src);
+        return;
+    }
+#endif
+
+    float srcColor[4];
+    sw_float_from_unorm8_simd(srcColor, src);
+    sw_framebuffer_blend_color(dst, srcColor);
+}
+
 //-------------------------------------------------------------------------------------------
 
 // Projection helper functions
@@ -2199,2603 +4567,5046 @@ static inline bool sw_polygon_clip(sw_vertex_t polygon[SW_MAX_CLIPPED_POLYGON_VE
     return (n >= 3);
 }
 
-// Triangle rendering logic
+// Deferred rasterization logic
 //-------------------------------------------------------------------------------------------
-static inline bool sw_triangle_face_culling(void)
+#if defined(RLSW_USE_STATS)
+static inline double sw_stats_get_time(void)
+{
+    double time = 0.0;
+#if defined(_WIN32)
+    struct timespec ts = { 0 };
+    timespec_get(&ts, TIME_UTC);
+    time = (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+#elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase = { 0 };
+    if (timebase.denom == 0) mach_timebase_info(&timebase);
+    time = (double)mach_absolute_time()*timebase.numer/timebase.denom*1e-9;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    time = (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+#else
+    time = (double)clock()/CLOCKS_PER_SEC;
+#endif
+    return time;
+}
+#endif
+
+#if defined(SW_HAS_DEFERRED)
+#if defined(RLSW_USE_THREADS)
+static inline int sw_deferred_get_thread_count(void)
 {
-    // NOTE: Face culling is done before clipping to avoid unnecessary computations
-    //       To handle triangles crossing the w=0 plane correctly,
-    //       we perform the winding order test in homogeneous coordinates directly,
-    //       before the perspective division (division by w)
-    //       This test determines the orientation of the triangle in the (x,y,w) plane,
-    //       which corresponds to the projected 2D winding order sign,
-    //       even with negative w values
+    int count = SW_RASTER_THREADS;
 
-    // Preload homogeneous coordinates into local variables
-    const float *h0 = RLSW.vertexBuffer[0].homogeneous;
-    const float *h1 = RLSW.vertexBuffer[1].homogeneous;
-    const float *h2 = RLSW.vertexBuffer[2].homogeneous;
+    if (count <= 0)
+    {
+    #if defined(_WIN32)
+        count = pthread_num_processors_np();
+    #elif defined(_SC_NPROCESSORS_ONLN)
+        count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    #else
+        count = 1;
+    #endif
+    }
 
-    // Compute a value proportional to the signed area in the projected 2D plane,
-    // calculated directly using homogeneous coordinates BEFORE division by w
-    // This is the determinant of the matrix formed by the (x, y, w) components
-    // of the vertices, which correctly captures the winding order in homogeneous
-    // space and its relationship to the projected 2D winding order, even with
-    // negative w values
-    // The determinant formula used here is:
-    // h0.x*(h1.y*h2.w - h2.y*h1.w) +
-    // h1.x*(h2.y*h0.w - h0.y*h2.w) +
-    // h2.x*(h0.y*h1.w - h1.y*h0.w)
+    return sw_clampi(count, 1, SW_MAX_RASTER_THREADS);
+}
 
-    const float hSgnArea =
-        h0[0]*(h1[1]*h2[3] - h2[1]*h1[3]) +
-        h1[0]*(h2[1]*h0[3] - h0[1]*h2[3]) +
-        h2[0]*(h0[1]*h1[3] - h1[1]*h0[3]);
+static inline bool sw_deferred_resize_bins(int w, int h)
+{
+    int tilesX = (w + SW_RASTER_TILE_SIZE - 1)/SW_RASTER_TILE_SIZE;
+    int tilesY = (h + SW_RASTER_TILE_SIZE - 1)/SW_RASTER_TILE_SIZE;
+    int count = tilesX*tilesY;
 
-    // Discard the triangle if its winding order (determined by the sign
-    // of the homogeneous area/determinant) matches the culled direction
-    // A positive hSgnArea typically corresponds to a counter-clockwise
-    // winding in the projected space when all w > 0
-    // This test is robust for points with w > 0 or w < 0, correctly
-    // capturing the change in orientation when crossing the w=0 plane
+    if (count > RLSW.deferred.binCount)
+    {
+        sw_tile_bin_t *bins = SW_REALLOC(RLSW.deferred.bins, count*sizeof(sw_tile_bin_t));
+        if (bins == NULL) return false;
 
-    // The culling logic remains the same based on the signed area/determinant
-    // A value of 0 for hSgnArea means the points are collinear in (x, y, w)
-    // space, which corresponds to a degenerate triangle projection
-    // Such triangles are typically not culled by this test (0 < 0 is false, 0 > 0 is false)
-    // and should be handled by the clipper if necessary
-    return (RLSW.cullFace == SW_FRONT)? (hSgnArea < 0) : (hSgnArea > 0); // Cull if winding is "clockwise" : "counter-clockwise"
+        for (int i = RLSW.deferred.binCount; i < count; i++) bins[i] = SW_CURLY_INIT(sw_tile_bin_t) { 0 };
+
+        RLSW.deferred.bins = bins;
+        RLSW.deferred.binCount = count;
+    }
+
+    RLSW.deferred.tilesX = tilesX;
+    RLSW.deferred.tilesY = tilesY;
+
+    return true;
 }
 
-static inline void sw_triangle_clip_and_project(void)
+static inline void sw_deferred_bin_cmd(uint32_t index)
 {
-    sw_vertex_t *polygon = RLSW.vertexBuffer;
-    int *vertexCounter = &RLSW.vertexCounter;
+    const sw_raster_cmd_t *cmd = &RLSW.deferred.cmds[index];
 
-    if (sw_polygon_clip(polygon, vertexCounter))
+    int tx0 = sw_clampi(cmd->bounds[0]/SW_RASTER_TILE_SIZE, 0, RLSW.deferred.tilesX - 1);
+    int ty0 = sw_clampi(cmd->bounds[1]/SW_RASTER_TILE_SIZE, 0, RLSW.deferred.tilesY - 1);
+    int tx1 = sw_clampi(cmd->bounds[2]/SW_RASTER_TILE_SIZE, 0, RLSW.deferred.tilesX - 1);
+    int ty1 = sw_clampi(cmd->bounds[3]/SW_RASTER_TILE_SIZE, 0, RLSW.deferred.tilesY - 1);
+
+    for (int ty = ty0; ty <= ty1; ty++)
     {
-        // Transformation to screen space and normalization
-        for (int i = 0; i < *vertexCounter; i++)
+        sw_tile_bin_t *bin = &RLSW.deferred.bins[ty*RLSW.deferred.tilesX + tx0];
+
+        for (int tx = tx0; tx <= tx1; tx++, bin++)
         {
-            sw_vertex_t *v = &polygon[i];
+            if (bin->count == bin->capacity)
+            {
+                int capacity = (bin->capacity > 0)? 2*bin->capacity : 64;
+                uint32_t *cmds = SW_REALLOC(bin->cmds, capacity*sizeof(uint32_t));
 
-            // Calculation of the reciprocal of W for normalization
-            // as well as perspective-correct attributes
-            const float wRcp = 1.0f/v->homogeneous[3];
-            v->homogeneous[3] = wRcp;
+                if (cmds == NULL)
+                {
+                    RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+                    continue;
+                }
 
-            // Division of XYZ coordinates by weight
-            v->homogeneous[0] *= wRcp;
-            v->homogeneous[1] *= wRcp;
-            v->homogeneous[2] *= wRcp;
+                bin->cmds = cmds;
+                bin->capacity = capacity;
+            }
 
-            // Division of texture coordinates (perspective-correct)
-            v->texcoord[0] *= wRcp;
-            v->texcoord[1] *= wRcp;
+            bin->cmds[bin->count++] = index;
+        }
+    }
+}
 
-            // Division of colors (perspective-correct)
-            v->color[0] *= wRcp;
-            v->color[1] *= wRcp;
-            v->color[2] *= wRcp;
-            v->color[3] *= wRcp;
+static void sw_deferred_process_jobs(void)
+{
+    while (true)
+    {
+        pthread_mutex_lock(&RLSW.deferred.mutex);
+        int index = RLSW.deferred.nextJob++;
+        pthread_mutex_unlock(&RLSW.deferred.mutex);
 
-            // Transformation to screen space
-            sw_project_ndc_to_screen(v->screen, v->homogeneous);
+        if (index >= RLSW.deferred.jobCount) break;
+
+        RLSW.deferred.job(RLSW.deferred.jobData, index);
+    }
+}
+
+static void *sw_deferred_worker(void *arg)
+{
+    uint32_t generation = 0;
+
+#if defined(RLSW_USE_STATS)
+    swStatsSlot = (int)(intptr_t)arg;
+#else
+    (void)arg;
+#endif
+
+    pthread_mutex_lock(&RLSW.deferred.mutex);
+
+    while (true)
+    {
+        while (!RLSW.deferred.quit && (generation == RLSW.deferred.generation))
+        {
+            pthread_cond_wait(&RLSW.deferred.wakeCond, &RLSW.deferred.mutex);
         }
+
+        if (RLSW.deferred.quit) break;
+
+        generation = RLSW.deferred.generation;
+        pthread_mutex_unlock(&RLSW.deferred.mutex);
+
+        sw_deferred_process_jobs();
+
+        pthread_mutex_lock(&RLSW.deferred.mutex);
+        if (--RLSW.deferred.pendingWorkers == 0) pthread_cond_signal(&RLSW.deferred.doneCond);
     }
+
+    pthread_mutex_unlock(&RLSW.deferred.mutex);
+
+    return NULL;
 }
 
-#define DEFINE_TRIANGLE_RASTER_SCANLINE(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND) \
-static inline void FUNC_NAME(const sw_texture_t *tex, const sw_vertex_t *start,     \
-                             const sw_vertex_t *end, float dUdy, float dVdy)        \
-{                                                                                   \
-    /* Gets the start and end coordinates */                                        \
-    int xStart = (int)start->screen[0];                                             \
-    int xEnd   = (int)end->screen[0];                                               \
-                                                                                    \
-    /* Avoid empty lines */                                                         \
-    if (xStart == xEnd) return;                                                     \
-                                                                                    \
-    /* Compute the subpixel distance to traverse before the first pixel */          \
-    float xSubstep = 1.0f - sw_fract(start->screen[0]);                             \
-                                                                                    \
-    /* Compute the inverse horizontal distance along the X axis */                  \
-    float dxRcp = 1.0f/(end->screen[0] - start->screen[0]);                         \
-                                                                                    \
-    /* Compute the interpolation steps along the X axis */                          \
-    float dZdx = (end->homogeneous[2] - start->homogeneous[2])*dxRcp;               \
-    float dWdx = (end->homogeneous[3] - start->homogeneous[3])*dxRcp;               \
-                                                                                    \
-    float dCdx[4] = {                                                               \
-        (end->color[0] - start->color[0])*dxRcp,                                    \
-        (end->color[1] - start->color[1])*dxRcp,                                    \
-        (end->color[2] - start->color[2])*dxRcp,                                    \
-        (end->color[3] - start->color[3])*dxRcp                                     \
-    };                                                                              \
-                                                                                    \
-    float dUdx = 0.0f;                                                              \
-    float dVdx = 0.0f;                                                              \
-    if (ENABLE_TEXTURE) {                                                           \
-        dUdx = (end->texcoord[0] - start->texcoord[0])*dxRcp;                       \
-        dVdx = (end->texcoord[1] - start->texcoord[1])*dxRcp;                       \
-    }                                                                               \
-                                                                                    \
-    /* Initializing the interpolation starting values  */                           \
-    float z = start->homogeneous[2] + dZdx*xSubstep;                                \
-    float w = start->homogeneous[3] + dWdx*xSubstep;                                \
-                                                                                    \
-    float color[4] = {                                                              \
-        start->color[0] + dCdx[0]*xSubstep,                                         \
-        start->color[1] + dCdx[1]*xSubstep,                                         \
-        start->color[2] + dCdx[2]*xSubstep,                                         \
-        start->color[3] + dCdx[3]*xSubstep                                          \
-    };                                                                              \
-                                                                                    \
-    float u = 0.0f;                                                                 \
-    float v = 0.0f;                                                                 \
-    if (ENABLE_TEXTURE) {                                                           \
-        u = start->texcoord[0] + dUdx*xSubstep;                                     \
-        v = start->texcoord[1] + dVdx*xSubstep;                                     \
-    }                                                                               \
-                                                                                    \
-    /* Pre-calculate the starting pointers for the framebuffer row */               \
-    int y = (int)start->screen[1];                                                  \
-    sw_pixel_t *ptr = RLSW.framebuffer.pixels + y*RLSW.framebuffer.width + xStart;  \
-                                                                                    \
-    /* Scanline rasterization */                                                    \
-    for (int x = xStart; x < xEnd; x++)                                             \
-    {                                                                               \
-        float wRcp = 1.0f/w;                                                        \
-        float srcColor[4] = {                                                       \
-            color[0]*wRcp,                                                          \
-            color[1]*wRcp,                                                          \
-            color[2]*wRcp,                                                          \
-            color[3]*wRcp                                                           \
-        };                                                                          \
-                                                                                    \
-        if (ENABLE_DEPTH_TEST)                                                      \
-        {                                                                           \
-            /* TODO: Implement different depth funcs? */                            \
-            float depth =  sw_framebuffer_read_depth(ptr);                          \
-            if (z > depth) goto discard;                                            \
-        }                                                                           \
-                                                                                    \
-        /* TODO: Implement depth mask */                                            \
-        sw_framebuffer_write_depth(ptr, z);                                         \
-                                                                                    \
-        if (ENABLE_TEXTURE)                                                         \
-        {                                                                           \
-            float texColor[4];                                                      \
-            float s = u*wRcp;                                                       \
-            float t = v*wRcp;                                                       \
-            sw_texture_sample(texColor, tex, s, t, dUdx, dUdy, dVdx, dVdy);         \
-            srcColor[0] *= texColor[0];                                             \
-            srcColor[1] *= texColor[1];                                             \
-            srcColor[2] *= texColor[2];                                             \
-            srcColor[3] *= texColor[3];                                             \
-        }                                                                           \
-                                                                                    \
-        if (ENABLE_COLOR_BLEND)                                                     \
-        {                                                                           \
-            float dstColor[4];                                                      \
-            sw_framebuffer_read_color(dstColor, ptr);                               \
-            sw_blend_colors(dstColor, srcColor);                                    \
-            sw_framebuffer_write_color(ptr, dstColor);                              \
-        }                                                                           \
-        else                                                                        \
-        {                                                                           \
-            sw_framebuffer_write_color(ptr, srcColor);                              \
-        }                                                                           \
-                                                                                    \
-        /* Increment the interpolation parameter, UVs, and pointers */              \
-    discard:                                                                        \
-        z += dZdx;                                                                  \
-        w += dWdx;                                                                  \
-        color[0] += dCdx[0];                                                        \
-        color[1] += dCdx[1];                                                        \
-        color[2] += dCdx[2];                                                        \
-        color[3] += dCdx[3];                                                        \
-        if (ENABLE_TEXTURE)                                                         \
-        {                                                                           \
-            u += dUdx;                                                              \
-            v += dVdx;                                                              \
-        }                                                                           \
-        ++ptr;                                                                      \
-    }                                                                               \
-}
+// Run a job for the indices [0, count) on the raster threads, the calling thread included
+static inline void sw_deferred_run_jobs(sw_job_f job, void *data, int count)
+{
+    // Wake up the workers
+    pthread_mutex_lock(&RLSW.deferred.mutex);
+    RLSW.deferred.job = job;
+    RLSW.deferred.jobData = data;
+    RLSW.deferred.jobCount = count;
+    RLSW.deferred.nextJob = 0;
+    RLSW.deferred.pendingWorkers = RLSW.deferred.threadCount - 1;
+    RLSW.deferred.generation++;
+    pthread_cond_broadcast(&RLSW.deferred.wakeCond);
+    pthread_mutex_unlock(&RLSW.deferred.mutex);
 
-#define DEFINE_TRIANGLE_RASTER(FUNC_NAME, FUNC_SCANLINE, ENABLE_TEXTURE)            \
-static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1,          \
-                             const sw_vertex_t *v2, const sw_texture_t *tex)        \
-{                                                                                   \
-    /* Swap vertices by increasing y */                                             \
-    if (v0->screen[1] > v1->screen[1]) { const sw_vertex_t *tmp = v0; v0 = v1; v1 = tmp; } \
-    if (v1->screen[1] > v2->screen[1]) { const sw_vertex_t *tmp = v1; v1 = v2; v2 = tmp; } \
-    if (v0->screen[1] > v1->screen[1]) { const sw_vertex_t *tmp = v0; v0 = v1; v1 = tmp; } \
-                                                                                    \
-    /* Extracting coordinates from the sorted vertices */                           \
-    float x0 = v0->screen[0], y0 = v0->screen[1];                                   \
-    float x1 = v1->screen[0], y1 = v1->screen[1];                                   \
-    float x2 = v2->screen[0], y2 = v2->screen[1];                                   \
-                                                                                    \
-    /* Compute height differences */                                                \
-    float h02 = y2 - y0;                                                            \
-    float h01 = y1 - y0;                                                            \
-    float h12 = y2 - y1;                                                            \
-                                                                                    \
-    if (h02 < 1e-6f) return;                                                        \
-                                                                                    \
-    /* Precompute the inverse values without additional checks */                   \
-    float h02Rcp = 1.0f/h02;                                                        \
-    float h01Rcp = (h01 > 1e-6f)? 1.0f/h01 : 0.0f;                                  \
-    float h12Rcp = (h12 > 1e-6f)? 1.0f/h12 : 0.0f;                                  \
-                                                                                    \
-    /* Pre-calculation of slopes */                                                 \
-    float dXdy02 = (x2 - x0)*h02Rcp;                                                \
-    float dXdy01 = (x1 - x0)*h01Rcp;                                                \
-    float dXdy12 = (x2 - x1)*h12Rcp;                                                \
-                                                                                    \
-    /* Y subpixel correction */                                                     \
-    float y0Substep = 1.0f - sw_fract(y0);                                          \
-    float y1Substep = 1.0f - sw_fract(y1);                                          \
-                                                                                    \
-    /* Y bounds (vertical clipping) */                                              \
-    int yTop = (int)y0;                                                             \
-    int yMid = (int)y1;                                                             \
-    int yBot = (int)y2;                                                             \
-                                                                                    \
-    /* Compute gradients for each side of the triangle */                           \
-    sw_vertex_t dVXdy02, dVXdy01, dVXdy12;                                          \
-    sw_get_vertex_grad_PTCH(&dVXdy02, v0, v2, h02Rcp);                              \
-    sw_get_vertex_grad_PTCH(&dVXdy01, v0, v1, h01Rcp);                              \
-    sw_get_vertex_grad_PTCH(&dVXdy12, v1, v2, h12Rcp);                              \
-                                                                                    \
-    /* Get a copy of vertices for interpolation and apply substep correction */     \
-    sw_vertex_t vLeft = *v0, vRight = *v0;                                          \
-    sw_add_vertex_grad_scaled_PTCH(&vLeft, &dVXdy02, y0Substep);                    \
-    sw_add_vertex_grad_scaled_PTCH(&vRight, &dVXdy01, y0Substep);                   \
-                                                                                    \
-    vLeft.screen[0] += dXdy02*y0Substep;                                            \
-    vRight.screen[0] += dXdy01*y0Substep;                                           \
-                                                                                    \
-    /* Scanline for the upper part of the triangle */                               \
-    for (int y = yTop; y < yMid; y++)                                               \
-    {                                                                               \
-        vLeft.screen[1] = vRight.screen[1] = y;                                     \
-                                                                                    \
-        if (vLeft.screen[0] < vRight.screen[0]) FUNC_SCANLINE(tex, &vLeft, &vRight, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
-        else FUNC_SCANLINE(tex, &vRight, &vLeft, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
-                                                                                    \
-        sw_add_vertex_grad_PTCH(&vLeft, &dVXdy02);                                  \
-        vLeft.screen[0] += dXdy02;                                                  \
-                                                                                    \
-        sw_add_vertex_grad_PTCH(&vRight, &dVXdy01);                                 \
-        vRight.screen[0] += dXdy01;                                                 \
-    }                                                                               \
-                                                                                    \
-    /* Get a copy of next right for interpolation and apply substep correction */   \
-    vRight = *v1;                                                                   \
-    sw_add_vertex_grad_scaled_PTCH(&vRight, &dVXdy12, y1Substep);                   \
-    vRight.screen[0] += dXdy12*y1Substep;                                           \
-                                                                                    \
-    /* Scanline for the lower part of the triangle */                               \
-    for (int y = yMid; y < yBot; y++)                                               \
-    {                                                                               \
-        vLeft.screen[1] = vRight.screen[1] = y;                                     \
-                                                                                    \
-        if (vLeft.screen[0] < vRight.screen[0]) FUNC_SCANLINE(tex, &vLeft, &vRight, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
-        else FUNC_SCANLINE(tex, &vRight, &vLeft, dVXdy02.texcoord[0], dVXdy02.texcoord[1]); \
-                                                                                    \
-        sw_add_vertex_grad_PTCH(&vLeft, &dVXdy02);                                  \
-        vLeft.screen[0] += dXdy02;                                                  \
-                                                                                    \
-        sw_add_vertex_grad_PTCH(&vRight, &dVXdy12);                                 \
-        vRight.screen[0] += dXdy12;                                                 \
-    }                                                                               \
+    sw_deferred_process_jobs();
+
+    pthread_mutex_lock(&RLSW.deferred.mutex);
+    while (RLSW.deferred.pendingWorkers > 0) pthread_cond_wait(&RLSW.deferred.doneCond, &RLSW.deferred.mutex);
+    pthread_mutex_unlock(&RLSW.deferred.mutex);
 }
 
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline, 0, 0, 0)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX, 1, 0, 0)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH, 0, 1, 0)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_BLEND, 0, 0, 1)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH, 1, 1, 0)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_BLEND, 1, 0, 1)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH_BLEND, 0, 1, 1)
-DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH_BLEND, 1, 1, 1)
-
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster, sw_triangle_raster_scanline, false)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX, sw_triangle_raster_scanline_TEX, true)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH, sw_triangle_raster_scanline_DEPTH, false)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_BLEND, sw_triangle_raster_scanline_BLEND, false)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH, sw_triangle_raster_scanline_TEX_DEPTH, true)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND, sw_triangle_raster_scanline_TEX_BLEND, true)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND, sw_triangle_raster_scanline_DEPTH_BLEND, false)
-DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND, sw_triangle_raster_scanline_TEX_DEPTH_BLEND, true)
+#endif  // RLSW_USE_THREADS
 
-static inline void sw_triangle_render(void)
+static inline void sw_deferred_raster_cmd(const sw_raster_cmd_t *cmd, const int bounds[4])
 {
-    if (RLSW.stateFlags & SW_STATE_CULL_FACE)
+    const sw_raster_state_t *state = &RLSW.deferred.states[cmd->state];
+
+    switch (cmd->type)
     {
-        if (!sw_triangle_face_culling()) return;
+        case SW_RASTER_CMD_TRIANGLE: state->triangle(&cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2], state->tex, bounds); break;
+        case SW_RASTER_CMD_QUAD: state->quad(cmd->vertices, state->tex, bounds); break;
+        default: break;
     }
+}
 
-    sw_triangle_clip_and_project();
+// Get the index of the primitive replayed at the given position
+static inline uint32_t sw_deferred_get_cmd(int position)
+{
+#if defined(RLSW_USE_COMMAND_BUFFER)
+    return RLSW.deferred.order[position];
+#else
+    return (uint32_t)position;
+#endif
+}
 
-    if (RLSW.vertexCounter < 3) return;
+#if defined(RLSW_USE_THREADS)
+static void sw_deferred_raster_tile(void *data, int tile)
+{
+    const sw_tile_bin_t *bin = &RLSW.deferred.bins[tile];
+    if (bin->count == 0) return;
 
-    #define TRIANGLE_RASTER(RASTER_FUNC)                        \
-    {                                                           \
-        for (int i = 0; i < RLSW.vertexCounter - 2; i++)        \
-        {                                                       \
-            RASTER_FUNC(                                        \
-                &RLSW.vertexBuffer[0],                          \
-                &RLSW.vertexBuffer[i + 1],                      \
-                &RLSW.vertexBuffer[i + 2],                      \
-                &RLSW.loadedTextures[RLSW.currentTexture]       \
-            );                                                  \
-        }                                                       \
-    }
+    (void)data;
 
-    uint32_t state = RLSW.stateFlags;
-    if (RLSW.currentTexture == 0) state &= ~SW_STATE_TEXTURE_2D;
-    if ((RLSW.srcFactor == SW_ONE) && (RLSW.dstFactor == SW_ZERO)) state &= ~SW_STATE_BLEND;
+    int tx = tile%RLSW.deferred.tilesX;
+    int ty = tile/RLSW.deferred.tilesX;
 
-    if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) TRIANGLE_RASTER(sw_triangle_raster_TEX)
-    else TRIANGLE_RASTER(sw_triangle_raster)
+    const int bounds[4] = {
+        tx*SW_RASTER_TILE_SIZE,
+        ty*SW_RASTER_TILE_SIZE,
+        sw_clampi((tx + 1)*SW_RASTER_TILE_SIZE, 0, RLSW.framebuffer.width),
+        sw_clampi((ty + 1)*SW_RASTER_TILE_SIZE, 0, RLSW.framebuffer.height)
+    };
 
-    #undef TRIANGLE_RASTER
+    // Primitives are rasterized in replay order, so blending and depth results
+    // are the same as with immediate rendering
+    for (int i = 0; i < bin->count; i++) sw_deferred_raster_cmd(&RLSW.deferred.cmds[bin->cmds[i]], bounds);
 }
-//-------------------------------------------------------------------------------------------
+#endif
 
-// Quad rendering logic
-//-------------------------------------------------------------------------------------------
-static inline bool sw_quad_face_culling(void)
+#if defined(RLSW_USE_COMMAND_BUFFER)
+static inline bool sw_deferred_bounds_overlap(const int a[4], const int b[4])
 {
-    // NOTE: Face culling is done before clipping to avoid unnecessary computations
-    //       To handle quads crossing the w=0 plane correctly,
-    //       we perform the winding order test in homogeneous coordinates directly,
-    //       before the perspective division (division by w)
-    //       For a convex quad with vertices P0, P1, P2, P3 in sequential order,
-    //       the winding order of the quad is the same as the winding order
-    //       of the triangle P0 P1 P2. We use the homogeneous triangle
-    //       winding test on this first triangle
+    return (a[0] <= b[2]) && (b[0] <= a[2]) && (a[1] <= b[3]) && (b[1] <= a[3]);
+}
 
-    // Preload homogeneous coordinates into local variables
-    const float *h0 = RLSW.vertexBuffer[0].homogeneous;
-    const float *h1 = RLSW.vertexBuffer[1].homogeneous;
-    const float *h2 = RLSW.vertexBuffer[2].homogeneous;
+// Build the replay order, moving every primitive to the last group with the same raster state
+// NOTE: A primitive can only move before the groups it doesn't overlap, pixels covered by
+// several primitives are still written in submission order
+static inline void sw_deferred_group_cmds(void)
+{
+    sw_raster_group_t *groups = RLSW.deferred.groups;
+    int groupCount = 0;
 
-    // NOTE: h3 is not needed for this test
-    // const float *h3 = RLSW.vertexBuffer[3].homogeneous;
+    for (int i = 0; i < RLSW.deferred.cmdCount; i++)
+    {
+        const sw_raster_cmd_t *cmd = &RLSW.deferred.cmds[i];
+        int target = -1;
 
-    // Compute a value proportional to the signed area of the triangle P0 P1 P2
-    // in the projected 2D plane, calculated directly using homogeneous coordinates
-    // BEFORE division by w
-    // This is the determinant of the matrix formed by the (x, y, w) components
-    // of the vertices P0, P1, and P2. Its sign correctly indicates the winding order
-    // in homogeneous space and its relationship to the projected 2D winding order,
-    // even with negative w values
-    // The determinant formula used here is:
-    // h0.x*(h1.y*h2.w - h2.y*h1.w) +
-    // h1.x*(h2.y*h0.w - h0.y*h2.w) +
-    // h2.x*(h0.y*h1.w - h1.y*h0.w)
+        for (int g = groupCount - 1; (g >= 0) && (g >= groupCount - SW_DEFERRED_GROUP_WINDOW); g--)
+        {
+            if (groups[g].state == cmd->state) { target = g; break; }
+            if (sw_deferred_bounds_overlap(groups[g].bounds, cmd->bounds)) break;
+        }
 
-    const float hSgnArea =
-        h0[0]*(h1[1]*h2[3] - h2[1]*h1[3]) +
-        h1[0]*(h2[1]*h0[3] - h0[1]*h2[3]) +
-        h2[0]*(h0[1]*h1[3] - h1[1]*h0[3]);
+        RLSW.deferred.nextCmd[i] = UINT32_MAX;
 
-    // Perform face culling based on the winding order determined by the sign
-    // of the homogeneous area/determinant of triangle P0 P1 P2
-    // This test is robust for points with w > 0 or w < 0 within the triangle,
-    // correctly capturing the change in orientation when crossing the w=0 plane
+        if (target < 0)
+        {
+            sw_raster_group_t *group = &groups[groupCount++];
+            group->state = cmd->state;
+            for (int j = 0; j < 4; j++) group->bounds[j] = cmd->bounds[j];
+            group->first = group->last = (uint32_t)i;
+            continue;
+        }
 
-    // A positive hSgnArea typically corresponds to a counter-clockwise
-    // winding in the projected space when all w > 0
-    // A value of 0 for hSgnArea means P0, P1, P2 are collinear in (x, y, w)
-    // space, which corresponds to a degenerate triangle projection
-    // Such quads might also be degenerate or non-planar. They are typically
-    // not culled by this test (0 < 0 is false, 0 > 0 is false)
-    // and should be handled by the clipper if necessary
+        sw_raster_group_t *group = &groups[target];
+        group->bounds[0] = sw_mini(group->bounds[0], cmd->bounds[0]);
+        group->bounds[1] = sw_mini(group->bounds[1], cmd->bounds[1]);
+        group->bounds[2] = sw_maxi(group->bounds[2], cmd->bounds[2]);
+        group->bounds[3] = sw_maxi(group->bounds[3], cmd->bounds[3]);
+        RLSW.deferred.nextCmd[group->last] = (uint32_t)i;
+        group->last = (uint32_t)i;
+    }
 
-    return (RLSW.cullFace == SW_FRONT)? (hSgnArea < 0.0f) : (hSgnArea > 0.0f); // Cull if winding is "clockwise" : "counter-clockwise"
+    int position = 0;
+    for (int g = 0; g < groupCount; g++)
+    {
+        for (uint32_t i = groups[g].first; i != UINT32_MAX; i = RLSW.deferred.nextCmd[i])
+        {
+            RLSW.deferred.order[position++] = i;
+        }
+    }
 }
+#endif
 
-static inline void sw_quad_clip_and_project(void)
+static inline void sw_deferred_flush(void)
 {
-    sw_vertex_t *polygon = RLSW.vertexBuffer;
-    int *vertexCounter = &RLSW.vertexCounter;
-
-    if (sw_polygon_clip(polygon, vertexCounter))
-    {
-        // Transformation to screen space and normalization
-        for (int i = 0; i < *vertexCounter; i++)
-        {
-            sw_vertex_t *v = &polygon[i];
+    if (RLSW.deferred.cmdCount == 0) return;
 
-            // Calculation of the reciprocal of W for normalization
-            // as well as perspective-correct attributes
-            const float wRcp = 1.0f/v->homogeneous[3];
-            v->homogeneous[3] = wRcp;
+#if defined(RLSW_USE_STATS)
+    double startTime = sw_stats_get_time();
+#endif
 
-            // Division of XYZ coordinates by weight
-            v->homogeneous[0] *= wRcp;
-            v->homogeneous[1] *= wRcp;
-            v->homogeneous[2] *= wRcp;
+#if defined(RLSW_USE_COMMAND_BUFFER)
+    sw_deferred_group_cmds();
+#endif
 
-            // Division of texture coordinates (perspective-correct)
-            v->texcoord[0] *= wRcp;
-            v->texcoord[1] *= wRcp;
+#if defined(RLSW_USE_THREADS)
+    if (RLSW.deferred.threadCount > 1)
+    {
+        for (int i = 0; i < RLSW.deferred.cmdCount; i++) sw_deferred_bin_cmd(sw_deferred_get_cmd(i));
 
-            // Division of colors (perspective-correct)
-            v->color[0] *= wRcp;
-            v->color[1] *= wRcp;
-            v->color[2] *= wRcp;
-            v->color[3] *= wRcp;
+        sw_deferred_run_jobs(sw_deferred_raster_tile, NULL, RLSW.deferred.tilesX*RLSW.deferred.tilesY);
 
-            // Transformation to screen space
-            sw_project_ndc_to_screen(v->screen, v->homogeneous);
-        }
+        const int tileCount = RLSW.deferred.tilesX*RLSW.deferred.tilesY;
+        for (int i = 0; i < tileCount; i++) RLSW.deferred.bins[i].count = 0;
+    }
+    else
+#endif
+    {
+        const int bounds[4] = { 0, 0, RLSW.framebuffer.width, RLSW.framebuffer.height };
+        for (int i = 0; i < RLSW.deferred.cmdCount; i++) sw_deferred_raster_cmd(&RLSW.deferred.cmds[sw_deferred_get_cmd(i)], bounds);
     }
+
+    SW_STATS_ADD(flushes, 1);
+#if defined(RLSW_USE_STATS)
+    SW_STATS_ADD(flushTime, sw_stats_get_time() - startTime);
+#endif
+
+    // Reset command buffer and state snapshots for the next primitives
+    RLSW.deferred.cmdCount = 0;
+    RLSW.deferred.stateCount = 0;
+    RLSW.deferred.currentState = -1;
 }
 
-static inline bool sw_quad_is_axis_aligned(void)
+// Get the snapshot of the current raster state, equal states share the same snapshot
+static inline uint32_t sw_deferred_get_state(void)
 {
-    // Reject quads with perspective projection
-    // The fast path assumes affine (non-perspective) quads,
-    // so we require all vertices to have homogeneous w = 1.0
-    for (int i = 0; i < 4; i++)
+    if (RLSW.deferred.currentState >= 0) return (uint32_t)RLSW.deferred.currentState;
+
+    const sw_raster_state_t *state = &RLSW.rasterState;
+    int index = 0;
+
+    for (; index < RLSW.deferred.stateCount; index++)
     {
-        if (RLSW.vertexBuffer[i].homogeneous[3] != 1.0f) return false;
+        const sw_raster_state_t *other = &RLSW.deferred.states[index];
+        if ((other->triangle == state->triangle) && (other->quad == state->quad) && (other->tex == state->tex)) break;
     }
 
-    // Epsilon tolerance in screen space (pixels)
-    const float epsilon = 0.5f;
+    if (index == RLSW.deferred.stateCount)
+    {
+        if (index == SW_MAX_DEFERRED_STATES)
+        {
+            sw_deferred_flush();
+            index = 0;
+        }
 
-    // Fetch screen-space positions for the four quad vertices
-    const float *p0 = RLSW.vertexBuffer[0].screen;
-    const float *p1 = RLSW.vertexBuffer[1].screen;
-    const float *p2 = RLSW.vertexBuffer[2].screen;
-    const float *p3 = RLSW.vertexBuffer[3].screen;
-
-    // Compute edge vectors between consecutive vertices
-    // These define the four sides of the quad in screen space
-    float dx01 = p1[0] - p0[0], dy01 = p1[1] - p0[1];
-    float dx12 = p2[0] - p1[0], dy12 = p2[1] - p1[1];
-    float dx23 = p3[0] - p2[0], dy23 = p3[1] - p2[1];
-    float dx30 = p0[0] - p3[0], dy30 = p0[1] - p3[1];
+        RLSW.deferred.states[index] = *state;
+        RLSW.deferred.stateCount = index + 1;
+    }
 
-    // Each edge must be either horizontal or vertical within epsilon tolerance
-    // If any edge deviates significantly from either axis, the quad is not axis-aligned
-    if (!((fabsf(dy01) < epsilon) || (fabsf(dx01) < epsilon))) return false;
-    if (!((fabsf(dy12) < epsilon) || (fabsf(dx12) < epsilon))) return false;
-    if (!((fabsf(dy23) < epsilon) || (fabsf(dx23) < epsilon))) return false;
-    if (!((fabsf(dy30) < epsilon) || (fabsf(dx30) < epsilon))) return false;
+    RLSW.deferred.currentState = index;
 
-    return true;
+    return (uint32_t)index;
 }
 
-static inline void sw_quad_sort_cw(const sw_vertex_t* *output)
+static inline sw_raster_cmd_t *sw_deferred_push_cmd(sw_raster_cmd_type_t type)
 {
-    const sw_vertex_t *input = RLSW.vertexBuffer;
-
-    // Calculate the centroid of the quad
-    float cx = (input[0].screen[0] + input[1].screen[0] +
-                input[2].screen[0] + input[3].screen[0])*0.25f;
-    float cy = (input[0].screen[1] + input[1].screen[1] +
-                input[2].screen[1] + input[3].screen[1])*0.25f;
+    if (RLSW.deferred.cmdCount >= SW_MAX_DEFERRED_PRIMITIVES) sw_deferred_flush();
 
-    // Calculate the angle of each vertex relative to the center
-    // and assign them directly to their correct position
-    const sw_vertex_t *corners[4] = { 0 };
+    uint32_t state = sw_deferred_get_state();
+    sw_raster_cmd_t *cmd = &RLSW.deferred.cmds[RLSW.deferred.cmdCount++];
 
-    for (int i = 0; i < 4; i++)
-    {
-        float dx = input[i].screen[0] - cx;
-        float dy = input[i].screen[1] - cy;
+    cmd->type = type;
+    cmd->state = state;
 
-        // Determine the quadrant (clockwise from top-left)
-        // top-left: dx < 0, dy < 0
-        // top-right: dx >= 0, dy < 0
-        // bottom-right: dx >= 0, dy >= 0
-        // bottom-left: dx < 0, dy >= 0
+    return cmd;
+}
 
-        int idx;
-        if (dy < 0) idx = (dx < 0)? 0 : 1; // Top row
-        else idx = (dx < 0)? 3 : 2; // Bottom row
+// Compute the screen bounds of a recorded primitive
+// NOTE: Bounds are extended by one pixel to stay conservative with the pixel center rules
+static inline void sw_deferred_set_bounds(sw_raster_cmd_t *cmd, int count)
+{
+    float xMin = cmd->vertices[0].screen[0], xMax = xMin;
+    float yMin = cmd->vertices[0].screen[1], yMax = yMin;
 
-        corners[idx] = &input[i];
+    for (int i = 1; i < count; i++)
+    {
+        const float *p = cmd->vertices[i].screen;
+        if (p[0] < xMin) xMin = p[0];
+        if (p[0] > xMax) xMax = p[0];
+        if (p[1] < yMin) yMin = p[1];
+        if (p[1] > yMax) yMax = p[1];
     }
 
-    output[0] = corners[0];  // top-left
-    output[1] = corners[1];  // top-right
-    output[2] = corners[2];  // bottom-right
-    output[3] = corners[3];  // bottom-left
+    cmd->bounds[0] = (int)floorf(xMin) - 1;
+    cmd->bounds[1] = (int)floorf(yMin) - 1;
+    cmd->bounds[2] = (int)floorf(xMax) + 1;
+    cmd->bounds[3] = (int)floorf(yMax) + 1;
 }
 
-// TODO: REVIEW: Could a perfectly aligned quad, where one of the four points has a different depth,
-// still appear perfectly aligned from a certain point of view?
-// Because in that case, we would still need to perform perspective division for textures and colors...
-#define DEFINE_QUAD_RASTER_AXIS_ALIGNED(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND) \
-static inline void FUNC_NAME(void)                                              \
-{                                                                               \
-    const sw_vertex_t *sortedVerts[4];                                          \
-    sw_quad_sort_cw(sortedVerts);                                               \
-                                                                                \
-    const sw_vertex_t *v0 = sortedVerts[0];                                     \
-    const sw_vertex_t *v1 = sortedVerts[1];                                     \
-    const sw_vertex_t *v2 = sortedVerts[2];                                     \
-    const sw_vertex_t *v3 = sortedVerts[3];                                     \
-                                                                                \
-    /* Screen bounds (axis-aligned) */                                          \
-    int xMin = (int)v0->screen[0];                                              \
-    int yMin = (int)v0->screen[1];                                              \
-    int xMax = (int)v2->screen[0];                                              \
-    int yMax = (int)v2->screen[1];                                              \
-                                                                                \
-    float w = v2->screen[0] - v0->screen[0];                                    \
-    float h = v2->screen[1] - v0->screen[1];                                    \
-                                                                                \
-    if ((w == 0) || (h == 0)) return;                                           \
-                                                                                \
-    float wRcp = (w > 0.0f)? 1.0f/w : 0.0f;                                     \
-    float hRcp = (h > 0.0f)? 1.0f/h : 0.0f;                                     \
-                                                                                \
-    /* Subpixel corrections */                                                  \
-    float xSubstep = 1.0f - sw_fract(v0->screen[0]);                            \
-    float ySubstep = 1.0f - sw_fract(v0->screen[1]);                            \
-                                                                                \
-    /* Calculation of vertex gradients in X and Y */                            \
-    float dUdx = 0.0f, dVdx = 0.0f;                                             \
-    float dUdy = 0.0f, dVdy = 0.0f;                                             \
-    if (ENABLE_TEXTURE) {                                                       \
-        dUdx = (v1->texcoord[0] - v0->texcoord[0])*wRcp;                        \
-        dVdx = (v1->texcoord[1] - v0->texcoord[1])*wRcp;                        \
-        dUdy = (v3->texcoord[0] - v0->texcoord[0])*hRcp;                        \
-        dVdy = (v3->texcoord[1] - v0->texcoord[1])*hRcp;                        \
-    }                                                                           \
-                                                                                \
-    float dCdx[4], dCdy[4];                                                     \
-    dCdx[0] = (v1->color[0] - v0->color[0])*wRcp;                               \
-    dCdx[1] = (v1->color[1] - v0->color[1])*wRcp;                               \
-    dCdx[2] = (v1->color[2] - v0->color[2])*wRcp;                               \
-    dCdx[3] = (v1->color[3] - v0->color[3])*wRcp;                               \
-    dCdy[0] = (v3->color[0] - v0->color[0])*hRcp;                               \
-    dCdy[1] = (v3->color[1] - v0->color[1])*hRcp;                               \
-    dCdy[2] = (v3->color[2] - v0->color[2])*hRcp;                               \
-    dCdy[3] = (v3->color[3] - v0->color[3])*hRcp;                               \
-                                                                                \
-    float dZdx, dZdy;                                                           \
-    dZdx = (v1->homogeneous[2] - v0->homogeneous[2])*wRcp;                      \
-    dZdy = (v3->homogeneous[2] - v0->homogeneous[2])*hRcp;                      \
-                                                                                \
-    /* Start of quad rasterization */                                           \
-    const sw_texture_t *tex;                                                    \
-    if (ENABLE_TEXTURE) tex = &RLSW.loadedTextures[RLSW.currentTexture];        \
-                                                                                \
-    sw_pixel_t *pixels = RLSW.framebuffer.pixels;                               \
-    int wDst = RLSW.framebuffer.width;                                          \
-                                                                                \
-    float zScanline = v0->homogeneous[2] + dZdx*xSubstep + dZdy*ySubstep;       \
-    float uScanline = v0->texcoord[0] + dUdx*xSubstep + dUdy*ySubstep;          \
-    float vScanline = v0->texcoord[1] + dVdx*xSubstep + dVdy*ySubstep;          \
-                                                                                \
-    float colorScanline[4] = {                                                  \
-        v0->color[0] + dCdx[0]*xSubstep + dCdy[0]*ySubstep,                     \
-        v0->color[1] + dCdx[1]*xSubstep + dCdy[1]*ySubstep,                     \
-        v0->color[2] + dCdx[2]*xSubstep + dCdy[2]*ySubstep,                     \
-        v0->color[3] + dCdx[3]*xSubstep + dCdy[3]*ySubstep                      \
-    };                                                                          \
-                                                                                \
-    for (int y = yMin; y < yMax; y++)                                           \
-    {                                                                           \
-        sw_pixel_t *ptr = pixels + y*wDst + xMin;                               \
-                                                                                \
-        float z = zScanline;                                                    \
-        float u = uScanline;                                                    \
-        float v = vScanline;                                                    \
-                                                                                \
-        float color[4] = {                                                      \
-            colorScanline[0],                                                   \
-            colorScanline[1],                                                   \
-            colorScanline[2],                                                   \
-            colorScanline[3]                                                    \
-        };                                                                      \
-                                                                                \
-        /* Scanline rasterization */                                            \
-        for (int x = xMin; x < xMax; x++)                                       \
-        {                                                                       \
-            /* Pixel color computation */                                       \
-            float srcColor[4] = {                                               \
-                color[0],                                                       \
-                color[1],                                                       \
-                color[2],                                                       \
-                color[3]                                                        \
-            };                                                                  \
-                                                                                \
-            /* Test and write depth */                                          \
-            if (ENABLE_DEPTH_TEST)                                              \
-            {                                                                   \
-                /* TODO: Implement different depth funcs? */                    \
-                float depth =  sw_framebuffer_read_depth(ptr);                  \
-                if (z > depth) goto discard;                                    \
-            }                                                                   \
-                                                                                \
-            /* TODO: Implement depth mask */                                    \
-            sw_framebuffer_write_depth(ptr, z);                                 \
-                                                                                \
-            if (ENABLE_TEXTURE)                                                 \
-            {                                                                   \
-                float texColor[4];                                              \
-                sw_texture_sample(texColor, tex, u, v, dUdx, dUdy, dVdx, dVdy); \
-                srcColor[0] *= texColor[0];                                     \
-                srcColor[1] *= texColor[1];                                     \
-                srcColor[2] *= texColor[2];                                     \
-                srcColor[3] *= texColor[3];                                     \
-            }                                                                   \
-                                                                                \
-            if (ENABLE_COLOR_BLEND)                                             \
-            {                                                                   \
-                float dstColor[4];                                              \
-                sw_framebuffer_read_color(dstColor, ptr);                       \
-                sw_blend_colors(dstColor, srcColor);                            \
-                sw_framebuffer_write_color(ptr, dstColor);                      \
-            }                                                                   \
-            else sw_framebuffer_write_color(ptr, srcColor);                     \
-                                                                                \
-        discard:                                                                \
-            z += dZdx;                                                          \
-            color[0] += dCdx[0];                                                \
-            color[1] += dCdx[1];                                                \
-            color[2] += dCdx[2];                                                \
-            color[3] += dCdx[3];                                                \
-            if (ENABLE_TEXTURE)                                                 \
-            {                                                                   \
-                u += dUdx;                                                      \
-                v += dVdx;                                                      \
-            }                                                                   \
-            ++ptr;                                                              \
-        }                                                                       \
-                                                                                \
-        zScanline += dZdy;                                                      \
-        colorScanline[0] += dCdy[0];                                            \
-        colorScanline[1] += dCdy[1];                                            \
-        colorScanline[2] += dCdy[2];                                            \
-        colorScanline[3] += dCdy[3];                                            \
-                                                                                \
-        if (ENABLE_TEXTURE)                                                     \
-        {                                                                       \
-            uScanline += dUdy;                                                  \
-            vScanline += dVdy;                                                  \
-        }                                                                       \
-    }                                                                           \
+static inline void sw_deferred_push_triangle(const sw_vertex_t *v0, const sw_vertex_t *v1, const sw_vertex_t *v2)
+{
+    sw_raster_cmd_t *cmd = sw_deferred_push_cmd(SW_RASTER_CMD_TRIANGLE);
+
+    cmd->vertices[0] = *v0;
+    cmd->vertices[1] = *v1;
+    cmd->vertices[2] = *v2;
+
+    sw_deferred_set_bounds(cmd, 3);
 }
 
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned, 0, 0, 0)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX, 1, 0, 0)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH, 0, 1, 0)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_BLEND, 0, 0, 1)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_DEPTH, 1, 1, 0)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_BLEND, 1, 0, 1)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH_BLEND, 0, 1, 1)
-DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_DEPTH_BLEND, 1, 1, 1)
+static inline void sw_deferred_push_quad(const sw_vertex_t *vertices)
+{
+    sw_raster_cmd_t *cmd = sw_deferred_push_cmd(SW_RASTER_CMD_QUAD);
+
+    for (int i = 0; i < 4; i++) cmd->vertices[i] = vertices[i];
 
-static inline void sw_quad_render(void)
+    sw_deferred_set_bounds(cmd, 4);
+}
+
+static inline void sw_deferred_init(void)
 {
-    if (RLSW.stateFlags & SW_STATE_CULL_FACE)
-    {
-        if (!sw_quad_face_culling()) return;
-    }
+    RLSW.deferred.currentState = -1;
 
-    sw_quad_clip_and_project();
+#if defined(RLSW_USE_THREADS)
+    int threadCount = sw_deferred_get_thread_count();
 
-    if (RLSW.vertexCounter < 3) return;
+    RLSW.deferred.threadCount = 1;
 
-    uint32_t state = RLSW.stateFlags;
-    if (RLSW.currentTexture == 0) state &= ~SW_STATE_TEXTURE_2D;
-    if ((RLSW.srcFactor == SW_ONE) && (RLSW.dstFactor == SW_ZERO)) state &= ~SW_STATE_BLEND;
+    #if !defined(RLSW_USE_COMMAND_BUFFER)
+    // Deferred mode is only useful with multiple raster threads
+    if (threadCount <= 1) return;
+    #endif
+#endif
+
+    bool allocated = true;
+
+    RLSW.deferred.cmds = (sw_raster_cmd_t *)SW_MALLOC(SW_MAX_DEFERRED_PRIMITIVES*sizeof(sw_raster_cmd_t));
+    allocated = allocated && (RLSW.deferred.cmds != NULL);
+
+#if defined(RLSW_USE_COMMAND_BUFFER)
+    RLSW.deferred.groups = (sw_raster_group_t *)SW_MALLOC(SW_MAX_DEFERRED_PRIMITIVES*sizeof(sw_raster_group_t));
+    RLSW.deferred.nextCmd = (uint32_t *)SW_MALLOC(SW_MAX_DEFERRED_PRIMITIVES*sizeof(uint32_t));
+    RLSW.deferred.order = (uint32_t *)SW_MALLOC(SW_MAX_DEFERRED_PRIMITIVES*sizeof(uint32_t));
+    allocated = allocated && (RLSW.deferred.groups != NULL) && (RLSW.deferred.nextCmd != NULL) && (RLSW.deferred.order != NULL);
+#endif
+
+#if defined(RLSW_USE_THREADS)
+    if (threadCount > 1) allocated = allocated && sw_deferred_resize_bins(RLSW.framebuffer.width, RLSW.framebuffer.height);
+#endif
 
-    if ((RLSW.vertexCounter == 4) && sw_quad_is_axis_aligned())
+    if (!allocated)
     {
-        if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_TEX_DEPTH_BLEND();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_DEPTH_BLEND();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) sw_quad_raster_axis_aligned_TEX_BLEND();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) sw_quad_raster_axis_aligned_TEX_DEPTH();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_quad_raster_axis_aligned_BLEND();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_quad_raster_axis_aligned_DEPTH();
-        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) sw_quad_raster_axis_aligned_TEX();
-        else sw_quad_raster_axis_aligned();
+        SW_LOG("WARNING: RLSW: Failed to allocate deferred rasterization buffers, using immediate mode\n");
         return;
     }
 
-    #define TRIANGLE_RASTER(RASTER_FUNC)                        \
-    {                                                           \
-        for (int i = 0; i < RLSW.vertexCounter - 2; i++)        \
-        {                                                       \
-            RASTER_FUNC(                                        \
-                &RLSW.vertexBuffer[0],                          \
-                &RLSW.vertexBuffer[i + 1],                      \
-                &RLSW.vertexBuffer[i + 2],                      \
-                &RLSW.loadedTextures[RLSW.currentTexture]       \
-            );                                                  \
-        }                                                       \
+    RLSW.deferred.enabled = true;
+
+#if defined(RLSW_USE_THREADS)
+    if (threadCount <= 1) return;
+
+    pthread_mutex_init(&RLSW.deferred.mutex, NULL);
+    pthread_cond_init(&RLSW.deferred.wakeCond, NULL);
+    pthread_cond_init(&RLSW.deferred.doneCond, NULL);
+    RLSW.deferred.workersReady = true;
+
+    int workerCount = 0;
+    for (int i = 0; i < threadCount - 1; i++)
+    {
+        if (pthread_create(&RLSW.deferred.threads[i], NULL, sw_deferred_worker, (void *)(intptr_t)(i + 1)) != 0) break;
+        workerCount++;
     }
 
-    if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) TRIANGLE_RASTER(sw_triangle_raster_BLEND)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) TRIANGLE_RASTER(sw_triangle_raster_DEPTH)
-    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) TRIANGLE_RASTER(sw_triangle_raster_TEX)
-    else TRIANGLE_RASTER(sw_triangle_raster)
+    RLSW.deferred.threadCount = workerCount + 1;
+
+    #if !defined(RLSW_USE_COMMAND_BUFFER)
+    RLSW.deferred.enabled = (RLSW.deferred.threadCount > 1);
+    #endif
 
-    #undef TRIANGLE_RASTER
+    if (RLSW.deferred.threadCount > 1) SW_LOG("INFO: RLSW: Deferred tile rasterization enabled (%i threads)\n", RLSW.deferred.threadCount);
+#endif
 }
-//-------------------------------------------------------------------------------------------
 
-// Line rendering logic
-//-------------------------------------------------------------------------------------------
-static inline bool sw_line_clip_coord(float q, float p, float *t0, float *t1)
+static inline void sw_deferred_close(void)
 {
-    if (fabsf(p) < SW_CLIP_EPSILON)
+#if defined(RLSW_USE_THREADS)
+    if (RLSW.deferred.workersReady)
     {
-        // Check if the line is entirely outside the window
-        if (q < -SW_CLIP_EPSILON) return 0; // Completely outside
-        return 1; // Completely inside or on the edges
-    }
+        pthread_mutex_lock(&RLSW.deferred.mutex);
+        RLSW.deferred.quit = true;
+        pthread_cond_broadcast(&RLSW.deferred.wakeCond);
+        pthread_mutex_unlock(&RLSW.deferred.mutex);
 
-    const float r = q/p;
+        for (int i = 0; i < RLSW.deferred.threadCount - 1; i++) pthread_join(RLSW.deferred.threads[i], NULL);
 
-    if (p < 0)
-    {
-        if (r > *t1) return 0;
-        if (r > *t0) *t0 = r;
-    }
-    else
-    {
-        if (r < *t0) return 0;
-        if (r < *t1) *t1 = r;
+        pthread_cond_destroy(&RLSW.deferred.doneCond);
+        pthread_cond_destroy(&RLSW.deferred.wakeCond);
+        pthread_mutex_destroy(&RLSW.deferred.mutex);
     }
 
-    return 1;
+    for (int i = 0; i < RLSW.deferred.binCount; i++) SW_FREE(RLSW.deferred.bins[i].cmds);
+
+    SW_FREE(RLSW.deferred.bins);
+#endif
+#if defined(RLSW_USE_COMMAND_BUFFER)
+    SW_FREE(RLSW.deferred.order);
+    SW_FREE(RLSW.deferred.nextCmd);
+    SW_FREE(RLSW.deferred.groups);
+#endif
+    SW_FREE(RLSW.deferred.cmds);
 }
+#else
+static inline void sw_deferred_flush(void) { /* Nothing to flush in immediate mode */ }
+#endif  // SW_HAS_DEFERRED
 
-static inline bool sw_line_clip(sw_vertex_t *v0, sw_vertex_t *v1)
+// Decode a compressed image, rows of blocks are decoded in parallel by the raster threads
+static inline void sw_decode_image(sw_decode_job_t *job)
 {
-    float t0 = 0.0f, t1 = 1.0f;
-    float dH[4], dC[4];
+    int blocksY = (job->height + 3)/4;
 
-    for (int i = 0; i < 4; i++)
+#if defined(RLSW_USE_THREADS)
+    if ((RLSW.deferred.threadCount > 1) && (blocksY > 1))
     {
-        dH[i] = v1->homogeneous[i] - v0->homogeneous[i];
-        dC[i] = v1->color[i] - v0->color[i];
+        sw_deferred_flush();
+        sw_deferred_run_jobs(sw_decode_block_row, job, blocksY);
+        return;
     }
+#endif
 
-    // Clipping Liang-Barsky
-    if (!sw_line_clip_coord(v0->homogeneous[3] - v0->homogeneous[0], -dH[3] + dH[0], &t0, &t1)) return false;
-    if (!sw_line_clip_coord(v0->homogeneous[3] + v0->homogeneous[0], -dH[3] - dH[0], &t0, &t1)) return false;
-    if (!sw_line_clip_coord(v0->homogeneous[3] - v0->homogeneous[1], -dH[3] + dH[1], &t0, &t1)) return false;
-    if (!sw_line_clip_coord(v0->homogeneous[3] + v0->homogeneous[1], -dH[3] - dH[1], &t0, &t1)) return false;
-    if (!sw_line_clip_coord(v0->homogeneous[3] - v0->homogeneous[2], -dH[3] + dH[2], &t0, &t1)) return false;
-    if (!sw_line_clip_coord(v0->homogeneous[3] + v0->homogeneous[2], -dH[3] - dH[2], &t0, &t1)) return false;
+    for (int by = 0; by < blocksY; by++) sw_decode_block_row(job, by);
+}
+//-------------------------------------------------------------------------------------------
 
-    // Clipping Scissor
-    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+// Triangle rendering logic
+//-------------------------------------------------------------------------------------------
+static inline bool sw_triangle_face_culling(void)
+{
+    // NOTE: Face culling is done before clipping to avoid unnecessary computations
+    //       To handle triangles crossing the w=0 plane correctly,
+    //       we perform the winding order test in homogeneous coordinates directly,
+    //       before the perspective division (division by w)
+    //       This test determines the orientation of the triangle in the (x,y,w) plane,
+    //       which corresponds to the projected 2D winding order sign,
+    //       even with negative w values
+
+    // Preload homogeneous coordinates into local variables
+    const float *h0 = RLSW.vertexBuffer[0].homogeneous;
+    const float *h1 = RLSW.vertexBuffer[1].homogeneous;
+    const float *h2 = RLSW.vertexBuffer[2].homogeneous;
+
+    // Compute a value proportional to the signed area in the projected 2D plane,
+    // calculated directly using homogeneous coordinates BEFORE division by w
+    // This is the determinant of the matrix formed by the (x, y, w) components
+    // of the vertices, which correctly captures the winding order in homogeneous
+    // space and its relationship to the projected 2D winding order, even with
+    // negative w values
+    // The determinant formula used here is:
+    // h0.x*(h1.y*h2.w - h2.y*h1.w) +
+    // h1.x*(h2.y*h0.w - h0.y*h2.w) +
+    // h2.x*(h0.y*h1.w - h1.y*h0.w)
+
+    const float hSgnArea =
+        h0[0]*(h1[1]*h2[3] - h2[1]*h1[3]) +
+        h1[0]*(h2[1]*h0[3] - h0[1]*h2[3]) +
+        h2[0]*(h0[1]*h1[3] - h1[1]*h0[3]);
+
+    // Discard the triangle if its winding order (determined by the sign
+    // of the homogeneous area/determinant) matches the culled direction
+    // A positive hSgnArea typically corresponds to a counter-clockwise
+    // winding in the projected space when all w > 0
+    // This test is robust for points with w > 0 or w < 0, correctly
+    // capturing the change in orientation when crossing the w=0 plane
+
+    // The culling logic remains the same based on the signed area/determinant
+    // A value of 0 for hSgnArea means the points are collinear in (x, y, w)
+    // space, which corresponds to a degenerate triangle projection
+    // Such triangles are typically not culled by this test (0 < 0 is false, 0 > 0 is false)
+    // and should be handled by the clipper if necessary
+    return (RLSW.cullFace == SW_FRONT)? (hSgnArea < 0) : (hSgnArea > 0); // Cull if winding is "clockwise" : "counter-clockwise"
+}
+
+static inline void sw_triangle_clip_and_project(void)
+{
+    sw_vertex_t *polygon = RLSW.vertexBuffer;
+    int *vertexCounter = &RLSW.vertexCounter;
+
+    if (sw_polygon_clip(polygon, vertexCounter))
+    {
+        // Transformation to screen space and normalization
+        for (int i = 0; i < *vertexCounter; i++)
+        {
+            sw_vertex_t *v = &polygon[i];
+
+            // Calculation of the reciprocal of W for normalization
+            // as well as perspective-correct attributes
+            const float wRcp = 1.0f/v->homogeneous[3];
+            v->homogeneous[3] = wRcp;
+
+            // Division of XYZ coordinates by weight
+            v->homogeneous[0] *= wRcp;
+            v->homogeneous[1] *= wRcp;
+            v->homogeneous[2] *= wRcp;
+
+            // Division of texture coordinates (perspective-correct)
+            v->texcoord[0] *= wRcp;
+            v->texcoord[1] *= wRcp;
+
+            // Division of colors (perspective-correct)
+            v->color[0] *= wRcp;
+            v->color[1] *= wRcp;
+            v->color[2] *= wRcp;
+            v->color[3] *= wRcp;
+
+            // Transformation to screen space
+            sw_project_ndc_to_screen(v->screen, v->homogeneous);
+        }
+    }
+}
+
+#define DEFINE_TRIANGLE_RASTER_SCANLINE(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_COLOR) \
+static inline void FUNC_NAME(const sw_texture_t *tex, const sw_vertex_t *start,     \
+                             const sw_vertex_t *end, float dUdy, float dVdy,        \
+                             int xMin, int xMax, float hizDepth)                    \
+{                                                                                   \
+    /* Gets the start and end coordinates */                                        \
+    int xStart = (int)start->screen[0];                                             \
+    int xEnd   = (int)end->screen[0];                                               \
+                                                                                    \
+    /* Avoid empty lines */                                                         \
+    if (xStart == xEnd) return;                                                     \
+                                                                                    \
+    /* Compute the subpixel distance to traverse before the first pixel */          \
+    float xSubstep = 1.0f - sw_fract(start->screen[0]);                             \
+                                                                                    \
+    /* Clamp the span to the raster bounds, skipping the clipped pixels */          \
+    if (xStart < xMin)                                                              \
+    {                                                                               \
+        xSubstep += (float)(xMin - xStart);                                         \
+        xStart = xMin;                                                              \
+    }                                                                               \
+    if (xEnd > xMax) xEnd = xMax;                                                   \
+    if (xStart >= xEnd) return;                                                     \
+                                                                                    \
+    /* Compute the inverse horizontal distance along the X axis */                  \
+    float dxRcp = 1.0f/(end->screen[0] - start->screen[0]);                         \
+                                                                                    \
+    /* Compute the interpolation steps along the X axis */                          \
+    float dZdx = (end->homogeneous[2] - start->homogeneous[2])*dxRcp;               \
+    float dWdx = (end->homogeneous[3] - start->homogeneous[3])*dxRcp;               \
+                                                                                    \
+    float dCdx[4] = {                                                               \
+        (end->color[0] - start->color[0])*dxRcp,                                    \
+        (end->color[1] - start->color[1])*dxRcp,                                    \
+        (end->color[2] - start->color[2])*dxRcp,                                    \
+        (end->color[3] - start->color[3])*dxRcp                                     \
+    };                                                                              \
+                                                                                    \
+    float dUdx = 0.0f;                                                              \
+    float dVdx = 0.0f;                                                              \
+    if (ENABLE_TEXTURE) {                                                           \
+        dUdx = (end->texcoord[0] - start->texcoord[0])*dxRcp;                       \
+        dVdx = (end->texcoord[1] - start->texcoord[1])*dxRcp;                       \
+    }                                                                               \
+                                                                                    \
+    /* Initializing the interpolation starting values  */                           \
+    float z = start->homogeneous[2] + dZdx*xSubstep;                                \
+    float w = start->homogeneous[3] + dWdx*xSubstep;                                \
+                                                                                    \
+    float color[4] = {                                                              \
+        start->color[0] + dCdx[0]*xSubstep,                                         \
+        start->color[1] + dCdx[1]*xSubstep,                                         \
+        start->color[2] + dCdx[2]*xSubstep,                                         \
+        start->color[3] + dCdx[3]*xSubstep                                          \
+    };                                                                              \
+                                                                                    \
+    float u = 0.0f;                                                                 \
+    float v = 0.0f;                                                                 \
+    if (ENABLE_TEXTURE) {                                                           \
+        u = start->texcoord[0] + dUdx*xSubstep;                                     \
+        v = start->texcoord[1] + dVdx*xSubstep;                                     \
+    }                                                                               \
+                                                                                    \
+    /* Pre-calculate the starting pointers for the framebuffer row */               \
+    int y = (int)start->screen[1];                                                  \
+    int offset = y*RLSW.framebuffer.stride + xStart;                                \
+    sw_color_t *cptr = RLSW.framebuffer.colorTarget + offset;                       \
+    sw_depth_t *dptr = RLSW.framebuffer.depth + offset;                             \
+                                                                                    \
+    const SWdepthfunc depthFunc = RLSW.depthFunc;                                   \
+    const bool depthMask = RLSW.depthMask;                                          \
+                                                                                    \
+    /* Scanline rasterization */                                                    \
+    for (int x = xStart; x < xEnd; x++)                                             \
+    {                                                                               \
+        if (ENABLE_DEPTH_TEST && (hizDepth > -INFINITY) && ((x == xStart) || ((x & (SW_HIZ_TILE_SIZE - 1)) == 0))) \
+        {                                                                           \
+            /* Skip the pixels of the tiles entirely behind the depth buffer */     \
+            int skipped = sw_hiz_hidden_run(hizDepth, x, y, xEnd);                  \
+            if (skipped > 0)                                                        \
+            {                                                                       \
+                float n = (float)skipped;                                           \
+                SW_STATS_ADD(pixelsDepthRejected, skipped);                         \
+                z += dZdx*n;                                                        \
+                w += dWdx*n;                                                        \
+                color[0] += dCdx[0]*n;                                              \
+                color[1] += dCdx[1]*n;                                              \
+                color[2] += dCdx[2]*n;                                              \
+                color[3] += dCdx[3]*n;                                              \
+                if (ENABLE_TEXTURE)                                                 \
+                {                                                                   \
+                    u += dUdx*n;                                                    \
+                    v += dVdx*n;                                                    \
+                }                                                                   \
+                cptr += skipped;                                                    \
+                dptr += skipped;                                                    \
+                x += skipped;                                                       \
+                if (x >= xEnd) break;                                               \
+            }                                                                       \
+        }                                                                           \
+                                                                                    \
+        if (ENABLE_DEPTH_TEST)                                                      \
+        {                                                                           \
+            float depth = sw_framebuffer_read_depth(dptr);                          \
+            if (!sw_depth_test(depthFunc, z, depth))                                \
+            {                                                                       \
+                SW_STATS_ADD(pixelsDepthRejected, 1);                               \
+                goto discard;                                                       \
+            }                                                                       \
+        }                                                                           \
+                                                                                    \
+        if (depthMask) sw_framebuffer_write_depth(dptr, z);                         \
+                                                                                    \
+        /* Depth only pass, no color to interpolate or sample */                    \
+        if (!ENABLE_COLOR) goto discard;                                            \
+                                                                                    \
+        /* Early depth test passed, the fragment can be shaded */                   \
+        float wRcp = 1.0f/w;                                                        \
+        float srcColor[4] = {                                                       \
+            color[0]*wRcp,                                                          \
+            color[1]*wRcp,                                                          \
+            color[2]*wRcp,                                                          \
+            color[3]*wRcp                                                           \
+        };                                                                          \
+                                                                                    \
+        if (ENABLE_TEXTURE)                                                         \
+        {                                                                           \
+            float texColor[4];                                                      \
+            float s = u*wRcp;                                                       \
+            float t = v*wRcp;                                                       \
+            /* Derivatives scaled by W approximate the perspective-correct ones */  \
+            sw_texture_sample(texColor, tex, s, t, dUdx*wRcp, dUdy*wRcp, dVdx*wRcp, dVdy*wRcp); \
+            srcColor[0] *= texColor[0];                                             \
+            srcColor[1] *= texColor[1];                                             \
+            srcColor[2] *= texColor[2];                                             \
+            srcColor[3] *= texColor[3];                                             \
+        }                                                                           \
+                                                                                    \
+        if (ENABLE_COLOR_BLEND)                                                     \
+        {                                                                           \
+            sw_framebuffer_blend_color(cptr, srcColor);                             \
+        }                                                                           \
+        else                                                                        \
+        {                                                                           \
+            sw_framebuffer_write_color(cptr, srcColor);                             \
+        }                                                                           \
+                                                                                    \
+        SW_STATS_ADD(pixelsShaded, 1);                                              \
+        if (ENABLE_COLOR_BLEND) SW_STATS_ADD(pixelsBlended, 1);                     \
+                                                                                    \
+        /* Increment the interpolation parameter, UVs, and pointers */              \
+    discard:                                                                        \
+        z += dZdx;                                                                  \
+        w += dWdx;                                                                  \
+        color[0] += dCdx[0];                                                        \
+        color[1] += dCdx[1];                                                        \
+        color[2] += dCdx[2];                                                        \
+        color[3] += dCdx[3];                                                        \
+        if (ENABLE_TEXTURE)                                                         \
+        {                                                                           \
+            u += dUdx;                                                              \
+            v += dVdx;                                                              \
+        }                                                                           \
+        ++cptr;                                                                     \
+        ++dptr;                                                                     \
+    }                                                                               \
+}
+
+#define DEFINE_TRIANGLE_RASTER(FUNC_NAME, FUNC_SCANLINE, ENABLE_TEXTURE, ENABLE_DEPTH_TEST) \
+static void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1,                 \
+                      const sw_vertex_t *v2, const sw_texture_t *tex,               \
+                      const int bounds[4])                                          \
+{                                                                                   \
+    /* Swap vertices by increasing y */                                             \
+    if (v0->screen[1] > v1->screen[1]) { const sw_vertex_t *tmp = v0; v0 = v1; v1 = tmp; } \
+    if (v1->screen[1] > v2->screen[1]) { const sw_vertex_t *tmp = v1; v1 = v2; v2 = tmp; } \
+    if (v0->screen[1] > v1->screen[1]) { const sw_vertex_t *tmp = v0; v0 = v1; v1 = tmp; } \
+                                                                                    \
+    /* Extracting coordinates from the sorted vertices */                           \
+    float x0 = v0->screen[0], y0 = v0->screen[1];                                   \
+    float x1 = v1->screen[0], y1 = v1->screen[1];                                   \
+    float x2 = v2->screen[0], y2 = v2->screen[1];                                   \
+                                                                                    \
+    /* Compute height differences */                                                \
+    float h02 = y2 - y0;                                                            \
+    float h01 = y1 - y0;                                                            \
+    float h12 = y2 - y1;                                                            \
+                                                                                    \
+    if (h02 < 1e-6f) return;                                                        \
+                                                                                    \
+    /* Coarse depth test and update over the bounding box */                        \
+    const sw_vertex_t *polygon[3] = { v0, v1, v2 };                                 \
+    int xBoxMin = sw_clampi((int)fminf(x0, fminf(x1, x2)), bounds[0], bounds[2]);   \
+    int xBoxMax = sw_clampi((int)fmaxf(x0, fmaxf(x1, x2)) + 1, bounds[0], bounds[2]); \
+    int yBoxMin = sw_clampi((int)y0, bounds[1], bounds[3]);                         \
+    int yBoxMax = sw_clampi((int)y2 + 1, bounds[1], bounds[3]);                     \
+    float hizDepth = 0.0f;                                                          \
+    if (!sw_hiz_begin_primitive(polygon, 3, xBoxMin, yBoxMin, xBoxMax, yBoxMax, ENABLE_DEPTH_TEST, &hizDepth)) return; \
+                                                                                    \
+    /* Precompute the inverse values without additional checks */                   \
+    float h02Rcp = 1.0f/h02;                                                        \
+    float h01Rcp = (h01 > 1e-6f)? 1.0f/h01 : 0.0f;                                  \
+    float h12Rcp = (h12 > 1e-6f)? 1.0f/h12 : 0.0f;                                  \
+                                                                                    \
+    /* Pre-calculation of slopes */                                                 \
+    float dXdy02 = (x2 - x0)*h02Rcp;                                                \
+    float dXdy01 = (x1 - x0)*h01Rcp;                                                \
+    float dXdy12 = (x2 - x1)*h12Rcp;                                                \
+                                                                                    \
+    /* Y subpixel correction */                                                     \
+    float y0Substep = 1.0f - sw_fract(y0);                                          \
+    float y1Substep = 1.0f - sw_fract(y1);                                          \
+                                                                                    \
+    /* Y bounds (vertical clipping) */                                              \
+    int yTop = (int)y0;                                                             \
+    int yMid = (int)y1;                                                             \
+    int yBot = (int)y2;                                                             \
+                                                                                    \
+    /* Compute gradients for each side of the triangle */                           \
+    sw_vertex_t dVXdy02, dVXdy01, dVXdy12;                                          \
+    sw_get_vertex_grad_PTCH(&dVXdy02, v0, v2, h02Rcp);                              \
+    sw_get_vertex_grad_PTCH(&dVXdy01, v0, v1, h01Rcp);                              \
+    sw_get_vertex_grad_PTCH(&dVXdy12, v1, v2, h12Rcp);                              \
+                                                                                    \
+    /* Rows range of each part of the triangle, clamped to the raster bounds */     \
+    int yUpperStart = (yTop > bounds[1])? yTop : bounds[1];                         \
+    int yUpperEnd = (yMid < bounds[3])? yMid : bounds[3];                           \
+    int yLowerStart = (yMid > bounds[1])? yMid : bounds[1];                         \
+    int yLowerEnd = (yBot < bounds[3])? yBot : bounds[3];                           \
+                                                                                    \
+    /* Get a copy of vertices for interpolation and apply substep correction */     \
+    /* NOTE: Rows skipped by the bounds are added to the substep */                 \
+    float yUpperSubstep = y0Substep + (float)(yUpperStart - yTop);                  \
+    sw_vertex_t vLeft = *v0, vRight = *v0;                                          \
+    sw_add_vertex_grad_scaled_PTCH(&vLeft, &dVXdy02, yUpperSubstep);                \
+    sw_add_vertex_grad_scaled_PTCH(&vRight, &dVXdy01, yUpperSubstep);               \
+                                                                                    \
+    vLeft.screen[0] += dXdy02*yUpperSubstep;                                        \
+    vRight.screen[0] += dXdy01*yUpperSubstep;                                       \
+                                                                                    \
+    /* Scanline for the upper part of the triangle */                               \
+    for (int y = yUpperStart; y < yUpperEnd; y++)                                   \
+    {                                                                               \
+        vLeft.screen[1] = vRight.screen[1] = y;                                     \
+                                                                                    \
+        if (vLeft.screen[0] < vRight.screen[0]) FUNC_SCANLINE(tex, &vLeft, &vRight, dVXdy02.texcoord[0], dVXdy02.texcoord[1], bounds[0], bounds[2], hizDepth); \
+        else FUNC_SCANLINE(tex, &vRight, &vLeft, dVXdy02.texcoord[0], dVXdy02.texcoord[1], bounds[0], bounds[2], hizDepth); \
+                                                                                    \
+        sw_add_vertex_grad_PTCH(&vLeft, &dVXdy02);                                  \
+        vLeft.screen[0] += dXdy02;                                                  \
+                                                                                    \
+        sw_add_vertex_grad_PTCH(&vRight, &dVXdy01);                                 \
+        vRight.screen[0] += dXdy01;                                                 \
+    }                                                                               \
+                                                                                    \
+    if (yLowerStart >= yLowerEnd) return;                                           \
+                                                                                    \
+    /* Restart the long edge if the upper part was not fully traversed */           \
+    if (yUpperEnd != yLowerStart)                                                   \
+    {                                                                               \
+        float yLeftSubstep = y0Substep + (float)(yLowerStart - yTop);               \
+        vLeft = *v0;                                                                \
+        sw_add_vertex_grad_scaled_PTCH(&vLeft, &dVXdy02, yLeftSubstep);             \
+        vLeft.screen[0] += dXdy02*yLeftSubstep;                                     \
+    }                                                                               \
+                                                                                    \
+    /* Get a copy of next right for interpolation and apply substep correction */   \
+    float yLowerSubstep = y1Substep + (float)(yLowerStart - yMid);                  \
+    vRight = *v1;                                                                   \
+    sw_add_vertex_grad_scaled_PTCH(&vRight, &dVXdy12, yLowerSubstep);               \
+    vRight.screen[0] += dXdy12*yLowerSubstep;                                       \
+                                                                                    \
+    /* Scanline for the lower part of the triangle */                               \
+    for (int y = yLowerStart; y < yLowerEnd; y++)                                   \
+    {                                                                               \
+        vLeft.screen[1] = vRight.screen[1] = y;                                     \
+                                                                                    \
+        if (vLeft.screen[0] < vRight.screen[0]) FUNC_SCANLINE(tex, &vLeft, &vRight, dVXdy02.texcoord[0], dVXdy02.texcoord[1], bounds[0], bounds[2], hizDepth); \
+        else FUNC_SCANLINE(tex, &vRight, &vLeft, dVXdy02.texcoord[0], dVXdy02.texcoord[1], bounds[0], bounds[2], hizDepth); \
+                                                                                    \
+        sw_add_vertex_grad_PTCH(&vLeft, &dVXdy02);                                  \
+        vLeft.screen[0] += dXdy02;                                                  \
+                                                                                    \
+        sw_add_vertex_grad_PTCH(&vRight, &dVXdy12);                                 \
+        vRight.screen[0] += dXdy12;                                                 \
+    }                                                                               \
+}
+
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline, 0, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX, 1, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH, 0, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_BLEND, 0, 0, 1, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH, 1, 1, 0, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_BLEND, 1, 0, 1, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH_BLEND, 0, 1, 1, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_TEX_DEPTH_BLEND, 1, 1, 1, 1)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_NOCOLOR, 0, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_SCANLINE(sw_triangle_raster_scanline_DEPTH_NOCOLOR, 0, 1, 0, 0)
+
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster, sw_triangle_raster_scanline, false, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX, sw_triangle_raster_scanline_TEX, true, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH, sw_triangle_raster_scanline_DEPTH, false, true)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_BLEND, sw_triangle_raster_scanline_BLEND, false, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH, sw_triangle_raster_scanline_TEX_DEPTH, true, true)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_BLEND, sw_triangle_raster_scanline_TEX_BLEND, true, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH_BLEND, sw_triangle_raster_scanline_DEPTH_BLEND, false, true)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_TEX_DEPTH_BLEND, sw_triangle_raster_scanline_TEX_DEPTH_BLEND, true, true)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_NOCOLOR, sw_triangle_raster_scanline_NOCOLOR, false, false)
+DEFINE_TRIANGLE_RASTER(sw_triangle_raster_DEPTH_NOCOLOR, sw_triangle_raster_scanline_DEPTH_NOCOLOR, false, true)
+
+// Half-space triangle rasterization
+//-------------------------------------------------------------------------------------------
+// NOTE: Vertices are snapped to a fixed-point subpixel grid and coverage is computed
+// with exact integer edge functions evaluated at pixel centers, 4 pixels at a time;
+// attributes are interpolated from their plane equations
+
+// Edge function state
+typedef struct {
+    int64_t value;      // Edge function value at the first pixel center of the row (fill rule bias applied)
+    int64_t stepX;      // Value increment per pixel along X
+    int64_t stepY;      // Value increment per row
+    int32_t lanes[4];   // Value offset of each pixel in a 4-pixel block
+} sw_edge_t;
+
+// Index of the first set bit of a 4-bit coverage mask (4 if empty)
+static const int8_t sw_mask_first_set[16] = { 4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0 };
+
+// Round a screen coordinate to the nearest subpixel (floor based, avoids libm call)
+// NOTE: The half pixel bias added on projection is removed, so pixel centers are at +0.5
+static inline int32_t sw_snap_subpixel(float v)
+{
+    float f = (v - 0.5f)*SW_SUBPIXEL_ONE + 0.5f;
+    int32_t i = (int32_t)f;
+    return i - (f < (float)i);
+}
+
+static inline void sw_edge_init(sw_edge_t *edge, int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t px, int32_t py)
+{
+    int64_t a = (int64_t)ay - by;
+    int64_t b = (int64_t)bx - ax;
+
+    // Top-left fill rule: pixel centers lying exactly on an edge
+    // are only covered if it is a top edge or a left edge
+    bool topLeft = (ay == by)? (bx > ax) : (by < ay);
+
+    edge->value = a*(px - ax) + b*(py - ay) - (topLeft? 0 : 1);
+    edge->stepX = a*SW_SUBPIXEL_ONE;
+    edge->stepY = b*SW_SUBPIXEL_ONE;
+
+    for (int i = 0; i < 4; i++) edge->lanes[i] = (int32_t)(i*edge->stepX);
+}
+
+// Get how many pixels a span limit can move to the left from one row to the next,
+// considering the left (stepX > 0) or right (stepX < 0) edges of the triangle
+static inline int sw_edge_row_slack(const sw_edge_t *edges, bool leftEdges, int maxSlack)
+{
+    float slack = 0.0f;
+
+    for (int i = 0; i < 3; i++)
+    {
+        if ((edges[i].stepX == 0) || ((edges[i].stepX > 0) != leftEdges)) continue;
+
+        float s = (float)edges[i].stepY/(float)edges[i].stepX;
+        if (s > slack) slack = s;
+    }
+
+    // NOTE: Two extra pixels account for the rounding of the span limits
+    return (slack < (float)maxSlack)? (int)slack + 2 : maxSlack + 2;
+}
+
+static inline int32_t sw_edge_saturate(int64_t value)
+{
+    // NOTE: Lane offsets are much smaller than 2^30, so saturating the
+    // edge value to this range keeps the sign of every lane unchanged
+    if (value > (1 << 30)) return (1 << 30);
+    if (value < -(1 << 30)) return -(1 << 30);
+    return (int32_t)value;
+}
+
+// Get the coverage mask of the 4-pixel block starting 'offset' pixels after the row start
+static inline int sw_edge_coverage_mask(const sw_edge_t *edges, int offset)
+{
+    int64_t v0 = edges[0].value + offset*edges[0].stepX;
+    int64_t v1 = edges[1].value + offset*edges[1].stepX;
+    int64_t v2 = edges[2].value + offset*edges[2].stepX;
+
+#if defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    __m128i w0 = _mm_add_epi32(_mm_set1_epi32(sw_edge_saturate(v0)), _mm_loadu_si128((const __m128i *)edges[0].lanes));
+    __m128i w1 = _mm_add_epi32(_mm_set1_epi32(sw_edge_saturate(v1)), _mm_loadu_si128((const __m128i *)edges[1].lanes));
+    __m128i w2 = _mm_add_epi32(_mm_set1_epi32(sw_edge_saturate(v2)), _mm_loadu_si128((const __m128i *)edges[2].lanes));
+    __m128i outside = _mm_or_si128(_mm_or_si128(w0, w1), w2);
+    return ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xF;
+#elif defined(SW_HAS_NEON) || defined(SW_HAS_NEON_FMA)
+    int32x4_t w0 = vaddq_s32(vdupq_n_s32(sw_edge_saturate(v0)), vld1q_s32(edges[0].lanes));
+    int32x4_t w1 = vaddq_s32(vdupq_n_s32(sw_edge_saturate(v1)), vld1q_s32(edges[1].lanes));
+    int32x4_t w2 = vaddq_s32(vdupq_n_s32(sw_edge_saturate(v2)), vld1q_s32(edges[2].lanes));
+    uint32x4_t outside = vshrq_n_u32(vreinterpretq_u32_s32(vorrq_s32(vorrq_s32(w0, w1), w2)), 31);
+    int mask = (int)vgetq_lane_u32(outside, 0) | ((int)vgetq_lane_u32(outside, 1) << 1) |
+               ((int)vgetq_lane_u32(outside, 2) << 2) | ((int)vgetq_lane_u32(outside, 3) << 3);
+    return ~mask & 0xF;
+#else
+    int mask = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        int64_t inside = (v0 + edges[0].lanes[i]) | (v1 + edges[1].lanes[i]) | (v2 + edges[2].lanes[i]);
+        mask |= (inside >= 0) << i;
+    }
+    return mask;
+#endif
+}
+
+// Sample positions relative to the pixel center, in 1/16 pixel (4x rotated grid)
+static const int8_t sw_msaa_sample_offsets[SW_MSAA_SAMPLES][2] = { { -2, -6 }, { 6, -2 }, { -6, 2 }, { 2, 6 } };
+
+// Setup the sample edges of a triangle and widen its edges to the pixels having any sample inside
+// NOTE: Sample edges get the offset of each sample as lanes, their value has to be set for each
+// row from the widened edge value minus its bias; also get the depth offset of each sample
+static inline void sw_msaa_init_edges(sw_edge_t edges[3], sw_edge_t sampleEdges[3], int64_t bias[3], float dZdx, float dZdy, float zOffset[SW_MSAA_SAMPLES])
+{
+    for (int i = 0; i < 3; i++)
+    {
+        int64_t a = edges[i].stepX/SW_SUBPIXEL_ONE;
+        int64_t b = edges[i].stepY/SW_SUBPIXEL_ONE;
+
+        sampleEdges[i] = edges[i];
+        bias[i] = 0;
+
+        for (int s = 0; s < SW_MSAA_SAMPLES; s++)
+        {
+            int64_t lane = (a*sw_msaa_sample_offsets[s][0] + b*sw_msaa_sample_offsets[s][1])*SW_SUBPIXEL_ONE/16;
+            sampleEdges[i].lanes[s] = (int32_t)lane;
+            if (lane > bias[i]) bias[i] = lane;
+        }
+
+        edges[i].value += bias[i];
+    }
+
+    for (int s = 0; s < SW_MSAA_SAMPLES; s++)
+    {
+        zOffset[s] = (dZdx*sw_msaa_sample_offsets[s][0] + dZdy*sw_msaa_sample_offsets[s][1])*(1.0f/16.0f);
+    }
+}
+
+// Depth test and write the covered samples of a pixel, returns the samples passing the test
+static inline int sw_msaa_depth_test(int coverage, int index, float z, const float zOffset[SW_MSAA_SAMPLES], bool depthTest, SWdepthfunc func, bool depthMask)
+{
+    sw_depth_t *const *planes = RLSW.framebuffer.msaa.depth;
+
+    for (int s = 0; s < SW_MSAA_SAMPLES; s++)
+    {
+        if (!(coverage & (1 << s))) continue;
+
+        float sampleZ = z + zOffset[s];
+        sw_depth_t *dptr = planes[s] + index;
+
+        if (depthTest && !sw_depth_test(func, sampleZ, sw_framebuffer_read_depth(dptr)))
+        {
+            coverage &= ~(1 << s);
+            continue;
+        }
+
+        if (depthMask) sw_framebuffer_write_depth(dptr, sampleZ);
+    }
+
+    return coverage;
+}
+
+// Write the color shaded for a pixel into its covered samples
+// NOTE: Samples holding the same color get the same blending result, which is the case
+// of most pixels away from the edges, so blending is only done once for them
+static inline void sw_msaa_write_color(int coverage, int index, const float src[4], bool blend)
+{
+    sw_color_t *const *planes = RLSW.framebuffer.msaa.color;
+    int first = sw_mask_first_set[coverage];
+    sw_color_t *dst = planes[first] + index;
+
+    bool uniform = true;
+    for (int s = first + 1; (s < SW_MSAA_SAMPLES) && uniform && blend; s++)
+    {
+        if (coverage & (1 << s)) uniform = (memcmp(planes[s] + index, dst, sizeof(sw_color_t)) == 0);
+    }
+
+    if (!uniform)
+    {
+        for (int s = first; s < SW_MSAA_SAMPLES; s++)
+        {
+            if (coverage & (1 << s)) sw_framebuffer_blend_color(planes[s] + index, src);
+        }
+        return;
+    }
+
+    if (blend) sw_framebuffer_blend_color(dst, src);
+    else sw_framebuffer_write_color(dst, src);
+
+    for (int s = first + 1; s < SW_MSAA_SAMPLES; s++)
+    {
+        if (coverage & (1 << s)) planes[s][index] = *dst;
+    }
+}
+
+// Copy the first sample of a pixel written without multisampling (lines, points) into the others
+static inline void sw_msaa_replicate_pixel(int index)
+{
+    sw_msaa_t *msaa = &RLSW.framebuffer.msaa;
+
+    for (int s = 1; s < SW_MSAA_SAMPLES; s++)
+    {
+        msaa->color[s][index] = msaa->color[0][index];
+        if (RLSW.depthMask) msaa->depth[s][index] = msaa->depth[0][index];
+    }
+}
+
+#define DEFINE_TRIANGLE_RASTER_HALF_SPACE(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_COLOR, ENABLE_MSAA) \
+static void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1,                 \
+                      const sw_vertex_t *v2, const sw_texture_t *tex,               \
+                      const int bounds[4])                                          \
+{                                                                                   \
+    /* Snap the vertices to the subpixel grid */                                    \
+    int32_t fx0 = sw_snap_subpixel(v0->screen[0]), fy0 = sw_snap_subpixel(v0->screen[1]); \
+    int32_t fx1 = sw_snap_subpixel(v1->screen[0]), fy1 = sw_snap_subpixel(v1->screen[1]); \
+    int32_t fx2 = sw_snap_subpixel(v2->screen[0]), fy2 = sw_snap_subpixel(v2->screen[1]); \
+                                                                                    \
+    /* Twice the signed area, used to get a consistent winding */                   \
+    int64_t area = (int64_t)(fx1 - fx0)*(fy2 - fy0) - (int64_t)(fx2 - fx0)*(fy1 - fy0); \
+    if (area == 0) return;                                                          \
+    if (area < 0)                                                                   \
+    {                                                                               \
+        const sw_vertex_t *tmp = v1; v1 = v2; v2 = tmp;                             \
+        int32_t t = fx1; fx1 = fx2; fx2 = t;                                        \
+        t = fy1; fy1 = fy2; fy2 = t;                                                \
+    }                                                                               \
+                                                                                    \
+    /* Bounding box in pixels, clamped to the raster bounds */                      \
+    int xMin = sw_clampi(sw_mini(fx0, sw_mini(fx1, fx2)) >> SW_HALF_SPACE_SUBPIXEL_BITS, bounds[0], bounds[2]); \
+    int yMin = sw_clampi(sw_mini(fy0, sw_mini(fy1, fy2)) >> SW_HALF_SPACE_SUBPIXEL_BITS, bounds[1], bounds[3]); \
+    int xMax = sw_clampi((sw_maxi(fx0, sw_maxi(fx1, fx2)) >> SW_HALF_SPACE_SUBPIXEL_BITS) + 1, bounds[0], bounds[2]); \
+    int yMax = sw_clampi((sw_maxi(fy0, sw_maxi(fy1, fy2)) >> SW_HALF_SPACE_SUBPIXEL_BITS) + 1, bounds[1], bounds[3]); \
+    if ((xMin >= xMax) || (yMin >= yMax)) return;                                   \
+                                                                                    \
+    /* Coarse depth test and update over the bounding box */                        \
+    const sw_vertex_t *polygon[3] = { v0, v1, v2 };                                 \
+    float hizDepth = 0.0f;                                                          \
+    if (!sw_hiz_begin_primitive(polygon, 3, xMin, yMin, xMax, yMax, ENABLE_DEPTH_TEST, &hizDepth)) return; \
+                                                                                    \
+    /* Edge functions evaluated at the center of the first pixel */                 \
+    int32_t px = (xMin << SW_HALF_SPACE_SUBPIXEL_BITS) + (SW_SUBPIXEL_ONE >> 1);    \
+    int32_t py = (yMin << SW_HALF_SPACE_SUBPIXEL_BITS) + (SW_SUBPIXEL_ONE >> 1);    \
+    sw_edge_t edges[3];                                                             \
+    sw_edge_init(&edges[0], fx1, fy1, fx2, fy2, px, py);                            \
+    sw_edge_init(&edges[1], fx2, fy2, fx0, fy0, px, py);                            \
+    sw_edge_init(&edges[2], fx0, fy0, fx1, fy1, px, py);                            \
+                                                                                    \
+    int slackLeft = sw_edge_row_slack(edges, true, xMax - xMin);                    \
+    int slackRight = sw_edge_row_slack(edges, false, xMax - xMin);                  \
+                                                                                    \
+    /* Attributes plane equations, computed from the snapped positions */           \
+    const float subRcp = 1.0f/SW_SUBPIXEL_ONE;                                      \
+    float dx1 = (fx1 - fx0)*subRcp, dy1 = (fy1 - fy0)*subRcp;                       \
+    float dx2 = (fx2 - fx0)*subRcp, dy2 = (fy2 - fy0)*subRcp;                       \
+    float areaRcp = 1.0f/(dx1*dy2 - dx2*dy1);                                       \
+    float gx1 = dy2*areaRcp, gx2 = -dy1*areaRcp;                                    \
+    float gy1 = -dx2*areaRcp, gy2 = dx1*areaRcp;                                    \
+                                                                                    \
+    /* Z, 1/W, RGBA and UV (divided by W) are all linear in screen space */         \
+    const float a0[8] = {                                                           \
+        v0->homogeneous[2], v0->homogeneous[3], v0->color[0], v0->color[1],         \
+        v0->color[2], v0->color[3], v0->texcoord[0], v0->texcoord[1]                \
+    };                                                                              \
+    const float a1[8] = {                                                           \
+        v1->homogeneous[2], v1->homogeneous[3], v1->color[0], v1->color[1],         \
+        v1->color[2], v1->color[3], v1->texcoord[0], v1->texcoord[1]                \
+    };                                                                              \
+    const float a2[8] = {                                                           \
+        v2->homogeneous[2], v2->homogeneous[3], v2->color[0], v2->color[1],         \
+        v2->color[2], v2->color[3], v2->texcoord[0], v2->texcoord[1]                \
+    };                                                                              \
+                                                                                    \
+    /* Gradients and values at the center of the first pixel of the bounding box */ \
+    float cx = (float)xMin + 0.5f - fx0*subRcp;                                     \
+    float cy = (float)yMin + 0.5f - fy0*subRcp;                                     \
+    float dAdx[8], dAdy[8], row[8];                                                 \
+    for (int i = 0; i < 8; i++)                                                     \
+    {                                                                               \
+        float d1 = a1[i] - a0[i];                                                   \
+        float d2 = a2[i] - a0[i];                                                   \
+        dAdx[i] = d1*gx1 + d2*gx2;                                                  \
+        dAdy[i] = d1*gy1 + d2*gy2;                                                  \
+        row[i] = a0[i] + dAdx[i]*cx + dAdy[i]*cy;                                   \
+    }                                                                               \
+                                                                                    \
+    const float dZdx = dAdx[0];                                                     \
+    const float dWdx = dAdx[1];                                                     \
+    const float dCdx[4] = { dAdx[2], dAdx[3], dAdx[4], dAdx[5] };                   \
+    const float dUdx = dAdx[6], dUdy = dAdy[6];                                     \
+    const float dTdx = dAdx[7], dTdy = dAdy[7];                                     \
+                                                                                    \
+    /* Multisampling: spans cover the pixels having any sample inside the */        \
+    /* triangle, the samples covered are given by the sample edges */               \
+    sw_edge_t sampleEdges[3];                                                       \
+    int64_t sampleBias[3] = { 0 };                                                  \
+    float zOffset[SW_MSAA_SAMPLES] = { 0 };                                         \
+    if (ENABLE_MSAA) sw_msaa_init_edges(edges, sampleEdges, sampleBias, dZdx, dAdy[0], zOffset); \
+                                                                                    \
+    /* Flat shaded triangles (same color on all vertices and 1x1 texture if any) */ \
+    /* get a constant source color, skipping the per-pixel division and sampling */ \
+    float flatColor[4] = { 0 };                                                     \
+    bool isFlat = ENABLE_COLOR && (!ENABLE_TEXTURE || ((tex->levels[0].width == 1) && (tex->levels[0].height == 1))); \
+    for (int i = 0; (i < 4) && isFlat; i++)                                         \
+    {                                                                               \
+        flatColor[i] = v0->color[i]/v0->homogeneous[3];                             \
+        isFlat = (fabsf(v1->color[i]/v1->homogeneous[3] - flatColor[i]) < 1e-5f) && \
+                 (fabsf(v2->color[i]/v2->homogeneous[3] - flatColor[i]) < 1e-5f);   \
+    }                                                                               \
+    if (isFlat && ENABLE_TEXTURE)                                                   \
+    {                                                                               \
+        float texColor[4];                                                          \
+        sw_texture_sample(texColor, tex, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);       \
+        for (int i = 0; i < 4; i++) flatColor[i] *= texColor[i];                    \
+    }                                                                               \
+                                                                                    \
+    const SWdepthfunc depthFunc = RLSW.depthFunc;                                   \
+    const bool depthMask = RLSW.depthMask;                                          \
+                                                                                    \
+    /* Covered span of the previous row, used as a starting point to find the next one */ \
+    int xPrevStart = 0, xPrevEnd = 0;                                               \
+                                                                                    \
+    for (int y = yMin; y < yMax; y++)                                               \
+    {                                                                               \
+        /* NOTE: Triangles are convex, so covered pixels of a row are contiguous */ \
+        /* and each span limit moves at most by the slack of its edges per row */   \
+        int xStart = xMax, xEnd = xMax;                                             \
+        bool hasPrev = (xPrevStart < xPrevEnd);                                     \
+                                                                                    \
+        /* Find the first covered pixel */                                          \
+        int xFrom = hasPrev? sw_maxi(xPrevStart - slackLeft, xMin) : xMin;          \
+        for (int x = xMin + ((xFrom - xMin) & ~3); x < xMax; x += 4)                \
+        {                                                                           \
+            int mask = sw_edge_coverage_mask(edges, x - xMin);                      \
+            if (xMax - x < 4) mask &= (1 << (xMax - x)) - 1;                        \
+                                                                                    \
+            if (mask != 0)                                                          \
+            {                                                                       \
+                xStart = x + sw_mask_first_set[mask];                               \
+                break;                                                              \
+            }                                                                       \
+        }                                                                           \
+                                                                                    \
+        /* Find the end of the span, pixels before the previous end minus the slack are covered */ \
+        if (xStart < xMax)                                                          \
+        {                                                                           \
+            xFrom = hasPrev? sw_maxi(xPrevEnd - slackRight, xStart) : xStart;       \
+            for (int x = xMin + ((xFrom - xMin) & ~3); x < xMax; x += 4)            \
+            {                                                                       \
+                int mask = sw_edge_coverage_mask(edges, x - xMin);                  \
+                if (xMax - x < 4) mask &= (1 << (xMax - x)) - 1;                    \
+                mask |= (1 << sw_clampi(xFrom - x, 0, 4)) - 1;                      \
+                                                                                    \
+                if (mask != 0xF)                                                    \
+                {                                                                   \
+                    xEnd = x + sw_mask_first_set[~mask & 0xF];                      \
+                    break;                                                          \
+                }                                                                   \
+            }                                                                       \
+        }                                                                           \
+                                                                                    \
+        xPrevStart = xStart;                                                        \
+        xPrevEnd = xEnd;                                                            \
+                                                                                    \
+        if (ENABLE_MSAA)                                                            \
+        {                                                                           \
+            for (int i = 0; i < 3; i++) sampleEdges[i].value = edges[i].value - sampleBias[i]; \
+        }                                                                           \
+        for (int i = 0; i < 3; i++) edges[i].value += edges[i].stepY;               \
+                                                                                    \
+        if (xStart >= xEnd)                                                         \
+        {                                                                           \
+            for (int i = 0; i < 8; i++) row[i] += dAdy[i];                          \
+            continue;                                                               \
+        }                                                                           \
+                                                                                    \
+        /* Attributes at the center of the first covered pixel */                   \
+        float offset = (float)(xStart - xMin);                                      \
+        float z = row[0] + dZdx*offset;                                             \
+        float w = row[1] + dWdx*offset;                                             \
+        float color[4] = {                                                          \
+            row[2] + dCdx[0]*offset,                                                \
+            row[3] + dCdx[1]*offset,                                                \
+            row[4] + dCdx[2]*offset,                                                \
+            row[5] + dCdx[3]*offset                                                 \
+        };                                                                          \
+        float u = row[6] + dUdx*offset;                                             \
+        float v = row[7] + dTdx*offset;                                             \
+        for (int i = 0; i < 8; i++) row[i] += dAdy[i];                              \
+                                                                                    \
+        int pixelIndex = y*RLSW.framebuffer.stride + xStart;                        \
+        sw_color_t *cptr = RLSW.framebuffer.colorTarget + pixelIndex;               \
+        sw_depth_t *dptr = RLSW.framebuffer.depth + pixelIndex;                     \
+                                                                                    \
+        for (int x = xStart; x < xEnd; x++, cptr++, dptr++)                         \
+        {                                                                           \
+            if (ENABLE_DEPTH_TEST && (hizDepth > -INFINITY) && ((x == xStart) || ((x & (SW_HIZ_TILE_SIZE - 1)) == 0))) \
+            {                                                                       \
+                /* Skip the pixels of the tiles entirely behind the depth buffer */ \
+                int skipped = sw_hiz_hidden_run(hizDepth, x, y, xEnd);              \
+                if (skipped > 0)                                                    \
+                {                                                                   \
+                    float n = (float)skipped;                                       \
+                    SW_STATS_ADD(pixelsDepthRejected, skipped);                     \
+                    z += dZdx*n;                                                    \
+                    w += dWdx*n;                                                    \
+                    color[0] += dCdx[0]*n;                                          \
+                    color[1] += dCdx[1]*n;                                          \
+                    color[2] += dCdx[2]*n;                                          \
+                    color[3] += dCdx[3]*n;                                          \
+                    if (ENABLE_TEXTURE)                                             \
+                    {                                                               \
+                        u += dUdx*n;                                                \
+                        v += dTdx*n;                                                \
+                    }                                                               \
+                    cptr += skipped;                                                \
+                    dptr += skipped;                                                \
+                    x += skipped;                                                   \
+                    if (x >= xEnd) break;                                           \
+                }                                                                   \
+            }                                                                       \
+                                                                                    \
+            int coverage = 0xF;                                                     \
+            if (ENABLE_MSAA)                                                        \
+            {                                                                       \
+                coverage = sw_edge_coverage_mask(sampleEdges, x - xMin);            \
+                if (coverage == 0) goto discard;                                    \
+                                                                                    \
+                coverage = sw_msaa_depth_test(coverage, (int)(dptr - RLSW.framebuffer.depth), z, zOffset, ENABLE_DEPTH_TEST, depthFunc, depthMask); \
+                if (coverage == 0)                                                  \
+                {                                                                   \
+                    SW_STATS_ADD(pixelsDepthRejected, 1);                           \
+                    goto discard;                                                   \
+                }                                                                   \
+            }                                                                       \
+            else                                                                    \
+            {                                                                       \
+                if (ENABLE_DEPTH_TEST)                                              \
+                {                                                                   \
+                    float depth = sw_framebuffer_read_depth(dptr);                  \
+                    if (!sw_depth_test(depthFunc, z, depth))                        \
+                    {                                                               \
+                        SW_STATS_ADD(pixelsDepthRejected, 1);                       \
+                        goto discard;                                               \
+                    }                                                               \
+                }                                                                   \
+                                                                                    \
+                if (depthMask) sw_framebuffer_write_depth(dptr, z);                 \
+            }                                                                       \
+                                                                                    \
+            if (!ENABLE_COLOR) goto discard;                                        \
+                                                                                    \
+            float srcColor[4] = { flatColor[0], flatColor[1], flatColor[2], flatColor[3] }; \
+                                                                                    \
+            if (!isFlat)                                                            \
+            {                                                                       \
+                float wRcp = 1.0f/w;                                                \
+                srcColor[0] = color[0]*wRcp;                                        \
+                srcColor[1] = color[1]*wRcp;                                        \
+                srcColor[2] = color[2]*wRcp;                                        \
+                srcColor[3] = color[3]*wRcp;                                        \
+                                                                                    \
+                if (ENABLE_TEXTURE)                                                 \
+                {                                                                   \
+                    float texColor[4];                                              \
+                    sw_texture_sample(texColor, tex, u*wRcp, v*wRcp, dUdx*wRcp, dUdy*wRcp, dTdx*wRcp, dTdy*wRcp); \
+                    srcColor[0] *= texColor[0];                                     \
+                    srcColor[1] *= texColor[1];                                     \
+                    srcColor[2] *= texColor[2];                                     \
+                    srcColor[3] *= texColor[3];                                     \
+                }                                                                   \
+            }                                                                       \
+                                                                                    \
+            if (ENABLE_MSAA)                                                        \
+            {                                                                       \
+                sw_msaa_write_color(coverage, (int)(dptr - RLSW.framebuffer.depth), srcColor, ENABLE_COLOR_BLEND); \
+            }                                                                       \
+            else if (ENABLE_COLOR_BLEND)                                            \
+            {                                                                       \
+                sw_framebuffer_blend_color(cptr, srcColor);                         \
+            }                                                                       \
+            else                                                                    \
+            {                                                                       \
+                sw_framebuffer_write_color(cptr, srcColor);                         \
+            }                                                                       \
+                                                                                    \
+            SW_STATS_ADD(pixelsShaded, 1);                                          \
+            if (ENABLE_COLOR_BLEND) SW_STATS_ADD(pixelsBlended, 1);                 \
+                                                                                    \
+        discard:                                                                    \
+            z += dZdx;                                                              \
+            w += dWdx;                                                              \
+            color[0] += dCdx[0];                                                    \
+            color[1] += dCdx[1];                                                    \
+            color[2] += dCdx[2];                                                    \
+            color[3] += dCdx[3];                                                    \
+            if (ENABLE_TEXTURE)                                                     \
+            {                                                                       \
+                u += dUdx;                                                          \
+                v += dTdx;                                                          \
+            }                                                                       \
+        }                                                                           \
+    }                                                                               \
+}
+
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs, 0, 0, 0, 1, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_TEX, 1, 0, 0, 1, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_DEPTH, 0, 1, 0, 1, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_BLEND, 0, 0, 1, 1, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_TEX_DEPTH, 1, 1, 0, 1, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_TEX_BLEND, 1, 0, 1, 1, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_DEPTH_BLEND, 0, 1, 1, 1, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_TEX_DEPTH_BLEND, 1, 1, 1, 1, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_NOCOLOR, 0, 0, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_DEPTH_NOCOLOR, 0, 1, 0, 0, 0)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA, 0, 0, 0, 1, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_TEX, 1, 0, 0, 1, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_DEPTH, 0, 1, 0, 1, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_BLEND, 0, 0, 1, 1, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_TEX_DEPTH, 1, 1, 0, 1, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_TEX_BLEND, 1, 0, 1, 1, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_DEPTH_BLEND, 0, 1, 1, 1, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_TEX_DEPTH_BLEND, 1, 1, 1, 1, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_NOCOLOR, 0, 0, 0, 0, 1)
+DEFINE_TRIANGLE_RASTER_HALF_SPACE(sw_triangle_raster_hs_MSAA_DEPTH_NOCOLOR, 0, 1, 0, 0, 1)
+//-------------------------------------------------------------------------------------------
+
+// Get the rasterization state, removing the features that would have no effect
+static inline uint32_t sw_get_raster_state(void)
+{
+    uint32_t state = RLSW.stateFlags;
+    if (RLSW.currentTexture == 0) state &= ~SW_STATE_TEXTURE_2D;
+    if ((RLSW.srcFactor == SW_ONE) && (RLSW.dstFactor == SW_ZERO)) state &= ~SW_STATE_BLEND;
+
+    // Without color writes only the depth is rasterized, with some channels masked
+    // the blending variants are used as they read the destination color
+    if (RLSW.colorMask == 0) state = (state & ~(SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) | SW_STATE_NO_COLOR;
+    else if (RLSW.colorMask != SW_COLOR_MASK_ALL) state |= SW_STATE_BLEND;
+
+    return state;
+}
+
+static inline sw_raster_triangle_f sw_triangle_get_raster_func(uint32_t state)
+{
+    // NOTE: Multisampling is only implemented by the half-space rasterizer
+    if (SW_STATE_CHECK_EX(state, SW_STATE_MULTISAMPLE))
+    {
+        if (SW_STATE_CHECK_EX(state, SW_STATE_NO_COLOR)) return SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)? sw_triangle_raster_hs_MSAA_DEPTH_NOCOLOR : sw_triangle_raster_hs_MSAA_NOCOLOR;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) return sw_triangle_raster_hs_MSAA_TEX_DEPTH_BLEND;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) return sw_triangle_raster_hs_MSAA_DEPTH_BLEND;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) return sw_triangle_raster_hs_MSAA_TEX_BLEND;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) return sw_triangle_raster_hs_MSAA_TEX_DEPTH;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) return sw_triangle_raster_hs_MSAA_BLEND;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) return sw_triangle_raster_hs_MSAA_DEPTH;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) return sw_triangle_raster_hs_MSAA_TEX;
+
+        return sw_triangle_raster_hs_MSAA;
+    }
+
+    if (SW_STATE_CHECK_EX(state, SW_STATE_HALF_SPACE))
+    {
+        if (SW_STATE_CHECK_EX(state, SW_STATE_NO_COLOR)) return SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)? sw_triangle_raster_hs_DEPTH_NOCOLOR : sw_triangle_raster_hs_NOCOLOR;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) return sw_triangle_raster_hs_TEX_DEPTH_BLEND;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) return sw_triangle_raster_hs_DEPTH_BLEND;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) return sw_triangle_raster_hs_TEX_BLEND;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) return sw_triangle_raster_hs_TEX_DEPTH;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) return sw_triangle_raster_hs_BLEND;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) return sw_triangle_raster_hs_DEPTH;
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) return sw_triangle_raster_hs_TEX;
+
+        return sw_triangle_raster_hs;
+    }
+
+    if (SW_STATE_CHECK_EX(state, SW_STATE_NO_COLOR)) return SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)? sw_triangle_raster_DEPTH_NOCOLOR : sw_triangle_raster_NOCOLOR;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) return sw_triangle_raster_TEX_DEPTH_BLEND;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) return sw_triangle_raster_DEPTH_BLEND;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) return sw_triangle_raster_TEX_BLEND;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) return sw_triangle_raster_TEX_DEPTH;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) return sw_triangle_raster_BLEND;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) return sw_triangle_raster_DEPTH;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) return sw_triangle_raster_TEX;
+
+    return sw_triangle_raster;
+}
+
+// Rasterize the clipped polygon stored in the vertex buffer as a triangle fan
+static inline void sw_triangle_fan_render(void)
+{
+#if defined(SW_HAS_DEFERRED)
+    if (RLSW.deferred.enabled)
+    {
+        for (int i = 0; i < RLSW.vertexCounter - 2; i++)
+        {
+            sw_deferred_push_triangle(&RLSW.vertexBuffer[0], &RLSW.vertexBuffer[i + 1], &RLSW.vertexBuffer[i + 2]);
+        }
+        return;
+    }
+#endif
+
+    const sw_raster_triangle_f func = RLSW.rasterState.triangle;
+    const sw_texture_t *tex = RLSW.rasterState.tex;
+    const int bounds[4] = { 0, 0, RLSW.framebuffer.width, RLSW.framebuffer.height };
+
+    for (int i = 0; i < RLSW.vertexCounter - 2; i++)
+    {
+        func(&RLSW.vertexBuffer[0], &RLSW.vertexBuffer[i + 1], &RLSW.vertexBuffer[i + 2], tex, bounds);
+    }
+}
+
+static inline void sw_triangle_render(void)
+{
+    if (RLSW.stateFlags & SW_STATE_CULL_FACE)
+    {
+        if (!sw_triangle_face_culling())
+        {
+            SW_STATS_ADD(primitivesCulled, 1);
+            return;
+        }
+    }
+
+    sw_triangle_clip_and_project();
+
+    if (RLSW.vertexCounter < 3)
+    {
+        SW_STATS_ADD(primitivesClipped, 1);
+        return;
+    }
+
+    sw_framebuffer_mark_dirty_polygon();
+    sw_triangle_fan_render();
+}
+//-------------------------------------------------------------------------------------------
+
+// Quad rendering logic
+//-------------------------------------------------------------------------------------------
+static inline bool sw_quad_face_culling(void)
+{
+    // NOTE: Face culling is done before clipping to avoid unnecessary computations
+    //       To handle quads crossing the w=0 plane correctly,
+    //       we perform the winding order test in homogeneous coordinates directly,
+    //       before the perspective division (division by w)
+    //       For a convex quad with vertices P0, P1, P2, P3 in sequential order,
+    //       the winding order of the quad is the same as the winding order
+    //       of the triangle P0 P1 P2. We use the homogeneous triangle
+    //       winding test on this first triangle
+
+    // Preload homogeneous coordinates into local variables
+    const float *h0 = RLSW.vertexBuffer[0].homogeneous;
+    const float *h1 = RLSW.vertexBuffer[1].homogeneous;
+    const float *h2 = RLSW.vertexBuffer[2].homogeneous;
+
+    // NOTE: h3 is not needed for this test
+    // const float *h3 = RLSW.vertexBuffer[3].homogeneous;
+
+    // Compute a value proportional to the signed area of the triangle P0 P1 P2
+    // in the projected 2D plane, calculated directly using homogeneous coordinates
+    // BEFORE division by w
+    // This is the determinant of the matrix formed by the (x, y, w) components
+    // of the vertices P0, P1, and P2. Its sign correctly indicates the winding order
+    // in homogeneous space and its relationship to the projected 2D winding order,
+    // even with negative w values
+    // The determinant formula used here is:
+    // h0.x*(h1.y*h2.w - h2.y*h1.w) +
+    // h1.x*(h2.y*h0.w - h0.y*h2.w) +
+    // h2.x*(h0.y*h1.w - h1.y*h0.w)
+
+    const float hSgnArea =
+        h0[0]*(h1[1]*h2[3] - h2[1]*h1[3]) +
+        h1[0]*(h2[1]*h0[3] - h0[1]*h2[3]) +
+        h2[0]*(h0[1]*h1[3] - h1[1]*h0[3]);
+
+    // Perform face culling based on the winding order determined by the sign
+    // of the homogeneous area/determinant of triangle P0 P1 P2
+    // This test is robust for points with w > 0 or w < 0 within the triangle,
+    // correctly capturing the change in orientation when crossing the w=0 plane
+
+    // A positive hSgnArea typically corresponds to a counter-clockwise
+    // winding in the projected space when all w > 0
+    // A value of 0 for hSgnArea means P0, P1, P2 are collinear in (x, y, w)
+    // space, which corresponds to a degenerate triangle projection
+    // Such quads might also be degenerate or non-planar. They are typically
+    // not culled by this test (0 < 0 is false, 0 > 0 is false)
+    // and should be handled by the clipper if necessary
+
+    return (RLSW.cullFace == SW_FRONT)? (hSgnArea < 0.0f) : (hSgnArea > 0.0f); // Cull if winding is "clockwise" : "counter-clockwise"
+}
+
+static inline void sw_quad_clip_and_project(void)
+{
+    sw_vertex_t *polygon = RLSW.vertexBuffer;
+    int *vertexCounter = &RLSW.vertexCounter;
+
+    if (sw_polygon_clip(polygon, vertexCounter))
+    {
+        // Transformation to screen space and normalization
+        for (int i = 0; i < *vertexCounter; i++)
+        {
+            sw_vertex_t *v = &polygon[i];
+
+            // Calculation of the reciprocal of W for normalization
+            // as well as perspective-correct attributes
+            const float wRcp = 1.0f/v->homogeneous[3];
+            v->homogeneous[3] = wRcp;
+
+            // Division of XYZ coordinates by weight
+            v->homogeneous[0] *= wRcp;
+            v->homogeneous[1] *= wRcp;
+            v->homogeneous[2] *= wRcp;
+
+            // Division of texture coordinates (perspective-correct)
+            v->texcoord[0] *= wRcp;
+            v->texcoord[1] *= wRcp;
+
+            // Division of colors (perspective-correct)
+            v->color[0] *= wRcp;
+            v->color[1] *= wRcp;
+            v->color[2] *= wRcp;
+            v->color[3] *= wRcp;
+
+            // Transformation to screen space
+            sw_project_ndc_to_screen(v->screen, v->homogeneous);
+        }
+    }
+}
+
+static inline bool sw_quad_is_axis_aligned(void)
+{
+    // Reject quads with perspective projection
+    // The fast path assumes affine (non-perspective) quads,
+    // so we require all vertices to have homogeneous w = 1.0
+    for (int i = 0; i < 4; i++)
+    {
+        if (RLSW.vertexBuffer[i].homogeneous[3] != 1.0f) return false;
+    }
+
+    // Epsilon tolerance in screen space (pixels)
+    const float epsilon = 0.5f;
+
+    // Fetch screen-space positions for the four quad vertices
+    const float *p0 = RLSW.vertexBuffer[0].screen;
+    const float *p1 = RLSW.vertexBuffer[1].screen;
+    const float *p2 = RLSW.vertexBuffer[2].screen;
+    const float *p3 = RLSW.vertexBuffer[3].screen;
+
+    // Compute edge vectors between consecutive vertices
+    // These define the four sides of the quad in screen space
+    float dx01 = p1[0] - p0[0], dy01 = p1[1] - p0[1];
+    float dx12 = p2[0] - p1[0], dy12 = p2[1] - p1[1];
+    float dx23 = p3[0] - p2[0], dy23 = p3[1] - p2[1];
+    float dx30 = p0[0] - p3[0], dy30 = p0[1] - p3[1];
+
+    // Each edge must be either horizontal or vertical within epsilon tolerance
+    // If any edge deviates significantly from either axis, the quad is not axis-aligned
+    if (!((fabsf(dy01) < epsilon) || (fabsf(dx01) < epsilon))) return false;
+    if (!((fabsf(dy12) < epsilon) || (fabsf(dx12) < epsilon))) return false;
+    if (!((fabsf(dy23) < epsilon) || (fabsf(dx23) < epsilon))) return false;
+    if (!((fabsf(dy30) < epsilon) || (fabsf(dx30) < epsilon))) return false;
+
+    return true;
+}
+
+static inline void sw_quad_sort_cw(const sw_vertex_t* *output, const sw_vertex_t *input)
+{
+
+    // Calculate the centroid of the quad
+    float cx = (input[0].screen[0] + input[1].screen[0] +
+                input[2].screen[0] + input[3].screen[0])*0.25f;
+    float cy = (input[0].screen[1] + input[1].screen[1] +
+                input[2].screen[1] + input[3].screen[1])*0.25f;
+
+    // Calculate the angle of each vertex relative to the center
+    // and assign them directly to their correct position
+    const sw_vertex_t *corners[4] = { 0 };
+
+    for (int i = 0; i < 4; i++)
+    {
+        float dx = input[i].screen[0] - cx;
+        float dy = input[i].screen[1] - cy;
+
+        // Determine the quadrant (clockwise from top-left)
+        // top-left: dx < 0, dy < 0
+        // top-right: dx >= 0, dy < 0
+        // bottom-right: dx >= 0, dy >= 0
+        // bottom-left: dx < 0, dy >= 0
+
+        int idx;
+        if (dy < 0) idx = (dx < 0)? 0 : 1; // Top row
+        else idx = (dx < 0)? 3 : 2; // Bottom row
+
+        corners[idx] = &input[i];
+    }
+
+    output[0] = corners[0];  // top-left
+    output[1] = corners[1];  // top-right
+    output[2] = corners[2];  // bottom-right
+    output[3] = corners[3];  // bottom-left
+}
+
+// TODO: REVIEW: Could a perfectly aligned quad, where one of the four points has a different depth,
+// still appear perfectly aligned from a certain point of view?
+// Because in that case, we would still need to perform perspective division for textures and colors...
+#define DEFINE_QUAD_RASTER_AXIS_ALIGNED(FUNC_NAME, ENABLE_TEXTURE, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, ENABLE_COLOR) \
+static void FUNC_NAME(const sw_vertex_t *vertices, const sw_texture_t *tex,    \
+                      const int bounds[4])                                      \
+{                                                                               \
+    const sw_vertex_t *sortedVerts[4];                                          \
+    sw_quad_sort_cw(sortedVerts, vertices);                                     \
+                                                                                \
+    const sw_vertex_t *v0 = sortedVerts[0];                                     \
+    const sw_vertex_t *v1 = sortedVerts[1];                                     \
+    const sw_vertex_t *v2 = sortedVerts[2];                                     \
+    const sw_vertex_t *v3 = sortedVerts[3];                                     \
+                                                                                \
+    /* Screen bounds (axis-aligned) */                                          \
+    int xMin = (int)v0->screen[0];                                              \
+    int yMin = (int)v0->screen[1];                                              \
+    int xMax = (int)v2->screen[0];                                              \
+    int yMax = (int)v2->screen[1];                                              \
+                                                                                \
+    float w = v2->screen[0] - v0->screen[0];                                    \
+    float h = v2->screen[1] - v0->screen[1];                                    \
+                                                                                \
+    if ((w == 0) || (h == 0)) return;                                           \
+                                                                                \
+    float wRcp = (w > 0.0f)? 1.0f/w : 0.0f;                                     \
+    float hRcp = (h > 0.0f)? 1.0f/h : 0.0f;                                     \
+                                                                                \
+    /* Subpixel corrections */                                                  \
+    float xSubstep = 1.0f - sw_fract(v0->screen[0]);                            \
+    float ySubstep = 1.0f - sw_fract(v0->screen[1]);                            \
+                                                                                \
+    /* Clamp to the raster bounds, skipped pixels are added to the substeps */  \
+    if (xMin < bounds[0]) { xSubstep += (float)(bounds[0] - xMin); xMin = bounds[0]; } \
+    if (yMin < bounds[1]) { ySubstep += (float)(bounds[1] - yMin); yMin = bounds[1]; } \
+    if (xMax > bounds[2]) xMax = bounds[2];                                     \
+    if (yMax > bounds[3]) yMax = bounds[3];                                     \
+    if ((xMin >= xMax) || (yMin >= yMax)) return;                               \
+                                                                                \
+    /* Coarse depth test and update */                                          \
+    float hizDepth = 0.0f;                                                      \
+    if (!sw_hiz_begin_primitive(sortedVerts, 4, xMin, yMin, xMax, yMax, ENABLE_DEPTH_TEST, &hizDepth)) return; \
+                                                                                \
+    /* Calculation of vertex gradients in X and Y */                            \
+    float dUdx = 0.0f, dVdx = 0.0f;                                             \
+    float dUdy = 0.0f, dVdy = 0.0f;                                             \
+    if (ENABLE_TEXTURE) {                                                       \
+        dUdx = (v1->texcoord[0] - v0->texcoord[0])*wRcp;                        \
+        dVdx = (v1->texcoord[1] - v0->texcoord[1])*wRcp;                        \
+        dUdy = (v3->texcoord[0] - v0->texcoord[0])*hRcp;                        \
+        dVdy = (v3->texcoord[1] - v0->texcoord[1])*hRcp;                        \
+    }                                                                           \
+                                                                                \
+    float dCdx[4], dCdy[4];                                                     \
+    dCdx[0] = (v1->color[0] - v0->color[0])*wRcp;                               \
+    dCdx[1] = (v1->color[1] - v0->color[1])*wRcp;                               \
+    dCdx[2] = (v1->color[2] - v0->color[2])*wRcp;                               \
+    dCdx[3] = (v1->color[3] - v0->color[3])*wRcp;                               \
+    dCdy[0] = (v3->color[0] - v0->color[0])*hRcp;                               \
+    dCdy[1] = (v3->color[1] - v0->color[1])*hRcp;                               \
+    dCdy[2] = (v3->color[2] - v0->color[2])*hRcp;                               \
+    dCdy[3] = (v3->color[3] - v0->color[3])*hRcp;                               \
+                                                                                \
+    float dZdx, dZdy;                                                           \
+    dZdx = (v1->homogeneous[2] - v0->homogeneous[2])*wRcp;                      \
+    dZdy = (v3->homogeneous[2] - v0->homogeneous[2])*hRcp;                      \
+                                                                                \
+    /* Constant color quads with nearest texture sampling (2D sprites and text) */ \
+    /* are shaded and blended with 8-bit integer math, skipping float conversions */ \
+    bool isFlat8 = ENABLE_COLOR && (!ENABLE_TEXTURE || ((tex->minFilter == SW_NEAREST) && (tex->magFilter == SW_NEAREST))) && \
+                   (!ENABLE_COLOR_BLEND || (RLSW.blendMode != SW_BLEND_GENERIC)); \
+    for (int i = 0; (i < 4) && isFlat8; i++) isFlat8 = (dCdx[i] == 0.0f) && (dCdy[i] == 0.0f); \
+                                                                                \
+    uint8_t color8[4] = { 0 };                                                  \
+    if (isFlat8) sw_float_to_unorm8_simd(color8, v0->color);                    \
+                                                                                \
+    /* Start of quad rasterization */                                           \
+    sw_color_t *colorPlane = RLSW.framebuffer.colorTarget;                      \
+    sw_depth_t *depthPlane = RLSW.framebuffer.depth;                            \
+    int stride = RLSW.framebuffer.stride;                                       \
+                                                                                \
+    const SWdepthfunc depthFunc = RLSW.depthFunc;                               \
+    const bool depthMask = RLSW.depthMask;                                      \
+                                                                                \
+    float zScanline = v0->homogeneous[2] + dZdx*xSubstep + dZdy*ySubstep;       \
+    float uScanline = v0->texcoord[0] + dUdx*xSubstep + dUdy*ySubstep;          \
+    float vScanline = v0->texcoord[1] + dVdx*xSubstep + dVdy*ySubstep;          \
+                                                                                \
+    float colorScanline[4] = {                                                  \
+        v0->color[0] + dCdx[0]*xSubstep + dCdy[0]*ySubstep,                     \
+        v0->color[1] + dCdx[1]*xSubstep + dCdy[1]*ySubstep,                     \
+        v0->color[2] + dCdx[2]*xSubstep + dCdy[2]*ySubstep,                     \
+        v0->color[3] + dCdx[3]*xSubstep + dCdy[3]*ySubstep                      \
+    };                                                                          \
+                                                                                \
+    for (int y = yMin; y < yMax; y++)                                           \
+    {                                                                           \
+        sw_color_t *cptr = colorPlane + y*stride + xMin;                        \
+        sw_depth_t *dptr = depthPlane + y*stride + xMin;                        \
+                                                                                \
+        float z = zScanline;                                                    \
+        float u = uScanline;                                                    \
+        float v = vScanline;                                                    \
+                                                                                \
+        float color[4] = {                                                      \
+            colorScanline[0],                                                   \
+            colorScanline[1],                                                   \
+            colorScanline[2],                                                   \
+            colorScanline[3]                                                    \
+        };                                                                      \
+                                                                                \
+        /* Scanline rasterization */                                            \
+        for (int x = xMin; x < xMax; x++)                                       \
+        {                                                                       \
+            /* Pixel color computation */                                       \
+            float srcColor[4] = {                                               \
+                color[0],                                                       \
+                color[1],                                                       \
+                color[2],                                                       \
+                color[3]                                                        \
+            };                                                                  \
+                                                                                \
+            /* Test and write depth */                                          \
+            if (ENABLE_DEPTH_TEST)                                              \
+            {                                                                   \
+                float depth = sw_framebuffer_read_depth(dptr);                  \
+                if (!sw_depth_test(depthFunc, z, depth))                        \
+                {                                                               \
+                    SW_STATS_ADD(pixelsDepthRejected, 1);                       \
+                    goto discard;                                               \
+                }                                                               \
+            }                                                                   \
+                                                                                \
+            if (depthMask) sw_framebuffer_write_depth(dptr, z);                 \
+                                                                                \
+            /* Depth only pass, no color to sample */                           \
+            if (!ENABLE_COLOR) goto discard;                                    \
+                                                                                \
+            if (isFlat8)                                                        \
+            {                                                                   \
+                uint8_t srcColor8[4] = { color8[0], color8[1], color8[2], color8[3] }; \
+                uint8_t texel8[4];                                              \
+                if (ENABLE_TEXTURE) sw_modulate_colors8(srcColor8, sw_texture_sample_nearest8(tex, u, v, texel8)); \
+                if (ENABLE_COLOR_BLEND) sw_framebuffer_blend_color8(cptr, srcColor8); \
+                else sw_framebuffer_write_color8(cptr, srcColor8);              \
+                SW_STATS_ADD(pixelsShaded, 1);                                  \
+                if (ENABLE_COLOR_BLEND) SW_STATS_ADD(pixelsBlended, 1);         \
+                goto discard;                                                   \
+            }                                                                   \
+                                                                                \
+            if (ENABLE_TEXTURE)                                                 \
+            {                                                                   \
+                float texColor[4];                                              \
+                sw_texture_sample(texColor, tex, u, v, dUdx, dUdy, dVdx, dVdy); \
+                srcColor[0] *= texColor[0];                                     \
+                srcColor[1] *= texColor[1];                                     \
+                srcColor[2] *= texColor[2];                                     \
+                srcColor[3] *= texColor[3];                                     \
+            }                                                                   \
+                                                                                \
+            if (ENABLE_COLOR_BLEND) sw_framebuffer_blend_color(cptr, srcColor); \
+            else sw_framebuffer_write_color(cptr, srcColor);                    \
+            SW_STATS_ADD(pixelsShaded, 1);                                      \
+            if (ENABLE_COLOR_BLEND) SW_STATS_ADD(pixelsBlended, 1);             \
+                                                                                \
+        discard:                                                                \
+            z += dZdx;                                                          \
+            color[0] += dCdx[0];                                                \
+            color[1] += dCdx[1];                                                \
+            color[2] += dCdx[2];                                                \
+            color[3] += dCdx[3];                                                \
+            if (ENABLE_TEXTURE)                                                 \
+            {                                                                   \
+                u += dUdx;                                                      \
+                v += dVdx;                                                      \
+            }                                                                   \
+            ++cptr;                                                             \
+            ++dptr;                                                             \
+        }                                                                       \
+                                                                                \
+        zScanline += dZdy;                                                      \
+        colorScanline[0] += dCdy[0];                                            \
+        colorScanline[1] += dCdy[1];                                            \
+        colorScanline[2] += dCdy[2];                                            \
+        colorScanline[3] += dCdy[3];                                            \
+                                                                                \
+        if (ENABLE_TEXTURE)                                                     \
+        {                                                                       \
+            uScanline += dUdy;                                                  \
+            vScanline += dVdy;                                                  \
+        }                                                                       \
+    }                                                                           \
+}
+
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned, 0, 0, 0, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX, 1, 0, 0, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH, 0, 1, 0, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_BLEND, 0, 0, 1, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_DEPTH, 1, 1, 0, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_BLEND, 1, 0, 1, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH_BLEND, 0, 1, 1, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_TEX_DEPTH_BLEND, 1, 1, 1, 1)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_NOCOLOR, 0, 0, 0, 0)
+DEFINE_QUAD_RASTER_AXIS_ALIGNED(sw_quad_raster_axis_aligned_DEPTH_NOCOLOR, 0, 1, 0, 0)
+
+static inline sw_raster_quad_f sw_quad_get_raster_func(uint32_t state)
+{
+    if (SW_STATE_CHECK_EX(state, SW_STATE_NO_COLOR)) return SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)? sw_quad_raster_axis_aligned_DEPTH_NOCOLOR : sw_quad_raster_axis_aligned_NOCOLOR;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) return sw_quad_raster_axis_aligned_TEX_DEPTH_BLEND;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) return sw_quad_raster_axis_aligned_DEPTH_BLEND;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_BLEND)) return sw_quad_raster_axis_aligned_TEX_BLEND;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D | SW_STATE_DEPTH_TEST)) return sw_quad_raster_axis_aligned_TEX_DEPTH;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) return sw_quad_raster_axis_aligned_BLEND;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) return sw_quad_raster_axis_aligned_DEPTH;
+    else if (SW_STATE_CHECK_EX(state, SW_STATE_TEXTURE_2D)) return sw_quad_raster_axis_aligned_TEX;
+
+    return sw_quad_raster_axis_aligned;
+}
+
+static inline void sw_quad_render(void)
+{
+    if (RLSW.stateFlags & SW_STATE_CULL_FACE)
+    {
+        if (!sw_quad_face_culling())
+        {
+            SW_STATS_ADD(primitivesCulled, 1);
+            return;
+        }
+    }
+
+    sw_quad_clip_and_project();
+
+    if (RLSW.vertexCounter < 3)
+    {
+        SW_STATS_ADD(primitivesClipped, 1);
+        return;
+    }
+
+    sw_framebuffer_mark_dirty_polygon();
+
+    // NOTE: Multisampled quads are rasterized as triangles, the axis aligned path has no coverage
+    if ((RLSW.vertexCounter == 4) && !SW_STATE_CHECK(SW_STATE_MULTISAMPLE) && sw_quad_is_axis_aligned())
+    {
+    #if defined(SW_HAS_DEFERRED)
+        if (RLSW.deferred.enabled)
+        {
+            sw_deferred_push_quad(RLSW.vertexBuffer);
+            return;
+        }
+    #endif
+
+        const int bounds[4] = { 0, 0, RLSW.framebuffer.width, RLSW.framebuffer.height };
+        RLSW.rasterState.quad(RLSW.vertexBuffer, RLSW.rasterState.tex, bounds);
+        return;
+    }
+
+    sw_triangle_fan_render();
+}
+//-------------------------------------------------------------------------------------------
+
+// Line rendering logic
+//-------------------------------------------------------------------------------------------
+static inline bool sw_line_clip_coord(float q, float p, float *t0, float *t1)
+{
+    if (fabsf(p) < SW_CLIP_EPSILON)
+    {
+        // Check if the line is entirely outside the window
+        if (q < -SW_CLIP_EPSILON) return 0; // Completely outside
+        return 1; // Completely inside or on the edges
+    }
+
+    const float r = q/p;
+
+    if (p < 0)
+    {
+        if (r > *t1) return 0;
+        if (r > *t0) *t0 = r;
+    }
+    else
+    {
+        if (r < *t0) return 0;
+        if (r < *t1) *t1 = r;
+    }
+
+    return 1;
+}
+
+static inline bool sw_line_clip(sw_vertex_t *v0, sw_vertex_t *v1)
+{
+    float t0 = 0.0f, t1 = 1.0f;
+    float dH[4], dC[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+        dH[i] = v1->homogeneous[i] - v0->homogeneous[i];
+        dC[i] = v1->color[i] - v0->color[i];
+    }
+
+    // Clipping Liang-Barsky
+    if (!sw_line_clip_coord(v0->homogeneous[3] - v0->homogeneous[0], -dH[3] + dH[0], &t0, &t1)) return false;
+    if (!sw_line_clip_coord(v0->homogeneous[3] + v0->homogeneous[0], -dH[3] - dH[0], &t0, &t1)) return false;
+    if (!sw_line_clip_coord(v0->homogeneous[3] - v0->homogeneous[1], -dH[3] + dH[1], &t0, &t1)) return false;
+    if (!sw_line_clip_coord(v0->homogeneous[3] + v0->homogeneous[1], -dH[3] - dH[1], &t0, &t1)) return false;
+    if (!sw_line_clip_coord(v0->homogeneous[3] - v0->homogeneous[2], -dH[3] + dH[2], &t0, &t1)) return false;
+    if (!sw_line_clip_coord(v0->homogeneous[3] + v0->homogeneous[2], -dH[3] - dH[2], &t0, &t1)) return false;
+
+    // Clipping Scissor
+    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    {
+        if (!sw_line_clip_coord(v0->homogeneous[0] - RLSW.scClipMin[0]*v0->homogeneous[3], RLSW.scClipMin[0]*dH[3] - dH[0], &t0, &t1)) return false;
+        if (!sw_line_clip_coord(RLSW.scClipMax[0]*v0->homogeneous[3] - v0->homogeneous[0], dH[0] - RLSW.scClipMax[0]*dH[3], &t0, &t1)) return false;
+        if (!sw_line_clip_coord(v0->homogeneous[1] - RLSW.scClipMin[1]*v0->homogeneous[3], RLSW.scClipMin[1]*dH[3] - dH[1], &t0, &t1)) return false;
+        if (!sw_line_clip_coord(RLSW.scClipMax[1]*v0->homogeneous[3] - v0->homogeneous[1], dH[1] - RLSW.scClipMax[1]*dH[3], &t0, &t1)) return false;
+    }
+
+    // Interpolation of new coordinates
+    if (t1 < 1.0f)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            v1->homogeneous[i] = v0->homogeneous[i] + t1*dH[i];
+            v1->color[i] = v0->color[i] + t1*dC[i];
+        }
+    }
+
+    if (t0 > 0.0f)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            v0->homogeneous[i] += t0*dH[i];
+            v0->color[i] += t0*dC[i];
+        }
+    }
+
+    return true;
+}
+
+static inline bool sw_line_clip_and_project(sw_vertex_t *v0, sw_vertex_t *v1)
+{
+    if (!sw_line_clip(v0, v1)) return false;
+
+    // Convert homogeneous coordinates to NDC
+    v0->homogeneous[3] = 1.0f/v0->homogeneous[3];
+    v1->homogeneous[3] = 1.0f/v1->homogeneous[3];
+    for (int i = 0; i < 3; i++)
+    {
+        v0->homogeneous[i] *= v0->homogeneous[3];
+        v1->homogeneous[i] *= v1->homogeneous[3];
+    }
+
+    // Convert NDC coordinates to screen space
+    sw_project_ndc_to_screen(v0->screen, v0->homogeneous);
+    sw_project_ndc_to_screen(v1->screen, v1->homogeneous);
+
+    return true;
+}
+
+#define DEFINE_LINE_RASTER(FUNC_NAME, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND) \
+static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1) \
+{                                                                       \
+    float x0 = v0->screen[0];                                           \
+    float y0 = v0->screen[1];                                           \
+    float x1 = v1->screen[0];                                           \
+    float y1 = v1->screen[1];                                           \
+                                                                        \
+    float dx = x1 - x0;                                                 \
+    float dy = y1 - y0;                                                 \
+                                                                        \
+    /* Compute dominant axis and subpixel offset */                     \
+    float steps, substep;                                               \
+    if (fabsf(dx) > fabsf(dy))                                          \
+    {                                                                   \
+        steps = fabsf(dx);                                              \
+        if (steps < 1.0f) return;                                       \
+        substep = (dx >= 0.0f)? (1.0f - sw_fract(x0)) : sw_fract(x0);   \
+    }                                                                   \
+    else                                                                \
+    {                                                                   \
+        steps = fabsf(dy);                                              \
+        if (steps < 1.0f) return;                                       \
+        substep = (dy >= 0.0f)? (1.0f - sw_fract(y0)) : sw_fract(y0);   \
+    }                                                                   \
+                                                                        \
+    /* Compute per pixel increments */                                  \
+    float xInc = dx/steps;                                              \
+    float yInc = dy/steps;                                              \
+    float stepRcp = 1.0f/steps;                                         \
+                                                                        \
+    float zInc = (v1->homogeneous[2] - v0->homogeneous[2])*stepRcp;     \
+    float rInc = (v1->color[0] - v0->color[0])*stepRcp;                 \
+    float gInc = (v1->color[1] - v0->color[1])*stepRcp;                 \
+    float bInc = (v1->color[2] - v0->color[2])*stepRcp;                 \
+    float aInc = (v1->color[3] - v0->color[3])*stepRcp;                 \
+                                                                        \
+    /* Initializing the interpolation starting values  */               \
+    float x = x0 + xInc*substep;                                        \
+    float y = y0 + yInc*substep;                                        \
+    float z = v0->homogeneous[2] + zInc*substep;                        \
+    float r = v0->color[0] + rInc*substep;                              \
+    float g = v0->color[1] + gInc*substep;                              \
+    float b = v0->color[2] + bInc*substep;                              \
+    float a = v0->color[3] + aInc*substep;                              \
+                                                                        \
+    const int stride = RLSW.framebuffer.stride;                         \
+    sw_color_t *colorPlane = RLSW.framebuffer.colorTarget;              \
+    sw_depth_t *depthPlane = RLSW.framebuffer.depth;                    \
+    const bool multisample = RLSW.framebuffer.msaa.isEnabled;           \
+                                                                        \
+    int numPixels = (int)(steps - substep) + 1;                         \
+                                                                        \
+    for (int i = 0; i < numPixels; i++)                                 \
+    {                                                                   \
+        /* REVIEW: May require reviewing projection details */          \
+        int px = (int)(x - 0.5f);                                       \
+        int py = (int)(y - 0.5f);                                       \
+                                                                        \
+        int offset = py*stride + px;                                    \
+        sw_color_t *cptr = colorPlane + offset;                         \
+        sw_depth_t *dptr = depthPlane + offset;                         \
+                                                                        \
+        if (ENABLE_DEPTH_TEST)                                          \
+        {                                                               \
+            float depth = sw_framebuffer_read_depth(dptr);              \
+            if (!sw_depth_test(RLSW.depthFunc, z, depth))               \
+            {                                                           \
+                SW_STATS_ADD(pixelsDepthRejected, 1);                   \
+                goto discard;                                           \
+            }                                                           \
+        }                                                               \
+                                                                        \
+        if (RLSW.depthMask) sw_framebuffer_write_depth(dptr, z);        \
+                                                                        \
+        float color[4] = {r, g, b, a};                                  \
+                                                                        \
+        if (ENABLE_COLOR_BLEND) sw_framebuffer_blend_color(cptr, color); \
+        else sw_framebuffer_write_color(cptr, color);                   \
+        if (multisample) sw_msaa_replicate_pixel(offset);               \
+        SW_STATS_ADD(pixelsShaded, 1);                                  \
+        if (ENABLE_COLOR_BLEND) SW_STATS_ADD(pixelsBlended, 1);         \
+                                                                        \
+    discard:                                                            \
+        x += xInc; y += yInc; z += zInc;                                \
+        r += rInc; g += gInc; b += bInc; a += aInc;                     \
+    }                                                                   \
+}
+
+#define DEFINE_LINE_THICK_RASTER(FUNC_NAME, RASTER_FUNC)                \
+void FUNC_NAME(const sw_vertex_t *v1, const sw_vertex_t *v2)            \
+{                                                                       \
+    sw_vertex_t tv1, tv2;                                               \
+                                                                        \
+    int x1 = (int)v1->screen[0];                                        \
+    int y1 = (int)v1->screen[1];                                        \
+    int x2 = (int)v2->screen[0];                                        \
+    int y2 = (int)v2->screen[1];                                        \
+                                                                        \
+    int dx = x2 - x1;                                                   \
+    int dy = y2 - y1;                                                   \
+                                                                        \
+    RASTER_FUNC(v1, v2);                                                \
+                                                                        \
+    if ((dx != 0) && (abs(dy/dx) < 1))                                  \
+    {                                                                   \
+        int wy = (int)((RLSW.lineWidth - 1.0f)*abs(dx)/sqrtf(dx*dx + dy*dy)); \
+        wy >>= 1;                                                       \
+        for (int i = 1; i <= wy; i++)                                   \
+        {                                                               \
+            tv1 = *v1, tv2 = *v2;                                       \
+            tv1.screen[1] -= i;                                         \
+            tv2.screen[1] -= i;                                         \
+            RASTER_FUNC(&tv1, &tv2);                                    \
+            tv1 = *v1, tv2 = *v2;                                       \
+            tv1.screen[1] += i;                                         \
+            tv2.screen[1] += i;                                         \
+            RASTER_FUNC(&tv1, &tv2);                                    \
+        }                                                               \
+    }                                                                   \
+    else if (dy != 0)                                                   \
+    {                                                                   \
+        int wx = (int)((RLSW.lineWidth - 1.0f)*abs(dy)/sqrtf(dx*dx + dy*dy)); \
+        wx >>= 1;                                                       \
+        for (int i = 1; i <= wx; i++)                                   \
+        {                                                               \
+            tv1 = *v1, tv2 = *v2;                                       \
+            tv1.screen[0] -= i;                                         \
+            tv2.screen[0] -= i;                                         \
+            RASTER_FUNC(&tv1, &tv2);                                    \
+            tv1 = *v1, tv2 = *v2;                                       \
+            tv1.screen[0] += i;                                         \
+            tv2.screen[0] += i;                                         \
+            RASTER_FUNC(&tv1, &tv2);                                    \
+        }                                                               \
+    }                                                                   \
+}
+
+DEFINE_LINE_RASTER(sw_line_raster, 0, 0)
+DEFINE_LINE_RASTER(sw_line_raster_DEPTH, 1, 0)
+DEFINE_LINE_RASTER(sw_line_raster_BLEND, 0, 1)
+DEFINE_LINE_RASTER(sw_line_raster_DEPTH_BLEND, 1, 1)
+
+DEFINE_LINE_THICK_RASTER(sw_line_thick_raster, sw_line_raster)
+DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_DEPTH, sw_line_raster_DEPTH)
+DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_BLEND, sw_line_raster_BLEND)
+DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_DEPTH_BLEND, sw_line_raster_DEPTH_BLEND)
+
+static inline void sw_line_render(sw_vertex_t *vertices)
+{
+    // Lines are rasterized immediately, pending primitives must be drawn first
+    sw_deferred_flush();
+
+    if (!sw_line_clip_and_project(&vertices[0], &vertices[1])) return;
+
+    int margin = (int)RLSW.lineWidth + 1;
+    int xMin = (int)fminf(vertices[0].screen[0], vertices[1].screen[0]) - margin;
+    int yMin = (int)fminf(vertices[0].screen[1], vertices[1].screen[1]) - margin;
+    int xMax = (int)fmaxf(vertices[0].screen[0], vertices[1].screen[0]) + margin + 1;
+    int yMax = (int)fmaxf(vertices[0].screen[1], vertices[1].screen[1]) + margin + 1;
+
+    sw_framebuffer_mark_dirty(xMin, yMin, xMax, yMax);
+
+    // Depth written without test or by farther fragments can be higher than the max depth of the tiles
+    if (sw_hiz_depth_can_rise(SW_STATE_CHECK(SW_STATE_DEPTH_TEST))) sw_hiz_raise_rect(xMin, yMin, xMax, yMax, 1.0f);
+
+    // Masked color channels are written by the blending variants
+    uint32_t state = RLSW.stateFlags;
+    if (RLSW.colorMask != SW_COLOR_MASK_ALL) state |= SW_STATE_BLEND;
+
+    if (RLSW.lineWidth >= 2.0f)
+    {
+        if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_line_thick_raster_DEPTH_BLEND(&vertices[0], &vertices[1]);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_line_thick_raster_BLEND(&vertices[0], &vertices[1]);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_line_thick_raster_DEPTH(&vertices[0], &vertices[1]);
+        else sw_line_thick_raster(&vertices[0], &vertices[1]);
+    }
+    else
+    {
+        if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_line_raster_DEPTH_BLEND(&vertices[0], &vertices[1]);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_line_raster_BLEND(&vertices[0], &vertices[1]);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_line_raster_DEPTH(&vertices[0], &vertices[1]);
+        else sw_line_raster(&vertices[0], &vertices[1]);
+    }
+}
+//-------------------------------------------------------------------------------------------
+
+// Point rendering logic
+//-------------------------------------------------------------------------------------------
+static inline bool sw_point_clip_and_project(sw_vertex_t *v)
+{
+    if (v->homogeneous[3] != 1.0f)
+    {
+        for (int_fast8_t i = 0; i < 3; i++)
+        {
+            if ((v->homogeneous[i] < -v->homogeneous[3]) || (v->homogeneous[i] > v->homogeneous[3])) return false;
+        }
+
+        v->homogeneous[3] = 1.0f/v->homogeneous[3];
+        v->homogeneous[0] *= v->homogeneous[3];
+        v->homogeneous[1] *= v->homogeneous[3];
+        v->homogeneous[2] *= v->homogeneous[3];
+    }
+
+    sw_project_ndc_to_screen(v->screen, v->homogeneous);
+
+    const int *min = NULL, *max = NULL;
+
+    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+    {
+        min = RLSW.scMin;
+        max = RLSW.scMax;
+    }
+    else
+    {
+        min = RLSW.vpMin;
+        max = RLSW.vpMax;
+    }
+
+    bool insideX = (v->screen[0] - RLSW.pointRadius < max[0]) && (v->screen[0] + RLSW.pointRadius > min[0]);
+    bool insideY = (v->screen[1] - RLSW.pointRadius < max[1]) && (v->screen[1] + RLSW.pointRadius > min[1]);
+
+    return (insideX && insideY);
+}
+
+#define DEFINE_POINT_RASTER(FUNC_NAME, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, CHECK_BOUNDS) \
+static inline void FUNC_NAME(int x, int y, float z, const float color[4])   \
+{                                                                           \
+    if (CHECK_BOUNDS == 1)                                                  \
+    {                                                                       \
+        if ((x < RLSW.vpMin[0]) || (x >= RLSW.vpMax[0])) return;            \
+        if ((y < RLSW.vpMin[1]) || (y >= RLSW.vpMax[1])) return;            \
+    }                                                                       \
+    else if (CHECK_BOUNDS == SW_SCISSOR_TEST)                               \
+    {                                                                       \
+        if ((x < RLSW.scMin[0]) || (x >= RLSW.scMax[0])) return;            \
+        if ((y < RLSW.scMin[1]) || (y >= RLSW.scMax[1])) return;            \
+    }                                                                       \
+                                                                            \
+    int offset = y*RLSW.framebuffer.stride + x;                             \
+    sw_color_t *cptr = RLSW.framebuffer.colorTarget + offset;               \
+    sw_depth_t *dptr = RLSW.framebuffer.depth + offset;                     \
+                                                                            \
+    if (ENABLE_DEPTH_TEST)                                                  \
+    {                                                                       \
+        float depth = sw_framebuffer_read_depth(dptr);                      \
+        if (!sw_depth_test(RLSW.depthFunc, z, depth))                       \
+        {                                                                   \
+            SW_STATS_ADD(pixelsDepthRejected, 1);                           \
+            return;                                                         \
+        }                                                                   \
+    }                                                                       \
+                                                                            \
+    if (RLSW.depthMask) sw_framebuffer_write_depth(dptr, z);                \
+                                                                            \
+    if (ENABLE_COLOR_BLEND) sw_framebuffer_blend_color(cptr, color);        \
+    else sw_framebuffer_write_color(cptr, color);                           \
+    if (RLSW.framebuffer.msaa.isEnabled) sw_msaa_replicate_pixel(offset);   \
+    SW_STATS_ADD(pixelsShaded, 1);                                          \
+    if (ENABLE_COLOR_BLEND) SW_STATS_ADD(pixelsBlended, 1);                 \
+}
+
+#define DEFINE_POINT_THICK_RASTER(FUNC_NAME, RASTER_FUNC)                   \
+static inline void FUNC_NAME(sw_vertex_t *v)                                \
+{                                                                           \
+    int cx = v->screen[0];                                                  \
+    int cy = v->screen[1];                                                  \
+    float cz = v->homogeneous[2];                                           \
+    int radius = RLSW.pointRadius;                                          \
+    const float *color = v->color;                                          \
+                                                                            \
+    int x = 0;                                                              \
+    int y = radius;                                                         \
+    int d = 3 - 2*radius;                                                   \
+                                                                            \
+    while (x <= y)                                                          \
+    {                                                                       \
+        for (int i = -x; i <= x; i++)                                       \
+        {                                                                   \
+            RASTER_FUNC(cx + i, cy + y, cz, color);                         \
+            RASTER_FUNC(cx + i, cy - y, cz, color);                         \
+        }                                                                   \
+        for (int i = -y; i <= y; i++)                                       \
+        {                                                                   \
+            RASTER_FUNC(cx + i, cy + x, cz, color);                         \
+            RASTER_FUNC(cx + i, cy - x, cz, color);                         \
+        }                                                                   \
+        if (d > 0)                                                          \
+        {                                                                   \
+            y--;                                                            \
+            d = d + 4*(x - y) + 10;                                         \
+        }                                                                   \
+        else d = d + 4*x + 6;                                               \
+        x++;                                                                \
+    }                                                                       \
+}
+
+DEFINE_POINT_RASTER(sw_point_raster, 0, 0, 0)
+DEFINE_POINT_RASTER(sw_point_raster_DEPTH, 1, 0, 0)
+DEFINE_POINT_RASTER(sw_point_raster_BLEND, 0, 1, 0)
+DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND, 1, 1, 0)
+
+DEFINE_POINT_RASTER(sw_point_raster_CHECK, 0, 0, 1)
+DEFINE_POINT_RASTER(sw_point_raster_DEPTH_CHECK, 1, 0, 1)
+DEFINE_POINT_RASTER(sw_point_raster_BLEND_CHECK, 0, 1, 1)
+DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND_CHECK, 1, 1, 1)
+
+DEFINE_POINT_RASTER(sw_point_raster_CHECK_SCISSOR, 0, 0, SW_SCISSOR_TEST)
+DEFINE_POINT_RASTER(sw_point_raster_DEPTH_CHECK_SCISSOR, 1, 0, SW_SCISSOR_TEST)
+DEFINE_POINT_RASTER(sw_point_raster_BLEND_CHECK_SCISSOR, 0, 1, SW_SCISSOR_TEST)
+DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND_CHECK_SCISSOR, 1, 1, SW_SCISSOR_TEST)
+
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster, sw_point_raster_CHECK)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH, sw_point_raster_DEPTH_CHECK)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_BLEND, sw_point_raster_BLEND_CHECK)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_BLEND, sw_point_raster_DEPTH_BLEND_CHECK)
+
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_SCISSOR, sw_point_raster_CHECK_SCISSOR)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_SCISSOR, sw_point_raster_DEPTH_CHECK_SCISSOR)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_BLEND_SCISSOR, sw_point_raster_BLEND_CHECK_SCISSOR)
+DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_BLEND_SCISSOR, sw_point_raster_DEPTH_BLEND_CHECK_SCISSOR)
+
+static inline void sw_point_render(sw_vertex_t *v)
+{
+    // Points are rasterized immediately, pending primitives must be drawn first
+    sw_deferred_flush();
+
+    if (!sw_point_clip_and_project(v)) return;
+
+    int margin = (int)RLSW.pointRadius + 1;
+    int xMin = (int)v->screen[0] - margin;
+    int yMin = (int)v->screen[1] - margin;
+    int xMax = (int)v->screen[0] + margin + 1;
+    int yMax = (int)v->screen[1] + margin + 1;
+
+    sw_framebuffer_mark_dirty(xMin, yMin, xMax, yMax);
+
+    // Depth written without test or by farther fragments can be higher than the max depth of the tiles
+    if (sw_hiz_depth_can_rise(SW_STATE_CHECK(SW_STATE_DEPTH_TEST))) sw_hiz_raise_rect(xMin, yMin, xMax, yMax, 1.0f);
+
+    // Masked color channels are written by the blending variants
+    uint32_t state = RLSW.stateFlags;
+    if (RLSW.colorMask != SW_COLOR_MASK_ALL) state |= SW_STATE_BLEND;
+
+    if (RLSW.pointRadius >= 1.0f)
+    {
+        if (SW_STATE_CHECK_EX(state, SW_STATE_SCISSOR_TEST))
+        {
+            if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_thick_raster_DEPTH_BLEND_SCISSOR(v);
+            else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_point_thick_raster_BLEND_SCISSOR(v);
+            else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_point_thick_raster_DEPTH_SCISSOR(v);
+            else sw_point_thick_raster_SCISSOR(v);
+        }
+        else
+        {
+            if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_thick_raster_DEPTH_BLEND(v);
+            else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_point_thick_raster_BLEND(v);
+            else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_point_thick_raster_DEPTH(v);
+            else sw_point_thick_raster(v);
+        }
+    }
+    else
+    {
+        if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_raster_DEPTH_BLEND(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_BLEND)) sw_point_raster_BLEND(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+        else if (SW_STATE_CHECK_EX(state, SW_STATE_DEPTH_TEST)) sw_point_raster_DEPTH(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+        else sw_point_raster(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
+    }
+}
+//-------------------------------------------------------------------------------------------
+
+// Polygon modes rendering logic
+//-------------------------------------------------------------------------------------------
+static inline void sw_poly_point_render(void)
+{
+    for (int i = 0; i < RLSW.vertexCounter; i++) sw_point_render(&RLSW.vertexBuffer[i]);
+}
+
+static inline void sw_poly_line_render(void)
+{
+    const sw_vertex_t *vertices = RLSW.vertexBuffer;
+    int cm1 = RLSW.vertexCounter - 1;
+
+    for (int i = 0; i < cm1; i++)
+    {
+        sw_vertex_t verts[2] = { vertices[i], vertices[i + 1] };
+        sw_line_render(verts);
+    }
+
+    sw_vertex_t verts[2] = { vertices[cm1], vertices[0] };
+    sw_line_render(verts);
+}
+
+// Select the raster functions of the current state, only when the state changed
+static inline void sw_update_raster_state(void)
+{
+    if (!RLSW.isDirtyRasterState) return;
+
+    uint32_t state = sw_get_raster_state();
+
+    RLSW.rasterState.triangle = sw_triangle_get_raster_func(state);
+    RLSW.rasterState.quad = sw_quad_get_raster_func(state);
+    RLSW.rasterState.tex = &RLSW.loadedTextures[RLSW.currentTexture];
+    RLSW.isDirtyRasterState = false;
+
+#if defined(SW_HAS_DEFERRED)
+    RLSW.deferred.currentState = -1;
+#endif
+}
+
+static inline void sw_poly_fill_render(void)
+{
+    switch (RLSW.drawMode)
+    {
+        case SW_POINTS: sw_point_render(&RLSW.vertexBuffer[0]); break;
+        case SW_LINES: sw_line_render(RLSW.vertexBuffer); break;
+        case SW_TRIANGLES: sw_update_raster_state(); sw_triangle_render(); break;
+        case SW_QUADS: sw_update_raster_state(); sw_quad_render(); break;
+    }
+}
+//-------------------------------------------------------------------------------------------
+
+// Immediate rendering logic
+//-------------------------------------------------------------------------------------------
+static inline void sw_immediate_render_primitive(void)
+{
+    SW_STATS_ADD(primitives, 1);
+
+    switch (RLSW.polyMode)
+    {
+        case SW_FILL: sw_poly_fill_render(); break;
+        case SW_LINE: sw_poly_line_render(); break;
+        case SW_POINT: sw_poly_point_render(); break;
+        default: break;
+    }
+
+    RLSW.vertexCounter = 0;
+}
+
+void sw_immediate_push_vertex(const float position[4], const float color[4], const float texcoord[2])
+{
+    SW_STATS_ADD(vertices, 1);
+
+    // Copy the attributes in the current vertex
+    sw_vertex_t *vertex = &RLSW.vertexBuffer[RLSW.vertexCounter++];
+    for (int i = 0; i < 4; i++)
+    {
+        vertex->position[i] = position[i];
+        if (i < 2) vertex->texcoord[i] = texcoord[i];
+        vertex->color[i] = color[i];
+    }
+
+    // Calculate homogeneous coordinates
+    const float *m = RLSW.matMVP, *v = vertex->position;
+    vertex->homogeneous[0] = m[0]*v[0] + m[4]*v[1] + m[8]*v[2] + m[12]*v[3];
+    vertex->homogeneous[1] = m[1]*v[0] + m[5]*v[1] + m[9]*v[2] + m[13]*v[3];
+    vertex->homogeneous[2] = m[2]*v[0] + m[6]*v[1] + m[10]*v[2] + m[14]*v[3];
+    vertex->homogeneous[3] = m[3]*v[0] + m[7]*v[1] + m[11]*v[2] + m[15]*v[3];
+
+    // Immediate rendering of the primitive if the required number is reached
+    if (RLSW.vertexCounter == RLSW.reqVertices) sw_immediate_render_primitive();
+}
+
+// Push a vertex already transformed by the vertex batch stage
+static inline void sw_immediate_push_transformed_vertex(const sw_vertex_t *vertex)
+{
+    SW_STATS_ADD(vertices, 1);
+
+    RLSW.vertexBuffer[RLSW.vertexCounter++] = *vertex;
+
+    if (RLSW.vertexCounter == RLSW.reqVertices) sw_immediate_render_primitive();
+}
+//-------------------------------------------------------------------------------------------
+
+// Vertex batch processing logic
+//-------------------------------------------------------------------------------------------
+static inline bool sw_vertex_cache_reserve(int count)
+{
+    if (count <= RLSW.vertexCacheSize) return true;
+
+    sw_vertex_t *cache = SW_REALLOC(RLSW.vertexCache, count*sizeof(sw_vertex_t));
+    if (cache == NULL) return false;
+
+    RLSW.vertexCache = cache;
+    RLSW.vertexCacheSize = count;
+
+    return true;
+}
+
+// Fetch the attributes of a vertex from the bound arrays
+static inline void sw_vertex_fetch(sw_vertex_t *vertex, int index)
+{
+    const float *texMatrix = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
+    const float *defaultTexcoord = RLSW.current.texcoord;
+    const float *defaultColor = RLSW.current.color;
+
+    const float *positions = RLSW.array.positions;
+    const float *texcoords = RLSW.array.texcoords;
+    const uint8_t *colors = RLSW.array.colors;
+
+    float u = texcoords? texcoords[2*index] : defaultTexcoord[0];
+    float v = texcoords? texcoords[2*index + 1] : defaultTexcoord[1];
+
+    vertex->texcoord[0] = texMatrix[0]*u + texMatrix[4]*v + texMatrix[12];
+    vertex->texcoord[1] = texMatrix[1]*u + texMatrix[5]*v + texMatrix[13];
+
+    for (int i = 0; i < 4; i++) vertex->color[i] = defaultColor[i];
+
+    if (colors)
+    {
+        const uint8_t *c = &colors[4*index];
+        vertex->color[0] *= (float)c[0]*SW_INV_255;
+        vertex->color[1] *= (float)c[1]*SW_INV_255;
+        vertex->color[2] *= (float)c[2]*SW_INV_255;
+        vertex->color[3] *= (float)c[3]*SW_INV_255;
+    }
+
+    const float *p = &positions[3*index];
+    vertex->position[0] = p[0];
+    vertex->position[1] = p[1];
+    vertex->position[2] = p[2];
+    vertex->position[3] = 1.0f;
+}
+
+// Calculate the homogeneous coordinates of a batch of vertices
+// NOTE: The MVP is loaded once for the whole batch, instead of once per vertex
+static inline void sw_vertex_batch_transform(sw_vertex_t *vertices, int count)
+{
+    const float *m = RLSW.matMVP;
+
+#if defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    const __m128 c0 = _mm_loadu_ps(&m[0]);
+    const __m128 c1 = _mm_loadu_ps(&m[4]);
+    const __m128 c2 = _mm_loadu_ps(&m[8]);
+    const __m128 c3 = _mm_loadu_ps(&m[12]);
+
+    for (int i = 0; i < count; i++)
+    {
+        const float *v = vertices[i].position;
+        __m128 h = _mm_mul_ps(c0, _mm_set1_ps(v[0]));
+        h = _mm_add_ps(h, _mm_mul_ps(c1, _mm_set1_ps(v[1])));
+        h = _mm_add_ps(h, _mm_mul_ps(c2, _mm_set1_ps(v[2])));
+        h = _mm_add_ps(h, _mm_mul_ps(c3, _mm_set1_ps(v[3])));
+        _mm_storeu_ps(vertices[i].homogeneous, h);
+    }
+#elif defined(SW_HAS_NEON) || defined(SW_HAS_NEON_FMA)
+    const float32x4_t c0 = vld1q_f32(&m[0]);
+    const float32x4_t c1 = vld1q_f32(&m[4]);
+    const float32x4_t c2 = vld1q_f32(&m[8]);
+    const float32x4_t c3 = vld1q_f32(&m[12]);
+
+    for (int i = 0; i < count; i++)
+    {
+        const float *v = vertices[i].position;
+        float32x4_t h = vmulq_n_f32(c0, v[0]);
+        h = vmlaq_n_f32(h, c1, v[1]);
+        h = vmlaq_n_f32(h, c2, v[2]);
+        h = vmlaq_n_f32(h, c3, v[3]);
+        vst1q_f32(vertices[i].homogeneous, h);
+    }
+#else
+    const float m0 = m[0], m1 = m[1], m2 = m[2], m3 = m[3];
+    const float m4 = m[4], m5 = m[5], m6 = m[6], m7 = m[7];
+    const float m8 = m[8], m9 = m[9], m10 = m[10], m11 = m[11];
+    const float m12 = m[12], m13 = m[13], m14 = m[14], m15 = m[15];
+
+    for (int i = 0; i < count; i++)
+    {
+        const float *v = vertices[i].position;
+        float *h = vertices[i].homogeneous;
+        h[0] = m0*v[0] + m4*v[1] + m8*v[2] + m12*v[3];
+        h[1] = m1*v[0] + m5*v[1] + m9*v[2] + m13*v[3];
+        h[2] = m2*v[0] + m6*v[1] + m10*v[2] + m14*v[3];
+        h[3] = m3*v[0] + m7*v[1] + m11*v[2] + m15*v[3];
+    }
+#endif
+}
+
+// Fetch and transform the vertices [first, first + count) of the bound arrays
+static inline void sw_vertex_batch_process(sw_vertex_t *vertices, int first, int count)
+{
+    for (int i = 0; i < count; i++) sw_vertex_fetch(&vertices[i], first + i);
+    sw_vertex_batch_transform(vertices, count);
+}
+//-------------------------------------------------------------------------------------------
+
+
+// Validity check helper functions
+//-------------------------------------------------------------------------------------------
+static inline bool sw_is_texture_valid(uint32_t id)
+{
+    bool valid = true;
+
+    if (id == 0) valid = false;
+    else if (id >= SW_MAX_TEXTURES) valid = false;
+    else if (RLSW.loadedTextures[id].levels[0].pixels == NULL) valid = false;
+
+    return valid;
+}
+
+static inline bool sw_is_texture_filter_valid(int filter)
+{
+    return ((filter == SW_NEAREST) || (filter == SW_LINEAR));
+}
+
+static inline bool sw_is_texture_min_filter_valid(int filter)
+{
+    return (sw_is_texture_filter_valid(filter) ||
+            (filter == SW_NEAREST_MIPMAP_NEAREST) || (filter == SW_LINEAR_MIPMAP_NEAREST) ||
+            (filter == SW_NEAREST_MIPMAP_LINEAR) || (filter == SW_LINEAR_MIPMAP_LINEAR));
+}
+
+static inline bool sw_is_texture_wrap_valid(int wrap)
+{
+    return ((wrap == SW_REPEAT) || (wrap == SW_CLAMP));
+}
+
+static inline bool sw_is_draw_mode_valid(int mode)
+{
+    bool result = false;
+
+    switch (mode)
+    {
+        case SW_POINTS:
+        case SW_LINES:
+        case SW_TRIANGLES:
+        case SW_QUADS: result = true; break;
+        default: break;
+    }
+
+    return result;
+}
+
+static inline bool sw_is_poly_mode_valid(int mode)
+{
+    bool result = false;
+
+    switch (mode)
+    {
+        case SW_POINT:
+        case SW_LINE:
+        case SW_FILL: result = true; break;
+        default: break;
+    }
+
+    return result;
+}
+
+static inline bool sw_is_face_valid(int face)
+{
+    return (face == SW_FRONT || face == SW_BACK);
+}
+
+static inline bool sw_is_blend_src_factor_valid(int blend)
+{
+    bool result = false;
+
+    switch (blend)
+    {
+        case SW_ZERO:
+        case SW_ONE:
+        case SW_SRC_COLOR:
+        case SW_ONE_MINUS_SRC_COLOR:
+        case SW_SRC_ALPHA:
+        case SW_ONE_MINUS_SRC_ALPHA:
+        case SW_DST_ALPHA:
+        case SW_ONE_MINUS_DST_ALPHA:
+        case SW_DST_COLOR:
+        case SW_ONE_MINUS_DST_COLOR:
+        case SW_SRC_ALPHA_SATURATE: result = true; break;
+        default: break;
+    }
+
+    return result;
+}
+
+static inline bool sw_is_blend_dst_factor_valid(int blend)
+{
+    bool result = false;
+
+    switch (blend)
+    {
+        case SW_ZERO:
+        case SW_ONE:
+        case SW_SRC_COLOR:
+        case SW_ONE_MINUS_SRC_COLOR:
+        case SW_SRC_ALPHA:
+        case SW_ONE_MINUS_SRC_ALPHA:
+        case SW_DST_ALPHA:
+        case SW_ONE_MINUS_DST_ALPHA:
+        case SW_DST_COLOR:
+        case SW_ONE_MINUS_DST_COLOR: result = true; break;
+        default: break;
+    }
+
+    return result;
+}
+
+static inline bool sw_is_depth_func_valid(int func)
+{
+    return ((func >= SW_NEVER) && (func <= SW_ALWAYS));
+}
+//-------------------------------------------------------------------------------------------
+
+// Render targets management functions
+// NOTE: The bound framebuffer state lives in RLSW.framebuffer, the other ones are stored in
+// RLSW.renderTargets[id].fb; texture rows go bottom-up, as with OpenGL render targets, so
+// the color plane rows are flipped when copied from or into the attached texture
+//-------------------------------------------------------------------------------------------
+// Copy a range of the color plane rows into the attached texture, rows [yMin, yMax) and columns [xMin, xMax)
+static inline void sw_render_target_store_rows(sw_mipmap_t *level, int xMin, int yMin, int xMax, int yMax)
+{
+    const sw_framebuffer_t *fb = &RLSW.framebuffer;
+
+    for (int y = yMin; y < yMax; y++)
+    {
+        const sw_color_t *src = fb->color + y*fb->stride + xMin;
+        int row = fb->height - 1 - y;
+
+        for (int x = xMin; x < xMax;)
+        {
+            uint8_t *dst = &level->pixels[4*sw_texture_texel_offset(level, x, row)];
+        #if SW_COLOR_BUFFER_BITS == 32
+            // Texels of a row are consecutive up to the end of their 4x4 block (or of the row)
+            int run = (level->blockStride == 0)? (xMax - x) : sw_mini(4 - (x & 3), xMax - x);
+            memcpy(dst, src, 4*run);
+            src += run;
+            x += run;
+        #else
+            sw_framebuffer_read_color8(dst, src);
+            src++;
+            x++;
+        #endif
+        }
+    }
+}
+
+// Load the color plane of the bound framebuffer from its attached texture
+static inline void sw_render_target_load(const sw_render_target_t *target)
+{
+    sw_framebuffer_t *fb = &RLSW.framebuffer;
+
+    sw_framebuffer_mark_invalid();
+
+    if (!sw_is_texture_valid(target->colorTexture)) return;
+
+    const sw_mipmap_t *level = &RLSW.loadedTextures[target->colorTexture].levels[0];
+    if ((level->width != fb->width) || (level->height != fb->height) || (level->compressed != 0)) return;
+
+    for (int y = 0; y < fb->height; y++)
+    {
+        sw_color_t *dst = fb->color + y*fb->stride;
+        int row = fb->height - 1 - y;
+
+        for (int x = 0; x < fb->width;)
+        {
+            const uint8_t *src = &level->pixels[4*sw_texture_texel_offset(level, x, row)];
+        #if SW_COLOR_BUFFER_BITS == 32
+            int run = (level->blockStride == 0)? (fb->width - x) : sw_mini(4 - (x & 3), fb->width - x);
+            memcpy(dst, src, 4*run);
+            dst += run;
+            x += run;
+        #else
+            sw_framebuffer_write_color8(dst, src);
+            dst++;
+            x++;
+        #endif
+        }
+    }
+
+    if (fb->msaa.isEnabled) sw_msaa_load(fb);
+
+    // The texture has the same content, nothing has to be stored back yet
+    fb->dirty.count = 0;
+}
+
+// Store the regions of the bound framebuffer written since the last store into its attached texture
+static inline void sw_render_target_store(const sw_render_target_t *target)
+{
+    sw_framebuffer_t *fb = &RLSW.framebuffer;
+
+    sw_msaa_resolve(fb);
+
+    if (sw_is_texture_valid(target->colorTexture))
+    {
+        sw_mipmap_t *level = &RLSW.loadedTextures[target->colorTexture].levels[0];
+
+        if ((level->width == fb->width) && (level->height == fb->height) && (level->compressed == 0))
+        {
+            for (int i = 0; i < fb->dirty.count; i++)
+            {
+                const int *rect = fb->dirty.rects[i];
+                sw_render_target_store_rows(level, rect[0], rect[1], rect[2], rect[3]);
+            }
+        }
+    }
+
+    fb->dirty.count = 0;
+}
+
+// Setup the planes of the bound framebuffer object for its attachments
+// NOTE: Dimensions come from the color texture, or from the depth renderbuffer without one
+static inline bool sw_render_target_setup(sw_render_target_t *target)
+{
+    sw_framebuffer_t *fb = &RLSW.framebuffer;
+    int w = 1, h = 1;
+
+    if (sw_is_texture_valid(target->colorTexture))
+    {
+        w = RLSW.loadedTextures[target->colorTexture].levels[0].width;
+        h = RLSW.loadedTextures[target->colorTexture].levels[0].height;
+    }
+    else if ((target->depthRenderbuffer > 0) && (RLSW.renderbuffers[target->depthRenderbuffer].width > 0))
+    {
+        w = RLSW.renderbuffers[target->depthRenderbuffer].width;
+        h = RLSW.renderbuffers[target->depthRenderbuffer].height;
+    }
+
+    if ((w != fb->width) || (h != fb->height))
+    {
+        if (!sw_framebuffer_resize(fb, w, h, w) || !sw_hiz_resize(&fb->hiz, w, h))
+        {
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+            return false;
+        }
+
+        target->isStale = true;
+    }
+
+    if (target->isStale)
+    {
+        sw_render_target_load(target);
+        target->isStale = false;
+    }
+
+#if defined(RLSW_USE_THREADS)
+    if ((RLSW.deferred.threadCount > 1) && !sw_deferred_resize_bins(w, h)) return false;
+#endif
+
+    return true;
+}
+
+// Store the rendering pending in the bound framebuffer object when its color attachment is the given texture
+static inline void sw_render_target_sync_texture(uint32_t id)
+{
+    const sw_render_target_t *target = &RLSW.renderTargets[RLSW.currentFramebuffer];
+    if ((RLSW.currentFramebuffer > 0) && (target->colorTexture == id)) sw_render_target_store(target);
+}
+
+// Mark the framebuffer objects using a texture as stale, or detach it when deleted
+static inline void sw_render_target_texture_changed(uint32_t id, bool deleted)
+{
+    for (int i = 1; i < SW_MAX_FRAMEBUFFERS; i++)
+    {
+        sw_render_target_t *target = &RLSW.renderTargets[i];
+        if (!target->isUsed || (target->colorTexture != id)) continue;
+
+        if (deleted) target->colorTexture = 0;
+        else
+        {
+            target->isStale = true;
+            if (RLSW.currentFramebuffer == (uint32_t)i) sw_render_target_setup(target);
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition
+//----------------------------------------------------------------------------------
+bool swInit(int w, int h)
+{
+    sw_kernels_init();
+
+    if (!sw_framebuffer_resize(&RLSW.framebuffer, w, h, w)) { swClose(); return false; }
+    if (!sw_hiz_resize(&RLSW.framebuffer.hiz, w, h)) { swClose(); return false; }
+    sw_framebuffer_mark_invalid();
+
+    swViewport(0, 0, w, h);
+    swScissor(0, 0, w, h);
+
+    RLSW.loadedTextures = (sw_texture_t *)SW_MALLOC(SW_MAX_TEXTURES*sizeof(sw_texture_t));
+    if (RLSW.loadedTextures == NULL) { swClose(); return false; }
+
+    // NOTE: New textures copy the default texture, so all its levels must start empty
+    memset(RLSW.loadedTextures, 0, SW_MAX_TEXTURES*sizeof(sw_texture_t));
+
+    RLSW.freeTextureIds = (uint32_t *)SW_MALLOC(SW_MAX_TEXTURES*sizeof(uint32_t));
+    if (RLSW.loadedTextures == NULL) { swClose(); return false; }
+
+    RLSW.clearColor[3] = 1.0f;
+    RLSW.clearDepth = 1.0f;
+
+    RLSW.currentMatrixMode = SW_MODELVIEW;
+    RLSW.currentMatrix = &RLSW.stackModelview[0];
+
+    sw_matrix_id(RLSW.stackProjection[0]);
+    sw_matrix_id(RLSW.stackModelview[0]);
+    sw_matrix_id(RLSW.stackTexture[0]);
+    sw_matrix_id(RLSW.matMVP);
+
+    RLSW.stackProjectionCounter = 1;
+    RLSW.stackModelviewCounter = 1;
+    RLSW.stackTextureCounter = 1;
+    RLSW.isDirtyMVP = false;
+
+    RLSW.current.texcoord[0] = 0.0f;
+    RLSW.current.texcoord[1] = 0.0f;
+
+    RLSW.current.color[0] = 1.0f;
+    RLSW.current.color[1] = 1.0f;
+    RLSW.current.color[2] = 1.0f;
+    RLSW.current.color[3] = 1.0f;
+
+    RLSW.srcFactor = SW_SRC_ALPHA;
+    RLSW.dstFactor = SW_ONE_MINUS_SRC_ALPHA;
+
+    RLSW.srcFactorFunc = sw_factor_src_alpha;
+    RLSW.dstFactorFunc = sw_factor_one_minus_src_alpha;
+    RLSW.blendMode = sw_get_blend_mode(SW_SRC_ALPHA, SW_ONE_MINUS_SRC_ALPHA);
+
+    RLSW.polyMode = SW_FILL;
+    RLSW.cullFace = SW_BACK;
+
+    RLSW.depthFunc = SW_LEQUAL;
+    RLSW.depthMask = true;
+    RLSW.colorMask = SW_COLOR_MASK_ALL;
+
+    if (SW_TRIANGLE_RASTER_HALF_SPACE) RLSW.stateFlags |= SW_STATE_HALF_SPACE;
+    RLSW.isDirtyRasterState = true;
+
+    static uint32_t defaultTex[3*2*2] = {
+        0xFFFFFFFF,
+        0xFFFFFFFF,
+        0xFFFFFFFF,
+        0xFFFFFFFF
+    };
+
+    RLSW.loadedTextures[0].levels[0].pixels = (uint8_t*)defaultTex;
+    RLSW.loadedTextures[0].levels[0].width = 2;
+    RLSW.loadedTextures[0].levels[0].height = 2;
+    RLSW.loadedTextures[0].levels[0].wMinus1 = 1;
+    RLSW.loadedTextures[0].levels[0].hMinus1 = 1;
+    RLSW.loadedTextures[0].levels[0].isPOT = true;
+    RLSW.loadedTextures[0].levelCount = 1;
+    RLSW.loadedTextures[0].minFilter = SW_NEAREST;
+    RLSW.loadedTextures[0].magFilter = SW_NEAREST;
+    RLSW.loadedTextures[0].sWrap = SW_REPEAT;
+    RLSW.loadedTextures[0].tWrap = SW_REPEAT;
+    RLSW.loadedTextures[0].tx = 0.5f;
+    RLSW.loadedTextures[0].ty = 0.5f;
+
+    RLSW.loadedTextureCount = 1;
+
+#if defined(SW_HAS_DEFERRED)
+    sw_deferred_init();
+#endif
+
+    SW_LOG("INFO: RLSW: Software renderer initialized successfully\n");
+#if defined(SW_HAS_CPU_DISPATCH)
+    switch (RLSW.kernels.level)
     {
-        if (!sw_line_clip_coord(v0->homogeneous[0] - RLSW.scClipMin[0]*v0->homogeneous[3], RLSW.scClipMin[0]*dH[3] - dH[0], &t0, &t1)) return false;
-        if (!sw_line_clip_coord(RLSW.scClipMax[0]*v0->homogeneous[3] - v0->homogeneous[0], dH[0] - RLSW.scClipMax[0]*dH[3], &t0, &t1)) return false;
-        if (!sw_line_clip_coord(v0->homogeneous[1] - RLSW.scClipMin[1]*v0->homogeneous[3], RLSW.scClipMin[1]*dH[3] - dH[1], &t0, &t1)) return false;
-        if (!sw_line_clip_coord(RLSW.scClipMax[1]*v0->homogeneous[3] - v0->homogeneous[1], dH[1] - RLSW.scClipMax[1]*dH[3], &t0, &t1)) return false;
+        case SW_CPU_LEVEL_AVX2: SW_LOG("INFO: RLSW: Framebuffer kernels selected for CPU: AVX2\n"); break;
+        case SW_CPU_LEVEL_SSE2: SW_LOG("INFO: RLSW: Framebuffer kernels selected for CPU: SSE2\n"); break;
+        default: SW_LOG("INFO: RLSW: Framebuffer kernels selected for CPU: Scalar\n"); break;
+    }
+#endif
+#if defined(SW_HAS_FMA_AVX) && defined(SW_HAS_FMA_AVX2)
+    SW_LOG("INFO: RLSW: Using SIMD instructions: FMA AVX\n");
+#endif
+#if defined(SW_HAS_AVX) || defined(SW_HAS_AVX2)
+    SW_LOG("INFO: RLSW: Using SIMD instructions: AVX\n");
+#endif
+#if defined(SW_HAS_SSE) || defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
+    SW_LOG("INFO: RLSW: Using SIMD instructions: SSE\n");
+#endif
+#if defined(SW_HAS_NEON_FMA) || defined(SW_HAS_NEON)
+    SW_LOG("INFO: RLSW: Using SIMD instructions: NEON\n");
+#endif
+#if defined(SW_HAS_RVV)
+    SW_LOG("INFO: RLSW: Using SIMD instructions: RVV\n");
+#endif
+
+    return true;
+}
+
+void swClose(void)
+{
+    // NOTE: Framebuffer objects are stored in their textures before these are freed
+    if (RLSW.currentFramebuffer > 0) swBindFramebuffer(0);
+
+#if defined(SW_HAS_DEFERRED)
+    sw_deferred_close();
+#endif
+
+    for (int i = 1; i < SW_MAX_FRAMEBUFFERS; i++)
+    {
+        if (!RLSW.renderTargets[i].isUsed) continue;
+        SW_FREE(RLSW.renderTargets[i].fb.color);
+        SW_FREE(RLSW.renderTargets[i].fb.depth);
+        SW_FREE(RLSW.renderTargets[i].fb.hiz.maxDepth);
+        SW_FREE(RLSW.renderTargets[i].fb.msaa.color[0]);
+        SW_FREE(RLSW.renderTargets[i].fb.msaa.depth[1]);
     }
 
-    // Interpolation of new coordinates
-    if (t1 < 1.0f)
+    // NOTE: Starts at texture 1, texture 0 does not have to be freed
+    for (int i = 1; i < RLSW.loadedTextureCount; i++)
+    {
+        if (sw_is_texture_valid(i))
+        {
+            sw_texture_free_levels(&RLSW.loadedTextures[i], 0);
+        }
+    }
+
+    if (!RLSW.framebuffer.isExternal) SW_FREE(RLSW.framebuffer.color);
+    SW_FREE(RLSW.framebuffer.depth);
+    SW_FREE(RLSW.framebuffer.hiz.maxDepth);
+    SW_FREE(RLSW.framebuffer.msaa.color[0]);
+    SW_FREE(RLSW.framebuffer.msaa.depth[1]);
+    SW_FREE(RLSW.vertexCache);
+    SW_FREE(RLSW.loadedTextures);
+    SW_FREE(RLSW.freeTextureIds);
+
+    RLSW = SW_CURLY_INIT(sw_context_t) { 0 };
+}
+
+bool swResizeFramebuffer(int w, int h)
+{
+    // Framebuffer objects get their dimensions from their attachments
+    if (RLSW.currentFramebuffer > 0) { RLSW.errCode = SW_INVALID_OPERATION; return false; }
+
+    sw_deferred_flush();
+
+    int stride = w;
+
+    if (RLSW.framebuffer.isExternal)
+    {
+        // External memory can not be resized, it has to be bound again with the new size
+        if ((w != RLSW.framebuffer.width) || (h != RLSW.framebuffer.height)) { RLSW.errCode = SW_INVALID_OPERATION; return false; }
+        stride = RLSW.framebuffer.stride;
+    }
+
+    if (!sw_framebuffer_resize(&RLSW.framebuffer, w, h, stride)) return false;
+    if (!sw_hiz_resize(&RLSW.framebuffer.hiz, w, h)) return false;
+    sw_framebuffer_mark_invalid();
+
+#if defined(RLSW_USE_THREADS)
+    if ((RLSW.deferred.threadCount > 1) && !sw_deferred_resize_bins(w, h)) return false;
+#endif
+
+    return true;
+}
+
+bool swBindFramebufferMemory(void *pixels, int w, int h, int stride, SWformat format)
+{
+    if (RLSW.currentFramebuffer > 0) { RLSW.errCode = SW_INVALID_OPERATION; return false; }
+
+    sw_deferred_flush();
+
+#if (SW_COLOR_BUFFER_BITS == 32)
+    if (pixels == NULL)
+    {
+        // Restore the internal color buffer, keeping the current size
+        if (!RLSW.framebuffer.isExternal) return true;
+
+        RLSW.framebuffer.color = NULL;
+        RLSW.framebuffer.colorAllocSz = 0;
+        RLSW.framebuffer.isExternal = false;
+        RLSW.framebuffer.isBGRA = false;
+
+        return swResizeFramebuffer(RLSW.framebuffer.width, RLSW.framebuffer.height);
+    }
+
+    if ((format != SW_RGBA) && (format != SW_BGRA)) { RLSW.errCode = SW_INVALID_ENUM; return false; }
+    if ((w <= 0) || (h <= 0)) { RLSW.errCode = SW_INVALID_VALUE; return false; }
+
+    if (stride == 0) stride = w*(int)sizeof(sw_color_t);
+    if ((stride < w*(int)sizeof(sw_color_t)) || ((stride%sizeof(sw_color_t)) != 0) ||
+        (((uintptr_t)pixels%sizeof(sw_color_t)) != 0)) { RLSW.errCode = SW_INVALID_VALUE; return false; }
+
+    if (!RLSW.framebuffer.isExternal) SW_FREE(RLSW.framebuffer.color);
+
+    RLSW.framebuffer.color = (sw_color_t *)pixels;
+    RLSW.framebuffer.colorAllocSz = 0;
+    RLSW.framebuffer.isExternal = true;
+    RLSW.framebuffer.isBGRA = (format == SW_BGRA);
+
+    stride /= (int)sizeof(sw_color_t);
+
+    if (!sw_framebuffer_resize(&RLSW.framebuffer, w, h, stride)) return false;
+    if (!sw_hiz_resize(&RLSW.framebuffer.hiz, w, h)) return false;
+    sw_framebuffer_mark_invalid();
+
+#if defined(RLSW_USE_THREADS)
+    if ((RLSW.deferred.threadCount > 1) && !sw_deferred_resize_bins(w, h)) return false;
+#endif
+
+    return true;
+#else
+    // Only the RGBA 32 bits color buffer layout can be shared with external memory
+    (void)pixels; (void)w; (void)h; (void)stride; (void)format;
+    RLSW.errCode = SW_INVALID_OPERATION;
+    return false;
+#endif
+}
+
+void swFinish(void)
+{
+    sw_deferred_flush();
+    sw_msaa_resolve(&RLSW.framebuffer);
+}
+
+int swGetDirtyRects(int *rects, int maxCount)
+{
+    const sw_region_t *dirty = &RLSW.framebuffer.dirty;
+
+    if (rects == NULL) return dirty->count;
+    if (maxCount <= 0) return 0;
+
+    int count = sw_mini(dirty->count, maxCount);
+
+    for (int i = 0; i < dirty->count; i++)
+    {
+        const int *rect = dirty->rects[i];
+        int *out = &rects[4*sw_mini(i, count - 1)];
+
+        if (i < count)
+        {
+            out[0] = rect[0];
+            out[1] = rect[1];
+            out[2] = rect[2] - rect[0];
+            out[3] = rect[3] - rect[1];
+        }
+        else
+        {
+            // Rects exceeding maxCount are merged into the last one
+            int xMax = sw_maxi(out[0] + out[2], rect[2]);
+            int yMax = sw_maxi(out[1] + out[3], rect[3]);
+            out[0] = sw_mini(out[0], rect[0]);
+            out[1] = sw_mini(out[1], rect[1]);
+            out[2] = xMax - out[0];
+            out[3] = yMax - out[1];
+        }
+    }
+
+    return count;
+}
+
+void swResetDirtyRects(void)
+{
+    RLSW.framebuffer.dirty.count = 0;
+}
+
+void swGetStats(SWstats *stats)
+{
+    if (stats == NULL) { RLSW.errCode = SW_INVALID_VALUE; return; }
+
+    *stats = SW_CURLY_INIT(SWstats) { 0 };
+
+#if defined(RLSW_USE_STATS)
+    // Fragments of the recorded primitives are only counted once rasterized
+    sw_deferred_flush();
+
+    for (int i = 0; i < SW_STATS_SLOTS; i++)
+    {
+        const SWstats *counters = &RLSW.stats[i].counters;
+
+        stats->vertices += counters->vertices;
+        stats->primitives += counters->primitives;
+        stats->primitivesCulled += counters->primitivesCulled;
+        stats->primitivesClipped += counters->primitivesClipped;
+        stats->pixelsShaded += counters->pixelsShaded;
+        stats->pixelsBlended += counters->pixelsBlended;
+        stats->pixelsDepthRejected += counters->pixelsDepthRejected;
+        stats->flushes += counters->flushes;
+        stats->flushTime += counters->flushTime;
+    }
+#endif
+}
+
+void swResetStats(void)
+{
+#if defined(RLSW_USE_STATS)
+    memset(RLSW.stats, 0, sizeof(RLSW.stats));
+#endif
+}
+
+void swCopyFramebuffer(int x, int y, int w, int h, SWformat format, SWtype type, void *pixels)
+{
+    sw_pixelformat_t pFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
+
+    sw_deferred_flush();
+    sw_msaa_resolve(&RLSW.framebuffer);
+
+    if (w <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+    if (h <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+
+    x = sw_clampi(x, 0, RLSW.framebuffer.width);
+    y = sw_clampi(y, 0, RLSW.framebuffer.height);
+
+    if (w > RLSW.framebuffer.width - x) w = RLSW.framebuffer.width - x;
+    if (h > RLSW.framebuffer.height - y) h = RLSW.framebuffer.height - y;
+
+    if ((w <= 0) || (h <= 0)) return;
+
+    if ((x == 0) && (y == 0) && (w == RLSW.framebuffer.width) && (h == RLSW.framebuffer.height) &&
+        ((RLSW.packRowLength == 0) || (RLSW.packRowLength == w)))
+    {
+        #if SW_COLOR_BUFFER_BITS == 32
+            if (pFormat == SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+            {
+                sw_framebuffer_copy_fast(pixels);
+                return;
+            }
+        #elif SW_COLOR_BUFFER_BITS == 16
+            if (pFormat == SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5)
+            {
+                sw_framebuffer_copy_fast(pixels);
+                return;
+            }
+        #endif
+    }
+
+    switch (pFormat)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: sw_framebuffer_copy_to_GRAYSCALE(x, y, w, h, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: sw_framebuffer_copy_to_GRAYALPHA(x, y, w, h, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: sw_framebuffer_copy_to_R5G6B5(x, y, w, h, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: sw_framebuffer_copy_to_R8G8B8(x, y, w, h, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: sw_framebuffer_copy_to_R5G5B5A1(x, y, w, h, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: sw_framebuffer_copy_to_R4G4B4A4(x, y, w, h, (uint16_t *)pixels); break;
+    #if SW_COLOR_BUFFER_BITS == 32
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_copy_color32(x, y, w, h, (uint32_t *)pixels); break;
+    #else
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_copy_to_R8G8B8A8(x, y, w, h, (uint8_t *)pixels); break;
+    #endif
+        // Below: not implemented
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
+    }
+}
+
+void swBlitFramebuffer(int xDst, int yDst, int wDst, int hDst, int xSrc, int ySrc, int wSrc, int hSrc, SWformat format, SWtype type, void *pixels)
+{
+    sw_pixelformat_t pFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
+
+    sw_deferred_flush();
+    sw_msaa_resolve(&RLSW.framebuffer);
+
+    if (wSrc <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+    if (hSrc <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+
+    if (wSrc > RLSW.framebuffer.width) wSrc = RLSW.framebuffer.width;
+    if (hSrc > RLSW.framebuffer.height) hSrc = RLSW.framebuffer.height;
+
+    xSrc = sw_clampi(xSrc, 0, wSrc);
+    ySrc = sw_clampi(ySrc, 0, hSrc);
+
+    // Check if the sizes are identical after clamping the source to avoid unexpected issues
+    // REVIEW: This repeats the operations if true, so we could make a copy function without these checks
+    if (xDst == xSrc && yDst == ySrc && wDst == wSrc && hDst == hSrc)
+    {
+        swCopyFramebuffer(xSrc, ySrc, wSrc, hSrc, format, type, pixels);
+    }
+
+    switch (pFormat)
+    {
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: sw_framebuffer_blit_to_GRAYALPHA(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: sw_framebuffer_blit_to_GRAYALPHA(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: sw_framebuffer_blit_to_R5G6B5(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: sw_framebuffer_blit_to_R8G8B8(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: sw_framebuffer_blit_to_R5G5B5A1(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
+        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: sw_framebuffer_blit_to_R4G4B4A4(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
+    #if SW_COLOR_BUFFER_BITS == 32
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_blit_color32(wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint32_t *)pixels); break;
+    #else
+        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_blit_to_R8G8B8A8(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
+    #endif
+        // Below: not implemented
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16:
+        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
+        default:
+            RLSW.errCode = SW_INVALID_ENUM;
+            break;
+    }
+}
+
+void swEnable(SWstate state)
+{
+    switch (state)
     {
-        for (int i = 0; i < 4; i++)
+        case SW_SCISSOR_TEST: RLSW.stateFlags |= SW_STATE_SCISSOR_TEST; break;
+        case SW_TEXTURE_2D: RLSW.stateFlags |= SW_STATE_TEXTURE_2D; break;
+        case SW_DEPTH_TEST: RLSW.stateFlags |= SW_STATE_DEPTH_TEST; break;
+        case SW_CULL_FACE: RLSW.stateFlags |= SW_STATE_CULL_FACE; break;
+        case SW_BLEND:
         {
-            v1->homogeneous[i] = v0->homogeneous[i] + t1*dH[i];
-            v1->color[i] = v0->color[i] + t1*dC[i];
-        }
+            // Masked color writes read the blend state at raster time
+            if (RLSW.colorMask != SW_COLOR_MASK_ALL) sw_deferred_flush();
+            RLSW.stateFlags |= SW_STATE_BLEND;
+        } break;
+        case SW_MULTISAMPLE:
+        {
+            sw_deferred_flush();
+            if (!sw_framebuffer_set_multisample(true)) return;
+            RLSW.stateFlags |= SW_STATE_MULTISAMPLE;
+        } break;
+        case SW_RASTER_HALF_SPACE: RLSW.stateFlags |= SW_STATE_HALF_SPACE; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; return;
     }
 
-    if (t0 > 0.0f)
+    RLSW.isDirtyRasterState = true;
+}
+
+void swDisable(SWstate state)
+{
+    switch (state)
     {
-        for (int i = 0; i < 4; i++)
+        case SW_SCISSOR_TEST: RLSW.stateFlags &= ~SW_STATE_SCISSOR_TEST; break;
+        case SW_TEXTURE_2D: RLSW.stateFlags &= ~SW_STATE_TEXTURE_2D; break;
+        case SW_DEPTH_TEST: RLSW.stateFlags &= ~SW_STATE_DEPTH_TEST; break;
+        case SW_CULL_FACE: RLSW.stateFlags &= ~SW_STATE_CULL_FACE; break;
+        case SW_BLEND:
         {
-            v0->homogeneous[i] += t0*dH[i];
-            v0->color[i] += t0*dC[i];
-        }
+            // Masked color writes read the blend state at raster time
+            if (RLSW.colorMask != SW_COLOR_MASK_ALL) sw_deferred_flush();
+            RLSW.stateFlags &= ~SW_STATE_BLEND;
+        } break;
+        case SW_MULTISAMPLE:
+        {
+            // Samples are resolved into the color plane, rendering goes on into it
+            sw_deferred_flush();
+            sw_framebuffer_set_multisample(false);
+            RLSW.stateFlags &= ~SW_STATE_MULTISAMPLE;
+        } break;
+        case SW_RASTER_HALF_SPACE: RLSW.stateFlags &= ~SW_STATE_HALF_SPACE; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; return;
     }
 
-    return true;
+    RLSW.isDirtyRasterState = true;
 }
 
-static inline bool sw_line_clip_and_project(sw_vertex_t *v0, sw_vertex_t *v1)
+void swGetIntegerv(SWget name, int *v)
 {
-    if (!sw_line_clip(v0, v1)) return false;
-
-    // Convert homogeneous coordinates to NDC
-    v0->homogeneous[3] = 1.0f/v0->homogeneous[3];
-    v1->homogeneous[3] = 1.0f/v1->homogeneous[3];
-    for (int i = 0; i < 3; i++)
+    switch (name)
     {
-        v0->homogeneous[i] *= v0->homogeneous[3];
-        v1->homogeneous[i] *= v1->homogeneous[3];
+        case SW_MODELVIEW_STACK_DEPTH: *v = SW_MODELVIEW_STACK_DEPTH; break;
+        case SW_PROJECTION_STACK_DEPTH: *v = SW_PROJECTION_STACK_DEPTH; break;
+        case SW_TEXTURE_STACK_DEPTH: *v = SW_TEXTURE_STACK_DEPTH; break;
+        case SW_FRAMEBUFFER_BINDING: *v = (int)RLSW.currentFramebuffer; break;
+        case SW_RENDERBUFFER_BINDING: *v = (int)RLSW.currentRenderbuffer; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
     }
+}
 
-    // Convert NDC coordinates to screen space
-    sw_project_ndc_to_screen(v0->screen, v0->homogeneous);
-    sw_project_ndc_to_screen(v1->screen, v1->homogeneous);
+void swGetFloatv(SWget name, float *v)
+{
+    switch (name)
+    {
+        case SW_COLOR_CLEAR_VALUE:
+        {
+            for (int i = 0; i < 4; i++) v[i] = RLSW.clearColor[i];
+        } break;
+        case SW_DEPTH_CLEAR_VALUE:
+        {
+            v[0] = RLSW.clearDepth;
+        } break;
+        case SW_CURRENT_COLOR:
+        {
+            v[0] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].color[0];
+            v[1] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].color[1];
+            v[2] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].color[2];
+            v[3] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].color[3];
+        } break;
+        case SW_CURRENT_TEXTURE_COORDS:
+        {
+            v[0] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].texcoord[0];
+            v[1] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].texcoord[1];
+        } break;
+        case SW_POINT_SIZE:
+        {
+            v[0] = 2.0f*RLSW.pointRadius;
+        } break;
+        case SW_LINE_WIDTH:
+        {
+            v[0] = RLSW.lineWidth;
+        } break;
+        case SW_MODELVIEW_MATRIX:
+        {
+            for (int i = 0; i < 16; i++) v[i] = RLSW.stackModelview[RLSW.stackModelviewCounter - 1][i];
 
-    return true;
+        } break;
+        case SW_PROJECTION_MATRIX:
+        {
+            for (int i = 0; i < 16; i++) v[i] = RLSW.stackProjection[RLSW.stackProjectionCounter - 1][i];
+
+        } break;
+        case SW_TEXTURE_MATRIX:
+        {
+            for (int i = 0; i < 16; i++) v[i] = RLSW.stackTexture[RLSW.stackTextureCounter - 1][i];
+
+        } break;
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
+    }
 }
 
-#define DEFINE_LINE_RASTER(FUNC_NAME, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND) \
-static inline void FUNC_NAME(const sw_vertex_t *v0, const sw_vertex_t *v1) \
-{                                                                       \
-    float x0 = v0->screen[0];                                           \
-    float y0 = v0->screen[1];                                           \
-    float x1 = v1->screen[0];                                           \
-    float y1 = v1->screen[1];                                           \
-                                                                        \
-    float dx = x1 - x0;                                                 \
-    float dy = y1 - y0;                                                 \
-                                                                        \
-    /* Compute dominant axis and subpixel offset */                     \
-    float steps, substep;                                               \
-    if (fabsf(dx) > fabsf(dy))                                          \
-    {                                                                   \
-        steps = fabsf(dx);                                              \
-        if (steps < 1.0f) return;                                       \
-        substep = (dx >= 0.0f)? (1.0f - sw_fract(x0)) : sw_fract(x0);   \
-    }                                                                   \
-    else                                                                \
-    {                                                                   \
-        steps = fabsf(dy);                                              \
-        if (steps < 1.0f) return;                                       \
-        substep = (dy >= 0.0f)? (1.0f - sw_fract(y0)) : sw_fract(y0);   \
-    }                                                                   \
-                                                                        \
-    /* Compute per pixel increments */                                  \
-    float xInc = dx/steps;                                              \
-    float yInc = dy/steps;                                              \
-    float stepRcp = 1.0f/steps;                                         \
-                                                                        \
-    float zInc = (v1->homogeneous[2] - v0->homogeneous[2])*stepRcp;     \
-    float rInc = (v1->color[0] - v0->color[0])*stepRcp;                 \
-    float gInc = (v1->color[1] - v0->color[1])*stepRcp;                 \
-    float bInc = (v1->color[2] - v0->color[2])*stepRcp;                 \
-    float aInc = (v1->color[3] - v0->color[3])*stepRcp;                 \
-                                                                        \
-    /* Initializing the interpolation starting values  */               \
-    float x = x0 + xInc*substep;                                        \
-    float y = y0 + yInc*substep;                                        \
-    float z = v0->homogeneous[2] + zInc*substep;                        \
-    float r = v0->color[0] + rInc*substep;                              \
-    float g = v0->color[1] + gInc*substep;                              \
-    float b = v0->color[2] + bInc*substep;                              \
-    float a = v0->color[3] + aInc*substep;                              \
-                                                                        \
-    const int fbWidth = RLSW.framebuffer.width;                         \
-    sw_pixel_t *pixels = RLSW.framebuffer.pixels;                       \
-                                                                        \
-    int numPixels = (int)(steps - substep) + 1;                         \
-                                                                        \
-    for (int i = 0; i < numPixels; i++)                                 \
-    {                                                                   \
-        /* REVIEW: May require reviewing projection details */          \
-        int px = (int)(x - 0.5f);                                       \
-        int py = (int)(y - 0.5f);                                       \
-                                                                        \
-        sw_pixel_t *ptr = pixels + py*fbWidth + px;                     \
-                                                                        \
-        if (ENABLE_DEPTH_TEST)                                          \
-        {                                                               \
-            float depth = sw_framebuffer_read_depth(ptr);               \
-            if (z > depth) goto discard;                                \
-        }                                                               \
-                                                                        \
-        sw_framebuffer_write_depth(ptr, z);                             \
-                                                                        \
-        float color[4] = {r, g, b, a};                                  \
-                                                                        \
-        if (ENABLE_COLOR_BLEND)                                         \
-        {                                                               \
-            float dstColor[4];                                          \
-            sw_framebuffer_read_color(dstColor, ptr);                   \
-            sw_blend_colors(dstColor, color);                           \
-            sw_framebuffer_write_color(ptr, dstColor);                  \
-        }                                                               \
-        else sw_framebuffer_write_color(ptr, color);                    \
-                                                                        \
-    discard:                                                            \
-        x += xInc; y += yInc; z += zInc;                                \
-        r += rInc; g += gInc; b += bInc; a += aInc;                     \
-    }                                                                   \
+const char *swGetString(SWget name)
+{
+    const char *result = NULL;
+
+    switch (name)
+    {
+        case SW_VENDOR: result = "RLSW Header"; break;
+        case SW_RENDERER:
+        {
+            // NOTE: Report the instruction set level of the framebuffer kernels selected at runtime
+            switch (RLSW.kernels.level)
+            {
+                case SW_CPU_LEVEL_AVX2: result = "RLSW Software Renderer (AVX2)"; break;
+                case SW_CPU_LEVEL_SSE2: result = "RLSW Software Renderer (SSE2)"; break;
+                default: result = "RLSW Software Renderer"; break;
+            }
+        } break;
+        case SW_VERSION: result = "RLSW 1.0"; break;
+        case SW_EXTENSIONS: result = "None"; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
+    }
+
+    return result;
 }
 
-#define DEFINE_LINE_THICK_RASTER(FUNC_NAME, RASTER_FUNC)                \
-void FUNC_NAME(const sw_vertex_t *v1, const sw_vertex_t *v2)            \
-{                                                                       \
-    sw_vertex_t tv1, tv2;                                               \
-                                                                        \
-    int x1 = (int)v1->screen[0];                                        \
-    int y1 = (int)v1->screen[1];                                        \
-    int x2 = (int)v2->screen[0];                                        \
-    int y2 = (int)v2->screen[1];                                        \
-                                                                        \
-    int dx = x2 - x1;                                                   \
-    int dy = y2 - y1;                                                   \
-                                                                        \
-    RASTER_FUNC(v1, v2);                                                \
-                                                                        \
-    if ((dx != 0) && (abs(dy/dx) < 1))                                  \
-    {                                                                   \
-        int wy = (int)((RLSW.lineWidth - 1.0f)*abs(dx)/sqrtf(dx*dx + dy*dy)); \
-        wy >>= 1;                                                       \
-        for (int i = 1; i <= wy; i++)                                   \
-        {                                                               \
-            tv1 = *v1, tv2 = *v2;                                       \
-            tv1.screen[1] -= i;                                         \
-            tv2.screen[1] -= i;                                         \
-            RASTER_FUNC(&tv1, &tv2);                                    \
-            tv1 = *v1, tv2 = *v2;                                       \
-            tv1.screen[1] += i;                                         \
-            tv2.screen[1] += i;                                         \
-            RASTER_FUNC(&tv1, &tv2);                                    \
-        }                                                               \
-    }                                                                   \
-    else if (dy != 0)                                                   \
-    {                                                                   \
-        int wx = (int)((RLSW.lineWidth - 1.0f)*abs(dy)/sqrtf(dx*dx + dy*dy)); \
-        wx >>= 1;                                                       \
-        for (int i = 1; i <= wx; i++)                                   \
-        {                                                               \
-            tv1 = *v1, tv2 = *v2;                                       \
-            tv1.screen[0] -= i;                                         \
-            tv2.screen[0] -= i;                                         \
-            RASTER_FUNC(&tv1, &tv2);                                    \
-            tv1 = *v1, tv2 = *v2;                                       \
-            tv1.screen[0] += i;                                         \
-            tv2.screen[0] += i;                                         \
-            RASTER_FUNC(&tv1, &tv2);                                    \
-        }                                                               \
-    }                                                                   \
+SWerrcode swGetError(void)
+{
+    SWerrcode ret = RLSW.errCode;
+    RLSW.errCode = SW_NO_ERROR;
+    return ret;
 }
 
-DEFINE_LINE_RASTER(sw_line_raster, 0, 0)
-DEFINE_LINE_RASTER(sw_line_raster_DEPTH, 1, 0)
-DEFINE_LINE_RASTER(sw_line_raster_BLEND, 0, 1)
-DEFINE_LINE_RASTER(sw_line_raster_DEPTH_BLEND, 1, 1)
+void swViewport(int x, int y, int width, int height)
+{
+    if ((width < 0) || (height < 0))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    RLSW.vpRect[0] = x;
+    RLSW.vpRect[1] = y;
+    RLSW.vpRect[2] = width;
+    RLSW.vpRect[3] = height;
+
+    RLSW.vpSize[0] = width;
+    RLSW.vpSize[1] = height;
+
+    RLSW.vpHalf[0] = width/2.0f;
+    RLSW.vpHalf[1] = height/2.0f;
 
-DEFINE_LINE_THICK_RASTER(sw_line_thick_raster, sw_line_raster)
-DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_DEPTH, sw_line_raster_DEPTH)
-DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_BLEND, sw_line_raster_BLEND)
-DEFINE_LINE_THICK_RASTER(sw_line_thick_raster_DEPTH_BLEND, sw_line_raster_DEPTH_BLEND)
+    RLSW.vpCenter[0] = (float)x + RLSW.vpHalf[0];
+    RLSW.vpCenter[1] = (float)y + RLSW.vpHalf[1];
 
-static inline void sw_line_render(sw_vertex_t *vertices)
-{
-    if (!sw_line_clip_and_project(&vertices[0], &vertices[1])) return;
+    RLSW.vpMin[0] = sw_clampi(x, 0, RLSW.framebuffer.width - 1);
+    RLSW.vpMin[1] = sw_clampi(y, 0, RLSW.framebuffer.height - 1);
+    RLSW.vpMax[0] = sw_clampi(x + width, 0, RLSW.framebuffer.width - 1);
+    RLSW.vpMax[1] = sw_clampi(y + height, 0, RLSW.framebuffer.height - 1);
+}
 
-    if (RLSW.lineWidth >= 2.0f)
+void swScissor(int x, int y, int width, int height)
+{
+    if ((width < 0) || (height < 0))
     {
-        if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_line_thick_raster_DEPTH_BLEND(&vertices[0], &vertices[1]);
-        else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_line_thick_raster_BLEND(&vertices[0], &vertices[1]);
-        else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_line_thick_raster_DEPTH(&vertices[0], &vertices[1]);
-        else sw_line_thick_raster(&vertices[0], &vertices[1]);
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
     }
-    else
+
+    RLSW.scRect[0] = x;
+    RLSW.scRect[1] = y;
+    RLSW.scRect[2] = width;
+    RLSW.scRect[3] = height;
+
+    RLSW.scMin[0] = sw_clampi(x, 0, RLSW.framebuffer.width - 1);
+    RLSW.scMin[1] = sw_clampi(y, 0, RLSW.framebuffer.height - 1);
+    RLSW.scMax[0] = sw_clampi(x + width, 0, RLSW.framebuffer.width - 1);
+    RLSW.scMax[1] = sw_clampi(y + height, 0, RLSW.framebuffer.height - 1);
+
+    RLSW.scClipMin[0] = (2.0f*(float)RLSW.scMin[0]/(float)RLSW.vpSize[0]) - 1.0f;
+    RLSW.scClipMax[0] = (2.0f*(float)RLSW.scMax[0]/(float)RLSW.vpSize[0]) - 1.0f;
+    RLSW.scClipMax[1] = 1.0f - (2.0f*(float)RLSW.scMin[1]/(float)RLSW.vpSize[1]);
+    RLSW.scClipMin[1] = 1.0f - (2.0f*(float)RLSW.scMax[1]/(float)RLSW.vpSize[1]);
+}
+
+void swPixelStorei(SWpixelstore pname, int param)
+{
+    switch (pname)
     {
-        if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_line_raster_DEPTH_BLEND(&vertices[0], &vertices[1]);
-        else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_line_raster_BLEND(&vertices[0], &vertices[1]);
-        else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_line_raster_DEPTH(&vertices[0], &vertices[1]);
-        else sw_line_raster(&vertices[0], &vertices[1]);
+        case SW_PACK_ROW_LENGTH:
+        {
+            if (param < 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+            RLSW.packRowLength = param;
+        } break;
+        case SW_PACK_ALIGNMENT:
+        case SW_UNPACK_ALIGNMENT: break; // NOTE: Rows are always tightly packed, the alignment is ignored
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
     }
 }
-//-------------------------------------------------------------------------------------------
 
-// Point rendering logic
-//-------------------------------------------------------------------------------------------
-static inline bool sw_point_clip_and_project(sw_vertex_t *v)
+void swClearColor(float r, float g, float b, float a)
 {
-    if (v->homogeneous[3] != 1.0f)
+    RLSW.clearColor[0] = sw_saturate(r);
+    RLSW.clearColor[1] = sw_saturate(g);
+    RLSW.clearColor[2] = sw_saturate(b);
+    RLSW.clearColor[3] = sw_saturate(a);
+}
+
+void swClearDepth(float depth)
+{
+    RLSW.clearDepth = sw_saturate(depth);
+}
+
+void swClear(uint32_t bitmask)
+{
+    sw_deferred_flush();
+
+    // NOTE: Clear values are packed in the buffers format, each buffer is filled separately
+    if (bitmask & SW_COLOR_BUFFER_BIT)
     {
-        for (int_fast8_t i = 0; i < 3; i++)
+        sw_color_t color;
+        sw_framebuffer_write_color(&color, RLSW.clearColor);
+        sw_framebuffer_fill(RLSW.framebuffer.color, &color, sizeof(sw_color_t));
+        sw_framebuffer_mark_cleared(&color);
+
+        if (RLSW.framebuffer.msaa.isEnabled)
         {
-            if ((v->homogeneous[i] < -v->homogeneous[3]) || (v->homogeneous[i] > v->homogeneous[3])) return false;
+            // The color plane already holds the cleared pixels, a full clear leaves nothing to resolve
+            for (int i = 0; i < SW_MSAA_SAMPLES; i++) sw_framebuffer_fill(RLSW.framebuffer.msaa.color[i], &color, sizeof(sw_color_t));
+            if (!(RLSW.stateFlags & SW_STATE_SCISSOR_TEST)) RLSW.framebuffer.msaa.unresolved.count = 0;
         }
-
-        v->homogeneous[3] = 1.0f/v->homogeneous[3];
-        v->homogeneous[0] *= v->homogeneous[3];
-        v->homogeneous[1] *= v->homogeneous[3];
-        v->homogeneous[2] *= v->homogeneous[3];
     }
 
-    sw_project_ndc_to_screen(v->screen, v->homogeneous);
+    if (bitmask & SW_DEPTH_BUFFER_BIT)
+    {
+        sw_depth_t clearDepth;
+        sw_framebuffer_write_depth(&clearDepth, RLSW.clearDepth);
+        sw_framebuffer_fill(RLSW.framebuffer.depth, &clearDepth, sizeof(sw_depth_t));
 
-    const int *min = NULL, *max = NULL;
+        if (RLSW.framebuffer.msaa.isEnabled)
+        {
+            for (int i = 1; i < SW_MSAA_SAMPLES; i++) sw_framebuffer_fill(RLSW.framebuffer.msaa.depth[i], &clearDepth, sizeof(sw_depth_t));
+        }
 
-    if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+        // Tiles bound the stored depth, so use the depth value as read back from the buffer
+        float depth = sw_framebuffer_read_depth(&clearDepth);
+
+        if (RLSW.stateFlags & SW_STATE_SCISSOR_TEST)
+        {
+            sw_hiz_raise_rect(RLSW.scMin[0], RLSW.scMin[1], RLSW.scMax[0] + 1, RLSW.scMax[1] + 1, depth);
+        }
+        else
+        {
+            int count = RLSW.framebuffer.hiz.tilesX*RLSW.framebuffer.hiz.tilesY;
+            for (int i = 0; i < count; i++) RLSW.framebuffer.hiz.maxDepth[i] = depth;
+        }
+    }
+}
+
+void swBlendFunc(SWfactor sfactor, SWfactor dfactor)
+{
+    if (!sw_is_blend_src_factor_valid(sfactor) ||
+        !sw_is_blend_dst_factor_valid(dfactor))
     {
-        min = RLSW.scMin;
-        max = RLSW.scMax;
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
     }
-    else
+
+    // Redundant changes would flush the deferred primitives for nothing
+    if ((sfactor == RLSW.srcFactor) && (dfactor == RLSW.dstFactor)) return;
+
+    // Blend factors are read at raster time
+    sw_deferred_flush();
+
+    RLSW.srcFactor = sfactor;
+    RLSW.dstFactor = dfactor;
+    RLSW.isDirtyRasterState = true;
+
+    switch (sfactor)
     {
-        min = RLSW.vpMin;
-        max = RLSW.vpMax;
+        case SW_ZERO: RLSW.srcFactorFunc = sw_factor_zero; break;
+        case SW_ONE: RLSW.srcFactorFunc = sw_factor_one; break;
+        case SW_SRC_COLOR: RLSW.srcFactorFunc = sw_factor_src_color; break;
+        case SW_ONE_MINUS_SRC_COLOR: RLSW.srcFactorFunc = sw_factor_one_minus_src_color; break;
+        case SW_SRC_ALPHA: RLSW.srcFactorFunc = sw_factor_src_alpha; break;
+        case SW_ONE_MINUS_SRC_ALPHA: RLSW.srcFactorFunc = sw_factor_one_minus_src_alpha; break;
+        case SW_DST_ALPHA: RLSW.srcFactorFunc = sw_factor_dst_alpha; break;
+        case SW_ONE_MINUS_DST_ALPHA: RLSW.srcFactorFunc = sw_factor_one_minus_dst_alpha; break;
+        case SW_DST_COLOR: RLSW.srcFactorFunc = sw_factor_dst_color; break;
+        case SW_ONE_MINUS_DST_COLOR: RLSW.srcFactorFunc = sw_factor_one_minus_dst_color; break;
+        case SW_SRC_ALPHA_SATURATE: RLSW.srcFactorFunc = sw_factor_src_alpha_saturate; break;
+        default: break;
     }
 
-    bool insideX = (v->screen[0] - RLSW.pointRadius < max[0]) && (v->screen[0] + RLSW.pointRadius > min[0]);
-    bool insideY = (v->screen[1] - RLSW.pointRadius < max[1]) && (v->screen[1] + RLSW.pointRadius > min[1]);
+    switch (dfactor)
+    {
+        case SW_ZERO: RLSW.dstFactorFunc = sw_factor_zero; break;
+        case SW_ONE: RLSW.dstFactorFunc = sw_factor_one; break;
+        case SW_SRC_COLOR: RLSW.dstFactorFunc = sw_factor_src_color; break;
+        case SW_ONE_MINUS_SRC_COLOR: RLSW.dstFactorFunc = sw_factor_one_minus_src_color; break;
+        case SW_SRC_ALPHA: RLSW.dstFactorFunc = sw_factor_src_alpha; break;
+        case SW_ONE_MINUS_SRC_ALPHA: RLSW.dstFactorFunc = sw_factor_one_minus_src_alpha; break;
+        case SW_DST_ALPHA: RLSW.dstFactorFunc = sw_factor_dst_alpha; break;
+        case SW_ONE_MINUS_DST_ALPHA: RLSW.dstFactorFunc = sw_factor_one_minus_dst_alpha; break;
+        case SW_DST_COLOR: RLSW.dstFactorFunc = sw_factor_dst_color; break;
+        case SW_ONE_MINUS_DST_COLOR: RLSW.dstFactorFunc = sw_factor_one_minus_dst_color; break;
+        case SW_SRC_ALPHA_SATURATE: break;
+        default: break;
+    }
 
-    return (insideX && insideY);
+    RLSW.blendMode = sw_get_blend_mode(sfactor, dfactor);
 }
 
-#define DEFINE_POINT_RASTER(FUNC_NAME, ENABLE_DEPTH_TEST, ENABLE_COLOR_BLEND, CHECK_BOUNDS) \
-static inline void FUNC_NAME(int x, int y, float z, const float color[4])   \
-{                                                                           \
-    if (CHECK_BOUNDS == 1)                                                  \
-    {                                                                       \
-        if ((x < RLSW.vpMin[0]) || (x >= RLSW.vpMax[0])) return;            \
-        if ((y < RLSW.vpMin[1]) || (y >= RLSW.vpMax[1])) return;            \
-    }                                                                       \
-    else if (CHECK_BOUNDS == SW_SCISSOR_TEST)                               \
-    {                                                                       \
-        if ((x < RLSW.scMin[0]) || (x >= RLSW.scMax[0])) return;            \
-        if ((y < RLSW.scMin[1]) || (y >= RLSW.scMax[1])) return;            \
-    }                                                                       \
-                                                                            \
-    int offset = y*RLSW.framebuffer.width + x;                              \
-    sw_pixel_t *ptr = RLSW.framebuffer.pixels + offset;                     \
-                                                                            \
-    if (ENABLE_DEPTH_TEST)                                                  \
-    {                                                                       \
-        float depth = sw_framebuffer_read_depth(ptr);                       \
-        if (z > depth) return;                                              \
-    }                                                                       \
-                                                                            \
-    sw_framebuffer_write_depth(ptr, z);                                     \
-                                                                            \
-    if (ENABLE_COLOR_BLEND)                                                 \
-    {                                                                       \
-        float dstColor[4];                                                  \
-        sw_framebuffer_read_color(dstColor, ptr);                           \
-        sw_blend_colors(dstColor, color);                                   \
-        sw_framebuffer_write_color(ptr, dstColor);                          \
-    }                                                                       \
-    else sw_framebuffer_write_color(ptr, color);                            \
-}
+void swDepthFunc(SWdepthfunc func)
+{
+    if (!sw_is_depth_func_valid(func))
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
 
-#define DEFINE_POINT_THICK_RASTER(FUNC_NAME, RASTER_FUNC)                   \
-static inline void FUNC_NAME(sw_vertex_t *v)                                \
-{                                                                           \
-    int cx = v->screen[0];                                                  \
-    int cy = v->screen[1];                                                  \
-    float cz = v->homogeneous[2];                                           \
-    int radius = RLSW.pointRadius;                                          \
-    const float *color = v->color;                                          \
-                                                                            \
-    int x = 0;                                                              \
-    int y = radius;                                                         \
-    int d = 3 - 2*radius;                                                   \
-                                                                            \
-    while (x <= y)                                                          \
-    {                                                                       \
-        for (int i = -x; i <= x; i++)                                       \
-        {                                                                   \
-            RASTER_FUNC(cx + i, cy + y, cz, color);                         \
-            RASTER_FUNC(cx + i, cy - y, cz, color);                         \
-        }                                                                   \
-        for (int i = -y; i <= y; i++)                                       \
-        {                                                                   \
-            RASTER_FUNC(cx + i, cy + x, cz, color);                         \
-            RASTER_FUNC(cx + i, cy - x, cz, color);                         \
-        }                                                                   \
-        if (d > 0)                                                          \
-        {                                                                   \
-            y--;                                                            \
-            d = d + 4*(x - y) + 10;                                         \
-        }                                                                   \
-        else d = d + 4*x + 6;                                               \
-        x++;                                                                \
-    }                                                                       \
-}
+    if (func == RLSW.depthFunc) return;
 
-DEFINE_POINT_RASTER(sw_point_raster, 0, 0, 0)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH, 1, 0, 0)
-DEFINE_POINT_RASTER(sw_point_raster_BLEND, 0, 1, 0)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND, 1, 1, 0)
+    // Depth function is read at raster time
+    sw_deferred_flush();
 
-DEFINE_POINT_RASTER(sw_point_raster_CHECK, 0, 0, 1)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_CHECK, 1, 0, 1)
-DEFINE_POINT_RASTER(sw_point_raster_BLEND_CHECK, 0, 1, 1)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND_CHECK, 1, 1, 1)
+    RLSW.depthFunc = func;
+}
 
-DEFINE_POINT_RASTER(sw_point_raster_CHECK_SCISSOR, 0, 0, SW_SCISSOR_TEST)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_CHECK_SCISSOR, 1, 0, SW_SCISSOR_TEST)
-DEFINE_POINT_RASTER(sw_point_raster_BLEND_CHECK_SCISSOR, 0, 1, SW_SCISSOR_TEST)
-DEFINE_POINT_RASTER(sw_point_raster_DEPTH_BLEND_CHECK_SCISSOR, 1, 1, SW_SCISSOR_TEST)
+void swDepthMask(bool flag)
+{
+    if (flag == RLSW.depthMask) return;
 
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster, sw_point_raster_CHECK)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH, sw_point_raster_DEPTH_CHECK)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_BLEND, sw_point_raster_BLEND_CHECK)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_BLEND, sw_point_raster_DEPTH_BLEND_CHECK)
+    // Depth mask is read at raster time
+    sw_deferred_flush();
 
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_SCISSOR, sw_point_raster_CHECK_SCISSOR)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_SCISSOR, sw_point_raster_DEPTH_CHECK_SCISSOR)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_BLEND_SCISSOR, sw_point_raster_BLEND_CHECK_SCISSOR)
-DEFINE_POINT_THICK_RASTER(sw_point_thick_raster_DEPTH_BLEND_SCISSOR, sw_point_raster_DEPTH_BLEND_CHECK_SCISSOR)
+    RLSW.depthMask = flag;
+}
 
-static inline void sw_point_render(sw_vertex_t *v)
+void swColorMask(bool r, bool g, bool b, bool a)
 {
-    if (!sw_point_clip_and_project(v)) return;
+    uint32_t mask = (r? 0x1 : 0) | (g? 0x2 : 0) | (b? 0x4 : 0) | (a? 0x8 : 0);
+    if (mask == RLSW.colorMask) return;
 
-    if (RLSW.pointRadius >= 1.0f)
-    {
-        if (SW_STATE_CHECK(SW_STATE_SCISSOR_TEST))
-        {
-            if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_thick_raster_DEPTH_BLEND_SCISSOR(v);
-            else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_point_thick_raster_BLEND_SCISSOR(v);
-            else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_point_thick_raster_DEPTH_SCISSOR(v);
-            else sw_point_thick_raster_SCISSOR(v);
-        }
-        else
-        {
-            if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_thick_raster_DEPTH_BLEND(v);
-            else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_point_thick_raster_BLEND(v);
-            else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_point_thick_raster_DEPTH(v);
-            else sw_point_thick_raster(v);
-        }
-    }
-    else
-    {
-        if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST | SW_STATE_BLEND)) sw_point_raster_DEPTH_BLEND(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
-        else if (SW_STATE_CHECK(SW_STATE_BLEND)) sw_point_raster_BLEND(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
-        else if (SW_STATE_CHECK(SW_STATE_DEPTH_TEST)) sw_point_raster_DEPTH(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
-        else sw_point_raster(v->screen[0], v->screen[1], v->homogeneous[2], v->color);
-    }
+    // Color mask is read at raster time and selects the raster functions
+    sw_deferred_flush();
+
+    RLSW.colorMask = mask;
+    RLSW.isDirtyRasterState = true;
 }
-//-------------------------------------------------------------------------------------------
 
-// Polygon modes rendering logic
-//-------------------------------------------------------------------------------------------
-static inline void sw_poly_point_render(void)
+void swPolygonMode(SWpoly mode)
 {
-    for (int i = 0; i < RLSW.vertexCounter; i++) sw_point_render(&RLSW.vertexBuffer[i]);
+    if (!sw_is_poly_mode_valid(mode))
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
+
+    RLSW.polyMode = mode;
 }
 
-static inline void sw_poly_line_render(void)
+void swCullFace(SWface face)
 {
-    const sw_vertex_t *vertices = RLSW.vertexBuffer;
-    int cm1 = RLSW.vertexCounter - 1;
-
-    for (int i = 0; i < cm1; i++)
+    if (!sw_is_face_valid(face))
     {
-        sw_vertex_t verts[2] = { vertices[i], vertices[i + 1] };
-        sw_line_render(verts);
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
     }
 
-    sw_vertex_t verts[2] = { vertices[cm1], vertices[0] };
-    sw_line_render(verts);
+    RLSW.cullFace = face;
+}
+
+void swPointSize(float size)
+{
+    RLSW.pointRadius = floorf(size*0.5f);
 }
 
-static inline void sw_poly_fill_render(void)
+void swLineWidth(float width)
 {
-    switch (RLSW.drawMode)
-    {
-        case SW_POINTS: sw_point_render(&RLSW.vertexBuffer[0]); break;
-        case SW_LINES: sw_line_render(RLSW.vertexBuffer); break;
-        case SW_TRIANGLES: sw_triangle_render(); break;
-        case SW_QUADS: sw_quad_render(); break;
-    }
+    RLSW.lineWidth = roundf(width);
 }
-//-------------------------------------------------------------------------------------------
 
-// Immediate rendering logic
-//-------------------------------------------------------------------------------------------
-void sw_immediate_push_vertex(const float position[4], const float color[4], const float texcoord[2])
+void swMatrixMode(SWmatrix mode)
 {
-    // Copy the attributes in the current vertex
-    sw_vertex_t *vertex = &RLSW.vertexBuffer[RLSW.vertexCounter++];
-    for (int i = 0; i < 4; i++)
+    switch (mode)
     {
-        vertex->position[i] = position[i];
-        if (i < 2) vertex->texcoord[i] = texcoord[i];
-        vertex->color[i] = color[i];
+        case SW_PROJECTION: RLSW.currentMatrix = &RLSW.stackProjection[RLSW.stackProjectionCounter - 1]; break;
+        case SW_MODELVIEW: RLSW.currentMatrix = &RLSW.stackModelview[RLSW.stackModelviewCounter - 1]; break;
+        case SW_TEXTURE: RLSW.currentMatrix = &RLSW.stackTexture[RLSW.stackTextureCounter - 1]; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; return;
     }
 
-    // Calculate homogeneous coordinates
-    const float *m = RLSW.matMVP, *v = vertex->position;
-    vertex->homogeneous[0] = m[0]*v[0] + m[4]*v[1] + m[8]*v[2] + m[12]*v[3];
-    vertex->homogeneous[1] = m[1]*v[0] + m[5]*v[1] + m[9]*v[2] + m[13]*v[3];
-    vertex->homogeneous[2] = m[2]*v[0] + m[6]*v[1] + m[10]*v[2] + m[14]*v[3];
-    vertex->homogeneous[3] = m[3]*v[0] + m[7]*v[1] + m[11]*v[2] + m[15]*v[3];
+    RLSW.currentMatrixMode = mode;
+}
 
-    // Immediate rendering of the primitive if the required number is reached
-    if (RLSW.vertexCounter == RLSW.reqVertices)
+void swPushMatrix(void)
+{
+    switch (RLSW.currentMatrixMode)
     {
-        switch (RLSW.polyMode)
+        case SW_PROJECTION:
         {
-            case SW_FILL: sw_poly_fill_render(); break;
-            case SW_LINE: sw_poly_line_render(); break;
-            case SW_POINT: sw_poly_point_render(); break;
-            default: break;
-        }
+            if (RLSW.stackProjectionCounter >= SW_MAX_PROJECTION_STACK_SIZE)
+            {
+                RLSW.errCode = SW_STACK_OVERFLOW;
+                return;
+            }
 
-        RLSW.vertexCounter = 0;
-    }
-}
+            int iOld = RLSW.stackProjectionCounter - 1;
+            int iNew = RLSW.stackProjectionCounter++;
 
-//-------------------------------------------------------------------------------------------
+            for (int i = 0; i < 16; i++)
+            {
+                RLSW.stackProjection[iNew][i] = RLSW.stackProjection[iOld][i];
+            }
 
-// Validity check helper functions
-//-------------------------------------------------------------------------------------------
-static inline bool sw_is_texture_valid(uint32_t id)
-{
-    bool valid = true;
+            RLSW.currentMatrix = &RLSW.stackProjection[iNew];
+        } break;
+        case SW_MODELVIEW:
+        {
+            if (RLSW.stackModelviewCounter >= SW_MAX_MODELVIEW_STACK_SIZE)
+            {
+                RLSW.errCode = SW_STACK_OVERFLOW;
+                return;
+            }
 
-    if (id == 0) valid = false;
-    else if (id >= SW_MAX_TEXTURES) valid = false;
-    else if (RLSW.loadedTextures[id].pixels == NULL) valid = false;
+            int iOld = RLSW.stackModelviewCounter - 1;
+            int iNew = RLSW.stackModelviewCounter++;
 
-    return true;
-}
+            for (int i = 0; i < 16; i++)
+            {
+                RLSW.stackModelview[iNew][i] = RLSW.stackModelview[iOld][i];
+            }
 
-static inline bool sw_is_texture_filter_valid(int filter)
-{
-    return ((filter == SW_NEAREST) || (filter == SW_LINEAR));
-}
+            RLSW.currentMatrix = &RLSW.stackModelview[iNew];
+        } break;
+        case SW_TEXTURE:
+        {
+            if (RLSW.stackTextureCounter >= SW_MAX_TEXTURE_STACK_SIZE)
+            {
+                RLSW.errCode = SW_STACK_OVERFLOW;
+                return;
+            }
 
-static inline bool sw_is_texture_wrap_valid(int wrap)
-{
-    return ((wrap == SW_REPEAT) || (wrap == SW_CLAMP));
-}
+            int iOld = RLSW.stackTextureCounter - 1;
+            int iNew = RLSW.stackTextureCounter++;
 
-static inline bool sw_is_draw_mode_valid(int mode)
-{
-    bool result = false;
+            for (int i = 0; i < 16; i++)
+            {
+                RLSW.stackTexture[iNew][i] = RLSW.stackTexture[iOld][i];
+            }
 
-    switch (mode)
-    {
-        case SW_POINTS:
-        case SW_LINES:
-        case SW_TRIANGLES:
-        case SW_QUADS: result = true; break;
+            RLSW.currentMatrix = &RLSW.stackTexture[iNew];
+        } break;
         default: break;
     }
-
-    return result;
 }
 
-static inline bool sw_is_poly_mode_valid(int mode)
+void swPopMatrix(void)
 {
-    bool result = false;
-
-    switch (mode)
+    switch (RLSW.currentMatrixMode)
     {
-        case SW_POINT:
-        case SW_LINE:
-        case SW_FILL: result = true; break;
+        case SW_PROJECTION:
+        {
+            if (RLSW.stackProjectionCounter <= 0)
+            {
+                RLSW.errCode = SW_STACK_UNDERFLOW;
+                return;
+            }
+
+            RLSW.currentMatrix = &RLSW.stackProjection[--RLSW.stackProjectionCounter];
+            RLSW.isDirtyMVP = true; //< The MVP is considered to have been changed
+        } break;
+        case SW_MODELVIEW:
+        {
+            if (RLSW.stackModelviewCounter <= 0)
+            {
+                RLSW.errCode = SW_STACK_UNDERFLOW;
+                return;
+            }
+
+            RLSW.currentMatrix = &RLSW.stackModelview[--RLSW.stackModelviewCounter];
+            RLSW.isDirtyMVP = true; //< The MVP is considered to have been changed
+        } break;
+        case SW_TEXTURE:
+        {
+            if (RLSW.stackTextureCounter <= 0)
+            {
+                RLSW.errCode = SW_STACK_UNDERFLOW;
+                return;
+            }
+
+            RLSW.currentMatrix = &RLSW.stackTexture[--RLSW.stackTextureCounter];
+        } break;
         default: break;
     }
+}
 
-    return result;
+void swLoadIdentity(void)
+{
+    sw_matrix_id(*RLSW.currentMatrix);
+    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
 }
 
-static inline bool sw_is_face_valid(int face)
+void swTranslatef(float x, float y, float z)
 {
-    return (face == SW_FRONT || face == SW_BACK);
+    sw_matrix_t mat;
+    sw_matrix_id(mat);
+
+    mat[12] = x;
+    mat[13] = y;
+    mat[14] = z;
+
+    sw_matrix_mul(*RLSW.currentMatrix, mat, *RLSW.currentMatrix);
+
+    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
 }
 
-static inline bool sw_is_blend_src_factor_valid(int blend)
+void swRotatef(float angle, float x, float y, float z)
 {
-    bool result = false;
+    angle *= SW_DEG2RAD;
 
-    switch (blend)
+    float lengthSq = x*x + y*y + z*z;
+
+    if ((lengthSq != 1.0f) && (lengthSq != 0.0f))
     {
-        case SW_ZERO:
-        case SW_ONE:
-        case SW_SRC_COLOR:
-        case SW_ONE_MINUS_SRC_COLOR:
-        case SW_SRC_ALPHA:
-        case SW_ONE_MINUS_SRC_ALPHA:
-        case SW_DST_ALPHA:
-        case SW_ONE_MINUS_DST_ALPHA:
-        case SW_DST_COLOR:
-        case SW_ONE_MINUS_DST_COLOR:
-        case SW_SRC_ALPHA_SATURATE: result = true; break;
-        default: break;
+        float invLength = 1.0f/sqrtf(lengthSq);
+        x *= invLength;
+        y *= invLength;
+        z *= invLength;
     }
 
-    return result;
+    float sinres = sinf(angle);
+    float cosres = cosf(angle);
+    float t = 1.0f - cosres;
+
+    sw_matrix_t mat;
+
+    mat[0] = x*x*t + cosres;
+    mat[1] = y*x*t + z*sinres;
+    mat[2] = z*x*t - y*sinres;
+    mat[3] = 0.0f;
+
+    mat[4] = x*y*t - z*sinres;
+    mat[5] = y*y*t + cosres;
+    mat[6] = z*y*t + x*sinres;
+    mat[7] = 0.0f;
+
+    mat[8] = x*z*t + y*sinres;
+    mat[9] = y*z*t - x*sinres;
+    mat[10] = z*z*t + cosres;
+    mat[11] = 0.0f;
+
+    mat[12] = 0.0f;
+    mat[13] = 0.0f;
+    mat[14] = 0.0f;
+    mat[15] = 1.0f;
+
+    sw_matrix_mul(*RLSW.currentMatrix, mat, *RLSW.currentMatrix);
+
+    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
 }
 
-static inline bool sw_is_blend_dst_factor_valid(int blend)
+void swScalef(float x, float y, float z)
 {
-    bool result = false;
+    sw_matrix_t mat;
 
-    switch (blend)
-    {
-        case SW_ZERO:
-        case SW_ONE:
-        case SW_SRC_COLOR:
-        case SW_ONE_MINUS_SRC_COLOR:
-        case SW_SRC_ALPHA:
-        case SW_ONE_MINUS_SRC_ALPHA:
-        case SW_DST_ALPHA:
-        case SW_ONE_MINUS_DST_ALPHA:
-        case SW_DST_COLOR:
-        case SW_ONE_MINUS_DST_COLOR: result = true; break;
-        default: break;
-    }
+    mat[0]  = x, mat[1]  = 0, mat[2]  = 0, mat[3]  = 0;
+    mat[4]  = 0, mat[5]  = y, mat[6]  = 0, mat[7]  = 0;
+    mat[8]  = 0, mat[9]  = 0, mat[10] = z, mat[11] = 0;
+    mat[12] = 0, mat[13] = 0, mat[14] = 0, mat[15] = 1;
 
-    return result;
+    sw_matrix_mul(*RLSW.currentMatrix, mat, *RLSW.currentMatrix);
+
+    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
 }
-//-------------------------------------------------------------------------------------------
 
-//----------------------------------------------------------------------------------
-// Module Functions Definition
-//----------------------------------------------------------------------------------
-bool swInit(int w, int h)
+void swMultMatrixf(const float *mat)
 {
-    if (!sw_framebuffer_load(w, h)) { swClose(); return false; }
+    sw_matrix_mul(*RLSW.currentMatrix, mat, *RLSW.currentMatrix);
 
-    swViewport(0, 0, w, h);
-    swScissor(0, 0, w, h);
+    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
+}
 
-    RLSW.loadedTextures = (sw_texture_t *)SW_MALLOC(SW_MAX_TEXTURES*sizeof(sw_texture_t));
-    if (RLSW.loadedTextures == NULL) { swClose(); return false; }
+void swFrustum(double left, double right, double bottom, double top, double znear, double zfar)
+{
+    sw_matrix_t mat;
 
-    RLSW.freeTextureIds = (uint32_t *)SW_MALLOC(SW_MAX_TEXTURES*sizeof(uint32_t));
-    if (RLSW.loadedTextures == NULL) { swClose(); return false; }
+    double rl = right - left;
+    double tb = top - bottom;
+    double fn = zfar - znear;
 
-    const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    sw_framebuffer_write_color(&RLSW.clearValue, clearColor);
-    sw_framebuffer_write_depth(&RLSW.clearValue, 1.0f);
+    mat[0] = (float)(znear*2.0)/rl;
+    mat[1] = 0.0f;
+    mat[2] = 0.0f;
+    mat[3] = 0.0f;
 
-    RLSW.currentMatrixMode = SW_MODELVIEW;
-    RLSW.currentMatrix = &RLSW.stackModelview[0];
+    mat[4] = 0.0f;
+    mat[5] = (float)(znear*2.0)/tb;
+    mat[6] = 0.0f;
+    mat[7] = 0.0f;
 
-    sw_matrix_id(RLSW.stackProjection[0]);
-    sw_matrix_id(RLSW.stackModelview[0]);
-    sw_matrix_id(RLSW.stackTexture[0]);
-    sw_matrix_id(RLSW.matMVP);
+    mat[8] = (float)(right + left)/rl;
+    mat[9] = (float)(top + bottom)/tb;
+    mat[10] = -(float)(zfar + znear)/fn;
+    mat[11] = -1.0f;
 
-    RLSW.stackProjectionCounter = 1;
-    RLSW.stackModelviewCounter = 1;
-    RLSW.stackTextureCounter = 1;
-    RLSW.isDirtyMVP = false;
+    mat[12] = 0.0f;
+    mat[13] = 0.0f;
+    mat[14] = -(zfar*znear*2.0)/fn;
+    mat[15] = 0.0f;
 
-    RLSW.current.texcoord[0] = 0.0f;
-    RLSW.current.texcoord[1] = 0.0f;
+    sw_matrix_mul(*RLSW.currentMatrix, *RLSW.currentMatrix, mat);
 
-    RLSW.current.color[0] = 1.0f;
-    RLSW.current.color[1] = 1.0f;
-    RLSW.current.color[2] = 1.0f;
-    RLSW.current.color[3] = 1.0f;
+    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
+}
 
-    RLSW.srcFactor = SW_SRC_ALPHA;
-    RLSW.dstFactor = SW_ONE_MINUS_SRC_ALPHA;
+void swOrtho(double left, double right, double bottom, double top, double znear, double zfar)
+{
+    sw_matrix_t mat;
 
-    RLSW.srcFactorFunc = sw_factor_src_alpha;
-    RLSW.dstFactorFunc = sw_factor_one_minus_src_alpha;
+    double rl = right - left;
+    double tb = top - bottom;
+    double fn = zfar - znear;
 
-    RLSW.polyMode = SW_FILL;
-    RLSW.cullFace = SW_BACK;
+    mat[0] = 2.0f/(float)rl;
+    mat[1] = 0.0f;
+    mat[2] = 0.0f;
+    mat[3] = 0.0f;
 
-    static uint32_t defaultTex[3*2*2] = {
-        0xFFFFFFFF,
-        0xFFFFFFFF,
-        0xFFFFFFFF,
-        0xFFFFFFFF
-    };
+    mat[4] = 0.0f;
+    mat[5] = 2.0f/(float)tb;
+    mat[6] = 0.0f;
+    mat[7] = 0.0f;
 
-    RLSW.loadedTextures[0].pixels = (uint8_t*)defaultTex;
-    RLSW.loadedTextures[0].width = 2;
-    RLSW.loadedTextures[0].height = 2;
-    RLSW.loadedTextures[0].wMinus1 = 1;
-    RLSW.loadedTextures[0].hMinus1 = 1;
-    RLSW.loadedTextures[0].minFilter = SW_NEAREST;
-    RLSW.loadedTextures[0].magFilter = SW_NEAREST;
-    RLSW.loadedTextures[0].sWrap = SW_REPEAT;
-    RLSW.loadedTextures[0].tWrap = SW_REPEAT;
-    RLSW.loadedTextures[0].tx = 0.5f;
-    RLSW.loadedTextures[0].ty = 0.5f;
+    mat[8] = 0.0f;
+    mat[9] = 0.0f;
+    mat[10] = -2.0f/(float)fn;
+    mat[11] = 0.0f;
 
-    RLSW.loadedTextureCount = 1;
+    mat[12] = -(float)(left + right)/rl;
+    mat[13] = -(float)(top + bottom)/tb;
+    mat[14] = -(float)(zfar + znear)/fn;
+    mat[15] = 1.0f;
 
-    SW_LOG("INFO: RLSW: Software renderer initialized successfully\n");
-#if defined(SW_HAS_FMA_AVX) && defined(SW_HAS_FMA_AVX2)
-    SW_LOG("INFO: RLSW: Using SIMD instructions: FMA AVX\n");
-#endif
-#if defined(SW_HAS_AVX) || defined(SW_HAS_AVX2)
-    SW_LOG("INFO: RLSW: Using SIMD instructions: AVX\n");
-#endif
-#if defined(SW_HAS_SSE) || defined(SW_HAS_SSE2) || defined(SW_HAS_SSE3) || defined(SW_HAS_SSSE3) || defined(SW_HAS_SSE41) || defined(SW_HAS_SSE42)
-    SW_LOG("INFO: RLSW: Using SIMD instructions: SSE\n");
-#endif
-#if defined(SW_HAS_NEON_FMA) || defined(SW_HAS_NEON)
-    SW_LOG("INFO: RLSW: Using SIMD instructions: NEON\n");
-#endif
-#if defined(SW_HAS_RVV)
-    SW_LOG("INFO: RLSW: Using SIMD instructions: RVV\n");
-#endif
+    sw_matrix_mul(*RLSW.currentMatrix, *RLSW.currentMatrix, mat);
 
-    return true;
+    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
 }
 
-void swClose(void)
+void swBegin(SWdraw mode)
 {
-    // NOTE: Starts at texture 1, texture 0 does not have to be freed
-    for (int i = 1; i < RLSW.loadedTextureCount; i++)
+    // Check if the draw mode is valid
+    if (!sw_is_draw_mode_valid(mode))
     {
-        if (sw_is_texture_valid(i))
-        {
-            SW_FREE(RLSW.loadedTextures[i].pixels);
-        }
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
     }
 
-    SW_FREE(RLSW.framebuffer.pixels);
-    SW_FREE(RLSW.loadedTextures);
-    SW_FREE(RLSW.freeTextureIds);
+    // Recalculate the MVP if this is needed
+    if (RLSW.isDirtyMVP)
+    {
+        sw_matrix_mul_rst(RLSW.matMVP,
+            RLSW.stackModelview[RLSW.stackModelviewCounter - 1],
+            RLSW.stackProjection[RLSW.stackProjectionCounter - 1]);
 
-    RLSW = SW_CURLY_INIT(sw_context_t) { 0 };
+        RLSW.isDirtyMVP = false;
+    }
+
+    // Obtain the number of vertices needed for this primitive
+    switch (mode)
+    {
+        case SW_POINTS: RLSW.reqVertices = 1; break;
+        case SW_LINES: RLSW.reqVertices = 2; break;
+        case SW_TRIANGLES: RLSW.reqVertices = 3; break;
+        case SW_QUADS: RLSW.reqVertices = 4; break;
+    }
+
+    // Initialize required values
+    RLSW.vertexCounter = 0;
+    RLSW.drawMode = mode;
 }
 
-bool swResizeFramebuffer(int w, int h)
+void swEnd(void)
 {
-    return sw_framebuffer_resize(w, h);
+    RLSW.drawMode = (SWdraw)0;
 }
 
-void swCopyFramebuffer(int x, int y, int w, int h, SWformat format, SWtype type, void *pixels)
+void swVertex2i(int x, int y)
 {
-    sw_pixelformat_t pFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
-
-    if (w <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
-    if (h <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
-
-    if (w > RLSW.framebuffer.width) w = RLSW.framebuffer.width;
-    if (h > RLSW.framebuffer.height) h = RLSW.framebuffer.height;
-
-    x = sw_clampi(x, 0, w);
-    y = sw_clampi(y, 0, h);
-
-    if ((x >= w) || (y >= h)) return;
-
-    if ((x == 0) && (y == 0) && (w == RLSW.framebuffer.width) && (h == RLSW.framebuffer.height))
-    {
-        #if SW_COLOR_BUFFER_BITS == 32
-            if (pFormat == SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
-            {
-                sw_framebuffer_copy_fast(pixels);
-                return;
-            }
-        #elif SW_COLOR_BUFFER_BITS == 16
-            if (pFormat == SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5)
-            {
-                sw_framebuffer_copy_fast(pixels);
-                return;
-            }
-        #endif
-    }
-
-    switch (pFormat)
-    {
-        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: sw_framebuffer_copy_to_GRAYALPHA(x, y, w, h, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: sw_framebuffer_copy_to_GRAYALPHA(x, y, w, h, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: sw_framebuffer_copy_to_R5G6B5(x, y, w, h, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: sw_framebuffer_copy_to_R8G8B8(x, y, w, h, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: sw_framebuffer_copy_to_R5G5B5A1(x, y, w, h, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: sw_framebuffer_copy_to_R4G4B4A4(x, y, w, h, (uint16_t *)pixels); break;
-        //case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_copy_to_R8G8B8A8(x, y, w, h, (uint8_t *)pixels); break;
-        // Below: not implemented
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
-        default: RLSW.errCode = SW_INVALID_ENUM; break;
-    }
+    const float v[4] = { (float)x, (float)y, 0.0f, 1.0f };
+    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
 }
 
-void swBlitFramebuffer(int xDst, int yDst, int wDst, int hDst, int xSrc, int ySrc, int wSrc, int hSrc, SWformat format, SWtype type, void *pixels)
+void swVertex2f(float x, float y)
 {
-    sw_pixelformat_t pFormat = (sw_pixelformat_t)sw_get_pixel_format(format, type);
-
-    if (wSrc <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
-    if (hSrc <= 0) { RLSW.errCode = SW_INVALID_VALUE; return; }
+    const float v[4] = { x, y, 0.0f, 1.0f };
+    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
+}
 
-    if (wSrc > RLSW.framebuffer.width) wSrc = RLSW.framebuffer.width;
-    if (hSrc > RLSW.framebuffer.height) hSrc = RLSW.framebuffer.height;
+void swVertex2fv(const float *v)
+{
+    const float v4[4] = { v[0], v[1], 0.0f, 1.0f };
+    sw_immediate_push_vertex(v4, RLSW.current.color, RLSW.current.texcoord);
+}
 
-    xSrc = sw_clampi(xSrc, 0, wSrc);
-    ySrc = sw_clampi(ySrc, 0, hSrc);
+void swVertex3i(int x, int y, int z)
+{
+    const float v[4] = { (float)x, (float)y, (float)z, 1.0f };
+    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
+}
 
-    // Check if the sizes are identical after clamping the source to avoid unexpected issues
-    // REVIEW: This repeats the operations if true, so we could make a copy function without these checks
-    if (xDst == xSrc && yDst == ySrc && wDst == wSrc && hDst == hSrc)
-    {
-        swCopyFramebuffer(xSrc, ySrc, wSrc, hSrc, format, type, pixels);
-    }
+void swVertex3f(float x, float y, float z)
+{
+    const float v[4] = { x, y, z, 1.0f };
+    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
+}
 
-    switch (pFormat)
-    {
-        case SW_PIXELFORMAT_UNCOMPRESSED_GRAYSCALE: sw_framebuffer_blit_to_GRAYALPHA(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: sw_framebuffer_blit_to_GRAYALPHA(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R5G6B5: sw_framebuffer_blit_to_R5G6B5(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8: sw_framebuffer_blit_to_R8G8B8(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: sw_framebuffer_blit_to_R5G5B5A1(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: sw_framebuffer_blit_to_R4G4B4A4(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint16_t *)pixels); break;
-        case SW_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: sw_framebuffer_blit_to_R8G8B8A8(xDst, yDst, wDst, hDst, xSrc, ySrc, wSrc, hSrc, (uint8_t *)pixels); break;
-        // Below: not implemented
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R32G32B32A32:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16:
-        case SW_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16:
-        default:
-            RLSW.errCode = SW_INVALID_ENUM;
-            break;
-    }
+void swVertex3fv(const float *v)
+{
+    const float v4[4] = { v[0], v[1], v[2], 1.0f };
+    sw_immediate_push_vertex(v4, RLSW.current.color, RLSW.current.texcoord);
 }
 
-void swEnable(SWstate state)
+void swVertex4i(int x, int y, int z, int w)
 {
-    switch (state)
-    {
-        case SW_SCISSOR_TEST: RLSW.stateFlags |= SW_STATE_SCISSOR_TEST; break;
-        case SW_TEXTURE_2D: RLSW.stateFlags |= SW_STATE_TEXTURE_2D; break;
-        case SW_DEPTH_TEST: RLSW.stateFlags |= SW_STATE_DEPTH_TEST; break;
-        case SW_CULL_FACE: RLSW.stateFlags |= SW_STATE_CULL_FACE; break;
-        case SW_BLEND: RLSW.stateFlags |= SW_STATE_BLEND; break;
-        default: RLSW.errCode = SW_INVALID_ENUM; break;
-    }
+    const float v[4] = { (float)x, (float)y, (float)z, (float)w };
+    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
 }
 
-void swDisable(SWstate state)
+void swVertex4f(float x, float y, float z, float w)
 {
-    switch (state)
-    {
-        case SW_SCISSOR_TEST: RLSW.stateFlags &= ~SW_STATE_SCISSOR_TEST; break;
-        case SW_TEXTURE_2D: RLSW.stateFlags &= ~SW_STATE_TEXTURE_2D; break;
-        case SW_DEPTH_TEST: RLSW.stateFlags &= ~SW_STATE_DEPTH_TEST; break;
-        case SW_CULL_FACE: RLSW.stateFlags &= ~SW_STATE_CULL_FACE; break;
-        case SW_BLEND: RLSW.stateFlags &= ~SW_STATE_BLEND; break;
-        default: RLSW.errCode = SW_INVALID_ENUM; break;
-    }
+    const float v[4] = { x, y, z, w };
+    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
 }
 
-void swGetIntegerv(SWget name, int *v)
+void swVertex4fv(const float *v)
 {
-    switch (name)
-    {
-        case SW_MODELVIEW_STACK_DEPTH: *v = SW_MODELVIEW_STACK_DEPTH; break;
-        case SW_PROJECTION_STACK_DEPTH: *v = SW_PROJECTION_STACK_DEPTH; break;
-        case SW_TEXTURE_STACK_DEPTH: *v = SW_TEXTURE_STACK_DEPTH; break;
-        default: RLSW.errCode = SW_INVALID_ENUM; break;
-    }
+    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
 }
 
-void swGetFloatv(SWget name, float *v)
+void swColor3ub(uint8_t r, uint8_t g, uint8_t b)
 {
-    switch (name)
-    {
-        case SW_COLOR_CLEAR_VALUE:
-        {
-            sw_framebuffer_read_color(v, &RLSW.clearValue);
-        } break;
-        case SW_DEPTH_CLEAR_VALUE:
-        {
-            v[0] = sw_framebuffer_read_depth(&RLSW.clearValue);
-        } break;
-        case SW_CURRENT_COLOR:
-        {
-            v[0] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].color[0];
-            v[1] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].color[1];
-            v[2] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].color[2];
-            v[3] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].color[3];
-        } break;
-        case SW_CURRENT_TEXTURE_COORDS:
-        {
-            v[0] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].texcoord[0];
-            v[1] = RLSW.vertexBuffer[RLSW.vertexCounter - 1].texcoord[1];
-        } break;
-        case SW_POINT_SIZE:
-        {
-            v[0] = 2.0f*RLSW.pointRadius;
-        } break;
-        case SW_LINE_WIDTH:
-        {
-            v[0] = RLSW.lineWidth;
-        } break;
-        case SW_MODELVIEW_MATRIX:
-        {
-            for (int i = 0; i < 16; i++) v[i] = RLSW.stackModelview[RLSW.stackModelviewCounter - 1][i];
+    float cv[4];
+    cv[0] = (float)r*SW_INV_255;
+    cv[1] = (float)g*SW_INV_255;
+    cv[2] = (float)b*SW_INV_255;
+    cv[3] = 1.0f;
 
-        } break;
-        case SW_PROJECTION_MATRIX:
-        {
-            for (int i = 0; i < 16; i++) v[i] = RLSW.stackProjection[RLSW.stackProjectionCounter - 1][i];
+    swColor4fv(cv);
+}
 
-        } break;
-        case SW_TEXTURE_MATRIX:
-        {
-            for (int i = 0; i < 16; i++) v[i] = RLSW.stackTexture[RLSW.stackTextureCounter - 1][i];
+void swColor3ubv(const uint8_t *v)
+{
+    float cv[4];
+    cv[0] = (float)v[0]*SW_INV_255;
+    cv[1] = (float)v[1]*SW_INV_255;
+    cv[2] = (float)v[2]*SW_INV_255;
+    cv[3] = 1.0f;
 
-        } break;
-        default: RLSW.errCode = SW_INVALID_ENUM; break;
-    }
+    swColor4fv(cv);
 }
 
-const char *swGetString(SWget name)
+void swColor3f(float r, float g, float b)
 {
-    const char *result = NULL;
-
-    switch (name)
-    {
-        case SW_VENDOR: result = "RLSW Header"; break;
-        case SW_RENDERER: result = "RLSW Software Renderer"; break;
-        case SW_VERSION: result = "RLSW 1.0"; break;
-        case SW_EXTENSIONS: result = "None"; break;
-        default: RLSW.errCode = SW_INVALID_ENUM; break;
-    }
+    float cv[4];
+    cv[0] = r;
+    cv[1] = g;
+    cv[2] = b;
+    cv[3] = 1.0f;
 
-    return result;
+    swColor4fv(cv);
 }
 
-SWerrcode swGetError(void)
+void swColor3fv(const float *v)
 {
-    SWerrcode ret = RLSW.errCode;
-    RLSW.errCode = SW_NO_ERROR;
-    return ret;
+    float cv[4];
+    cv[0] = v[0];
+    cv[1] = v[1];
+    cv[2] = v[2];
+    cv[3] = 1.0f;
+
+    swColor4fv(cv);
 }
 
-void swViewport(int x, int y, int width, int height)
+void swColor4ub(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
 {
-    if ((width < 0) || (height < 0))
-    {
-        RLSW.errCode = SW_INVALID_VALUE;
-        return;
-    }
-
-    RLSW.vpSize[0] = width;
-    RLSW.vpSize[1] = height;
+    float cv[4];
+    cv[0] = (float)r*SW_INV_255;
+    cv[1] = (float)g*SW_INV_255;
+    cv[2] = (float)b*SW_INV_255;
+    cv[3] = (float)a*SW_INV_255;
 
-    RLSW.vpHalf[0] = width/2.0f;
-    RLSW.vpHalf[1] = height/2.0f;
+    swColor4fv(cv);
+}
 
-    RLSW.vpCenter[0] = (float)x + RLSW.vpHalf[0];
-    RLSW.vpCenter[1] = (float)y + RLSW.vpHalf[1];
+void swColor4ubv(const uint8_t *v)
+{
+    float cv[4];
+    cv[0] = (float)v[0]*SW_INV_255;
+    cv[1] = (float)v[1]*SW_INV_255;
+    cv[2] = (float)v[2]*SW_INV_255;
+    cv[3] = (float)v[3]*SW_INV_255;
 
-    RLSW.vpMin[0] = sw_clampi(x, 0, RLSW.framebuffer.width - 1);
-    RLSW.vpMin[1] = sw_clampi(y, 0, RLSW.framebuffer.height - 1);
-    RLSW.vpMax[0] = sw_clampi(x + width, 0, RLSW.framebuffer.width - 1);
-    RLSW.vpMax[1] = sw_clampi(y + height, 0, RLSW.framebuffer.height - 1);
+    swColor4fv(cv);
 }
 
-void swScissor(int x, int y, int width, int height)
+void swColor4f(float r, float g, float b, float a)
 {
-    if ((width < 0) || (height < 0))
-    {
-        RLSW.errCode = SW_INVALID_VALUE;
-        return;
-    }
-
-    RLSW.scMin[0] = sw_clampi(x, 0, RLSW.framebuffer.width - 1);
-    RLSW.scMin[1] = sw_clampi(y, 0, RLSW.framebuffer.height - 1);
-    RLSW.scMax[0] = sw_clampi(x + width, 0, RLSW.framebuffer.width - 1);
-    RLSW.scMax[1] = sw_clampi(y + height, 0, RLSW.framebuffer.height - 1);
+    float cv[4];
+    cv[0] = r;
+    cv[1] = g;
+    cv[2] = b;
+    cv[3] = a;
 
-    RLSW.scClipMin[0] = (2.0f*(float)RLSW.scMin[0]/(float)RLSW.vpSize[0]) - 1.0f;
-    RLSW.scClipMax[0] = (2.0f*(float)RLSW.scMax[0]/(float)RLSW.vpSize[0]) - 1.0f;
-    RLSW.scClipMax[1] = 1.0f - (2.0f*(float)RLSW.scMin[1]/(float)RLSW.vpSize[1]);
-    RLSW.scClipMin[1] = 1.0f - (2.0f*(float)RLSW.scMax[1]/(float)RLSW.vpSize[1]);
+    swColor4fv(cv);
 }
 
-void swClearColor(float r, float g, float b, float a)
+void swColor4fv(const float *v)
 {
-    float v[4] = { r, g, b, a };
-    sw_framebuffer_write_color(&RLSW.clearValue, v);
+    for (int i = 0; i < 4; i++) RLSW.current.color[i] = v[i];
 }
 
-void swClearDepth(float depth)
+void swTexCoord2f(float u, float v)
 {
-    sw_framebuffer_write_depth(&RLSW.clearValue, depth);
+    const float *m = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
+
+    RLSW.current.texcoord[0] = m[0]*u + m[4]*v + m[12];
+    RLSW.current.texcoord[1] = m[1]*u + m[5]*v + m[13];
 }
 
-void swClear(uint32_t bitmask)
+void swTexCoord2fv(const float *v)
 {
-    int size = RLSW.framebuffer.width*RLSW.framebuffer.height;
+    const float *m = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
 
-    if ((bitmask & (SW_COLOR_BUFFER_BIT | SW_DEPTH_BUFFER_BIT)) == (SW_COLOR_BUFFER_BIT | SW_DEPTH_BUFFER_BIT))
-    {
-        sw_framebuffer_fill(RLSW.framebuffer.pixels, size, RLSW.clearValue);
-    }
-    else if (bitmask & (SW_COLOR_BUFFER_BIT))
-    {
-        sw_framebuffer_fill_color(RLSW.framebuffer.pixels, size, RLSW.clearValue.color);
-    }
-    else if (bitmask & SW_DEPTH_BUFFER_BIT)
+    RLSW.current.texcoord[0] = m[0]*v[0] + m[4]*v[1] + m[12];
+    RLSW.current.texcoord[1] = m[1]*v[0] + m[5]*v[1] + m[13];
+}
+
+void swBindArray(SWarray type, void *buffer)
+{
+    switch (type)
     {
-        sw_framebuffer_fill_depth(RLSW.framebuffer.pixels, size, RLSW.clearValue.depth);
+        case SW_VERTEX_ARRAY: RLSW.array.positions = (float *)buffer; break;
+        case SW_TEXTURE_COORD_ARRAY: RLSW.array.texcoords = (float *)buffer; break;
+        case SW_COLOR_ARRAY: RLSW.array.colors = (uint8_t *)buffer; break;
+        default: break;
     }
 }
 
-void swBlendFunc(SWfactor sfactor, SWfactor dfactor)
+void swDrawArrays(SWdraw mode, int offset, int count)
 {
-    if (!sw_is_blend_src_factor_valid(sfactor) ||
-        !sw_is_blend_dst_factor_valid(dfactor))
+    if (RLSW.array.positions == 0)
     {
-        RLSW.errCode = SW_INVALID_ENUM;
+        RLSW.errCode = SW_INVALID_OPERATION;
         return;
     }
 
-    RLSW.srcFactor = sfactor;
-    RLSW.dstFactor = dfactor;
+    if (count < 0)
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
 
-    switch (sfactor)
+    if (!sw_vertex_cache_reserve(sw_mini(count, SW_VERTEX_BATCH_SIZE)))
     {
-        case SW_ZERO: RLSW.srcFactorFunc = sw_factor_zero; break;
-        case SW_ONE: RLSW.srcFactorFunc = sw_factor_one; break;
-        case SW_SRC_COLOR: RLSW.srcFactorFunc = sw_factor_src_color; break;
-        case SW_ONE_MINUS_SRC_COLOR: RLSW.srcFactorFunc = sw_factor_one_minus_src_color; break;
-        case SW_SRC_ALPHA: RLSW.srcFactorFunc = sw_factor_src_alpha; break;
-        case SW_ONE_MINUS_SRC_ALPHA: RLSW.srcFactorFunc = sw_factor_one_minus_src_alpha; break;
-        case SW_DST_ALPHA: RLSW.srcFactorFunc = sw_factor_dst_alpha; break;
-        case SW_ONE_MINUS_DST_ALPHA: RLSW.srcFactorFunc = sw_factor_one_minus_dst_alpha; break;
-        case SW_DST_COLOR: RLSW.srcFactorFunc = sw_factor_dst_color; break;
-        case SW_ONE_MINUS_DST_COLOR: RLSW.srcFactorFunc = sw_factor_one_minus_dst_color; break;
-        case SW_SRC_ALPHA_SATURATE: RLSW.srcFactorFunc = sw_factor_src_alpha_saturate; break;
-        default: break;
+        RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+        return;
     }
 
-    switch (dfactor)
+    swBegin(mode);
     {
-        case SW_ZERO: RLSW.dstFactorFunc = sw_factor_zero; break;
-        case SW_ONE: RLSW.dstFactorFunc = sw_factor_one; break;
-        case SW_SRC_COLOR: RLSW.dstFactorFunc = sw_factor_src_color; break;
-        case SW_ONE_MINUS_SRC_COLOR: RLSW.dstFactorFunc = sw_factor_one_minus_src_color; break;
-        case SW_SRC_ALPHA: RLSW.dstFactorFunc = sw_factor_src_alpha; break;
-        case SW_ONE_MINUS_SRC_ALPHA: RLSW.dstFactorFunc = sw_factor_one_minus_src_alpha; break;
-        case SW_DST_ALPHA: RLSW.dstFactorFunc = sw_factor_dst_alpha; break;
-        case SW_ONE_MINUS_DST_ALPHA: RLSW.dstFactorFunc = sw_factor_one_minus_dst_alpha; break;
-        case SW_DST_COLOR: RLSW.dstFactorFunc = sw_factor_dst_color; break;
-        case SW_ONE_MINUS_DST_COLOR: RLSW.dstFactorFunc = sw_factor_one_minus_dst_color; break;
-        case SW_SRC_ALPHA_SATURATE: break;
-        default: break;
+        int end = offset + count;
+
+        for (int first = offset; first < end; first += SW_VERTEX_BATCH_SIZE)
+        {
+            int batchCount = sw_mini(end - first, SW_VERTEX_BATCH_SIZE);
+            sw_vertex_batch_process(RLSW.vertexCache, first, batchCount);
+
+            for (int i = 0; i < batchCount; i++) sw_immediate_push_transformed_vertex(&RLSW.vertexCache[i]);
+        }
     }
+    swEnd();
 }
 
-void swPolygonMode(SWpoly mode)
+void swDrawElements(SWdraw mode, int count, int type, const void *indices)
 {
-    if (!sw_is_poly_mode_valid(mode))
+    if (RLSW.array.positions == 0)
     {
-        RLSW.errCode = SW_INVALID_ENUM;
+        RLSW.errCode = SW_INVALID_OPERATION;
         return;
     }
 
-    RLSW.polyMode = mode;
-}
-
-void swCullFace(SWface face)
-{
-    if (!sw_is_face_valid(face))
+    if (count < 0)
     {
-        RLSW.errCode = SW_INVALID_ENUM;
+        RLSW.errCode = SW_INVALID_VALUE;
         return;
     }
 
-    RLSW.cullFace = face;
-}
+    const uint8_t *indicesUb = NULL;
+    const uint16_t *indicesUs = NULL;
+    const uint32_t *indicesUi = NULL;
 
-void swPointSize(float size)
-{
-    RLSW.pointRadius = floorf(size*0.5f);
-}
+    switch (type)
+    {
+        case SW_UNSIGNED_BYTE:
+            indicesUb = (const uint8_t *)indices;
+            break;
+        case SW_UNSIGNED_SHORT:
+            indicesUs = (const uint16_t *)indices;
+            break;
+        case SW_UNSIGNED_INT:
+            indicesUi = (const uint32_t *)indices;
+            break;
+        default:
+            RLSW.errCode = SW_INVALID_ENUM;
+            return;
+    }
 
-void swLineWidth(float width)
-{
-    RLSW.lineWidth = roundf(width);
-}
+    if (count == 0) return;
 
-void swMatrixMode(SWmatrix mode)
-{
-    switch (mode)
+    // Get the range of vertices referenced by the indices
+    int minIndex = indicesUb? indicesUb[0] : (indicesUs? indicesUs[0] : (int)indicesUi[0]);
+    int maxIndex = minIndex;
+
+    for (int i = 1; i < count; i++)
     {
-        case SW_PROJECTION: RLSW.currentMatrix = &RLSW.stackProjection[RLSW.stackProjectionCounter - 1]; break;
-        case SW_MODELVIEW: RLSW.currentMatrix = &RLSW.stackModelview[RLSW.stackModelviewCounter - 1]; break;
-        case SW_TEXTURE: RLSW.currentMatrix = &RLSW.stackTexture[RLSW.stackTextureCounter - 1]; break;
-        default: RLSW.errCode = SW_INVALID_ENUM; return;
+        int index = indicesUb? indicesUb[i] :
+                   (indicesUs? indicesUs[i] : (int)indicesUi[i]);
+
+        minIndex = sw_mini(minIndex, index);
+        maxIndex = sw_maxi(maxIndex, index);
     }
 
-    RLSW.currentMatrixMode = mode;
-}
+    // When the indices reference a compact range (indexed meshes), every vertex of
+    // the range is transformed once and shared by all the primitives using it,
+    // otherwise the referenced vertices are gathered and transformed per batch
+    int rangeCount = maxIndex - minIndex + 1;
+    bool useRange = (rangeCount <= sw_maxi(count, SW_VERTEX_BATCH_SIZE));
 
-void swPushMatrix(void)
-{
-    switch (RLSW.currentMatrixMode)
+    if (!sw_vertex_cache_reserve(useRange? rangeCount : sw_mini(count, SW_VERTEX_BATCH_SIZE)))
     {
-        case SW_PROJECTION:
+        RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+        return;
+    }
+
+    swBegin(mode);
+    {
+        if (useRange)
         {
-            if (RLSW.stackProjectionCounter >= SW_MAX_PROJECTION_STACK_SIZE)
+            for (int first = 0; first < rangeCount; first += SW_VERTEX_BATCH_SIZE)
             {
-                RLSW.errCode = SW_STACK_OVERFLOW;
-                return;
+                int batchCount = sw_mini(rangeCount - first, SW_VERTEX_BATCH_SIZE);
+                sw_vertex_batch_process(&RLSW.vertexCache[first], minIndex + first, batchCount);
             }
 
-            int iOld = RLSW.stackProjectionCounter - 1;
-            int iNew = RLSW.stackProjectionCounter++;
-
-            for (int i = 0; i < 16; i++)
+            for (int i = 0; i < count; i++)
             {
-                RLSW.stackProjection[iNew][i] = RLSW.stackProjection[iOld][i];
-            }
+                int index = indicesUb? indicesUb[i] :
+                           (indicesUs? indicesUs[i] : (int)indicesUi[i]);
 
-            RLSW.currentMatrix = &RLSW.stackProjection[iNew];
-        } break;
-        case SW_MODELVIEW:
+                sw_immediate_push_transformed_vertex(&RLSW.vertexCache[index - minIndex]);
+            }
+        }
+        else
         {
-            if (RLSW.stackModelviewCounter >= SW_MAX_MODELVIEW_STACK_SIZE)
+            for (int first = 0; first < count; first += SW_VERTEX_BATCH_SIZE)
             {
-                RLSW.errCode = SW_STACK_OVERFLOW;
-                return;
-            }
-
-            int iOld = RLSW.stackModelviewCounter - 1;
-            int iNew = RLSW.stackModelviewCounter++;
+                int batchCount = sw_mini(count - first, SW_VERTEX_BATCH_SIZE);
 
-            for (int i = 0; i < 16; i++)
-            {
-                RLSW.stackModelview[iNew][i] = RLSW.stackModelview[iOld][i];
-            }
+                for (int i = 0; i < batchCount; i++)
+                {
+                    int index = indicesUb? indicesUb[first + i] :
+                               (indicesUs? indicesUs[first + i] : (int)indicesUi[first + i]);
 
-            RLSW.currentMatrix = &RLSW.stackModelview[iNew];
-        } break;
-        case SW_TEXTURE:
-        {
-            if (RLSW.stackTextureCounter >= SW_MAX_TEXTURE_STACK_SIZE)
-            {
-                RLSW.errCode = SW_STACK_OVERFLOW;
-                return;
-            }
+                    sw_vertex_fetch(&RLSW.vertexCache[i], index);
+                }
 
-            int iOld = RLSW.stackTextureCounter - 1;
-            int iNew = RLSW.stackTextureCounter++;
+                sw_vertex_batch_transform(RLSW.vertexCache, batchCount);
 
-            for (int i = 0; i < 16; i++)
-            {
-                RLSW.stackTexture[iNew][i] = RLSW.stackTexture[iOld][i];
+                for (int i = 0; i < batchCount; i++) sw_immediate_push_transformed_vertex(&RLSW.vertexCache[i]);
             }
-
-            RLSW.currentMatrix = &RLSW.stackTexture[iNew];
-        } break;
-        default: break;
+        }
     }
+    swEnd();
 }
 
-void swPopMatrix(void)
+void swGenTextures(int count, uint32_t *textures)
 {
-    switch (RLSW.currentMatrixMode)
-    {
-        case SW_PROJECTION:
-        {
-            if (RLSW.stackProjectionCounter <= 0)
-            {
-                RLSW.errCode = SW_STACK_UNDERFLOW;
-                return;
-            }
+    if ((count == 0) || (textures == NULL)) return;
 
-            RLSW.currentMatrix = &RLSW.stackProjection[--RLSW.stackProjectionCounter];
-            RLSW.isDirtyMVP = true; //< The MVP is considered to have been changed
-        } break;
-        case SW_MODELVIEW:
+    for (int i = 0; i < count; i++)
+    {
+        if (RLSW.loadedTextureCount >= SW_MAX_TEXTURES)
         {
-            if (RLSW.stackModelviewCounter <= 0)
-            {
-                RLSW.errCode = SW_STACK_UNDERFLOW;
-                return;
-            }
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory, not really stack overflow
+            return;
+        }
 
-            RLSW.currentMatrix = &RLSW.stackModelview[--RLSW.stackModelviewCounter];
-            RLSW.isDirtyMVP = true; //< The MVP is considered to have been changed
-        } break;
-        case SW_TEXTURE:
-        {
-            if (RLSW.stackTextureCounter <= 0)
-            {
-                RLSW.errCode = SW_STACK_UNDERFLOW;
-                return;
-            }
+        uint32_t id = 0;
+        if (RLSW.freeTextureIdCount > 0) id = RLSW.freeTextureIds[--RLSW.freeTextureIdCount];
+        else id = RLSW.loadedTextureCount++;
 
-            RLSW.currentMatrix = &RLSW.stackTexture[--RLSW.stackTextureCounter];
-        } break;
-        default: break;
+        RLSW.loadedTextures[id] = RLSW.loadedTextures[0];
+        textures[i] = id;
     }
 }
 
-void swLoadIdentity(void)
-{
-    sw_matrix_id(*RLSW.currentMatrix);
-    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
-}
-
-void swTranslatef(float x, float y, float z)
+void swDeleteTextures(int count, uint32_t *textures)
 {
-    sw_matrix_t mat;
-    sw_matrix_id(mat);
+    if ((count == 0) || (textures == NULL)) return;
 
-    mat[12] = x;
-    mat[13] = y;
-    mat[14] = z;
+    sw_deferred_flush();
 
-    sw_matrix_mul(*RLSW.currentMatrix, mat, *RLSW.currentMatrix);
+    for (int i = 0; i < count; i++)
+    {
+        if (!sw_is_texture_valid(textures[i]))
+        {
+            RLSW.errCode = SW_INVALID_VALUE;
+            continue;
+        }
 
-    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
+        sw_texture_free_levels(&RLSW.loadedTextures[textures[i]], 0);
+        sw_render_target_texture_changed(textures[i], true);
+        RLSW.freeTextureIds[RLSW.freeTextureIdCount++] = textures[i];
+    }
 }
 
-void swRotatef(float angle, float x, float y, float z)
+void swTexImage2D(int width, int height, SWformat format, SWtype type, const void *data)
 {
-    angle *= SW_DEG2RAD;
+    swTexImage2DLevel(0, width, height, format, type, data);
+}
 
-    float lengthSq = x*x + y*y + z*z;
+void swTexImage2DLevel(int level, int width, int height, SWformat format, SWtype type, const void *data)
+{
+    uint32_t id = RLSW.currentTexture;
 
-    if ((lengthSq != 1.0f) && (lengthSq != 0.0f))
+    if (!sw_is_texture_valid(id) || (level < 0) || (level >= SW_MAX_MIPMAP_LEVELS) || (width <= 0) || (height <= 0))
     {
-        float invLength = 1.0f/sqrtf(lengthSq);
-        x *= invLength;
-        y *= invLength;
-        z *= invLength;
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
     }
 
-    float sinres = sinf(angle);
-    float cosres = cosf(angle);
-    float t = 1.0f - cosres;
+    int pixelFormat = sw_get_pixel_format(format, type);
 
-    sw_matrix_t mat;
+    if (pixelFormat <= SW_PIXELFORMAT_UNKNOWN)
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
 
-    mat[0] = x*x*t + cosres;
-    mat[1] = y*x*t + z*sinres;
-    mat[2] = z*x*t - y*sinres;
-    mat[3] = 0.0f;
+    sw_texture_t *texture = &RLSW.loadedTextures[id];
 
-    mat[4] = x*y*t - z*sinres;
-    mat[5] = y*y*t + cosres;
-    mat[6] = z*y*t + x*sinres;
-    mat[7] = 0.0f;
+    sw_deferred_flush();
 
-    mat[8] = x*z*t + y*sinres;
-    mat[9] = y*z*t - x*sinres;
-    mat[10] = z*z*t + cosres;
-    mat[11] = 0.0f;
+    sw_mipmap_t *mipmap = sw_texture_define_level(texture, level, width, height, (SWcompressed)0);
+    if (mipmap == NULL) return;
 
-    mat[12] = 0.0f;
-    mat[13] = 0.0f;
-    mat[14] = 0.0f;
-    mat[15] = 1.0f;
+    // NOTE: Texture without data (e.g. render target color attachment) is cleared
+    if (data == NULL) memset(mipmap->pixels, 0, 4*(size_t)sw_texture_texel_offset(mipmap, width - 1, height - 1) + 4);
+    else sw_texture_write_rect(mipmap, 0, 0, width, height, data, pixelFormat);
 
-    sw_matrix_mul(*RLSW.currentMatrix, mat, *RLSW.currentMatrix);
+    if (level == 0)
+    {
+        texture->tx = 1.0f/width;
+        texture->ty = 1.0f/height;
+        sw_render_target_texture_changed(id, false);
+    }
 
-    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
+    // Only consecutive levels from the base can be sampled
+    texture->levelCount = 0;
+    while ((texture->levelCount < SW_MAX_MIPMAP_LEVELS) && (texture->levels[texture->levelCount].pixels != NULL)) texture->levelCount++;
 }
 
-void swScalef(float x, float y, float z)
+void swTexSubImage2D(int level, int xOffset, int yOffset, int width, int height, SWformat format, SWtype type, const void *data)
 {
-    sw_matrix_t mat;
+    uint32_t id = RLSW.currentTexture;
 
-    mat[0]  = x, mat[1]  = 0, mat[2]  = 0, mat[3]  = 0;
-    mat[4]  = 0, mat[5]  = y, mat[6]  = 0, mat[7]  = 0;
-    mat[8]  = 0, mat[9]  = 0, mat[10] = z, mat[11] = 0;
-    mat[12] = 0, mat[13] = 0, mat[14] = 0, mat[15] = 1;
+    if (!sw_is_texture_valid(id) || (level < 0) || (level >= SW_MAX_MIPMAP_LEVELS) || (data == NULL))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
 
-    sw_matrix_mul(*RLSW.currentMatrix, mat, *RLSW.currentMatrix);
+    int pixelFormat = sw_get_pixel_format(format, type);
 
-    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
-}
+    if (pixelFormat <= SW_PIXELFORMAT_UNKNOWN)
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
+
+    sw_mipmap_t *mipmap = &RLSW.loadedTextures[id].levels[level];
+
+    // NOTE: Textures without uploaded data share the pixels of the default texture
+    if ((mipmap->pixels == NULL) || (mipmap->pixels == RLSW.loadedTextures[0].levels[0].pixels) || (mipmap->compressed != 0))
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    if ((xOffset < 0) || (yOffset < 0) || (width < 0) || (height < 0) ||
+        (xOffset + width > mipmap->width) || (yOffset + height > mipmap->height))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    if ((width == 0) || (height == 0)) return;
+
+    sw_deferred_flush();
 
-void swMultMatrixf(const float *mat)
-{
-    sw_matrix_mul(*RLSW.currentMatrix, mat, *RLSW.currentMatrix);
+    if (level == 0) sw_render_target_sync_texture(id);
 
-    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
+    sw_texture_write_rect(mipmap, xOffset, yOffset, width, height, data, pixelFormat);
+
+    if (level == 0) sw_render_target_texture_changed(id, false);
 }
 
-void swFrustum(double left, double right, double bottom, double top, double znear, double zfar)
+void swGetTexImage(int level, SWformat format, SWtype type, void *pixels)
 {
-    sw_matrix_t mat;
-
-    double rl = right - left;
-    double tb = top - bottom;
-    double fn = zfar - znear;
-
-    mat[0] = (float)(znear*2.0)/rl;
-    mat[1] = 0.0f;
-    mat[2] = 0.0f;
-    mat[3] = 0.0f;
+    uint32_t id = RLSW.currentTexture;
 
-    mat[4] = 0.0f;
-    mat[5] = (float)(znear*2.0)/tb;
-    mat[6] = 0.0f;
-    mat[7] = 0.0f;
+    if (!sw_is_texture_valid(id) || (level < 0) || (level >= SW_MAX_MIPMAP_LEVELS) ||
+        (RLSW.loadedTextures[id].levels[level].pixels == NULL) || (pixels == NULL))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
 
-    mat[8] = (float)(right + left)/rl;
-    mat[9] = (float)(top + bottom)/tb;
-    mat[10] = -(float)(zfar + znear)/fn;
-    mat[11] = -1.0f;
+    const sw_mipmap_t *mipmap = &RLSW.loadedTextures[id].levels[level];
 
-    mat[12] = 0.0f;
-    mat[13] = 0.0f;
-    mat[14] = -(zfar*znear*2.0)/fn;
-    mat[15] = 0.0f;
+    sw_deferred_flush();
 
-    sw_matrix_mul(*RLSW.currentMatrix, *RLSW.currentMatrix, mat);
+    if (level == 0) sw_render_target_sync_texture(id);
 
-    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
+    if (!sw_texture_read_rect(mipmap, 0, 0, mipmap->width, mipmap->height, pixels, (sw_pixelformat_t)sw_get_pixel_format(format, type)))
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+    }
 }
 
-void swOrtho(double left, double right, double bottom, double top, double znear, double zfar)
+bool swBindTextureMemory(void *pixels, int width, int height)
 {
-    sw_matrix_t mat;
+    uint32_t id = RLSW.currentTexture;
 
-    double rl = right - left;
-    double tb = top - bottom;
-    double fn = zfar - znear;
+    if (!sw_is_texture_valid(id)) { RLSW.errCode = SW_INVALID_OPERATION; return false; }
+    if ((pixels != NULL) && ((width <= 0) || (height <= 0))) { RLSW.errCode = SW_INVALID_VALUE; return false; }
 
-    mat[0] = 2.0f/(float)rl;
-    mat[1] = 0.0f;
-    mat[2] = 0.0f;
-    mat[3] = 0.0f;
+    // NOTE: Rendering is deferred with RLSW_USE_THREADS or RLSW_USE_COMMAND_BUFFER, the memory
+    // must not be modified while draws using it may be pending (swFinish())
+    sw_deferred_flush();
 
-    mat[4] = 0.0f;
-    mat[5] = 2.0f/(float)tb;
-    mat[6] = 0.0f;
-    mat[7] = 0.0f;
+    sw_texture_t *texture = &RLSW.loadedTextures[id];
+    sw_mipmap_t *mipmap = &texture->levels[0];
 
-    mat[8] = 0.0f;
-    mat[9] = 0.0f;
-    mat[10] = -2.0f/(float)fn;
-    mat[11] = 0.0f;
+    sw_texture_free_levels(texture, 0);
 
-    mat[12] = -(float)(left + right)/rl;
-    mat[13] = -(float)(top + bottom)/tb;
-    mat[14] = -(float)(zfar + znear)/fn;
-    mat[15] = 1.0f;
+    if (pixels == NULL)
+    {
+        // Back to the content of a texture without uploaded data
+        *mipmap = RLSW.loadedTextures[0].levels[0];
+    }
+    else
+    {
+        // External memory is sampled as is, with row-major texels
+        mipmap->pixels = (uint8_t *)pixels;
+        mipmap->width = width;
+        mipmap->height = height;
+        mipmap->wMinus1 = width - 1;
+        mipmap->hMinus1 = height - 1;
+        mipmap->isPOT = (((width & (width - 1)) == 0) && ((height & (height - 1)) == 0));
+        mipmap->blockStride = 0;
+        mipmap->isExternal = true;
+    }
 
-    sw_matrix_mul(*RLSW.currentMatrix, *RLSW.currentMatrix, mat);
+    texture->levelCount = 1;
+    texture->tx = 1.0f/mipmap->width;
+    texture->ty = 1.0f/mipmap->height;
 
-    if (RLSW.currentMatrixMode != SW_TEXTURE) RLSW.isDirtyMVP = true;
+    sw_render_target_texture_changed(id, false);
+
+    return true;
 }
 
-void swBegin(SWdraw mode)
+void swCompressedTexImage2D(int level, SWcompressed format, int width, int height, int size, const void *data)
 {
-    // Check if the draw mode is valid
-    if (!sw_is_draw_mode_valid(mode))
+    uint32_t id = RLSW.currentTexture;
+
+    if (!sw_is_texture_valid(id) || (level < 0) || (level >= SW_MAX_MIPMAP_LEVELS) || (width <= 0) || (height <= 0) || (data == NULL))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
+
+    int blockBytes = sw_get_block_bytes(format);
+
+    if (blockBytes == 0)
     {
         RLSW.errCode = SW_INVALID_ENUM;
         return;
     }
 
-    // Recalculate the MVP if this is needed
-    if (RLSW.isDirtyMVP)
+    int blocksX = (width + 3)/4;
+    int blocksY = (height + 3)/4;
+
+    if (size < blocksX*blocksY*blockBytes)
     {
-        sw_matrix_mul_rst(RLSW.matMVP,
-            RLSW.stackModelview[RLSW.stackModelviewCounter - 1],
-            RLSW.stackProjection[RLSW.stackProjectionCounter - 1]);
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
 
-        RLSW.isDirtyMVP = false;
+    sw_texture_t *texture = &RLSW.loadedTextures[id];
+
+    sw_deferred_flush();
+
+    // DXT1 blocks can be kept as is, their texels are decoded on sampling
+    bool keep = SW_TEXTURE_KEEP_DXT1 && ((format == SW_COMPRESSED_RGB_DXT1) || (format == SW_COMPRESSED_RGBA_DXT1));
+
+    sw_mipmap_t *mipmap = sw_texture_define_level(texture, level, width, height, keep? format : (SWcompressed)0);
+    if (mipmap == NULL) return;
+
+    if (keep) memcpy(mipmap->pixels, data, (size_t)blocksX*blocksY*blockBytes);
+    else
+    {
+        sw_decode_job_t job = { format, (const uint8_t *)data, blocksX, width, height, mipmap, NULL };
+        sw_decode_image(&job);
     }
 
-    // Obtain the number of vertices needed for this primitive
-    switch (mode)
+    if (level == 0)
     {
-        case SW_POINTS: RLSW.reqVertices = 1; break;
-        case SW_LINES: RLSW.reqVertices = 2; break;
-        case SW_TRIANGLES: RLSW.reqVertices = 3; break;
-        case SW_QUADS: RLSW.reqVertices = 4; break;
+        texture->tx = 1.0f/width;
+        texture->ty = 1.0f/height;
+        sw_render_target_texture_changed(id, false);
     }
 
-    // Initialize required values
-    RLSW.vertexCounter = 0;
-    RLSW.drawMode = mode;
+    // Only consecutive levels from the base can be sampled
+    texture->levelCount = 0;
+    while ((texture->levelCount < SW_MAX_MIPMAP_LEVELS) && (texture->levels[texture->levelCount].pixels != NULL)) texture->levelCount++;
 }
 
-void swEnd(void)
+bool swDecompressImage(SWcompressed format, int width, int height, const void *data, void *pixels)
 {
-    RLSW.drawMode = (SWdraw)0;
-}
+    if ((width <= 0) || (height <= 0) || (data == NULL) || (pixels == NULL)) { RLSW.errCode = SW_INVALID_VALUE; return false; }
+    if (sw_get_block_bytes(format) == 0) { RLSW.errCode = SW_INVALID_ENUM; return false; }
 
-void swVertex2i(int x, int y)
-{
-    const float v[4] = { (float)x, (float)y, 0.0f, 1.0f };
-    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
-}
+    sw_decode_job_t job = { format, (const uint8_t *)data, (width + 3)/4, width, height, NULL, (uint8_t *)pixels };
+    sw_decode_image(&job);
 
-void swVertex2f(float x, float y)
-{
-    const float v[4] = { x, y, 0.0f, 1.0f };
-    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
+    return true;
 }
 
-void swVertex2fv(const float *v)
+void swGenerateMipmap(void)
 {
-    const float v4[4] = { v[0], v[1], 0.0f, 1.0f };
-    sw_immediate_push_vertex(v4, RLSW.current.color, RLSW.current.texcoord);
-}
+    uint32_t id = RLSW.currentTexture;
 
-void swVertex3i(int x, int y, int z)
-{
-    const float v[4] = { (float)x, (float)y, (float)z, 1.0f };
-    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
-}
+    if (!sw_is_texture_valid(id) || (RLSW.loadedTextures[id].levels[0].pixels == NULL))
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
 
-void swVertex3f(float x, float y, float z)
-{
-    const float v[4] = { x, y, z, 1.0f };
-    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
-}
+    sw_texture_t *texture = &RLSW.loadedTextures[id];
 
-void swVertex3fv(const float *v)
-{
-    const float v4[4] = { v[0], v[1], v[2], 1.0f };
-    sw_immediate_push_vertex(v4, RLSW.current.color, RLSW.current.texcoord);
-}
+    sw_deferred_flush();
 
-void swVertex4i(int x, int y, int z, int w)
-{
-    const float v[4] = { (float)x, (float)y, (float)z, (float)w };
-    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
-}
+    sw_texture_free_levels(texture, 1);
 
-void swVertex4f(float x, float y, float z, float w)
-{
-    const float v[4] = { x, y, z, w };
-    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
-}
+    for (int i = 1; i < SW_MAX_MIPMAP_LEVELS; i++)
+    {
+        const sw_mipmap_t *src = &texture->levels[i - 1];
+        if ((src->width == 1) && (src->height == 1)) break;
 
-void swVertex4fv(const float *v)
-{
-    sw_immediate_push_vertex(v, RLSW.current.color, RLSW.current.texcoord);
-}
+        sw_mipmap_t *dst = &texture->levels[i];
 
-void swColor3ub(uint8_t r, uint8_t g, uint8_t b)
-{
-    float cv[4];
-    cv[0] = (float)r*SW_INV_255;
-    cv[1] = (float)g*SW_INV_255;
-    cv[2] = (float)b*SW_INV_255;
-    cv[3] = 1.0f;
+        if (!sw_texture_alloc_level(dst, sw_maxi(src->width >> 1, 1), sw_maxi(src->height >> 1, 1)))
+        {
+            *dst = SW_CURLY_INIT(sw_mipmap_t) { 0 };
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+            return;
+        }
 
-    swColor4fv(cv);
+        sw_texture_downsample(dst, src);
+        texture->levelCount = i + 1;
+    }
 }
 
-void swColor3ubv(const uint8_t *v)
+void swTexParameteri(int param, int value)
 {
-    float cv[4];
-    cv[0] = (float)v[0]*SW_INV_255;
-    cv[1] = (float)v[1]*SW_INV_255;
-    cv[2] = (float)v[2]*SW_INV_255;
-    cv[3] = 1.0f;
-
-    swColor4fv(cv);
-}
+    uint32_t id = RLSW.currentTexture;
 
-void swColor3f(float r, float g, float b)
-{
-    float cv[4];
-    cv[0] = r;
-    cv[1] = g;
-    cv[2] = b;
-    cv[3] = 1.0f;
+    if (!sw_is_texture_valid(id))
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
 
-    swColor4fv(cv);
-}
+    sw_texture_t *texture = &RLSW.loadedTextures[id];
 
-void swColor3fv(const float *v)
-{
-    float cv[4];
-    cv[0] = v[0];
-    cv[1] = v[1];
-    cv[2] = v[2];
-    cv[3] = 1.0f;
+    sw_deferred_flush();
 
-    swColor4fv(cv);
-}
+    switch (param)
+    {
+        case SW_TEXTURE_MIN_FILTER:
+        {
+            if (!sw_is_texture_min_filter_valid(value))
+            {
+                RLSW.errCode = SW_INVALID_ENUM;
+                return;
+            }
 
-void swColor4ub(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
-{
-    float cv[4];
-    cv[0] = (float)r*SW_INV_255;
-    cv[1] = (float)g*SW_INV_255;
-    cv[2] = (float)b*SW_INV_255;
-    cv[3] = (float)a*SW_INV_255;
+            texture->minFilter = (SWfilter)value;
+        } break;
+        case SW_TEXTURE_MAG_FILTER:
+        {
+            if (!sw_is_texture_filter_valid(value))
+            {
+                RLSW.errCode = SW_INVALID_ENUM;
+                return;
+            }
 
-    swColor4fv(cv);
-}
+            texture->magFilter = (SWfilter)value;
+        } break;
+        case SW_TEXTURE_WRAP_S:
+        {
+            if (!sw_is_texture_wrap_valid(value))
+            {
+                RLSW.errCode = SW_INVALID_ENUM;
+                return;
+            }
 
-void swColor4ubv(const uint8_t *v)
-{
-    float cv[4];
-    cv[0] = (float)v[0]*SW_INV_255;
-    cv[1] = (float)v[1]*SW_INV_255;
-    cv[2] = (float)v[2]*SW_INV_255;
-    cv[3] = (float)v[3]*SW_INV_255;
+            texture->sWrap = (SWwrap)value;
+        } break;
+        case SW_TEXTURE_WRAP_T:
+        {
+            if (!sw_is_texture_wrap_valid(value))
+            {
+                RLSW.errCode = SW_INVALID_ENUM;
+                return;
+            }
 
-    swColor4fv(cv);
+            texture->tWrap = (SWwrap)value;
+        } break;
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
+    }
 }
 
-void swColor4f(float r, float g, float b, float a)
+void swBindTexture(uint32_t id)
 {
-    float cv[4];
-    cv[0] = r;
-    cv[1] = g;
-    cv[2] = b;
-    cv[3] = a;
+    if (id >= SW_MAX_TEXTURES)
+    {
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
 
-    swColor4fv(cv);
-}
+    if (RLSW.loadedTextures[id].levels[0].pixels == NULL)
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
 
-void swColor4fv(const float *v)
-{
-    for (int i = 0; i < 4; i++) RLSW.current.color[i] = v[i];
+    RLSW.currentTexture = id;
+    RLSW.isDirtyRasterState = true;
 }
 
-void swTexCoord2f(float u, float v)
+void swGenFramebuffers(int count, uint32_t *framebuffers)
 {
-    const float *m = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
+    if ((count == 0) || (framebuffers == NULL)) return;
 
-    RLSW.current.texcoord[0] = m[0]*u + m[4]*v + m[12];
-    RLSW.current.texcoord[1] = m[1]*u + m[5]*v + m[13];
-}
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t id = 1;
+        while ((id < SW_MAX_FRAMEBUFFERS) && RLSW.renderTargets[id].isUsed) id++;
 
-void swTexCoord2fv(const float *v)
-{
-    const float *m = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
+        if (id == SW_MAX_FRAMEBUFFERS)
+        {
+            RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory, not really stack overflow
+            return;
+        }
 
-    RLSW.current.texcoord[0] = m[0]*v[0] + m[4]*v[1] + m[12];
-    RLSW.current.texcoord[1] = m[1]*v[0] + m[5]*v[1] + m[13];
+        RLSW.renderTargets[id] = SW_CURLY_INIT(sw_render_target_t) { 0 };
+        RLSW.renderTargets[id].isUsed = true;
+        framebuffers[i] = id;
+    }
 }
 
-void swBindArray(SWarray type, void *buffer)
+void swDeleteFramebuffers(int count, uint32_t *framebuffers)
 {
-    switch (type)
+    if ((count == 0) || (framebuffers == NULL)) return;
+
+    for (int i = 0; i < count; i++)
     {
-        case SW_VERTEX_ARRAY: RLSW.array.positions = (float *)buffer; break;
-        case SW_TEXTURE_COORD_ARRAY: RLSW.array.texcoords = (float *)buffer; break;
-        case SW_COLOR_ARRAY: RLSW.array.colors = (uint8_t *)buffer; break;
-        default: break;
+        uint32_t id = framebuffers[i];
+
+        if ((id == 0) || (id >= SW_MAX_FRAMEBUFFERS) || !RLSW.renderTargets[id].isUsed)
+        {
+            RLSW.errCode = SW_INVALID_VALUE;
+            continue;
+        }
+
+        // Deleting the bound framebuffer reverts to the default one
+        if (RLSW.currentFramebuffer == id) swBindFramebuffer(0);
+
+        sw_render_target_t *target = &RLSW.renderTargets[id];
+        SW_FREE(target->fb.color);
+        SW_FREE(target->fb.depth);
+        SW_FREE(target->fb.hiz.maxDepth);
+        SW_FREE(target->fb.msaa.color[0]);
+        SW_FREE(target->fb.msaa.depth[1]);
+        *target = SW_CURLY_INIT(sw_render_target_t) { 0 };
     }
 }
 
-void swDrawArrays(SWdraw mode, int offset, int count)
+void swBindFramebuffer(uint32_t id)
 {
-    if (RLSW.array.positions == 0)
+    if (id >= SW_MAX_FRAMEBUFFERS)
     {
-        RLSW.errCode = SW_INVALID_OPERATION;
+        RLSW.errCode = SW_INVALID_VALUE;
         return;
     }
 
-    swBegin(mode);
+    if ((id > 0) && !RLSW.renderTargets[id].isUsed)
     {
-        const float *texMatrix = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
-        const float *defaultTexcoord = RLSW.current.texcoord;
-        const float *defaultColor = RLSW.current.color;
-
-        const float *positions = RLSW.array.positions;
-        const float *texcoords = RLSW.array.texcoords;
-        const uint8_t *colors = RLSW.array.colors;
-
-        int end = offset + count;
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
 
-        for (int i = offset; i < end; i++)
-        {
-            float u, v;
-            if (texcoords)
-            {
-                int idx = 2*i;
-                u = texcoords[idx];
-                v = texcoords[idx + 1];
-            }
-            else
-            {
-                u = defaultTexcoord[0];
-                v = defaultTexcoord[1];
-            }
+    if (id == RLSW.currentFramebuffer) return;
 
-            float texcoord[2];
-            texcoord[0] = texMatrix[0]*u + texMatrix[4]*v + texMatrix[12];
-            texcoord[1] = texMatrix[1]*u + texMatrix[5]*v + texMatrix[13];
+    sw_deferred_flush();
 
-            float color[4] = {
-                defaultColor[0],
-                defaultColor[1],
-                defaultColor[2],
-                defaultColor[3]
-            };
+    // Rendering into the previous framebuffer object is done, store it into its texture
+    sw_render_target_t *previous = &RLSW.renderTargets[RLSW.currentFramebuffer];
+    if (RLSW.currentFramebuffer > 0) sw_render_target_store(previous);
+    previous->fb = RLSW.framebuffer;
 
-            if (colors)
-            {
-                int idx = 4*i;
-                color[0] *= (float)colors[idx]*SW_INV_255;
-                color[1] *= (float)colors[idx + 1]*SW_INV_255;
-                color[2] *= (float)colors[idx + 2]*SW_INV_255;
-                color[3] *= (float)colors[idx + 3]*SW_INV_255;
-            }
+    RLSW.framebuffer = RLSW.renderTargets[id].fb;
+    RLSW.currentFramebuffer = id;
 
-            int idx = 3*i;
-            float position[4] = {
-                positions[idx],
-                positions[idx + 1],
-                positions[idx + 2],
-                1.0f
-            };
+    if (id > 0) sw_render_target_setup(&RLSW.renderTargets[id]);
+#if defined(RLSW_USE_THREADS)
+    else if (RLSW.deferred.threadCount > 1) sw_deferred_resize_bins(RLSW.framebuffer.width, RLSW.framebuffer.height);
+#endif
 
-            sw_immediate_push_vertex(position, color, texcoord);
-        }
+    // Multisampling state applies to the bound framebuffer
+    if (!sw_framebuffer_set_multisample(SW_STATE_CHECK(SW_STATE_MULTISAMPLE)))
+    {
+        RLSW.stateFlags &= ~SW_STATE_MULTISAMPLE;
+        RLSW.isDirtyRasterState = true;
     }
-    swEnd();
+
+    // Viewport and scissor are clamped to the framebuffer dimensions
+    swViewport(RLSW.vpRect[0], RLSW.vpRect[1], RLSW.vpRect[2], RLSW.vpRect[3]);
+    swScissor(RLSW.scRect[0], RLSW.scRect[1], RLSW.scRect[2], RLSW.scRect[3]);
 }
 
-void swDrawElements(SWdraw mode, int count, int type, const void *indices)
+void swFramebufferTexture2D(SWattachment attachment, uint32_t texture, int level)
 {
-    if (RLSW.array.positions == 0)
+    uint32_t id = RLSW.currentFramebuffer;
+
+    if (id == 0)
     {
         RLSW.errCode = SW_INVALID_OPERATION;
         return;
     }
 
-    if (count < 0)
+    // NOTE: Depth textures are not supported, depth attachments are renderbuffers
+    if (attachment != SW_COLOR_ATTACHMENT0)
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
+
+    if ((level != 0) || ((texture > 0) && !sw_is_texture_valid(texture)))
     {
         RLSW.errCode = SW_INVALID_VALUE;
         return;
     }
 
-    const uint8_t *indicesUb = NULL;
-    const uint16_t *indicesUs = NULL;
-    const uint32_t *indicesUi = NULL;
+    sw_render_target_t *target = &RLSW.renderTargets[id];
 
-    switch (type)
+    sw_deferred_flush();
+    sw_render_target_store(target);
+
+    target->colorTexture = texture;
+    target->isStale = true;
+
+    sw_render_target_setup(target);
+}
+
+void swFramebufferRenderbuffer(SWattachment attachment, uint32_t renderbuffer)
+{
+    uint32_t id = RLSW.currentFramebuffer;
+
+    if (id == 0)
     {
-        case SW_UNSIGNED_BYTE:
-            indicesUb = (const uint8_t *)indices;
-            break;
-        case SW_UNSIGNED_SHORT:
-            indicesUs = (const uint16_t *)indices;
-            break;
-        case SW_UNSIGNED_INT:
-            indicesUi = (const uint32_t *)indices;
-            break;
-        default:
-            RLSW.errCode = SW_INVALID_ENUM;
-            return;
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
     }
 
-    swBegin(mode);
+    // NOTE: Color renderbuffers are not supported, color attachments are textures
+    if (attachment != SW_DEPTH_ATTACHMENT)
+    {
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
+    }
+
+    if ((renderbuffer >= SW_MAX_RENDERBUFFERS) || ((renderbuffer > 0) && !RLSW.renderbuffers[renderbuffer].isUsed))
     {
-        const float *texMatrix = RLSW.stackTexture[RLSW.stackTextureCounter - 1];
-        const float *defaultTexcoord = RLSW.current.texcoord;
-        const float *defaultColor = RLSW.current.color;
+        RLSW.errCode = SW_INVALID_VALUE;
+        return;
+    }
 
-        const float *positions = RLSW.array.positions;
-        const float *texcoords = RLSW.array.texcoords;
-        const uint8_t *colors = RLSW.array.colors;
+    sw_deferred_flush();
 
-        for (int i = 0; i < count; i++)
-        {
-            int index = indicesUb? indicesUb[i] :
-                       (indicesUs? indicesUs[i] : indicesUi[i]);
+    RLSW.renderTargets[id].depthRenderbuffer = renderbuffer;
+    sw_render_target_setup(&RLSW.renderTargets[id]);
+}
 
-            float u, v;
-            if (texcoords)
-            {
-                int idx = 2*index;
-                u = texcoords[idx];
-                v = texcoords[idx + 1];
-            }
-            else
-            {
-                u = defaultTexcoord[0];
-                v = defaultTexcoord[1];
-            }
+SWfbstatus swCheckFramebufferStatus(void)
+{
+    if (RLSW.currentFramebuffer == 0) return SW_FRAMEBUFFER_COMPLETE;
 
-            float texcoord[2];
-            texcoord[0] = texMatrix[0]*u + texMatrix[4]*v + texMatrix[12];
-            texcoord[1] = texMatrix[1]*u + texMatrix[5]*v + texMatrix[13];
+    const sw_render_target_t *target = &RLSW.renderTargets[RLSW.currentFramebuffer];
+    const sw_renderbuffer_t *depth = &RLSW.renderbuffers[target->depthRenderbuffer];
 
-            float color[4] = {
-                defaultColor[0],
-                defaultColor[1],
-                defaultColor[2],
-                defaultColor[3]
-            };
+    if ((target->colorTexture == 0) && (target->depthRenderbuffer == 0)) return SW_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT;
+    if ((target->colorTexture > 0) && !sw_is_texture_valid(target->colorTexture)) return SW_FRAMEBUFFER_INCOMPLETE_ATTACHMENT;
+    if ((target->depthRenderbuffer > 0) && (depth->width == 0)) return SW_FRAMEBUFFER_INCOMPLETE_ATTACHMENT;
 
-            if (colors)
-            {
-                int idx = 4*index;
-                color[0] *= (float)colors[idx]*SW_INV_255;
-                color[1] *= (float)colors[idx + 1]*SW_INV_255;
-                color[2] *= (float)colors[idx + 2]*SW_INV_255;
-                color[3] *= (float)colors[idx + 3]*SW_INV_255;
-            }
+    if ((target->colorTexture > 0) && (target->depthRenderbuffer > 0))
+    {
+        const sw_mipmap_t *color = &RLSW.loadedTextures[target->colorTexture].levels[0];
+        if ((color->width != depth->width) || (color->height != depth->height)) return SW_FRAMEBUFFER_INCOMPLETE_DIMENSIONS;
+    }
 
-            int idx = 3*index;
-            float position[4] = {
-                positions[idx],
-                positions[idx + 1],
-                positions[idx + 2],
-                1.0f
-            };
+    return SW_FRAMEBUFFER_COMPLETE;
+}
 
-            sw_immediate_push_vertex(position, color, texcoord);
-        }
+void swGetFramebufferAttachmentParameteriv(SWattachment attachment, SWattachmentparam pname, int *v)
+{
+    if (RLSW.currentFramebuffer == 0)
+    {
+        RLSW.errCode = SW_INVALID_OPERATION;
+        return;
+    }
+
+    const sw_render_target_t *target = &RLSW.renderTargets[RLSW.currentFramebuffer];
+    uint32_t name = 0;
+    int type = GL_NONE;
+
+    switch (attachment)
+    {
+        case SW_COLOR_ATTACHMENT0: name = target->colorTexture; type = (name > 0)? GL_TEXTURE : GL_NONE; break;
+        case SW_DEPTH_ATTACHMENT: name = target->depthRenderbuffer; type = (name > 0)? GL_RENDERBUFFER : GL_NONE; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; return;
+    }
+
+    switch (pname)
+    {
+        case SW_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE: *v = type; break;
+        case SW_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME: *v = (int)name; break;
+        default: RLSW.errCode = SW_INVALID_ENUM; break;
     }
-    swEnd();
 }
 
-void swGenTextures(int count, uint32_t *textures)
+void swGenRenderbuffers(int count, uint32_t *renderbuffers)
 {
-    if ((count == 0) || (textures == NULL)) return;
+    if ((count == 0) || (renderbuffers == NULL)) return;
 
     for (int i = 0; i < count; i++)
     {
-        if (RLSW.loadedTextureCount >= SW_MAX_TEXTURES)
+        uint32_t id = 1;
+        while ((id < SW_MAX_RENDERBUFFERS) && RLSW.renderbuffers[id].isUsed) id++;
+
+        if (id == SW_MAX_RENDERBUFFERS)
         {
             RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory, not really stack overflow
             return;
         }
 
-        uint32_t id = 0;
-        if (RLSW.freeTextureIdCount > 0) id = RLSW.freeTextureIds[--RLSW.freeTextureIdCount];
-        else id = RLSW.loadedTextureCount++;
-
-        RLSW.loadedTextures[id] = RLSW.loadedTextures[0];
-        textures[i] = id;
+        RLSW.renderbuffers[id] = SW_CURLY_INIT(sw_renderbuffer_t) { 0 };
+        RLSW.renderbuffers[id].isUsed = true;
+        renderbuffers[i] = id;
     }
 }
 
-void swDeleteTextures(int count, uint32_t *textures)
+void swDeleteRenderbuffers(int count, uint32_t *renderbuffers)
 {
-    if ((count == 0) || (textures == NULL)) return;
+    if ((count == 0) || (renderbuffers == NULL)) return;
 
     for (int i = 0; i < count; i++)
     {
-        if (!sw_is_texture_valid(textures[i]))
+        uint32_t id = renderbuffers[i];
+
+        if ((id == 0) || (id >= SW_MAX_RENDERBUFFERS) || !RLSW.renderbuffers[id].isUsed)
         {
             RLSW.errCode = SW_INVALID_VALUE;
             continue;
         }
 
-        SW_FREE(RLSW.loadedTextures[textures[i]].pixels);
+        // NOTE: The depth planes belong to the framebuffer objects, they only lose the attachment
+        for (int j = 1; j < SW_MAX_FRAMEBUFFERS; j++)
+        {
+            if (RLSW.renderTargets[j].depthRenderbuffer == id) RLSW.renderTargets[j].depthRenderbuffer = 0;
+        }
 
-        RLSW.loadedTextures[textures[i]].pixels = NULL;
-        RLSW.freeTextureIds[RLSW.freeTextureIdCount++] = textures[i];
+        if (RLSW.currentRenderbuffer == id) RLSW.currentRenderbuffer = 0;
+        RLSW.renderbuffers[id] = SW_CURLY_INIT(sw_renderbuffer_t) { 0 };
     }
 }
 
-void swTexImage2D(int width, int height, SWformat format, SWtype type, const void *data)
+void swBindRenderbuffer(uint32_t id)
 {
-    uint32_t id = RLSW.currentTexture;
-
-    if (!sw_is_texture_valid(id))
+    if (id >= SW_MAX_RENDERBUFFERS)
     {
         RLSW.errCode = SW_INVALID_VALUE;
         return;
     }
 
-    int pixelFormat = sw_get_pixel_format(format, type);
-
-    if (pixelFormat <= SW_PIXELFORMAT_UNKNOWN)
-    {
-        RLSW.errCode = SW_INVALID_ENUM;
-        return;
-    }
-
-    sw_texture_t *texture = &RLSW.loadedTextures[id];
-
-    int size = width*height;
-    texture->pixels = SW_MALLOC(4*size);
-
-    if (texture->pixels == NULL)
+    if ((id > 0) && !RLSW.renderbuffers[id].isUsed)
     {
-        RLSW.errCode = SW_STACK_OVERFLOW; // WARNING: Out of memory...
+        RLSW.errCode = SW_INVALID_OPERATION;
         return;
     }
 
-    for (int i = 0; i < size; i++)
-    {
-        uint32_t *dst = &((uint32_t*)texture->pixels)[i];
-        sw_get_pixel((uint8_t*)dst, data, i, pixelFormat);
-    }
-
-    texture->width = width;
-    texture->height = height;
-    texture->wMinus1 = width - 1;
-    texture->hMinus1 = height - 1;
-    texture->tx = 1.0f/width;
-    texture->ty = 1.0f/height;
+    RLSW.currentRenderbuffer = id;
 }
 
-void swTexParameteri(int param, int value)
+void swRenderbufferStorage(int format, int width, int height)
 {
-    uint32_t id = RLSW.currentTexture;
+    uint32_t id = RLSW.currentRenderbuffer;
 
-    if (!sw_is_texture_valid(id))
+    if (id == 0)
     {
-        RLSW.errCode = SW_INVALID_VALUE;
+        RLSW.errCode = SW_INVALID_OPERATION;
         return;
     }
 
-    sw_texture_t *texture = &RLSW.loadedTextures[id];
-
-    switch (param)
+    // NOTE: Any depth format is stored with SW_DEPTH_BUFFER_BITS
+    if ((format != GL_DEPTH_COMPONENT) && (format != GL_DEPTH_COMPONENT16) &&
+        (format != GL_DEPTH_COMPONENT24) && (format != GL_DEPTH_COMPONENT32))
     {
-        case SW_TEXTURE_MIN_FILTER:
-        {
-            if (!sw_is_texture_filter_valid(value))
-            {
-                RLSW.errCode = SW_INVALID_ENUM;
-                return;
-            }
-
-            texture->minFilter = (SWfilter)value;
-        } break;
-        case SW_TEXTURE_MAG_FILTER:
-        {
-            if (!sw_is_texture_filter_valid(value))
-            {
-                RLSW.errCode = SW_INVALID_ENUM;
-                return;
-            }
-
-            texture->magFilter = (SWfilter)value;
-        } break;
-        case SW_TEXTURE_WRAP_S:
-        {
-            if (!sw_is_texture_wrap_valid(value))
-            {
-                RLSW.errCode = SW_INVALID_ENUM;
-                return;
-            }
-
-            texture->sWrap = (SWwrap)value;
-        } break;
-        case SW_TEXTURE_WRAP_T:
-        {
-            if (!sw_is_texture_wrap_valid(value))
-            {
-                RLSW.errCode = SW_INVALID_ENUM;
-                return;
-            }
-
-            texture->tWrap = (SWwrap)value;
-        } break;
-        default: RLSW.errCode = SW_INVALID_ENUM; break;
+        RLSW.errCode = SW_INVALID_ENUM;
+        return;
     }
-}
 
-void swBindTexture(uint32_t id)
-{
-    if (id >= SW_MAX_TEXTURES)
+    if ((width <= 0) || (height <= 0))
     {
         RLSW.errCode = SW_INVALID_VALUE;
         return;
     }
 
-    if (RLSW.loadedTextures[id].pixels == NULL)
+    RLSW.renderbuffers[id].width = width;
+    RLSW.renderbuffers[id].height = height;
+
+    // The bound framebuffer object may get its dimensions from this renderbuffer
+    sw_render_target_t *target = &RLSW.renderTargets[RLSW.currentFramebuffer];
+    if ((RLSW.currentFramebuffer > 0) && (target->depthRenderbuffer == id))
     {
-        RLSW.errCode = SW_INVALID_OPERATION;
-        return;
+        sw_deferred_flush();
+        sw_render_target_setup(target);
     }
-
-    RLSW.currentTexture = id;
 }
 
 #endif // RLSW_IMPLEMENTATION
@@ -124,6 +124,9 @@ typedef struct {
     EGLConfig config;                   // Graphic config
 #else
     uint32_t prevDumbHandle;            // Handle to the previous dumb buffer (during frame swapping)
+    void *dumbBuffer;                   // Mapped memory of the dumb buffer being displayed, updated with the regions written
+    uint64_t dumbSize;                  // Size in bytes of the mapped dumb buffer
+    uint32_t dumbPitch;                 // Size in bytes of a row of the mapped dumb buffer
 #endif
 
     // Keyboard data
@@ -849,6 +852,38 @@ void SwapScreenBuffer(void)
     const uint32_t depth = SW_COLOR_BUFFER_BITS;
 #endif
 
+    // Once a dumb buffer is displayed, only the regions written since previous frame are copied to it
+    // NOTE: The buffer is updated while displayed, it requires no scaling and 32 bits pixels
+    if ((platform.dumbBuffer != NULL) && (bpp == 32) && (CORE.Window.render.width == (int)width) && (CORE.Window.render.height == (int)height))
+    {
+        int rects[4*SW_MAX_DIRTY_RECTS] = { 0 };
+        drmModeClip clips[SW_MAX_DIRTY_RECTS] = { 0 };
+
+        int count = swGetDirtyRects(rects, SW_MAX_DIRTY_RECTS);
+        swResetDirtyRects();
+
+        if (count == 0) return; // Nothing written, display is up to date
+
+        swPixelStorei(SW_PACK_ROW_LENGTH, platform.dumbPitch/4);
+        for (int i = 0; i < count; i++)
+        {
+            const int *rect = &rects[4*i];
+            swCopyFramebuffer(rect[0], rect[1], rect[2], rect[3], SW_RGBA, SW_UNSIGNED_BYTE, (unsigned char *)platform.dumbBuffer + rect[1]*platform.dumbPitch + rect[0]*4);
+
+            clips[i].x1 = (unsigned short)rect[0];
+            clips[i].y1 = (unsigned short)rect[1];
+            clips[i].x2 = (unsigned short)(rect[0] + rect[2]);
+            clips[i].y2 = (unsigned short)(rect[1] + rect[3]);
+        }
+        swPixelStorei(SW_PACK_ROW_LENGTH, 0);
+
+        // Notify the damaged regions, drivers scanning out directly from memory do not require it
+        int result = drmModeDirtyFB(platform.fd, platform.prevFB, clips, count);
+        if ((result != 0) && (result != -ENOSYS)) TRACELOG(LOG_WARNING, "DISPLAY: drmModeDirtyFB() failed with result: %d", result);
+
+        return;
+    }
+
     // Create a dumb buffer for software rendering
     struct drm_mode_create_dumb creq = { 0 };
     creq.width = width;
@@ -903,9 +938,7 @@ void SwapScreenBuffer(void)
     // Copy the software rendered buffer to the dumb buffer with scaling if needed
     // NOTE: RLSW will make a simple copy if the dimensions match
     swBlitFramebuffer(0, 0, width, height, 0, 0, width, height, SW_RGBA, SW_UNSIGNED_BYTE, dumbBuffer);
-
-    // Unmap the buffer
-    munmap(dumbBuffer, creq.size);
+    swResetDirtyRects();
 
     // Find a CRTC compatible with the connector
     uint32_t crtcId = 0;
@@ -917,6 +950,7 @@ void SwapScreenBuffer(void)
         if (!res)
         {
             TRACELOG(LOG_ERROR, "DISPLAY: Failed to get DRM resources");
+            munmap(dumbBuffer, creq.size);
             drmModeRmFB(platform.fd, fb);
             struct drm_mode_destroy_dumb dreq = {0};
             dreq.handle = creq.handle;
@@ -957,6 +991,7 @@ void SwapScreenBuffer(void)
         if (!crtcId)
         {
             TRACELOG(LOG_ERROR, "DISPLAY: No compatible CRTC found");
+            munmap(dumbBuffer, creq.size);
             drmModeRmFB(platform.fd, fb);
             struct drm_mode_destroy_dumb dreq = {0};
             dreq.handle = creq.handle;
@@ -973,6 +1008,7 @@ void SwapScreenBuffer(void)
         TRACELOG(LOG_ERROR, "DISPLAY: CRTC ID: %u, FB ID: %u, Connector ID: %u", crtcId, fb, platform.connector->connector_id);
         TRACELOG(LOG_ERROR, "DISPLAY: Mode: %dx%d@%d", mode->hdisplay, mode->vdisplay, mode->vrefresh);
 
+        munmap(dumbBuffer, creq.size);
         drmModeRmFB(platform.fd, fb);
         struct drm_mode_destroy_dumb dreq = {0};
         dreq.handle = creq.handle;
@@ -998,6 +1034,13 @@ void SwapScreenBuffer(void)
     }
 
     platform.prevDumbHandle = creq.handle;
+
+    // Keep the displayed buffer mapped, next frames only update the regions written
+    if (platform.dumbBuffer != NULL) munmap(platform.dumbBuffer, platform.dumbSize);
+
+    platform.dumbBuffer = dumbBuffer;
+    platform.dumbSize = creq.size;
+    platform.dumbPitch = creq.pitch;
 #endif
 }
 #endif // SUPPORT_DRM_CACHE
@@ -1684,6 +1727,20 @@ void ClosePlatform(void)
         gbm_device_destroy(platform.gbmDevice);
         platform.gbmDevice = NULL;
     }
+#else
+    if (platform.dumbBuffer != NULL)
+    {
+        munmap(platform.dumbBuffer, platform.dumbSize);
+        platform.dumbBuffer = NULL;
+    }
+
+    if (platform.prevDumbHandle)
+    {
+        struct drm_mode_destroy_dumb dreq = { 0 };
+        dreq.handle = platform.prevDumbHandle;
+        drmIoctl(platform.fd, DRM_IOCTL_MODE_DESTROY_DUMB, &dreq);
+        platform.prevDumbHandle = 0;
+    }
 #endif
 
     if (platform.crtc)
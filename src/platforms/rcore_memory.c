@@ -15,6 +15,10 @@
 *
 *   ADDITIONAL NOTES:
 *       - TRACELOG() function is located in raylib [utils] module
+*       - GetWindowHandle() returns the framebuffer memory, valid after EndDrawing()
+*       - EndDrawing() only copies the framebuffer regions written during the frame (rlsw dirty rects)
+*       - SetMemoryFramebuffer() sets user memory (RGBA/BGRA 32 bits) as framebuffer, the renderer
+*         draws into it, no copy on EndDrawing(); declared in raylib.h when PLATFORM_MEMORY is defined
 *
 *   CONFIGURATION:
 *       #define RCORE_PLATFORM_CUSTOM_FLAG
@@ -67,6 +71,7 @@ __declspec(dllimport) int __stdcall QueryPerformanceFrequency(LARGE_INTEGER *lpF
 
 typedef struct {
     unsigned int *pixels;   // Pointer to pixel data buffer (RGBA8888 format)
+    bool pixelsExternal;    // Pixel data buffer provided by user, rendered directly
 #if defined(_WIN32)
     LARGE_INTEGER timerFrequency;
 #endif
@@ -214,10 +219,10 @@ void SetWindowFocused(void)
 }
 
 // Get native window handle
+// NOTE: Memory platform has no window, the framebuffer memory is returned
 void *GetWindowHandle(void)
 {
-    TRACELOG(LOG_WARNING, "GetWindowHandle() not implemented on target platform");
-    return NULL;
+    return platform.pixels;
 }
 
 // Get number of monitors
@@ -354,8 +359,44 @@ void DisableCursor(void)
 // Swap back buffer with front buffer (screen drawing)
 void SwapScreenBuffer(void)
 {
-    // Update framebuffer
-    rlCopyFramebuffer(0, 0, CORE.Window.render.width, CORE.Window.render.height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, platform.pixels);
+    // Update framebuffer, external memory is rendered directly, just wait for rendering to complete
+    if (platform.pixelsExternal) rlFinishFramebuffer();
+    else
+    {
+        // Copy only the regions written since previous frame
+        int rects[4*SW_MAX_DIRTY_RECTS] = { 0 };
+        int count = swGetDirtyRects(rects, SW_MAX_DIRTY_RECTS);
+
+        swPixelStorei(SW_PACK_ROW_LENGTH, CORE.Window.render.width);
+        for (int i = 0; i < count; i++)
+        {
+            const int *rect = &rects[4*i];
+            swCopyFramebuffer(rect[0], rect[1], rect[2], rect[3], SW_RGBA, SW_UNSIGNED_BYTE, platform.pixels + rect[1]*CORE.Window.render.width + rect[0]);
+        }
+        swPixelStorei(SW_PACK_ROW_LENGTH, 0);
+    }
+
+    swResetDirtyRects();
+}
+
+// Set user memory as framebuffer, must fit render size with 32 bits per pixel
+// NOTE: Row size in bytes defined by stride (0 for packed rows), NULL restores the internal framebuffer
+bool SetMemoryFramebuffer(void *pixels, int stride, bool bgra)
+{
+    if (!rlBindFramebufferMemory(pixels, CORE.Window.render.width, CORE.Window.render.height, stride, bgra))
+    {
+        TRACELOG(LOG_WARNING, "DISPLAY: Failed to set memory framebuffer");
+        return false;
+    }
+
+    if (!platform.pixelsExternal) RL_FREE(platform.pixels);
+
+    if (pixels != NULL) platform.pixels = (unsigned int *)pixels;
+    else platform.pixels = (unsigned int *)RL_CALLOC(CORE.Window.render.width*CORE.Window.render.height, sizeof(int));
+
+    platform.pixelsExternal = (pixels != NULL);
+
+    return true;
 }
 
 //----------------------------------------------------------------------------------
@@ -554,7 +595,7 @@ int InitPlatform(void)
 // Close platform
 void ClosePlatform(void)
 {
-    RL_FREE(platform.pixels);
+    if (!platform.pixelsExternal) RL_FREE(platform.pixels);
 }
 
 //----------------------------------------------------------------------------------
@@ -881,6 +881,14 @@ typedef enum {
     TEXTURE_WRAP_MIRROR_CLAMP               // Mirrors and clamps to border the texture in tiled mode
 } TextureWrap;
 
+// Image border mode, pixels read outside the image on image processing
+typedef enum {
+    IMAGE_BORDER_ZERO = 0,                  // Pixels outside the image are transparent black
+    IMAGE_BORDER_CLAMP,                     // Pixels outside the image repeat the closest edge pixel
+    IMAGE_BORDER_MIRROR,                    // Pixels outside the image mirror the image (edge pixel repeated)
+    IMAGE_BORDER_WRAP                       // Pixels outside the image wrap around to the opposite edge
+} ImageBorderMode;
+
 // Cubemap layouts
 typedef enum {
     CUBEMAP_LAYOUT_AUTO_DETECT = 0,         // Automatically detect layout type
@@ -998,6 +1006,9 @@ RLAPI void SetWindowSize(int width, int height);                  // Set window
 RLAPI void SetWindowOpacity(float opacity);                       // Set window opacity [0.0f..1.0f]
 RLAPI void SetWindowFocused(void);                                // Set window focused
 RLAPI void *GetWindowHandle(void);                                // Get native window handle
+#if defined(PLATFORM_MEMORY)
+RLAPI bool SetMemoryFramebuffer(void *pixels, int stride, bool bgra); // Set user memory as framebuffer (RGBA/BGRA 32bit), rendered directly (PLATFORM_MEMORY only)
+#endif
 RLAPI int GetScreenWidth(void);                                   // Get current screen width
 RLAPI int GetScreenHeight(void);                                  // Get current screen height
 RLAPI int GetRenderWidth(void);                                   // Get current render width (it considers HiDPI)
@@ -1373,6 +1384,7 @@ RLAPI void ImageAlphaMask(Image *image, Image alphaMask);
 RLAPI void ImageAlphaPremultiply(Image *image);                                                          // Premultiply alpha channel
 RLAPI void ImageBlurGaussian(Image *image, int blurSize);                                                // Apply Gaussian blur using a box blur approximation
 RLAPI void ImageKernelConvolution(Image *image, const float *kernel, int kernelSize);                    // Apply custom square convolution kernel to image
+RLAPI void ImageKernelConvolutionEx(Image *image, const float *kernel, int kernelSize, int borderMode);   // Apply custom square convolution kernel to image, with border mode (ImageBorderMode)
 RLAPI void ImageResize(Image *image, int newWidth, int newHeight);                                       // Resize image (Bicubic scaling algorithm)
 RLAPI void ImageResizeNN(Image *image, int newWidth, int newHeight);                                     // Resize image (Nearest-Neighbor scaling algorithm)
 RLAPI void ImageResizeCanvas(Image *image, int newWidth, int newHeight, int offsetX, int offsetY, Color fill); // Resize canvas and fill with color
@@ -1389,8 +1401,10 @@ RLAPI void ImageColorGrayscale(Image *image);
 RLAPI void ImageColorContrast(Image *image, float contrast);                                             // Modify image color: contrast (-100 to 100)
 RLAPI void ImageColorBrightness(Image *image, int brightness);                                           // Modify image color: brightness (-255 to 255)
 RLAPI void ImageColorReplace(Image *image, Color color, Color replace);                                  // Modify image color: replace color
+RLAPI void ImageColorQuantize(Image *image, const Color *palette, int paletteSize);                      // Modify image color: replace colors by closest palette color
 RLAPI Color *LoadImageColors(Image image);                                                               // Load color data from image as a Color array (RGBA - 32bit)
 RLAPI Color *LoadImagePalette(Image image, int maxPaletteSize, int *colorCount);                         // Load colors palette from image as a Color array (RGBA - 32bit)
+RLAPI Color *LoadImagePaletteQuantized(Image image, int maxPaletteSize, int *colorCount);                // Load colors palette from image, quantized to palette size (median cut)
 RLAPI void UnloadImageColors(Color *colors);                                                             // Unload color data loaded with LoadImageColors()
 RLAPI void UnloadImagePalette(Color *colors);                                                            // Unload colors palette loaded with LoadImagePalette()
 RLAPI Rectangle GetImageAlphaBorder(Image image, float threshold);                                       // Get image alpha border rectangle
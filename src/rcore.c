@@ -694,6 +694,10 @@ void InitWindow(int width, int height, const char *title)
     // NOTE: Current fbo size stored as globals in rlgl for convenience
     rlglInit(CORE.Window.currentFbo.width, CORE.Window.currentFbo.height);
 
+    // Enable multisampling if requested, it's a no-op when the framebuffer has no samples
+    // NOTE: Required by the software renderer, that allocates its own samples
+    if (FLAG_IS_SET(CORE.Window.flags, FLAG_MSAA_4X_HINT)) rlEnableMultisample();
+
     // Setup default viewport
     SetupViewport(CORE.Window.currentFbo.width, CORE.Window.currentFbo.height);
 
@@ -922,6 +926,8 @@ void EndDrawing(void)
     PollInputEvents();      // Poll user events (before next frame update)
 #endif
 
+    rlEndFrameStats();      // Store frame statistics in history (only with RLGL_ENABLE_FRAME_STATS)
+
 #if defined(SUPPORT_SCREEN_CAPTURE)
     if (IsKeyPressed(KEY_F12))
     {
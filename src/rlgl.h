@@ -47,16 +47,31 @@
 *       #define RLGL_ENABLE_OPENGL_DEBUG_CONTEXT
 *           Enable debug context (only available on OpenGL 4.3)
 *
+*       #define RLGL_ENABLE_FRAME_STATS
+*           Record rendering statistics per frame (draw calls, batch flushes, vertices, timings...)
+*           in a history of the last RL_MAX_FRAME_STATS frames, retrieved with rlGetFrameStats()
+*           Software renderer also reports primitives culled/clipped and pixels shaded/blended/depth-rejected
+*           If not defined, the statistics counters compile to nothing
+*
+*       #define RLGL_ENABLE_COMMAND_LISTS
+*           Enable command lists recording: any thread can record immediate-mode vertex data
+*           (rlBegin()/rlEnd(), rlVertex*(), rlSetTexture(), matrix stack) and so raylib Draw*() functions
+*           into an rlCommandList, submitted in order by the rendering thread with rlSubmitCommandList()
+*           Submitted vertex are transformed by the matrices current at submission, as immediate-mode vertex
+*           Requires compiler thread-local storage support, if not defined recording is not available
+*
 *       rlgl capabilities could be customized just defining some internal
 *       values before library inclusion (default values listed):
 *
 *       #define RL_DEFAULT_BATCH_BUFFER_ELEMENTS   8192    // Default internal render batch elements limits
 *       #define RL_DEFAULT_BATCH_BUFFERS              1    // Default number of batch buffers (multi-buffering)
 *       #define RL_DEFAULT_BATCH_DRAWCALLS          256    // Default number of batch draw calls (by state changes: mode, texture)
+*       #define RL_DEFAULT_BATCH_STREAM_SEGMENTS      3    // Default number of vertex stream ring segments (persistent mapped buffer, OpenGL 3.3+)
 *       #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS    4    // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 *
 *       #define RL_MAX_MATRIX_STACK_SIZE             32    // Maximum size of internal Matrix stack
 *       #define RL_MAX_SHADER_LOCATIONS              32    // Maximum number of shader locations supported
+*       #define RL_MAX_FRAME_STATS                   64    // Maximum number of frames kept in statistics history
 *       #define RL_CULL_DISTANCE_NEAR              0.05    // Default projection matrix near cull distance
 *       #define RL_CULL_DISTANCE_FAR             4000.0    // Default projection matrix far cull distance
 *
@@ -225,6 +240,9 @@
 #ifndef RL_DEFAULT_BATCH_DRAWCALLS
     #define RL_DEFAULT_BATCH_DRAWCALLS             256      // Default number of batch draw calls (by state changes: mode, texture)
 #endif
+#ifndef RL_DEFAULT_BATCH_STREAM_SEGMENTS
+    #define RL_DEFAULT_BATCH_STREAM_SEGMENTS         3      // Default number of vertex stream ring segments (persistent mapped buffer, OpenGL 3.3+)
+#endif
 #ifndef RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS
     #define RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS       4      // Maximum number of textures units that can be activated on batch drawing (SetShaderValueTexture())
 #endif
@@ -239,6 +257,11 @@
     #define RL_MAX_SHADER_LOCATIONS                 32      // Maximum number of shader locations supported
 #endif
 
+// Frame statistics history
+#ifndef RL_MAX_FRAME_STATS
+    #define RL_MAX_FRAME_STATS                      64      // Maximum number of frames kept in statistics history
+#endif
+
 // Projection matrix culling
 #ifndef RL_CULL_DISTANCE_NEAR
     #define RL_CULL_DISTANCE_NEAR                 0.05      // Default near cull distance
@@ -432,6 +455,52 @@ typedef struct rlRenderBatch {
     float currentDepth;         // Current depth value for next draw
 } rlRenderBatch;
 
+// Command list type
+// NOTE: Vertex data is recorded with rlVertexBuffer layout, split in draws by mode and texture changes,
+// recording state (current vertex attributes, transform) is kept by the list, not shared with rlgl state
+typedef struct rlCommandList {
+    int vertexCapacity;         // Number of vertex allocated (grows on demand)
+    int vertexCounter;          // Number of vertex recorded
+    float *vertices;            // Vertex position (XYZ - 3 components per vertex)
+    float *texcoords;           // Vertex texture coordinates (UV - 2 components per vertex)
+    float *normals;             // Vertex normal (XYZ - 3 components per vertex)
+    unsigned char *colors;      // Vertex colors (RGBA - 4 components per vertex)
+
+    rlDrawCall *draws;          // Draw calls recorded, by mode and texture changes
+    int drawCapacity;           // Number of draw calls allocated (grows on demand)
+    int drawCounter;            // Draw calls counter
+
+    unsigned int currentTextureId; // Current texture id for next draw (0: default texture)
+    float texcoordx, texcoordy; // Current vertex texture coordinates
+    float normalx, normaly, normalz; // Current vertex normal
+    unsigned char colorr, colorg, colorb, colora; // Current vertex color
+    float currentDepth;         // Current depth value for next 2D vertex
+
+    Matrix transform;           // Current transform applied to recorded vertex
+    bool transformRequired;     // Require transform matrix application to recorded vertex
+    Matrix stack[RL_MAX_MATRIX_STACK_SIZE]; // Matrix stack for push/pop
+    int stackCounter;           // Matrix stack counter
+} rlCommandList;
+
+// Frame statistics (recorded with RLGL_ENABLE_FRAME_STATS)
+// NOTE: Primitives and pixels counters are only reported by the software renderer
+typedef struct rlFrameStats {
+    unsigned int drawCalls;         // Draw calls submitted (one per rlBegin() on OpenGL 1.1)
+    unsigned int batchFlushes;      // Render batches drawn with vertex data
+    unsigned int limitFlushes;      // Render batch draws forced by vertex buffer overflow (rlCheckRenderBatchLimit())
+    unsigned int drawCallFlushes;   // Render batch draws forced by draw calls overflow (texture or mode switches)
+    unsigned int textureSwitches;   // Texture changes registering a new batch draw call
+    unsigned int vertexCount;       // Vertices submitted
+    unsigned int primitivesCulled;  // Primitives rejected by face culling
+    unsigned int primitivesClipped; // Primitives entirely outside of the view volume
+    unsigned int pixelsShaded;      // Pixels written to the color buffer
+    unsigned int pixelsBlended;     // Pixels written with blending
+    unsigned int pixelsDepthRejected; // Pixels rejected by the depth test
+    double batchTime;               // Time spent drawing render batches (seconds)
+    double rasterTime;              // Time spent rasterizing deferred primitives (seconds, software renderer with threads)
+    double frameTime;               // Time elapsed since the end of previous frame (seconds)
+} rlFrameStats;
+
 // OpenGL version
 typedef enum {
     RL_OPENGL_11_SOFTWARE = 0,  // Software rendering
@@ -700,6 +769,8 @@ RLAPI void rlSetLineWidth(float width);                 // Set the line drawing
 RLAPI float rlGetLineWidth(void);                       // Get the line drawing width
 RLAPI void rlEnableSmoothLines(void);                   // Enable line aliasing
 RLAPI void rlDisableSmoothLines(void);                  // Disable line aliasing
+RLAPI void rlEnableMultisample(void);                   // Enable multisample anti-aliasing (MSAA)
+RLAPI void rlDisableMultisample(void);                  // Disable multisample anti-aliasing (MSAA)
 RLAPI void rlEnableStereoRender(void);                  // Enable stereo rendering
 RLAPI void rlDisableStereoRender(void);                 // Disable stereo rendering
 RLAPI bool rlIsStereoRenderEnabled(void);               // Check if stereo render is enabled
@@ -738,9 +809,24 @@ RLAPI void rlDrawRenderBatch(rlRenderBatch *batch);     // Draw render batch dat
 RLAPI void rlSetRenderBatchActive(rlRenderBatch *batch); // Set the active render batch for rlgl (NULL for default internal)
 RLAPI void rlDrawRenderBatchActive(void);               // Update and draw internal render batch
 RLAPI bool rlCheckRenderBatchLimit(int vCount);         // Check internal buffer overflow for a given number of vertex
+RLAPI void rlEnableRenderBatchSorting(void);            // Enable render batch draw calls merging by texture (keeping overlapping draws order)
+RLAPI void rlDisableRenderBatchSorting(void);           // Disable render batch draw calls merging
+
+// Command lists management
+// NOTE: Lists can be recorded concurrently by any thread (one list per thread at a time) using the
+// immediate-mode vertex API and raylib Draw*() functions, submission must be done by the rendering thread
+RLAPI rlCommandList rlLoadCommandList(int vertexCount); // Load a command list, initial vertex capacity
+RLAPI void rlUnloadCommandList(rlCommandList list);     // Unload command list
+RLAPI void rlBeginCommandList(rlCommandList *list);     // Begin recording into command list on current thread (list is reset, requires RLGL_ENABLE_COMMAND_LISTS)
+RLAPI void rlEndCommandList(void);                      // End recording on current thread
+RLAPI void rlSubmitCommandList(const rlCommandList *list); // Submit recorded command list into active render batch
 
 RLAPI void rlSetTexture(unsigned int id);               // Set current texture for render batch and check buffers limits
 
+// Frame statistics (requires RLGL_ENABLE_FRAME_STATS)
+RLAPI void rlEndFrameStats(void);                       // Store current frame statistics in the history and start a new frame
+RLAPI rlFrameStats rlGetFrameStats(int frame);          // Get statistics of a recorded frame (0: last completed frame, 1: previous one...)
+
 //------------------------------------------------------------------------------------------------------------------------
 
 // Vertex buffers management
@@ -779,6 +865,8 @@ RLAPI void rlUnloadFramebuffer(unsigned int id);                          // Del
 // WARNING: Copy and resize framebuffer functionality only defined for software backend
 RLAPI void rlCopyFramebuffer(int x, int y, int width, int height, int format, void *pixels); // Copy framebuffer pixel data to internal buffer
 RLAPI void rlResizeFramebuffer(int width, int height);                    // Resize internal framebuffer
+RLAPI bool rlBindFramebufferMemory(void *pixels, int width, int height, int stride, bool bgra); // Render into external 32-bit pixel memory (stride in bytes), NULL restores internal buffer
+RLAPI void rlFinishFramebuffer(void);                                     // Wait for pending rendering to complete on framebuffer
 
 // Shaders management
 RLAPI unsigned int rlLoadShaderCode(const char *vsCode, const char *fsCode);    // Load shader from code strings
@@ -847,6 +935,9 @@ RLAPI void rlLoadDrawQuad(void);     // Load and draw a quad
 #if defined(GRAPHICS_API_OPENGL_11)
     #if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
         #define RLSW_IMPLEMENTATION
+        #if defined(RLGL_ENABLE_FRAME_STATS)
+            #define RLSW_USE_STATS
+        #endif
         #define SW_MALLOC(sz) RL_MALLOC(sz)
         #define SW_REALLOC(ptr, newSz) RL_REALLOC(ptr, newSz)
         #define SW_FREE(ptr) RL_FREE(ptr)
@@ -914,6 +1005,14 @@ RLAPI void rlLoadDrawQuad(void);     // Load and draw a quad
 #include <string.h>                     // Required for: strcmp(), strlen() [Used in rlglInit(), on extensions loading]
 #include <math.h>                       // Required for: sqrtf(), sinf(), cosf(), floor(), log()
 
+#if defined(RLGL_ENABLE_FRAME_STATS)
+    #if defined(__APPLE__)
+        #include <mach/mach_time.h>     // Required for: mach_absolute_time() [Used in rlGetStatsTime()]
+    #else
+        #include <time.h>               // Required for: clock_gettime(), timespec_get() [Used in rlGetStatsTime()]
+    #endif
+#endif
+
 //----------------------------------------------------------------------------------
 // Defines and Macros
 //----------------------------------------------------------------------------------
@@ -1117,7 +1216,28 @@ typedef struct rlglData {
         int framebufferWidth;               // Current framebuffer width
         int framebufferHeight;              // Current framebuffer height
 
+        bool batchSorting;                  // Render batch draw calls merging by texture enabled
+
     } State;            // Renderer state
+    struct {
+        rlDrawCall draws[RL_DEFAULT_BATCH_DRAWCALLS]; // Merged draw calls
+        float *vertices;                    // Vertex positions reordered by merged draw calls
+        float *texcoords;                   // Vertex texcoords reordered by merged draw calls
+        float *normals;                     // Vertex normals reordered by merged draw calls
+        unsigned char *colors;              // Vertex colors reordered by merged draw calls
+        int vertexCapacity;                 // Number of vertex allocated for reordered data
+    } BatchSort;        // Render batch sorting buffers
+#if defined(GRAPHICS_API_OPENGL_33)
+    struct {
+        unsigned int vaoId;                 // OpenGL Vertex Array Object id (streamed interleaved vertex data)
+        unsigned int vboId;                 // OpenGL Vertex Buffer Object id (ring buffer, RL_DEFAULT_BATCH_STREAM_SEGMENTS segments)
+        unsigned char *mapped;              // Persistently mapped buffer memory (NULL if buffer orphaning is used)
+        unsigned char *data;                // Interleaved vertex data staging buffer (only for buffer orphaning)
+        GLsync fences[RL_DEFAULT_BATCH_STREAM_SEGMENTS]; // GPU fences signaled when segment data has been consumed
+        int segmentVertices;                // Number of vertex per ring segment
+        int currentSegment;                 // Ring segment used by last streamed batch
+    } Stream;           // Render batch vertex streaming
+#endif
     struct {
         bool vao;                           // VAO support (OpenGL ES2 could not support VAO extension) (GL_ARB_vertex_array_object)
         bool instancing;                    // Instancing supported (GL_ANGLE_instanced_arrays, GL_EXT_draw_instanced + GL_EXT_instanced_arrays)
@@ -1135,6 +1255,7 @@ typedef struct rlglData {
         bool texAnisoFilter;                // Anisotropic texture filtering support (GL_EXT_texture_filter_anisotropic)
         bool computeShader;                 // Compute shaders support (GL_ARB_compute_shader)
         bool ssbo;                          // Shader storage buffer object support (GL_ARB_shader_storage_buffer_object)
+        bool bufferStorage;                 // Persistent mapped buffers support (GL_ARB_buffer_storage + GL_ARB_sync)
 
         float maxAnisotropyLevel;           // Maximum anisotropy level supported (minimum is 2.0f)
         int maxDepthBits;                   // Maximum bits for depth component
@@ -1144,6 +1265,45 @@ typedef struct rlglData {
 
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
+#if defined(GRAPHICS_API_OPENGL_33)
+// Render batch streamed vertex, interleaved data
+typedef struct rlStreamVertex {
+    float position[3];                      // Vertex position (XYZ - 3 components per vertex)
+    float texcoord[2];                      // Vertex texture coordinates (UV - 2 components per vertex)
+    float normal[3];                        // Vertex normal (XYZ - 3 components per vertex)
+    unsigned char color[4];                 // Vertex color (RGBA - 4 components per vertex)
+} rlStreamVertex;
+#endif
+
+#if defined(RLGL_ENABLE_COMMAND_LISTS)
+    #if defined(__cplusplus)
+        #define RL_THREAD_LOCAL thread_local
+    #elif defined(_MSC_VER)
+        #define RL_THREAD_LOCAL __declspec(thread)
+    #else
+        #define RL_THREAD_LOCAL __thread
+    #endif
+
+// Redirect immediate-mode call into the command list being recorded on current thread (if any)
+#define RL_COMMAND_LIST_RECORD(call) if (rlRecordingList != NULL) { call; return; }
+#else
+#define RL_COMMAND_LIST_RECORD(call) ((void)0)
+#endif
+
+#if defined(RLGL_ENABLE_FRAME_STATS)
+typedef struct rlFrameStatsData {
+    rlFrameStats current;                   // Statistics of the frame being recorded
+    rlFrameStats history[RL_MAX_FRAME_STATS]; // Statistics of the last completed frames (ring buffer)
+    int historyIndex;                       // Next history entry to be written
+    int historyCount;                       // Number of valid history entries
+    double frameEndTime;                    // End time of the previous frame
+} rlFrameStatsData;
+
+#define RL_FRAME_STATS_ADD(field, n) (rlFrameStatsState.current.field += (n))
+#else
+#define RL_FRAME_STATS_ADD(field, n) ((void)0)
+#endif
+
 //----------------------------------------------------------------------------------
 // Global Variables Definition
 //----------------------------------------------------------------------------------
@@ -1153,6 +1313,12 @@ static double rlCullDistanceFar = RL_CULL_DISTANCE_FAR;
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 static rlglData RLGL = { 0 };
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
+#if defined(RLGL_ENABLE_FRAME_STATS)
+static rlFrameStatsData rlFrameStatsState = { 0 };
+#endif
+#if defined(RLGL_ENABLE_COMMAND_LISTS)
+static RL_THREAD_LOCAL rlCommandList *rlRecordingList = NULL; // Command list being recorded on current thread
+#endif
 static bool isGpuReady = false;
 
 #if defined(GRAPHICS_API_OPENGL_ES2) && !defined(GRAPHICS_API_OPENGL_ES3)
@@ -1173,12 +1339,36 @@ static PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor = NULL;
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 static void rlLoadShaderDefault(void);      // Load default shader
 static void rlUnloadShaderDefault(void);    // Unload default shader
+static int rlSortRenderBatch(rlRenderBatch *batch, int *vertexCount); // Merge render batch draw calls by texture (returns merged draws count)
+#if defined(GRAPHICS_API_OPENGL_33)
+static void rlLoadVertexStream(int vertexCount);    // Load render batch vertex stream (ring buffer)
+static void rlUnloadVertexStream(void);             // Unload render batch vertex stream
+static bool rlUpdateVertexStream(const float *vertices, const float *texcoords, const float *normals, const unsigned char *colors, int vertexCount); // Stream vertex data into next ring segment
+static void rlBindVertexStream(unsigned int indexBufferId); // Bind vertex stream VAO and current shader attributes
+#endif
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 static const char *rlGetCompressedFormatName(int format); // Get compressed format official GL identifier name
 #endif  // RLGL_SHOW_GL_DETAILS_INFO
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
 static int rlGetPixelDataSize(int width, int height, int format);   // Get pixel data size in bytes (image or texture)
+#if defined(RLGL_ENABLE_FRAME_STATS)
+static double rlGetStatsTime(void);                         // Get current time for statistics (seconds)
+#endif
+
+#if defined(RLGL_ENABLE_COMMAND_LISTS)
+static void rlRecordBegin(int mode);                        // Record drawing mode into current thread command list
+static void rlRecordEnd(void);                              // Record vertex providing end into current thread command list
+static void rlRecordVertex(float x, float y, float z);      // Record one vertex into current thread command list
+static void rlRecordTexCoord(float x, float y);             // Record current vertex texture coordinate
+static void rlRecordNormal(float x, float y, float z);      // Record current vertex normal
+static void rlRecordColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a); // Record current vertex color
+static void rlRecordTexture(unsigned int id);               // Record current texture
+static void rlRecordPushMatrix(void);                       // Push command list transform into its stack
+static void rlRecordPopMatrix(void);                        // Pop command list transform from its stack
+static void rlRecordLoadIdentity(void);                     // Reset command list transform
+static void rlRecordMatrix(Matrix mat);                     // Multiply command list transform by a matrix
+#endif
 
 static Matrix rlMatrixIdentity(void);                       // Get identity matrix
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
@@ -1186,10 +1376,16 @@ static Matrix rlMatrixIdentity(void);                       // Get identity matr
 typedef struct rl_float16 { float v[16]; } rl_float16;
 static rl_float16 rlMatrixToFloatV(Matrix mat);             // Get float array of matrix data
 #define rlMatrixToFloat(mat) (rlMatrixToFloatV(mat).v)      // Get float vector for Matrix
-static Matrix rlMatrixMultiply(Matrix left, Matrix right);  // Multiply two matrices
 static Matrix rlMatrixTranspose(Matrix mat);                // Transposes provided matrix
 static Matrix rlMatrixInvert(Matrix mat);                   // Invert provided matrix
 #endif
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2) || defined(RLGL_ENABLE_COMMAND_LISTS)
+static Matrix rlMatrixMultiply(Matrix left, Matrix right);  // Multiply two matrices
+static Matrix rlMatrixTranslate(float x, float y, float z); // Get translation matrix
+static Matrix rlMatrixRotate(float angle, float x, float y, float z); // Get rotation matrix (angle in degrees)
+static Matrix rlMatrixScale(float x, float y, float z);     // Get scaling matrix
+static Matrix rlMatrixFromFloat(const float *matf);         // Get matrix from float array (column-major)
+#endif
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition - Matrix operations
@@ -1219,13 +1415,13 @@ void rlOrtho(double left, double right, double bottom, double top, double znear,
     glOrtho(left, right, bottom, top, znear, zfar);
 }
 
-void rlPushMatrix(void) { glPushMatrix(); }
-void rlPopMatrix(void) { glPopMatrix(); }
-void rlLoadIdentity(void) { glLoadIdentity(); }
-void rlTranslatef(float x, float y, float z) { glTranslatef(x, y, z); }
-void rlRotatef(float angle, float x, float y, float z) { glRotatef(angle, x, y, z); }
-void rlScalef(float x, float y, float z) { glScalef(x, y, z); }
-void rlMultMatrixf(const float *matf) { glMultMatrixf(matf); }
+void rlPushMatrix(void) { RL_COMMAND_LIST_RECORD(rlRecordPushMatrix()); glPushMatrix(); }
+void rlPopMatrix(void) { RL_COMMAND_LIST_RECORD(rlRecordPopMatrix()); glPopMatrix(); }
+void rlLoadIdentity(void) { RL_COMMAND_LIST_RECORD(rlRecordLoadIdentity()); glLoadIdentity(); }
+void rlTranslatef(float x, float y, float z) { RL_COMMAND_LIST_RECORD(rlRecordMatrix(rlMatrixTranslate(x, y, z))); glTranslatef(x, y, z); }
+void rlRotatef(float angle, float x, float y, float z) { RL_COMMAND_LIST_RECORD(rlRecordMatrix(rlMatrixRotate(angle, x, y, z))); glRotatef(angle, x, y, z); }
+void rlScalef(float x, float y, float z) { RL_COMMAND_LIST_RECORD(rlRecordMatrix(rlMatrixScale(x, y, z))); glScalef(x, y, z); }
+void rlMultMatrixf(const float *matf) { RL_COMMAND_LIST_RECORD(rlRecordMatrix(rlMatrixFromFloat(matf))); glMultMatrixf(matf); }
 #endif
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 // Choose the current matrix to be transformed
@@ -1241,6 +1437,8 @@ void rlMatrixMode(int mode)
 // Push the current matrix into RLGL.State.stack
 void rlPushMatrix(void)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordPushMatrix());
+
     if (RLGL.State.stackCounter >= RL_MAX_MATRIX_STACK_SIZE) TRACELOG(RL_LOG_ERROR, "RLGL: Matrix stack overflow (RL_MAX_MATRIX_STACK_SIZE)");
 
     if (RLGL.State.currentMatrixMode == RL_MODELVIEW)
@@ -1256,6 +1454,8 @@ void rlPushMatrix(void)
 // Pop latest inserted matrix from RLGL.State.stack
 void rlPopMatrix(void)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordPopMatrix());
+
     if (RLGL.State.stackCounter > 0)
     {
         Matrix mat = RLGL.State.stack[RLGL.State.stackCounter - 1];
@@ -1273,18 +1473,17 @@ void rlPopMatrix(void)
 // Reset current matrix to identity matrix
 void rlLoadIdentity(void)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordLoadIdentity());
+
     *RLGL.State.currentMatrix = rlMatrixIdentity();
 }
 
 // Multiply the current matrix by a translation matrix
 void rlTranslatef(float x, float y, float z)
 {
-    Matrix matTranslation = {
-        1.0f, 0.0f, 0.0f, x,
-        0.0f, 1.0f, 0.0f, y,
-        0.0f, 0.0f, 1.0f, z,
-        0.0f, 0.0f, 0.0f, 1.0f
-    };
+    Matrix matTranslation = rlMatrixTranslate(x, y, z);
+
+    RL_COMMAND_LIST_RECORD(rlRecordMatrix(matTranslation));
 
     // NOTE: We transpose matrix with multiplication order
     *RLGL.State.currentMatrix = rlMatrixMultiply(matTranslation, *RLGL.State.currentMatrix);
@@ -1294,42 +1493,9 @@ void rlTranslatef(float x, float y, float z)
 // NOTE: The provided angle must be in degrees
 void rlRotatef(float angle, float x, float y, float z)
 {
-    Matrix matRotation = rlMatrixIdentity();
-
-    // Axis vector (x, y, z) normalization
-    float lengthSquared = x*x + y*y + z*z;
-    if ((lengthSquared != 1.0f) && (lengthSquared != 0.0f))
-    {
-        float inverseLength = 1.0f/sqrtf(lengthSquared);
-        x *= inverseLength;
-        y *= inverseLength;
-        z *= inverseLength;
-    }
-
-    // Rotation matrix generation
-    float sinres = sinf(DEG2RAD*angle);
-    float cosres = cosf(DEG2RAD*angle);
-    float t = 1.0f - cosres;
-
-    matRotation.m0 = x*x*t + cosres;
-    matRotation.m1 = y*x*t + z*sinres;
-    matRotation.m2 = z*x*t - y*sinres;
-    matRotation.m3 = 0.0f;
-
-    matRotation.m4 = x*y*t - z*sinres;
-    matRotation.m5 = y*y*t + cosres;
-    matRotation.m6 = z*y*t + x*sinres;
-    matRotation.m7 = 0.0f;
-
-    matRotation.m8 = x*z*t + y*sinres;
-    matRotation.m9 = y*z*t - x*sinres;
-    matRotation.m10 = z*z*t + cosres;
-    matRotation.m11 = 0.0f;
+    Matrix matRotation = rlMatrixRotate(angle, x, y, z);
 
-    matRotation.m12 = 0.0f;
-    matRotation.m13 = 0.0f;
-    matRotation.m14 = 0.0f;
-    matRotation.m15 = 1.0f;
+    RL_COMMAND_LIST_RECORD(rlRecordMatrix(matRotation));
 
     // NOTE: We transpose matrix with multiplication order
     *RLGL.State.currentMatrix = rlMatrixMultiply(matRotation, *RLGL.State.currentMatrix);
@@ -1338,12 +1504,9 @@ void rlRotatef(float angle, float x, float y, float z)
 // Multiply the current matrix by a scaling matrix
 void rlScalef(float x, float y, float z)
 {
-    Matrix matScale = {
-        x, 0.0f, 0.0f, 0.0f,
-        0.0f, y, 0.0f, 0.0f,
-        0.0f, 0.0f, z, 0.0f,
-        0.0f, 0.0f, 0.0f, 1.0f
-    };
+    Matrix matScale = rlMatrixScale(x, y, z);
+
+    RL_COMMAND_LIST_RECORD(rlRecordMatrix(matScale));
 
     // NOTE: We transpose matrix with multiplication order
     *RLGL.State.currentMatrix = rlMatrixMultiply(matScale, *RLGL.State.currentMatrix);
@@ -1353,10 +1516,9 @@ void rlScalef(float x, float y, float z)
 void rlMultMatrixf(const float *matf)
 {
     // Matrix creation from array
-    Matrix mat = { matf[0], matf[4], matf[8], matf[12],
-                   matf[1], matf[5], matf[9], matf[13],
-                   matf[2], matf[6], matf[10], matf[14],
-                   matf[3], matf[7], matf[11], matf[15] };
+    Matrix mat = rlMatrixFromFloat(matf);
+
+    RL_COMMAND_LIST_RECORD(rlRecordMatrix(mat));
 
     *RLGL.State.currentMatrix = rlMatrixMultiply(mat, *RLGL.State.currentMatrix);
 }
@@ -1459,6 +1621,9 @@ double rlGetCullDistanceFar(void)
 //---------------------------------------
 void rlBegin(int mode)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordBegin(mode));
+    RL_FRAME_STATS_ADD(drawCalls, 1);
+
     switch (mode)
     {
         case RL_LINES: glBegin(GL_LINES); break;
@@ -1468,20 +1633,22 @@ void rlBegin(int mode)
     }
 }
 
-void rlEnd(void) { glEnd(); }
-void rlVertex2i(int x, int y) { glVertex2i(x, y); }
-void rlVertex2f(float x, float y) { glVertex2f(x, y); }
-void rlVertex3f(float x, float y, float z) { glVertex3f(x, y, z); }
-void rlTexCoord2f(float x, float y) { glTexCoord2f(x, y); }
-void rlNormal3f(float x, float y, float z) { glNormal3f(x, y, z); }
-void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a) { glColor4ub(r, g, b, a); }
-void rlColor3f(float x, float y, float z) { glColor3f(x, y, z); }
-void rlColor4f(float x, float y, float z, float w) { glColor4f(x, y, z, w); }
+void rlEnd(void) { RL_COMMAND_LIST_RECORD(rlRecordEnd()); glEnd(); }
+void rlVertex2i(int x, int y) { RL_COMMAND_LIST_RECORD(rlRecordVertex((float)x, (float)y, 0.0f)); glVertex2i(x, y); RL_FRAME_STATS_ADD(vertexCount, 1); }
+void rlVertex2f(float x, float y) { RL_COMMAND_LIST_RECORD(rlRecordVertex(x, y, 0.0f)); glVertex2f(x, y); RL_FRAME_STATS_ADD(vertexCount, 1); }
+void rlVertex3f(float x, float y, float z) { RL_COMMAND_LIST_RECORD(rlRecordVertex(x, y, z)); glVertex3f(x, y, z); RL_FRAME_STATS_ADD(vertexCount, 1); }
+void rlTexCoord2f(float x, float y) { RL_COMMAND_LIST_RECORD(rlRecordTexCoord(x, y)); glTexCoord2f(x, y); }
+void rlNormal3f(float x, float y, float z) { RL_COMMAND_LIST_RECORD(rlRecordNormal(x, y, z)); glNormal3f(x, y, z); }
+void rlColor4ub(unsigned char r, unsigned char g, unsigned char b, unsigned char a) { RL_COMMAND_LIST_RECORD(rlRecordColor(r, g, b, a)); glColor4ub(r, g, b, a); }
+void rlColor3f(float x, float y, float z) { RL_COMMAND_LIST_RECORD(rlRecordColor((unsigned char)(x*255), (unsigned char)(y*255), (unsigned char)(z*255), 255)); glColor3f(x, y, z); }
+void rlColor4f(float x, float y, float z, float w) { RL_COMMAND_LIST_RECORD(rlRecordColor((unsigned char)(x*255), (unsigned char)(y*255), (unsigned char)(z*255), (unsigned char)(w*255))); glColor4f(x, y, z, w); }
 #endif
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 // Initialize drawing mode (how to organize vertex)
 void rlBegin(int mode)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordBegin(mode));
+
     // Draw mode can be RL_LINES, RL_TRIANGLES and RL_QUADS
     // NOTE: In all three cases, vertex are accumulated over default internal vertex buffer
     if (RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode != mode)
@@ -1504,7 +1671,11 @@ void rlBegin(int mode)
             }
         }
 
-        if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+        if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS)
+        {
+            RL_FRAME_STATS_ADD(drawCallFlushes, 1);
+            rlDrawRenderBatch(RLGL.currentBatch);
+        }
 
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode = mode;
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = RLGL.State.currentTextureId;
@@ -1515,6 +1686,8 @@ void rlBegin(int mode)
 // Finish vertex providing
 void rlEnd(void)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordEnd());
+
     // NOTE: Depth increment is dependant on rlOrtho(): z-near and z-far values,
     // as well as depth buffer bit-depth (16bit or 24bit or 32bit)
     // Correct increment formula would be: depthInc = (zfar - znear)/pow(2, bits)
@@ -1525,6 +1698,8 @@ void rlEnd(void)
 // NOTE: Vertex position data is the basic information required for drawing
 void rlVertex3f(float x, float y, float z)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordVertex(x, y, z));
+
     float tx = x;
     float ty = y;
     float tz = z;
@@ -1584,17 +1759,22 @@ void rlVertex3f(float x, float y, float z)
 
     RLGL.State.vertexCounter++;
     RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount++;
+    RL_FRAME_STATS_ADD(vertexCount, 1);
 }
 
 // Define one vertex (position)
 void rlVertex2f(float x, float y)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordVertex(x, y, rlRecordingList->currentDepth));
+
     rlVertex3f(x, y, RLGL.currentBatch->currentDepth);
 }
 
 // Define one vertex (position)
 void rlVertex2i(int x, int y)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordVertex((float)x, (float)y, rlRecordingList->currentDepth));
+
     rlVertex3f((float)x, (float)y, RLGL.currentBatch->currentDepth);
 }
 
@@ -1602,6 +1782,8 @@ void rlVertex2i(int x, int y)
 // NOTE: Texture coordinates are limited to QUADS only
 void rlTexCoord2f(float x, float y)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordTexCoord(x, y));
+
     RLGL.State.texcoordx = x;
     RLGL.State.texcoordy = y;
 }
@@ -1610,6 +1792,8 @@ void rlTexCoord2f(float x, float y)
 // NOTE: Normals limited to TRIANGLES only?
 void rlNormal3f(float x, float y, float z)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordNormal(x, y, z));
+
     float normalx = x;
     float normaly = y;
     float normalz = z;
@@ -1635,6 +1819,8 @@ void rlNormal3f(float x, float y, float z)
 // Define one vertex (color)
 void rlColor4ub(unsigned char x, unsigned char y, unsigned char z, unsigned char w)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordColor(x, y, z, w));
+
     RLGL.State.colorr = x;
     RLGL.State.colorg = y;
     RLGL.State.colorb = z;
@@ -1662,6 +1848,8 @@ void rlColor3f(float x, float y, float z)
 // Set current texture to use
 void rlSetTexture(unsigned int id)
 {
+    RL_COMMAND_LIST_RECORD(rlRecordTexture(id));
+
     if (id == 0)
     {
 #if defined(GRAPHICS_API_OPENGL_11)
@@ -1706,8 +1894,13 @@ void rlSetTexture(unsigned int id)
                 }
             }
 
-            if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+            if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS)
+            {
+                RL_FRAME_STATS_ADD(drawCallFlushes, 1);
+                rlDrawRenderBatch(RLGL.currentBatch);
+            }
 
+            RL_FRAME_STATS_ADD(textureSwitches, 1);
             RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = id;
             RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount = 0;
         }
@@ -1864,7 +2057,7 @@ void rlDisableShader(void)
 // Enable rendering to texture (fbo)
 void rlEnableFramebuffer(unsigned int id)
 {
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)
+#if ((defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
     glBindFramebuffer(GL_FRAMEBUFFER, id);
 #endif
 }
@@ -1873,7 +2066,7 @@ void rlEnableFramebuffer(unsigned int id)
 unsigned int rlGetActiveFramebuffer(void)
 {
     GLint fboId = 0;
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES3)) && defined(RLGL_RENDER_TEXTURES_HINT)
+#if ((defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES3)) && defined(RLGL_RENDER_TEXTURES_HINT)) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
     glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fboId);
 #endif
     return fboId;
@@ -1882,7 +2075,7 @@ unsigned int rlGetActiveFramebuffer(void)
 // Disable rendering to texture
 void rlDisableFramebuffer(void)
 {
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)
+#if ((defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 #endif
 }
@@ -1898,7 +2091,7 @@ void rlBlitFramebuffer(int srcX, int srcY, int srcWidth, int srcHeight, int dstX
 // Bind framebuffer object (fbo)
 void rlBindFramebuffer(unsigned int target, unsigned int framebuffer)
 {
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)
+#if ((defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
     glBindFramebuffer(target, framebuffer);
 #endif
 }
@@ -2070,6 +2263,23 @@ void rlDisableSmoothLines(void)
 #endif
 }
 
+// Enable multisample anti-aliasing (MSAA)
+// NOTE: Hardware backends require a multisampled framebuffer, the software renderer allocates its samples
+void rlEnableMultisample(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    glEnable(GL_MULTISAMPLE);
+#endif
+}
+
+// Disable multisample anti-aliasing (MSAA)
+void rlDisableMultisample(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    glDisable(GL_MULTISAMPLE);
+#endif
+}
+
 // Enable stereo rendering
 void rlEnableStereoRender(void)
 {
@@ -2320,6 +2530,10 @@ void rlglInit(int width, int height)
     RLGL.defaultBatch = rlLoadRenderBatch(RL_DEFAULT_BATCH_BUFFERS, RL_DEFAULT_BATCH_BUFFER_ELEMENTS);
     RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL] = -1;
     RLGL.currentBatch = &RLGL.defaultBatch;
+#if defined(GRAPHICS_API_OPENGL_33)
+    // Init render batch vertex stream, used by any batch that fits in a segment
+    rlLoadVertexStream(RL_DEFAULT_BATCH_BUFFER_ELEMENTS*4);
+#endif
 
     // Init stack matrices (emulating OpenGL 1.1)
     for (int i = 0; i < RL_MAX_MATRIX_STACK_SIZE; i++) RLGL.State.stack[i] = rlMatrixIdentity();
@@ -2386,6 +2600,16 @@ void rlglClose(void)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     rlUnloadRenderBatch(RLGL.defaultBatch);
+#if defined(GRAPHICS_API_OPENGL_33)
+    rlUnloadVertexStream();
+#endif
+
+    // Unload render batch sorting buffers
+    RL_FREE(RLGL.BatchSort.vertices);
+    RL_FREE(RLGL.BatchSort.texcoords);
+    RL_FREE(RLGL.BatchSort.normals);
+    RL_FREE(RLGL.BatchSort.colors);
+    RLGL.BatchSort.vertexCapacity = 0;
 
     rlUnloadShaderDefault(); // Unload default shader
 
@@ -2450,6 +2674,7 @@ void rlLoadExtensions(void *loader)
     RLGL.ExtSupported.texCompASTC = GLAD_GL_KHR_texture_compression_astc_hdr && GLAD_GL_KHR_texture_compression_astc_ldr;
     RLGL.ExtSupported.texCompDXT = GLAD_GL_EXT_texture_compression_s3tc;  // Texture compression: DXT
     RLGL.ExtSupported.texCompETC2 = GLAD_GL_ARB_ES3_compatibility;        // Texture compression: ETC2/EAC
+    RLGL.ExtSupported.bufferStorage = GLAD_GL_ARB_buffer_storage && GLAD_GL_VERSION_3_2; // Persistent mapped buffers (fences required)
     #if defined(GRAPHICS_API_OPENGL_43)
     RLGL.ExtSupported.computeShader = GLAD_GL_ARB_compute_shader;
     RLGL.ExtSupported.ssbo = GLAD_GL_ARB_shader_storage_buffer_object;
@@ -2982,34 +3207,72 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
 void rlDrawRenderBatch(rlRenderBatch *batch)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+#if defined(RLGL_ENABLE_FRAME_STATS)
+    double startTime = rlGetStatsTime();
+    if (RLGL.State.vertexCounter > 0) RL_FRAME_STATS_ADD(batchFlushes, 1);
+#endif
+
+    // Merge draw calls by texture if required
+    //------------------------------------------------------------------------------------------------------------
+    const rlDrawCall *draws = batch->draws;
+    int drawCounter = batch->drawCounter;
+    int vertexCounter = RLGL.State.vertexCounter;
+    const float *vertices = batch->vertexBuffer[batch->currentBuffer].vertices;
+    const float *texcoords = batch->vertexBuffer[batch->currentBuffer].texcoords;
+    const float *normals = batch->vertexBuffer[batch->currentBuffer].normals;
+    const unsigned char *colors = batch->vertexBuffer[batch->currentBuffer].colors;
+
+    // NOTE: Stereo rendering uses a different projection per eye, draws are kept in submission order
+    if (RLGL.State.batchSorting && !RLGL.State.stereoRender && (drawCounter > 1))
+    {
+        int mergedCounter = rlSortRenderBatch(batch, &vertexCounter);
+
+        if (mergedCounter > 0)
+        {
+            draws = RLGL.BatchSort.draws;
+            drawCounter = mergedCounter;
+            vertices = RLGL.BatchSort.vertices;
+            texcoords = RLGL.BatchSort.texcoords;
+            normals = RLGL.BatchSort.normals;
+            colors = RLGL.BatchSort.colors;
+        }
+    }
+    //------------------------------------------------------------------------------------------------------------
+
     // Update batch vertex buffers
     //------------------------------------------------------------------------------------------------------------
     // NOTE: If there is not vertex data, buffers doesn't need to be updated (vertexCount > 0)
     // TODO: If no data changed on the CPU arrays there is no need to re-upload data to GPU,
     // a flag can be used to detect changes but it would imply keeping a copy buffer and memcmp() both, does it worth it?
-    if (RLGL.State.vertexCounter > 0)
+    bool streamed = false;
+#if defined(GRAPHICS_API_OPENGL_33)
+    // Stream vertex data into the next ring segment, avoids stalling on buffers the GPU could be still reading
+    if (vertexCounter > 0) streamed = rlUpdateVertexStream(vertices, texcoords, normals, colors, vertexCounter);
+#endif
+
+    if ((vertexCounter > 0) && !streamed)
     {
         // Activate elements VAO
         if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
 
         // Vertex positions buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].vertices);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCounter*3*sizeof(float), vertices);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].vertices, GL_DYNAMIC_DRAW);  // Update all buffer
 
         // Texture coordinates buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[1]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*2*sizeof(float), batch->vertexBuffer[batch->currentBuffer].texcoords);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCounter*2*sizeof(float), texcoords);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*2*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].texcoords, GL_DYNAMIC_DRAW); // Update all buffer
 
         // Normals buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[2]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].normals);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCounter*3*sizeof(float), normals);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*3*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].normals, GL_DYNAMIC_DRAW); // Update all buffer
 
         // Colors buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[3]);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*4*sizeof(unsigned char), batch->vertexBuffer[batch->currentBuffer].colors);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCounter*4*sizeof(unsigned char), colors);
         //glBufferData(GL_ARRAY_BUFFER, sizeof(float)*4*4*batch->vertexBuffer[batch->currentBuffer].elementCount, batch->vertexBuffer[batch->currentBuffer].colors, GL_DYNAMIC_DRAW);    // Update all buffer
 
         // NOTE: glMapBuffer() causes sync issue
@@ -3054,7 +3317,7 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
         }
 
         // Draw buffers
-        if (RLGL.State.vertexCounter > 0)
+        if (vertexCounter > 0)
         {
             // Set current shader and upload current MVP matrix
             glUseProgram(RLGL.State.currentShaderId);
@@ -3086,6 +3349,10 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
                 glUniformMatrix4fv(RLGL.State.currentShaderLocs[RL_SHADER_LOC_MATRIX_NORMAL], 1, false, rlMatrixToFloat(rlMatrixTranspose(rlMatrixInvert(RLGL.State.transform))));
             }
 
+#if defined(GRAPHICS_API_OPENGL_33)
+            if (streamed) rlBindVertexStream(batch->vertexBuffer[batch->currentBuffer].vboId[4]);
+            else
+#endif
             if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
             else
             {
@@ -3131,28 +3398,30 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
             // NOTE: Batch system accumulates calls by texture0 changes, additional textures are enabled for all the draw calls
             glActiveTexture(GL_TEXTURE0);
 
-            for (int i = 0, vertexOffset = 0; i < batch->drawCounter; i++)
+            for (int i = 0, vertexOffset = 0; i < drawCounter; i++)
             {
                 // Bind current draw call texture, activated as GL_TEXTURE0 and bound to sampler2D texture0 by default
-                glBindTexture(GL_TEXTURE_2D, batch->draws[i].textureId);
+                glBindTexture(GL_TEXTURE_2D, draws[i].textureId);
 
-                if ((batch->draws[i].mode == RL_LINES) || (batch->draws[i].mode == RL_TRIANGLES)) glDrawArrays(batch->draws[i].mode, vertexOffset, batch->draws[i].vertexCount);
+                if ((draws[i].mode == RL_LINES) || (draws[i].mode == RL_TRIANGLES)) glDrawArrays(draws[i].mode, vertexOffset, draws[i].vertexCount);
                 else
                 {
     #if defined(GRAPHICS_API_OPENGL_33)
                     // We need to define the number of indices to be processed: elementCount*6
                     // NOTE: The final parameter tells the GPU the offset in bytes from the
                     // start of the index buffer to the location of the first index to process
-                    glDrawElements(GL_TRIANGLES, batch->draws[i].vertexCount/4*6, GL_UNSIGNED_INT, (GLvoid *)(vertexOffset/4*6*sizeof(GLuint)));
+                    glDrawElements(GL_TRIANGLES, draws[i].vertexCount/4*6, GL_UNSIGNED_INT, (GLvoid *)(vertexOffset/4*6*sizeof(GLuint)));
     #endif
     #if defined(GRAPHICS_API_OPENGL_ES2)
-                    glDrawElements(GL_TRIANGLES, batch->draws[i].vertexCount/4*6, GL_UNSIGNED_SHORT, (GLvoid *)(vertexOffset/4*6*sizeof(GLushort)));
+                    glDrawElements(GL_TRIANGLES, draws[i].vertexCount/4*6, GL_UNSIGNED_SHORT, (GLvoid *)(vertexOffset/4*6*sizeof(GLushort)));
     #endif
                 }
 
-                vertexOffset += (batch->draws[i].vertexCount + batch->draws[i].vertexAlignment);
+                vertexOffset += (draws[i].vertexCount + draws[i].vertexAlignment);
             }
 
+            RL_FRAME_STATS_ADD(drawCalls, drawCounter);
+
             if (!RLGL.ExtSupported.vao)
             {
                 glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -3167,6 +3436,11 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
         glUseProgram(0);    // Unbind shader program
     }
 
+#if defined(GRAPHICS_API_OPENGL_33)
+    // Fence the ring segment, it can't be overwritten until the GPU is done with it
+    if (streamed && (RLGL.Stream.mapped != NULL)) RLGL.Stream.fences[RLGL.Stream.currentSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+
     // Restore viewport to default measures
     if (eyeCount == 2) rlViewport(0, 0, RLGL.State.framebufferWidth, RLGL.State.framebufferHeight);
     //------------------------------------------------------------------------------------------------------------
@@ -3201,6 +3475,10 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
     // Change to next buffer in the list (in case of multi-buffering)
     batch->currentBuffer++;
     if (batch->currentBuffer >= batch->bufferCount) batch->currentBuffer = 0;
+
+#if defined(RLGL_ENABLE_FRAME_STATS)
+    RL_FRAME_STATS_ADD(batchTime, rlGetStatsTime() - startTime);
+#endif
 #endif
 }
 
@@ -3229,11 +3507,16 @@ bool rlCheckRenderBatchLimit(int vCount)
 {
     bool overflow = false;
 
+#if defined(RLGL_ENABLE_COMMAND_LISTS)
+    if (rlRecordingList != NULL) return overflow;   // Command lists grow on demand
+#endif
+
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     if ((RLGL.State.vertexCounter + vCount) >=
         (RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4))
     {
         overflow = true;
+        RL_FRAME_STATS_ADD(limitFlushes, 1);
 
         // Store current primitive drawing mode and texture id
         int currentMode = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode;
@@ -3250,6 +3533,249 @@ bool rlCheckRenderBatchLimit(int vCount)
     return overflow;
 }
 
+// Enable render batch draw calls merging by texture
+// NOTE: Draws are reordered only when they don't overlap the draws they are moved across
+void rlEnableRenderBatchSorting(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.batchSorting = true;
+#endif
+}
+
+// Disable render batch draw calls merging
+void rlDisableRenderBatchSorting(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.batchSorting = false;
+#endif
+}
+
+// Load a command list, initial vertex capacity
+// NOTE: Command lists are CPU-only data, they can be loaded and recorded from any thread
+rlCommandList rlLoadCommandList(int vertexCount)
+{
+    rlCommandList list = { 0 };
+
+    if (vertexCount < 4) vertexCount = 4;
+
+    list.vertexCapacity = vertexCount;
+    list.vertices = (float *)RL_MALLOC(vertexCount*3*sizeof(float));
+    list.texcoords = (float *)RL_MALLOC(vertexCount*2*sizeof(float));
+    list.normals = (float *)RL_MALLOC(vertexCount*3*sizeof(float));
+    list.colors = (unsigned char *)RL_MALLOC(vertexCount*4*sizeof(unsigned char));
+
+    list.drawCapacity = 32;
+    list.draws = (rlDrawCall *)RL_MALLOC(list.drawCapacity*sizeof(rlDrawCall));
+
+    list.transform = rlMatrixIdentity();
+    list.currentDepth = -1.0f;
+
+    return list;
+}
+
+// Unload command list
+void rlUnloadCommandList(rlCommandList list)
+{
+    RL_FREE(list.vertices);
+    RL_FREE(list.texcoords);
+    RL_FREE(list.normals);
+    RL_FREE(list.colors);
+    RL_FREE(list.draws);
+}
+
+// Begin recording into command list on current thread
+// NOTE: List is reset, immediate-mode vertex API calls on current thread are recorded
+// into the list (instead of the active render batch) until rlEndCommandList(),
+// recording starts with identity transform, opaque white color and no texture
+void rlBeginCommandList(rlCommandList *list)
+{
+#if defined(RLGL_ENABLE_COMMAND_LISTS)
+    if (list == NULL) return;
+
+    list->vertexCounter = 0;
+    list->drawCounter = 0;
+    list->currentTextureId = 0;
+    list->texcoordx = 0.0f;
+    list->texcoordy = 0.0f;
+    list->normalx = 0.0f;
+    list->normaly = 0.0f;
+    list->normalz = 1.0f;
+    list->colorr = 255;     // Opaque white, as OpenGL current color default
+    list->colorg = 255;
+    list->colorb = 255;
+    list->colora = 255;
+    list->currentDepth = -1.0f;
+    list->transform = rlMatrixIdentity();
+    list->transformRequired = false;
+    list->stackCounter = 0;
+
+    rlRecordingList = list;
+#else
+    (void)list;
+    TRACELOG(RL_LOG_WARNING, "RLGL: Command lists recording not available (RLGL_ENABLE_COMMAND_LISTS)");
+#endif
+}
+
+// End recording on current thread
+void rlEndCommandList(void)
+{
+#if defined(RLGL_ENABLE_COMMAND_LISTS)
+    rlRecordingList = NULL;
+#endif
+}
+
+// Submit recorded command list into active render batch
+// NOTE: Must be called by the rendering thread, once the list is not being recorded anymore,
+// lists are submitted in call order and can be submitted multiple times
+// NOTE: Recorded vertex are submitted as immediate-mode vertex on all backends: the transform
+// current at submission (rlPushMatrix(), rlTranslatef()...) applies to them, as do view and projection
+void rlSubmitCommandList(const rlCommandList *list)
+{
+    if ((list == NULL) || (list->vertexCounter == 0)) return;
+
+    for (int i = 0, vertexOffset = 0; i < list->drawCounter; i++)
+    {
+        const rlDrawCall *draw = &list->draws[i];
+
+        if (draw->vertexCount > 0)
+        {
+#if defined(GRAPHICS_API_OPENGL_11)
+            // Replay vertex data, no batching available
+            rlSetTexture(draw->textureId);
+            rlBegin(draw->mode);
+
+            for (int v = vertexOffset; v < (vertexOffset + draw->vertexCount); v++)
+            {
+                rlTexCoord2f(list->texcoords[2*v], list->texcoords[2*v + 1]);
+                rlNormal3f(list->normals[3*v], list->normals[3*v + 1], list->normals[3*v + 2]);
+                rlColor4ub(list->colors[4*v], list->colors[4*v + 1], list->colors[4*v + 2], list->colors[4*v + 3]);
+                rlVertex3f(list->vertices[3*v], list->vertices[3*v + 1], list->vertices[3*v + 2]);
+            }
+
+            rlEnd();
+#endif
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+            // Copy vertex data into active render batch, previous draws state (mode, texture) is checked
+            // by rlSetTexture()/rlBegin() as for any other draw, batch is drawn if limits are reached
+            rlSetTexture((draw->textureId != 0)? draw->textureId : RLGL.State.defaultTextureId);
+            rlBegin(draw->mode);
+
+            // NOTE: Vertex are copied by complete primitives, those can't be split between batches
+            int primitiveVertex = (draw->mode == RL_LINES)? 2 : ((draw->mode == RL_TRIANGLES)? 3 : 4);
+            int offset = vertexOffset;
+            int remaining = draw->vertexCount;
+
+            while (remaining > 0)
+            {
+                int available = RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer].elementCount*4 - 1 - RLGL.State.vertexCounter;
+                int count = (remaining <= available)? remaining : (available/primitiveVertex)*primitiveVertex;
+
+                if (count <= 0)
+                {
+                    rlCheckRenderBatchLimit(primitiveVertex + 1);
+                    continue;
+                }
+
+                rlVertexBuffer *buffer = &RLGL.currentBatch->vertexBuffer[RLGL.currentBatch->currentBuffer];
+                memcpy(buffer->vertices + 3*RLGL.State.vertexCounter, list->vertices + 3*offset, count*3*sizeof(float));
+                memcpy(buffer->texcoords + 2*RLGL.State.vertexCounter, list->texcoords + 2*offset, count*2*sizeof(float));
+                memcpy(buffer->normals + 3*RLGL.State.vertexCounter, list->normals + 3*offset, count*3*sizeof(float));
+                memcpy(buffer->colors + 4*RLGL.State.vertexCounter, list->colors + 4*offset, count*4*sizeof(unsigned char));
+
+                // Transform current at submission is applied as for immediate-mode vertex (and by OpenGL 1.1 modelview)
+                if (RLGL.State.transformRequired)
+                {
+                    Matrix mat = RLGL.State.transform;
+                    float *vertices = buffer->vertices + 3*RLGL.State.vertexCounter;
+                    float *normals = buffer->normals + 3*RLGL.State.vertexCounter;
+
+                    for (int v = 0; v < count; v++, vertices += 3, normals += 3)
+                    {
+                        float x = vertices[0], y = vertices[1], z = vertices[2];
+                        vertices[0] = mat.m0*x + mat.m4*y + mat.m8*z + mat.m12;
+                        vertices[1] = mat.m1*x + mat.m5*y + mat.m9*z + mat.m13;
+                        vertices[2] = mat.m2*x + mat.m6*y + mat.m10*z + mat.m14;
+
+                        x = normals[0]; y = normals[1]; z = normals[2];
+                        float nx = mat.m0*x + mat.m4*y + mat.m8*z;
+                        float ny = mat.m1*x + mat.m5*y + mat.m9*z;
+                        float nz = mat.m2*x + mat.m6*y + mat.m10*z;
+                        float length = sqrtf(nx*nx + ny*ny + nz*nz);
+                        float ilength = (length != 0.0f)? 1.0f/length : 1.0f;
+
+                        normals[0] = nx*ilength;
+                        normals[1] = ny*ilength;
+                        normals[2] = nz*ilength;
+                    }
+                }
+
+                RLGL.State.vertexCounter += count;
+                RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount += count;
+                RL_FRAME_STATS_ADD(vertexCount, count);
+
+                offset += count;
+                remaining -= count;
+            }
+
+            rlEnd();
+#endif
+        }
+
+        vertexOffset += draw->vertexCount;
+    }
+
+    rlSetTexture(0);
+}
+
+// Store current frame statistics in the history and start a new frame
+// NOTE: Called by EndDrawing(), after the frame has been presented
+void rlEndFrameStats(void)
+{
+#if defined(RLGL_ENABLE_FRAME_STATS)
+    rlFrameStats *current = &rlFrameStatsState.current;
+    double currentTime = rlGetStatsTime();
+
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    SWstats swStats = { 0 };
+    swGetStats(&swStats);
+    swResetStats();
+
+    current->primitivesCulled = swStats.primitivesCulled;
+    current->primitivesClipped = swStats.primitivesClipped;
+    current->pixelsShaded = swStats.pixelsShaded;
+    current->pixelsBlended = swStats.pixelsBlended;
+    current->pixelsDepthRejected = swStats.pixelsDepthRejected;
+    current->rasterTime = swStats.flushTime;
+#endif
+
+    if (rlFrameStatsState.frameEndTime > 0.0) current->frameTime = currentTime - rlFrameStatsState.frameEndTime;
+    rlFrameStatsState.frameEndTime = currentTime;
+
+    rlFrameStatsState.history[rlFrameStatsState.historyIndex] = *current;
+    rlFrameStatsState.historyIndex = (rlFrameStatsState.historyIndex + 1)%RL_MAX_FRAME_STATS;
+    if (rlFrameStatsState.historyCount < RL_MAX_FRAME_STATS) rlFrameStatsState.historyCount++;
+
+    rlFrameStats empty = { 0 };
+    *current = empty;
+#endif
+}
+
+// Get statistics of a recorded frame (0: last completed frame, 1: previous one...)
+// NOTE: Frames not recorded (or RLGL_ENABLE_FRAME_STATS not defined) return zeroed statistics
+rlFrameStats rlGetFrameStats(int frame)
+{
+    rlFrameStats stats = { 0 };
+
+#if defined(RLGL_ENABLE_FRAME_STATS)
+    if ((frame >= 0) && (frame < rlFrameStatsState.historyCount))
+    {
+        stats = rlFrameStatsState.history[(rlFrameStatsState.historyIndex - 1 - frame + RL_MAX_FRAME_STATS)%RL_MAX_FRAME_STATS];
+    }
+#endif
+
+    return stats;
+}
+
 // Textures data management
 //-----------------------------------------------------------------------------------------
 // Convert image data to OpenGL texture (returns OpenGL valid Id)
@@ -3261,7 +3787,15 @@ unsigned int rlLoadTexture(const void *data, int width, int height, int format,
     glBindTexture(GL_TEXTURE_2D, 0);    // Free any old binding
 
     // Check texture format support by OpenGL 1.1 (compressed textures not supported)
-#if defined(GRAPHICS_API_OPENGL_11)
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // NOTE: rlsw decodes DXT and ETC compressed textures on upload
+    if ((format == RL_PIXELFORMAT_COMPRESSED_PVRT_RGB) || (format == RL_PIXELFORMAT_COMPRESSED_PVRT_RGBA) ||
+        (format == RL_PIXELFORMAT_COMPRESSED_ASTC_4x4_RGBA) || (format == RL_PIXELFORMAT_COMPRESSED_ASTC_8x8_RGBA))
+    {
+        TRACELOG(RL_LOG_WARNING, "GL: Software renderer does not support PVRT and ASTC compressed texture formats");
+        return id;
+    }
+#elif defined(GRAPHICS_API_OPENGL_11)
     if (format >= RL_PIXELFORMAT_COMPRESSED_DXT1_RGB)
     {
         TRACELOG(RL_LOG_WARNING, "GL: OpenGL 1.1 does not support GPU compressed texture formats");
@@ -3329,7 +3863,7 @@ unsigned int rlLoadTexture(const void *data, int width, int height, int format,
         if (glInternalFormat != 0)
         {
             if (format < RL_PIXELFORMAT_COMPRESSED_DXT1_RGB) glTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, mipWidth, mipHeight, 0, glFormat, glType, dataPtr);
-#if !defined(GRAPHICS_API_OPENGL_11)
+#if !defined(GRAPHICS_API_OPENGL_11) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
             else glCompressedTexImage2D(GL_TEXTURE_2D, i, glInternalFormat, mipWidth, mipHeight, 0, mipSize, dataPtr);
 #endif
 
@@ -3402,6 +3936,14 @@ unsigned int rlLoadTexture(const void *data, int width, int height, int format,
         //glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_FORMAT, &complete);
     }
 #endif
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    if (mipmapCount > 1)
+    {
+        // Activate trilinear filtering if mipmaps are available
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    }
+#endif
 
     // At this point we have the texture loaded in GPU and texture parameters configured
 
@@ -3469,6 +4011,17 @@ unsigned int rlLoadTextureDepth(int width, int height, bool useRenderBuffer)
 
         TRACELOG(RL_LOG_INFO, "TEXTURE: [ID %i] Depth renderbuffer loaded successfully (%i bits)", id, (RLGL.ExtSupported.maxDepthBits >= 24)? RLGL.ExtSupported.maxDepthBits : 16);
     }
+#elif defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // NOTE: Software renderer does not support depth textures, a renderbuffer is always used
+    (void)useRenderBuffer;
+
+    glGenRenderbuffers(1, &id);
+    glBindRenderbuffer(GL_RENDERBUFFER, id);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    if (id > 0) TRACELOG(RL_LOG_INFO, "TEXTURE: [ID %i] Depth renderbuffer loaded successfully (%i bits)", id, SW_DEPTH_BUFFER_BITS);
 #endif
 
     return id;
@@ -3644,6 +4197,16 @@ void rlGetGlTextureFormats(int format, unsigned int *glInternalFormat, unsigned
         case RL_PIXELFORMAT_UNCOMPRESSED_R16G16B16: if (RLGL.ExtSupported.texFloat16) *glInternalFormat = GL_RGB16F; *glFormat = GL_RGB; *glType = GL_HALF_FLOAT; break;
         case RL_PIXELFORMAT_UNCOMPRESSED_R16G16B16A16: if (RLGL.ExtSupported.texFloat16) *glInternalFormat = GL_RGBA16F; *glFormat = GL_RGBA; *glType = GL_HALF_FLOAT; break;
     #endif
+    #if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+        // NOTE: Compressed textures are decoded by rlsw on upload
+        case RL_PIXELFORMAT_COMPRESSED_DXT1_RGB: *glInternalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;
+        case RL_PIXELFORMAT_COMPRESSED_DXT1_RGBA: *glInternalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
+        case RL_PIXELFORMAT_COMPRESSED_DXT3_RGBA: *glInternalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break;
+        case RL_PIXELFORMAT_COMPRESSED_DXT5_RGBA: *glInternalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+        case RL_PIXELFORMAT_COMPRESSED_ETC1_RGB: *glInternalFormat = GL_ETC1_RGB8_OES; break;
+        case RL_PIXELFORMAT_COMPRESSED_ETC2_RGB: *glInternalFormat = GL_COMPRESSED_RGB8_ETC2; break;
+        case RL_PIXELFORMAT_COMPRESSED_ETC2_EAC_RGBA: *glInternalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC; break;
+    #endif
     #if !defined(GRAPHICS_API_OPENGL_11)
         case RL_PIXELFORMAT_COMPRESSED_DXT1_RGB: if (RLGL.ExtSupported.texCompDXT) *glInternalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;
         case RL_PIXELFORMAT_COMPRESSED_DXT1_RGBA: if (RLGL.ExtSupported.texCompDXT) *glInternalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
@@ -3693,6 +4256,15 @@ void rlGenTextureMipmaps(unsigned int id, int width, int height, int format, int
     }
     else TRACELOG(RL_LOG_WARNING, "TEXTURE: [ID %i] Failed to generate mipmaps", id);
 
+    glBindTexture(GL_TEXTURE_2D, 0);
+#elif defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // NOTE: Software renderer generates mipmaps for any texture size (POT or NPOT)
+    glBindTexture(GL_TEXTURE_2D, id);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    *mipmaps = 1 + (int)floor(log((width > height)? width : height)/log(2));
+    TRACELOG(RL_LOG_INFO, "TEXTURE: [ID %i] Mipmaps generated automatically, total: %i", id, *mipmaps);
+
     glBindTexture(GL_TEXTURE_2D, 0);
 #else
     TRACELOG(RL_LOG_WARNING, "TEXTURE: [ID %i] GPU mipmap generation not supported", id);
@@ -3781,7 +4353,29 @@ void rlResizeFramebuffer(int width, int height)
 #endif
 }
 
-// Read screen pixel data (color buffer)
+// Render into external pixel memory, RGBA or BGRA 8 bits per channel
+// NOTE: Rows are 'stride' bytes apart (0 for packed rows), passing NULL restores the internal buffer
+bool rlBindFramebufferMemory(void *pixels, int width, int height, int stride, bool bgra)
+{
+    bool result = false;
+
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    result = swBindFramebufferMemory(pixels, width, height, stride, bgra? SW_BGRA : SW_RGBA);
+    if (!result) TRACELOG(RL_LOG_WARNING, "FBO: Failed to bind external framebuffer memory");
+#endif
+
+    return result;
+}
+
+// Wait for pending rendering to complete on framebuffer
+void rlFinishFramebuffer(void)
+{
+#if defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    swFinish();
+#endif
+}
+
+// Read screen pixel data (color buffer)
 unsigned char *rlReadScreenPixels(int width, int height)
 {
     unsigned char *imgData = (unsigned char *)RL_CALLOC(width*height*4, sizeof(unsigned char));
@@ -3827,7 +4421,7 @@ unsigned int rlLoadFramebuffer(void)
     unsigned int fboId = 0;
     if (!isGpuReady) { TRACELOG(RL_LOG_WARNING, "GL: GPU is not ready to load data, trying to load before InitWindow()?"); return fboId; }
 
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)
+#if ((defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
     glGenFramebuffers(1, &fboId);       // Create the framebuffer object
     glBindFramebuffer(GL_FRAMEBUFFER, 0);   // Unbind any framebuffer
 #endif
@@ -3870,6 +4464,15 @@ void rlFramebufferAttach(unsigned int fboId, unsigned int texId, int attachType,
         default: break;
     }
 
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+#elif defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
+    // NOTE: Software renderer supports one color texture and one depth renderbuffer per framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, fboId);
+
+    if ((attachType == RL_ATTACHMENT_COLOR_CHANNEL0) && (texType == RL_ATTACHMENT_TEXTURE2D)) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texId, mipLevel);
+    else if ((attachType == RL_ATTACHMENT_DEPTH) && (texType == RL_ATTACHMENT_RENDERBUFFER)) glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, texId);
+    else TRACELOG(RL_LOG_WARNING, "FBO: [ID %i] Attachment type not supported by software renderer", fboId);
+
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 #endif
 }
@@ -3879,7 +4482,7 @@ bool rlFramebufferComplete(unsigned int id)
 {
     bool result = false;
 
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)
+#if ((defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
     glBindFramebuffer(GL_FRAMEBUFFER, id);
 
     GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
@@ -3910,7 +4513,7 @@ bool rlFramebufferComplete(unsigned int id)
 // NOTE: All attached textures/cubemaps/renderbuffers are also deleted
 void rlUnloadFramebuffer(unsigned int id)
 {
-#if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)
+#if ((defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)) && defined(RLGL_RENDER_TEXTURES_HINT)) || defined(GRAPHICS_API_OPENGL_11_SOFTWARE)
     // Query depth attachment to automatically delete texture/renderbuffer
     int depthType = 0, depthId = 0;
     glBindFramebuffer(GL_FRAMEBUFFER, id);   // Bind framebuffer to query depth texture type
@@ -4061,6 +4664,9 @@ void rlDisableVertexAttribute(unsigned int index)
 void rlDrawVertexArray(int offset, int count)
 {
     glDrawArrays(GL_TRIANGLES, offset, count);
+
+    RL_FRAME_STATS_ADD(drawCalls, 1);
+    RL_FRAME_STATS_ADD(vertexCount, count);
 }
 
 // Draw vertex array elements
@@ -4071,6 +4677,9 @@ void rlDrawVertexArrayElements(int offset, int count, const void *buffer)
     if (offset > 0) bufferPtr += offset;
 
     glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (const unsigned short *)bufferPtr);
+
+    RL_FRAME_STATS_ADD(drawCalls, 1);
+    RL_FRAME_STATS_ADD(vertexCount, count);
 }
 
 // Draw vertex array instanced
@@ -4078,6 +4687,9 @@ void rlDrawVertexArrayInstanced(int offset, int count, int instances)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glDrawArraysInstanced(GL_TRIANGLES, offset, count, instances);
+
+    RL_FRAME_STATS_ADD(drawCalls, 1);
+    RL_FRAME_STATS_ADD(vertexCount, count*instances);
 #endif
 }
 
@@ -4090,6 +4702,9 @@ void rlDrawVertexArrayElementsInstanced(int offset, int count, const void *buffe
     if (offset > 0) bufferPtr += offset;
 
     glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (const unsigned short *)bufferPtr, instances);
+
+    RL_FRAME_STATS_ADD(drawCalls, 1);
+    RL_FRAME_STATS_ADD(vertexCount, count*instances);
 #endif
 }
 
@@ -4846,6 +5461,8 @@ void rlLoadDrawQuad(void)
     // Draw quad
     glBindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    RL_FRAME_STATS_ADD(drawCalls, 1);
+    RL_FRAME_STATS_ADD(vertexCount, 4);
     glBindVertexArray(0);
 
     // Delete buffers (VBO and VAO)
@@ -4924,6 +5541,8 @@ void rlLoadDrawCube(void)
     // Draw cube
     glBindVertexArray(cubeVAO);
     glDrawArrays(GL_TRIANGLES, 0, 36);
+    RL_FRAME_STATS_ADD(drawCalls, 1);
+    RL_FRAME_STATS_ADD(vertexCount, 36);
     glBindVertexArray(0);
 
     // Delete VBO and VAO
@@ -5119,6 +5738,304 @@ static void rlUnloadShaderDefault(void)
     TRACELOG(RL_LOG_INFO, "SHADER: [ID %i] Default shader unloaded successfully", RLGL.State.defaultShaderId);
 }
 
+#if defined(GRAPHICS_API_OPENGL_33)
+// Load render batch vertex stream (ring buffer)
+// NOTE: Interleaved vertex data is written into a persistently mapped ring buffer of
+// RL_DEFAULT_BATCH_STREAM_SEGMENTS segments, one fence per segment keeps CPU writes away from
+// data still in use by the GPU; if not supported, buffer orphaning is used instead
+static void rlLoadVertexStream(int vertexCount)
+{
+    if (!RLGL.ExtSupported.vao) return;
+
+    int segmentSize = vertexCount*sizeof(rlStreamVertex);
+    int bufferSize = segmentSize*RL_DEFAULT_BATCH_STREAM_SEGMENTS;
+
+    glGenVertexArrays(1, &RLGL.Stream.vaoId);
+    glGenBuffers(1, &RLGL.Stream.vboId);
+    glBindBuffer(GL_ARRAY_BUFFER, RLGL.Stream.vboId);
+
+    if (RLGL.ExtSupported.bufferStorage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, bufferSize, NULL, flags);
+        RLGL.Stream.mapped = (unsigned char *)glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, flags);
+
+        if (RLGL.Stream.mapped == NULL)
+        {
+            // Buffer storage is immutable, a new buffer is required for orphaning
+            glDeleteBuffers(1, &RLGL.Stream.vboId);
+            glGenBuffers(1, &RLGL.Stream.vboId);
+            glBindBuffer(GL_ARRAY_BUFFER, RLGL.Stream.vboId);
+        }
+    }
+
+    if (RLGL.Stream.mapped == NULL)
+    {
+        glBufferData(GL_ARRAY_BUFFER, segmentSize, NULL, GL_STREAM_DRAW);
+        RLGL.Stream.data = (unsigned char *)RL_MALLOC(segmentSize);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    RLGL.Stream.segmentVertices = vertexCount;
+    RLGL.Stream.currentSegment = 0;
+
+    if (RLGL.Stream.mapped != NULL) TRACELOG(RL_LOG_INFO, "RLGL: Render batch vertex stream loaded successfully (persistent mapped, %i segments)", RL_DEFAULT_BATCH_STREAM_SEGMENTS);
+    else TRACELOG(RL_LOG_INFO, "RLGL: Render batch vertex stream loaded successfully (buffer orphaning)");
+}
+
+// Unload render batch vertex stream
+static void rlUnloadVertexStream(void)
+{
+    if (RLGL.Stream.vboId == 0) return;
+
+    for (int i = 0; i < RL_DEFAULT_BATCH_STREAM_SEGMENTS; i++)
+    {
+        if (RLGL.Stream.fences[i] != NULL) glDeleteSync(RLGL.Stream.fences[i]);
+        RLGL.Stream.fences[i] = NULL;
+    }
+
+    if (RLGL.Stream.mapped != NULL)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, RLGL.Stream.vboId);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    glDeleteBuffers(1, &RLGL.Stream.vboId);
+    glDeleteVertexArrays(1, &RLGL.Stream.vaoId);
+    RL_FREE(RLGL.Stream.data);
+
+    RLGL.Stream.vaoId = 0;
+    RLGL.Stream.vboId = 0;
+    RLGL.Stream.mapped = NULL;
+    RLGL.Stream.data = NULL;
+}
+
+// Stream vertex data into next ring segment
+// NOTE: Returns false if data can not be streamed (no stream available or too many vertex),
+// in that case the batch vertex buffers must be updated instead
+static bool rlUpdateVertexStream(const float *vertices, const float *texcoords, const float *normals, const unsigned char *colors, int vertexCount)
+{
+    if ((RLGL.Stream.vboId == 0) || (vertexCount > RLGL.Stream.segmentVertices)) return false;
+
+    rlStreamVertex *streamVertices = (rlStreamVertex *)RLGL.Stream.data;
+
+    if (RLGL.Stream.mapped != NULL)
+    {
+        int segment = (RLGL.Stream.currentSegment + 1)%RL_DEFAULT_BATCH_STREAM_SEGMENTS;
+
+        // Wait for the GPU to be done with the segment,
+        // it only stalls if the GPU is RL_DEFAULT_BATCH_STREAM_SEGMENTS batches behind
+        if (RLGL.Stream.fences[segment] != NULL)
+        {
+            GLenum result = glClientWaitSync(RLGL.Stream.fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            while (result == GL_TIMEOUT_EXPIRED) result = glClientWaitSync(RLGL.Stream.fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+            glDeleteSync(RLGL.Stream.fences[segment]);
+            RLGL.Stream.fences[segment] = NULL;
+        }
+
+        RLGL.Stream.currentSegment = segment;
+        streamVertices = (rlStreamVertex *)(RLGL.Stream.mapped + segment*RLGL.Stream.segmentVertices*sizeof(rlStreamVertex));
+    }
+
+    for (int i = 0; i < vertexCount; i++)
+    {
+        memcpy(streamVertices[i].position, vertices + i*3, 3*sizeof(float));
+        memcpy(streamVertices[i].texcoord, texcoords + i*2, 2*sizeof(float));
+        memcpy(streamVertices[i].normal, normals + i*3, 3*sizeof(float));
+        memcpy(streamVertices[i].color, colors + i*4, 4*sizeof(unsigned char));
+    }
+
+    if (RLGL.Stream.mapped == NULL)
+    {
+        // Orphan previous buffer storage (GPU could be still reading it) and upload all data at once
+        glBindBuffer(GL_ARRAY_BUFFER, RLGL.Stream.vboId);
+        glBufferData(GL_ARRAY_BUFFER, RLGL.Stream.segmentVertices*sizeof(rlStreamVertex), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCount*sizeof(rlStreamVertex), RLGL.Stream.data);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    return true;
+}
+
+// Bind vertex stream VAO and current shader attributes
+// NOTE: Attributes are set on every bind, the current shader and ring segment could have changed
+static void rlBindVertexStream(unsigned int indexBufferId)
+{
+    size_t offset = 0;
+    if (RLGL.Stream.mapped != NULL) offset = (size_t)RLGL.Stream.currentSegment*RLGL.Stream.segmentVertices*sizeof(rlStreamVertex);
+
+    glBindVertexArray(RLGL.Stream.vaoId);
+    glBindBuffer(GL_ARRAY_BUFFER, RLGL.Stream.vboId);
+
+    // Bind vertex attrib: position (shader-location = 0)
+    if (RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION] != -1)
+    {
+        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, 0, sizeof(rlStreamVertex), (void *)offset);
+        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_POSITION]);
+    }
+
+    // Bind vertex attrib: texcoord (shader-location = 1)
+    if (RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01] != -1)
+    {
+        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, 0, sizeof(rlStreamVertex), (void *)(offset + 3*sizeof(float)));
+        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_TEXCOORD01]);
+    }
+
+    // Bind vertex attrib: normal (shader-location = 2)
+    if (RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL] != -1)
+    {
+        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL], 3, GL_FLOAT, 0, sizeof(rlStreamVertex), (void *)(offset + 5*sizeof(float)));
+        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_NORMAL]);
+    }
+
+    // Bind vertex attrib: color (shader-location = 3)
+    if (RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR] != -1)
+    {
+        glVertexAttribPointer(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(rlStreamVertex), (void *)(offset + 8*sizeof(float)));
+        glEnableVertexAttribArray(RLGL.State.currentShaderLocs[RL_SHADER_LOC_VERTEX_COLOR]);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
+}
+#endif  // GRAPHICS_API_OPENGL_33
+
+// Merge render batch draw calls sharing texture and mode into RLGL.BatchSort buffers
+// Draws are moved back to the last compatible draw only if they don't overlap any draw
+// they are moved across, so results are the same than drawing them in submission order
+// NOTE: Returns the number of merged draw calls, 0 if batch can't be merged (data is not reordered)
+static int rlSortRenderBatch(rlRenderBatch *batch, int *vertexCount)
+{
+    // Overlap tests are done on vertex positions, only valid if the batch MVP keeps
+    // x and y independent of z (no perspective), usual case for 2D drawing
+    Matrix mvp = rlMatrixMultiply(RLGL.State.modelview, RLGL.State.projection);
+    if ((mvp.m8 != 0.0f) || (mvp.m9 != 0.0f) || (mvp.m3 != 0.0f) || (mvp.m7 != 0.0f) || (mvp.m11 != 0.0f)) return 0;
+
+    const rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
+    const rlDrawCall *draws = batch->draws;
+
+    int drawOffset[RL_DEFAULT_BATCH_DRAWCALLS] = { 0 };         // First vertex of every draw
+    int drawNext[RL_DEFAULT_BATCH_DRAWCALLS] = { 0 };           // Next draw in the same merged draw
+    int groupFirst[RL_DEFAULT_BATCH_DRAWCALLS] = { 0 };         // First draw of every merged draw
+    int groupLast[RL_DEFAULT_BATCH_DRAWCALLS] = { 0 };          // Last draw of every merged draw
+    float groupBounds[RL_DEFAULT_BATCH_DRAWCALLS][4] = { 0 };   // Merged draws bounds: { xMin, yMin, xMax, yMax }
+    int groupCount = 0;
+    int mergedVertexCount = 0;
+
+    for (int i = 0, offset = 0; i < batch->drawCounter; offset += (draws[i].vertexCount + draws[i].vertexAlignment), i++)
+    {
+        drawOffset[i] = offset;
+        drawNext[i] = -1;
+
+        if (draws[i].vertexCount == 0) continue;
+
+        // Draws with incomplete primitives can't be merged with others
+        int primitiveSize = (draws[i].mode == RL_LINES)? 2 : ((draws[i].mode == RL_TRIANGLES)? 3 : 4);
+        if ((draws[i].vertexCount%primitiveSize) != 0) return 0;
+
+        float bounds[4] = { buffer->vertices[3*offset], buffer->vertices[3*offset + 1], buffer->vertices[3*offset], buffer->vertices[3*offset + 1] };
+        for (int v = offset + 1; v < (offset + draws[i].vertexCount); v++)
+        {
+            float x = buffer->vertices[3*v];
+            float y = buffer->vertices[3*v + 1];
+            if (x < bounds[0]) bounds[0] = x;
+            if (y < bounds[1]) bounds[1] = y;
+            if (x > bounds[2]) bounds[2] = x;
+            if (y > bounds[3]) bounds[3] = y;
+        }
+
+        // Look for the last merged draw with same texture and mode that can be reached
+        // NOTE: Lines width could exceed their bounds, so they are never moved across other draws
+        int target = -1;
+        for (int g = groupCount - 1; g >= 0; g--)
+        {
+            const rlDrawCall *group = &draws[groupFirst[g]];
+
+            if ((group->textureId == draws[i].textureId) && (group->mode == draws[i].mode)) { target = g; break; }
+            if ((draws[i].mode == RL_LINES) || (group->mode == RL_LINES)) break;
+
+            // Touching bounds are considered overlapping, edge pixels could be shared
+            if ((bounds[0] <= groupBounds[g][2]) && (groupBounds[g][0] <= bounds[2]) &&
+                (bounds[1] <= groupBounds[g][3]) && (groupBounds[g][1] <= bounds[3])) break;
+        }
+
+        if (target == -1)
+        {
+            target = groupCount++;
+            groupFirst[target] = i;
+            for (int k = 0; k < 4; k++) groupBounds[target][k] = bounds[k];
+        }
+        else
+        {
+            drawNext[groupLast[target]] = i;
+            if (bounds[0] < groupBounds[target][0]) groupBounds[target][0] = bounds[0];
+            if (bounds[1] < groupBounds[target][1]) groupBounds[target][1] = bounds[1];
+            if (bounds[2] > groupBounds[target][2]) groupBounds[target][2] = bounds[2];
+            if (bounds[3] > groupBounds[target][3]) groupBounds[target][3] = bounds[3];
+        }
+
+        groupLast[target] = i;
+        mergedVertexCount += draws[i].vertexCount;
+    }
+
+    // Nothing merged, submission order is kept
+    int drawCount = 0;
+    for (int i = 0; i < batch->drawCounter; i++) if (draws[i].vertexCount > 0) drawCount++;
+    if (groupCount == drawCount) return 0;
+
+    // Every merged draw starts aligned to 4 vertex, as required by quads indices
+    if ((mergedVertexCount + 3*groupCount) > buffer->elementCount*4) return 0;
+
+    if (RLGL.BatchSort.vertexCapacity < buffer->elementCount*4)
+    {
+        int capacity = buffer->elementCount*4;
+        float *vertices = (float *)RL_REALLOC(RLGL.BatchSort.vertices, capacity*3*sizeof(float));
+        if (vertices != NULL) RLGL.BatchSort.vertices = vertices;
+        float *texcoords = (float *)RL_REALLOC(RLGL.BatchSort.texcoords, capacity*2*sizeof(float));
+        if (texcoords != NULL) RLGL.BatchSort.texcoords = texcoords;
+        float *normals = (float *)RL_REALLOC(RLGL.BatchSort.normals, capacity*3*sizeof(float));
+        if (normals != NULL) RLGL.BatchSort.normals = normals;
+        unsigned char *colors = (unsigned char *)RL_REALLOC(RLGL.BatchSort.colors, capacity*4*sizeof(unsigned char));
+        if (colors != NULL) RLGL.BatchSort.colors = colors;
+
+        if ((vertices == NULL) || (texcoords == NULL) || (normals == NULL) || (colors == NULL)) return 0;
+        RLGL.BatchSort.vertexCapacity = capacity;
+    }
+
+    // Copy vertex data in merged draws order
+    int offset = 0;
+    for (int g = 0; g < groupCount; g++)
+    {
+        rlDrawCall *merged = &RLGL.BatchSort.draws[g];
+        merged->mode = draws[groupFirst[g]].mode;
+        merged->textureId = draws[groupFirst[g]].textureId;
+        merged->vertexCount = 0;
+
+        for (int i = groupFirst[g]; i != -1; i = drawNext[i])
+        {
+            int src = drawOffset[i];
+            int dst = offset + merged->vertexCount;
+            int count = draws[i].vertexCount;
+
+            memcpy(RLGL.BatchSort.vertices + 3*dst, buffer->vertices + 3*src, count*3*sizeof(float));
+            memcpy(RLGL.BatchSort.texcoords + 2*dst, buffer->texcoords + 2*src, count*2*sizeof(float));
+            memcpy(RLGL.BatchSort.normals + 3*dst, buffer->normals + 3*src, count*3*sizeof(float));
+            memcpy(RLGL.BatchSort.colors + 4*dst, buffer->colors + 4*src, count*4*sizeof(unsigned char));
+
+            merged->vertexCount += count;
+        }
+
+        merged->vertexAlignment = (4 - merged->vertexCount%4)%4;
+        offset += (merged->vertexCount + merged->vertexAlignment);
+    }
+
+    *vertexCount = offset;
+
+    return groupCount;
+}
+
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 // Get compressed format official GL identifier name
 static const char *rlGetCompressedFormatName(int format)
@@ -5197,6 +6114,32 @@ static const char *rlGetCompressedFormatName(int format)
 
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
+#if defined(RLGL_ENABLE_FRAME_STATS)
+// Get current time for statistics (seconds)
+// NOTE: Only time differences are used, so any monotonic clock origin is valid
+static double rlGetStatsTime(void)
+{
+    double time = 0.0;
+#if defined(_WIN32)
+    // NOTE: timespec_get() is available on MSVC and MinGW runtimes
+    struct timespec ts = { 0 };
+    timespec_get(&ts, TIME_UTC);
+    time = (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+#elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase = { 0 };
+    if (timebase.denom == 0) mach_timebase_info(&timebase);
+    time = (double)mach_absolute_time()*timebase.numer/timebase.denom*1e-9;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    time = (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+#else
+    time = (double)clock()/CLOCKS_PER_SEC;  // Fallback without POSIX clocks, processor time
+#endif
+    return time;
+}
+#endif
+
 // Get pixel data size in bytes (image or texture)
 // NOTE: Size depends on pixel format
 static int rlGetPixelDataSize(int width, int height, int format)
@@ -5259,6 +6202,207 @@ static int rlGetPixelDataSize(int width, int height, int format)
     return dataSize;
 }
 
+#if defined(RLGL_ENABLE_COMMAND_LISTS)
+// Command lists recording functions
+// NOTE: Only called on a thread recording a command list (rlRecordingList != NULL)
+//-------------------------------------------------------------------------------
+// Record drawing mode into current thread command list
+// NOTE: A new draw is registered on mode or texture changes
+static void rlRecordBegin(int mode)
+{
+    rlCommandList *list = rlRecordingList;
+
+    if (list->drawCounter > 0)
+    {
+        rlDrawCall *draw = &list->draws[list->drawCounter - 1];
+
+        if ((draw->mode == mode) && (draw->textureId == list->currentTextureId)) return;
+        if (draw->vertexCount == 0) list->drawCounter--;    // Reuse empty draw
+    }
+
+    if (list->drawCounter >= list->drawCapacity)
+    {
+        rlDrawCall *draws = (rlDrawCall *)RL_REALLOC(list->draws, list->drawCapacity*2*sizeof(rlDrawCall));
+        if (draws == NULL) { TRACELOG(RL_LOG_WARNING, "RLGL: Failed to grow command list draws"); return; }
+
+        list->draws = draws;
+        list->drawCapacity *= 2;
+    }
+
+    rlDrawCall *draw = &list->draws[list->drawCounter];
+    draw->mode = mode;
+    draw->vertexCount = 0;
+    draw->vertexAlignment = 0;
+    draw->textureId = list->currentTextureId;
+    list->drawCounter++;
+}
+
+// Record vertex providing end into current thread command list
+static void rlRecordEnd(void)
+{
+    // NOTE: Depth increment matches rlEnd(), 2D vertex depth is relative to the list
+    rlRecordingList->currentDepth += (1.0f/20000.0f);
+}
+
+// Record one vertex into current thread command list
+static void rlRecordVertex(float x, float y, float z)
+{
+    rlCommandList *list = rlRecordingList;
+
+    if (list->drawCounter == 0) rlRecordBegin(RL_QUADS);
+    if (list->drawCounter == 0) return;
+
+    if (list->vertexCounter >= list->vertexCapacity)
+    {
+        int capacity = list->vertexCapacity*2;
+        float *vertices = (float *)RL_REALLOC(list->vertices, capacity*3*sizeof(float));
+        float *texcoords = (float *)RL_REALLOC(list->texcoords, capacity*2*sizeof(float));
+        float *normals = (float *)RL_REALLOC(list->normals, capacity*3*sizeof(float));
+        unsigned char *colors = (unsigned char *)RL_REALLOC(list->colors, capacity*4*sizeof(unsigned char));
+
+        if (vertices != NULL) list->vertices = vertices;
+        if (texcoords != NULL) list->texcoords = texcoords;
+        if (normals != NULL) list->normals = normals;
+        if (colors != NULL) list->colors = colors;
+
+        if ((vertices == NULL) || (texcoords == NULL) || (normals == NULL) || (colors == NULL))
+        {
+            TRACELOG(RL_LOG_WARNING, "RLGL: Failed to grow command list vertex data");
+            return;
+        }
+
+        list->vertexCapacity = capacity;
+    }
+
+    float tx = x;
+    float ty = y;
+    float tz = z;
+
+    // Transform provided vector if required
+    if (list->transformRequired)
+    {
+        tx = list->transform.m0*x + list->transform.m4*y + list->transform.m8*z + list->transform.m12;
+        ty = list->transform.m1*x + list->transform.m5*y + list->transform.m9*z + list->transform.m13;
+        tz = list->transform.m2*x + list->transform.m6*y + list->transform.m10*z + list->transform.m14;
+    }
+
+    int i = list->vertexCounter;
+    list->vertices[3*i] = tx;
+    list->vertices[3*i + 1] = ty;
+    list->vertices[3*i + 2] = tz;
+    list->texcoords[2*i] = list->texcoordx;
+    list->texcoords[2*i + 1] = list->texcoordy;
+    list->normals[3*i] = list->normalx;
+    list->normals[3*i + 1] = list->normaly;
+    list->normals[3*i + 2] = list->normalz;
+    list->colors[4*i] = list->colorr;
+    list->colors[4*i + 1] = list->colorg;
+    list->colors[4*i + 2] = list->colorb;
+    list->colors[4*i + 3] = list->colora;
+
+    list->vertexCounter++;
+    list->draws[list->drawCounter - 1].vertexCount++;
+}
+
+// Record current vertex texture coordinate
+static void rlRecordTexCoord(float x, float y)
+{
+    rlRecordingList->texcoordx = x;
+    rlRecordingList->texcoordy = y;
+}
+
+// Record current vertex normal
+// NOTE: Normal is transformed and normalized as rlNormal3f() does
+static void rlRecordNormal(float x, float y, float z)
+{
+    rlCommandList *list = rlRecordingList;
+    float normalx = x;
+    float normaly = y;
+    float normalz = z;
+
+    if (list->transformRequired)
+    {
+        normalx = list->transform.m0*x + list->transform.m4*y + list->transform.m8*z;
+        normaly = list->transform.m1*x + list->transform.m5*y + list->transform.m9*z;
+        normalz = list->transform.m2*x + list->transform.m6*y + list->transform.m10*z;
+    }
+
+    float length = sqrtf(normalx*normalx + normaly*normaly + normalz*normalz);
+    if (length != 0.0f)
+    {
+        float ilength = 1.0f/length;
+        normalx *= ilength;
+        normaly *= ilength;
+        normalz *= ilength;
+    }
+
+    list->normalx = normalx;
+    list->normaly = normaly;
+    list->normalz = normalz;
+}
+
+// Record current vertex color
+static void rlRecordColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+{
+    rlRecordingList->colorr = r;
+    rlRecordingList->colorg = g;
+    rlRecordingList->colorb = b;
+    rlRecordingList->colora = a;
+}
+
+// Record current texture
+static void rlRecordTexture(unsigned int id)
+{
+    rlRecordingList->currentTextureId = id;
+}
+
+// Push command list transform into its stack
+// NOTE: Command lists only record the transform matrix (as RL_MODELVIEW mode after rlPushMatrix()),
+// projection and modelview matrices are the ones current at submission
+static void rlRecordPushMatrix(void)
+{
+    rlCommandList *list = rlRecordingList;
+
+    if (list->stackCounter >= RL_MAX_MATRIX_STACK_SIZE)
+    {
+        TRACELOG(RL_LOG_ERROR, "RLGL: Command list matrix stack overflow (RL_MAX_MATRIX_STACK_SIZE)");
+        return;
+    }
+
+    list->stack[list->stackCounter] = list->transform;
+    list->stackCounter++;
+    list->transformRequired = true;
+}
+
+// Pop command list transform from its stack
+static void rlRecordPopMatrix(void)
+{
+    rlCommandList *list = rlRecordingList;
+
+    // NOTE: Restored transform could include matrices recorded before the push
+    if (list->stackCounter > 0)
+    {
+        list->transform = list->stack[list->stackCounter - 1];
+        list->stackCounter--;
+        list->transformRequired = true;
+    }
+}
+
+// Reset command list transform
+static void rlRecordLoadIdentity(void)
+{
+    rlRecordingList->transform = rlMatrixIdentity();
+    rlRecordingList->transformRequired = false;
+}
+
+// Multiply command list transform by a matrix
+static void rlRecordMatrix(Matrix mat)
+{
+    rlRecordingList->transform = rlMatrixMultiply(mat, rlRecordingList->transform);
+    rlRecordingList->transformRequired = true;
+}
+#endif  // RLGL_ENABLE_COMMAND_LISTS
+
 // Auxiliar math functions
 //-------------------------------------------------------------------------------
 // Get identity matrix
@@ -5299,6 +6443,8 @@ static rl_float16 rlMatrixToFloatV(Matrix mat)
     return result;
 }
 
+#endif
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2) || defined(RLGL_ENABLE_COMMAND_LISTS)
 // Get two matrix multiplication
 // NOTE: When multiplying matrices... the order matters!
 static Matrix rlMatrixMultiply(Matrix left, Matrix right)
@@ -5325,6 +6471,88 @@ static Matrix rlMatrixMultiply(Matrix left, Matrix right)
     return result;
 }
 
+// Get translation matrix
+static Matrix rlMatrixTranslate(float x, float y, float z)
+{
+    Matrix result = {
+        1.0f, 0.0f, 0.0f, x,
+        0.0f, 1.0f, 0.0f, y,
+        0.0f, 0.0f, 1.0f, z,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+
+    return result;
+}
+
+// Get rotation matrix
+// NOTE: The provided angle must be in degrees
+static Matrix rlMatrixRotate(float angle, float x, float y, float z)
+{
+    Matrix matRotation = rlMatrixIdentity();
+
+    // Axis vector (x, y, z) normalization
+    float lengthSquared = x*x + y*y + z*z;
+    if ((lengthSquared != 1.0f) && (lengthSquared != 0.0f))
+    {
+        float inverseLength = 1.0f/sqrtf(lengthSquared);
+        x *= inverseLength;
+        y *= inverseLength;
+        z *= inverseLength;
+    }
+
+    // Rotation matrix generation
+    float sinres = sinf(DEG2RAD*angle);
+    float cosres = cosf(DEG2RAD*angle);
+    float t = 1.0f - cosres;
+
+    matRotation.m0 = x*x*t + cosres;
+    matRotation.m1 = y*x*t + z*sinres;
+    matRotation.m2 = z*x*t - y*sinres;
+    matRotation.m3 = 0.0f;
+
+    matRotation.m4 = x*y*t - z*sinres;
+    matRotation.m5 = y*y*t + cosres;
+    matRotation.m6 = z*y*t + x*sinres;
+    matRotation.m7 = 0.0f;
+
+    matRotation.m8 = x*z*t + y*sinres;
+    matRotation.m9 = y*z*t - x*sinres;
+    matRotation.m10 = z*z*t + cosres;
+    matRotation.m11 = 0.0f;
+
+    matRotation.m12 = 0.0f;
+    matRotation.m13 = 0.0f;
+    matRotation.m14 = 0.0f;
+    matRotation.m15 = 1.0f;
+
+    return matRotation;
+}
+
+// Get scaling matrix
+static Matrix rlMatrixScale(float x, float y, float z)
+{
+    Matrix result = {
+        x, 0.0f, 0.0f, 0.0f,
+        0.0f, y, 0.0f, 0.0f,
+        0.0f, 0.0f, z, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+
+    return result;
+}
+
+// Get matrix from float array (column-major, OpenGL style)
+static Matrix rlMatrixFromFloat(const float *matf)
+{
+    Matrix result = { matf[0], matf[4], matf[8], matf[12],
+                      matf[1], matf[5], matf[9], matf[13],
+                      matf[2], matf[6], matf[10], matf[14],
+                      matf[3], matf[7], matf[11], matf[15] };
+
+    return result;
+}
+#endif
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 // Transposes provided matrix
 static Matrix rlMatrixTranspose(Matrix mat)
 {
@@ -34,6 +34,10 @@
 *       #define SUPPORT_IMAGE_GENERATION
 *           Support procedural image generation functionality (gradient, spot, perlin-noise, cellular)
 *
+*       #define SUPPORT_IMAGE_THREADS
+*           Support multithreaded image processing, rows are split between MAX_IMAGE_THREADS threads
+*           NOTE: Requires pthreads (available on MinGW-w64 through winpthreads)
+*
 *   DEPENDENCIES:
 *       stb_image        - Multiple image formats loading (JPEG, PNG, BMP, TGA, PSD, GIF, PIC)
 *                          NOTE: stb_image has been slightly modified to support Android platform
@@ -78,6 +82,13 @@
 #include <math.h>               // Required for: fabsf() [Used in DrawTextureRec()]
 #include <stdio.h>              // Required for: sprintf() [Used in ExportImageAsCode()]
 
+#if defined(SUPPORT_IMAGE_THREADS)
+    #include <pthread.h>        // Required for: pthread_create(), pthread_join()
+    #if !defined(_WIN32)
+        #include <unistd.h>     // Required for: sysconf()
+    #endif
+#endif
+
 // Support only desired texture formats on stb_image
 #if !defined(SUPPORT_FILEFORMAT_BMP)
     #define STBI_NO_BMP
@@ -242,10 +253,67 @@
     #define GAUSSIAN_BLUR_ITERATIONS  4    // Number of box blur iterations to approximate gaussian blur
 #endif
 
+#ifndef BLUR_COLUMNS_BLOCK
+    #define BLUR_COLUMNS_BLOCK      256    // Number of columns blurred together on vertical blur passes
+#endif
+
+#ifndef MAX_IMAGE_THREADS
+    #define MAX_IMAGE_THREADS        16    // Maximum number of threads used on image processing (SUPPORT_IMAGE_THREADS)
+#endif
+
+#ifndef PALETTE_CACHE_SIZE
+    #define PALETTE_CACHE_SIZE    65536    // Number of colors cached on palette quantization (power of two)
+#endif
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
-// ...
+// Image blur data, shared by the ranges of rows or columns processed on every pass
+typedef struct BlurPassData {
+    unsigned char *pixels;          // RGBA8 pixels, alpha premultiplied
+    unsigned short *blurred;        // RGBA pixels in 8.8 fixed point, horizontal pass result
+    unsigned int *scales;           // Reciprocal scale of the horizontal window size of every column
+    int width;                      // Image width
+    int height;                     // Image height
+    int radius;                     // Blur window radius
+} BlurPassData;
+
+// Image convolution data, shared by the ranges of rows processed
+typedef struct ConvolutionData {
+    const Color *pixels;            // Source pixels
+    Color *result;                  // Convolution result pixels
+    int width;                      // Image width
+    int height;                     // Image height
+    const float *kernel;            // Square kernel values, row factors for separable kernels
+    const float *columnKernel;      // Column factors for separable kernels (NULL if not separable)
+    int kernelWidth;                // Kernel width (and height)
+    int borderMode;                 // Border mode (ImageBorderMode)
+    float *scratch;                 // Scratch values of every task: padded row, ring rows and row sums
+    int *rowIndices;                // Ring rows positions of every task
+    int paddedSize;                 // Padded row size (values)
+    int rowSize;                    // Ring row size (values)
+    size_t scratchSize;             // Scratch size of one task (values)
+} ConvolutionData;
+
+// Palette quantization box, range of histogram bins merged into one palette color
+typedef struct PaletteBox {
+    int start;                      // First bin (index on sorted bins)
+    int end;                        // Last bin (not included)
+    unsigned long long count;       // Number of pixels on box bins
+    unsigned long long score;       // Split priority, pixels count by widest channel range (0 if box can not be split)
+    int channel;                    // Channel with widest range (0: red, 1: green, 2: blue)
+} PaletteBox;
+
+#if defined(SUPPORT_IMAGE_THREADS)
+// Image processing task, range of rows or columns processed by one thread
+typedef struct ImageTask {
+    void (*process)(void *data, int task, int start, int end);
+    void *data;                     // Data shared by all tasks
+    int index;                      // Task index
+    int start;                      // First row or column
+    int end;                        // Last row or column (not included)
+} ImageTask;
+#endif
 
 //----------------------------------------------------------------------------------
 // Global Variables Definition
@@ -263,6 +331,26 @@ extern void LoadFontDefault(void);          // [Module: text] Loads default font
 static float HalfToFloat(unsigned short x);
 static unsigned short FloatToHalf(float x);
 static Vector4 *LoadImageDataNormalized(Image image);       // Load pixel data from image as Vector4 array (float normalized)
+static void *LoadImageDataConverted(Image image, int newFormat); // Load pixel data from image converted to a format up to 8 bit per channel (NULL if not supported)
+static void ImageFillSpan(Image *dst, int x, int y, int length, Color color);   // Fill horizontal span of pixels within an image (clipped to image bounds)
+static void BlendSpanRGBA8(unsigned char *dst, const unsigned char *src, int count, Color tint); // Blend span of RGBA8 pixels over RGBA8 pixels
+static void ClipEdgeSpan(int w, int step, int *kMin, int *kMax);              // Clip span of steps where edge function is not negative
+static int GetImageTaskCount(int count);                                      // Get number of tasks to split a range of rows or columns between threads
+static void ProcessImageParallel(void (*process)(void *data, int task, int start, int end), void *data, int count, int taskCount); // Process range of rows or columns, split in tasks
+#if defined(SUPPORT_IMAGE_THREADS)
+static void *ProcessImageTask(void *arg);                                       // Process image task range (thread entry point)
+#endif
+static void BlurPremultiplyRows(void *data, int task, int start, int end);    // Premultiply alpha of blur pixels rows
+static void BlurHorizontalRows(void *data, int task, int start, int end);     // Box blur pixels rows into 8.8 fixed point rows
+static void BlurVerticalColumns(void *data, int task, int start, int end);    // Box blur 8.8 fixed point columns into pixels columns
+static void BlurUnpremultiplyRows(void *data, int task, int start, int end);  // Reverse premultiplied alpha of blur pixels rows
+static int GetBorderIndex(int index, int size, int borderMode);               // Get index of pixel read at index, for a border mode (-1 if outside)
+static bool GetKernelFactors(const float *kernel, int kernelWidth, float *rowKernel, float *columnKernel); // Get row and column factors of a separable kernel
+static void ConvolutionRows(void *data, int task, int start, int end);        // Apply convolution kernel to image rows
+static unsigned int GetColorHash(unsigned int color);                         // Get hash value of packed RGBA color
+static int GetPaletteColors(const Color *pixels, int pixelCount, Color *palette, int maxPaletteSize); // Get pixels colors in order of appearance, up to palette size
+static int GetHistogramBinChannel(int bin, int channel);                      // Get channel value of RGB565 histogram bin
+static void SetPaletteBox(PaletteBox *box, const int *bins, const unsigned int *counts); // Set palette box pixels count and split priority
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition
@@ -1264,7 +1352,16 @@ void ImageFormat(Image *image, int newFormat)
 
     if ((newFormat != 0) && (image->format != newFormat))
     {
-        if ((image->format < PIXELFORMAT_COMPRESSED_DXT1_RGB) && (newFormat < PIXELFORMAT_COMPRESSED_DXT1_RGB))
+        // Formats up to 8 bit per channel are converted directly, without float intermediate data
+        void *data = LoadImageDataConverted(*image, newFormat);
+
+        if (data != NULL)
+        {
+            RL_FREE(image->data);
+            image->data = data;
+            image->format = newFormat;
+        }
+        else if ((image->format < PIXELFORMAT_COMPRESSED_DXT1_RGB) && (newFormat < PIXELFORMAT_COMPRESSED_DXT1_RGB))
         {
             Vector4 *pixels = LoadImageDataNormalized(*image);     // Supports 8 to 32 bit per channel
 
@@ -1449,18 +1546,18 @@ void ImageFormat(Image *image, int newFormat)
 
             RL_FREE(pixels);
             pixels = NULL;
-
-            // In case original image had mipmaps, generate mipmaps for formatted image
-            // NOTE: Original mipmaps are replaced by new ones, if custom mipmaps were used, they are lost
-            if (image->mipmaps > 1)
-            {
-                image->mipmaps = 1;
-            #if defined(SUPPORT_IMAGE_MANIPULATION)
-                if (image->data != NULL) ImageMipmaps(image);
-            #endif
-            }
         }
         else TRACELOG(LOG_WARNING, "IMAGE: Data format is compressed, can not be converted");
+
+        // In case original image had mipmaps, generate mipmaps for formatted image
+        // NOTE: Original mipmaps are replaced by new ones, if custom mipmaps were used, they are lost
+        if ((image->format == newFormat) && (image->mipmaps > 1))
+        {
+            image->mipmaps = 1;
+        #if defined(SUPPORT_IMAGE_MANIPULATION)
+            if (image->data != NULL) ImageMipmaps(image);
+        #endif
+        }
     }
 }
 
@@ -2098,142 +2195,60 @@ void ImageAlphaPremultiply(Image *image)
 }
 
 // Apply box blur to image
+// NOTE: Box blur passes use integer running sums over the window, horizontal pass results
+// are kept in 8.8 fixed point and vertical passes walk the rows keeping a sum per column
 void ImageBlurGaussian(Image *image, int blurSize)
 {
     // Security check to avoid program crash
     if ((image->data == NULL) || (image->width == 0) || (image->height == 0)) return;
 
-    ImageAlphaPremultiply(image);
-
     Color *pixels = LoadImageColors(*image);
+    unsigned short *blurred = (unsigned short *)RL_MALLOC((size_t)image->width*image->height*4*sizeof(unsigned short));
+    unsigned int *scales = (unsigned int *)RL_MALLOC(image->width*sizeof(unsigned int));
 
-    // Loop switches between pixelsCopy1 and pixelsCopy2
-    Vector4 *pixelsCopy1 = (Vector4 *)RL_MALLOC((image->height)*(image->width)*sizeof(Vector4));
-    Vector4 *pixelsCopy2 = (Vector4 *)RL_MALLOC((image->height)*(image->width)*sizeof(Vector4));
-
-    for (int i = 0; i < (image->height*image->width); i++)
+    if ((pixels == NULL) || (blurred == NULL) || (scales == NULL))
     {
-        pixelsCopy1[i].x = pixels[i].r;
-        pixelsCopy1[i].y = pixels[i].g;
-        pixelsCopy1[i].z = pixels[i].b;
-        pixelsCopy1[i].w = pixels[i].a;
+        UnloadImageColors(pixels);
+        RL_FREE(blurred);
+        RL_FREE(scales);
+        TRACELOG(LOG_WARNING, "IMAGE: Failed to allocate memory for blur");
+        return;
     }
 
-    // Repeated convolution of rectangular window signal by itself converges to a gaussian distribution
-    for (int j = 0; j < GAUSSIAN_BLUR_ITERATIONS; j++)
+    BlurPassData blur = { 0 };
+    blur.pixels = (unsigned char *)pixels;
+    blur.blurred = blurred;
+    blur.scales = scales;
+    blur.width = image->width;
+    blur.height = image->height;
+    blur.radius = (blurSize > 0)? blurSize : 0;
+
+    // Window for pixel x covers pixels [x - radius, x + radius] inside the row,
+    // reciprocal scale of the window size, (sum*scale) >> 16 is sum*256/size
+    for (int x = 0; x < blur.width; x++)
     {
-        // Horizontal motion blur
-        for (int row = 0; row < image->height; row++)
-        {
-            float avgR = 0.0f;
-            float avgG = 0.0f;
-            float avgB = 0.0f;
-            float avgAlpha = 0.0f;
-            int convolutionSize = blurSize;
-
-            for (int i = 0; i < blurSize; i++)
-            {
-                avgR += pixelsCopy1[row*image->width + i].x;
-                avgG += pixelsCopy1[row*image->width + i].y;
-                avgB += pixelsCopy1[row*image->width + i].z;
-                avgAlpha += pixelsCopy1[row*image->width + i].w;
-            }
-
-            for (int x = 0; x < image->width; x++)
-            {
-                if (x-blurSize-1 >= 0)
-                {
-                    avgR -= pixelsCopy1[row*image->width + x-blurSize-1].x;
-                    avgG -= pixelsCopy1[row*image->width + x-blurSize-1].y;
-                    avgB -= pixelsCopy1[row*image->width + x-blurSize-1].z;
-                    avgAlpha -= pixelsCopy1[row*image->width + x-blurSize-1].w;
-                    convolutionSize--;
-                }
-
-                if (x+blurSize < image->width)
-                {
-                    avgR += pixelsCopy1[row*image->width + x+blurSize].x;
-                    avgG += pixelsCopy1[row*image->width + x+blurSize].y;
-                    avgB += pixelsCopy1[row*image->width + x+blurSize].z;
-                    avgAlpha += pixelsCopy1[row*image->width + x+blurSize].w;
-                    convolutionSize++;
-                }
-
-                pixelsCopy2[row*image->width + x].x = avgR/convolutionSize;
-                pixelsCopy2[row*image->width + x].y = avgG/convolutionSize;
-                pixelsCopy2[row*image->width + x].z = avgB/convolutionSize;
-                pixelsCopy2[row*image->width + x].w = avgAlpha/convolutionSize;
-            }
-        }
-
-        // Vertical motion blur
-        for (int col = 0; col < image->width; col++)
-        {
-            float avgR = 0.0f;
-            float avgG = 0.0f;
-            float avgB = 0.0f;
-            float avgAlpha = 0.0f;
-            int convolutionSize = blurSize;
-
-            for (int i = 0; i < blurSize; i++)
-            {
-                avgR += pixelsCopy2[i*image->width + col].x;
-                avgG += pixelsCopy2[i*image->width + col].y;
-                avgB += pixelsCopy2[i*image->width + col].z;
-                avgAlpha += pixelsCopy2[i*image->width + col].w;
-            }
+        int size = ((x + blur.radius < blur.width)? x + blur.radius : blur.width - 1) - ((x - blur.radius > 0)? x - blur.radius : 0) + 1;
+        scales[x] = ((1U << 24) + size - 1)/size;
+    }
 
-            for (int y = 0; y < image->height; y++)
-            {
-                if (y-blurSize-1 >= 0)
-                {
-                    avgR -= pixelsCopy2[(y-blurSize-1)*image->width + col].x;
-                    avgG -= pixelsCopy2[(y-blurSize-1)*image->width + col].y;
-                    avgB -= pixelsCopy2[(y-blurSize-1)*image->width + col].z;
-                    avgAlpha -= pixelsCopy2[(y-blurSize-1)*image->width + col].w;
-                    convolutionSize--;
-                }
-                if (y+blurSize < image->height)
-                {
-                    avgR += pixelsCopy2[(y+blurSize)*image->width + col].x;
-                    avgG += pixelsCopy2[(y+blurSize)*image->width + col].y;
-                    avgB += pixelsCopy2[(y+blurSize)*image->width + col].z;
-                    avgAlpha += pixelsCopy2[(y+blurSize)*image->width + col].w;
-                    convolutionSize++;
-                }
+    int rowTasks = GetImageTaskCount(image->height);
+    int columnTasks = GetImageTaskCount(image->width);
 
-                pixelsCopy1[y*image->width + col].x = (unsigned char) (avgR/convolutionSize);
-                pixelsCopy1[y*image->width + col].y = (unsigned char) (avgG/convolutionSize);
-                pixelsCopy1[y*image->width + col].z = (unsigned char) (avgB/convolutionSize);
-                pixelsCopy1[y*image->width + col].w = (unsigned char) (avgAlpha/convolutionSize);
-            }
-        }
-    }
+    ProcessImageParallel(BlurPremultiplyRows, &blur, image->height, rowTasks);
 
-    // Reverse premultiply
-    for (int i = 0; i < (image->width)*(image->height); i++)
+    // Repeated convolution of rectangular window signal by itself converges to a gaussian distribution
+    for (int j = 0; j < GAUSSIAN_BLUR_ITERATIONS; j++)
     {
-        if (pixelsCopy1[i].w == 0.0f)
-        {
-            pixels[i].r = 0;
-            pixels[i].g = 0;
-            pixels[i].b = 0;
-            pixels[i].a = 0;
-        }
-        else if (pixelsCopy1[i].w <= 255.0f)
-        {
-            float alpha = (float)pixelsCopy1[i].w/255.0f;
-            pixels[i].r = (unsigned char)fminf((float)pixelsCopy1[i].x/alpha, 255.0);
-            pixels[i].g = (unsigned char)fminf((float)pixelsCopy1[i].y/alpha, 255.0);
-            pixels[i].b = (unsigned char)fminf((float)pixelsCopy1[i].z/alpha, 255.0);
-            pixels[i].a = (unsigned char) pixelsCopy1[i].w;
-        }
+        ProcessImageParallel(BlurHorizontalRows, &blur, image->height, rowTasks);
+        ProcessImageParallel(BlurVerticalColumns, &blur, image->width, columnTasks);
     }
 
+    ProcessImageParallel(BlurUnpremultiplyRows, &blur, image->height, rowTasks);
+
     int format = image->format;
     RL_FREE(image->data);
-    RL_FREE(pixelsCopy1);
-    RL_FREE(pixelsCopy2);
+    RL_FREE(blurred);
+    RL_FREE(scales);
 
     image->data = pixels;
     image->format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
@@ -2244,6 +2259,13 @@ void ImageBlurGaussian(Image *image, int blurSize)
 // Apply custom square convolution kernel to image
 // NOTE: The convolution kernel matrix is expected to be square
 void ImageKernelConvolution(Image *image, const float *kernel, int kernelSize)
+{
+    ImageKernelConvolutionEx(image, kernel, kernelSize, IMAGE_BORDER_ZERO);
+}
+
+// Apply custom square convolution kernel to image, with border mode (ImageBorderMode)
+// NOTE: Separable kernels (rank 1) are applied as a row pass and a column pass
+void ImageKernelConvolutionEx(Image *image, const float *kernel, int kernelSize, int borderMode)
 {
     if ((image->data == NULL) || (image->width == 0) || (image->height == 0) || kernel == NULL) return;
 
@@ -2255,118 +2277,63 @@ void ImageKernelConvolution(Image *image, const float *kernel, int kernelSize)
         return;
     }
 
-    Color *pixels = LoadImageColors(*image);
-
-    Vector4 *imageCopy2 = (Vector4 *)RL_MALLOC((image->height)*(image->width)*sizeof(Vector4));
-    Vector4 *temp = (Vector4 *)RL_MALLOC(kernelSize*sizeof(Vector4));
-
-    for (int i = 0; i < kernelSize; i++)
+    float *factors = (float *)RL_MALLOC(kernelWidth*2*sizeof(float));
+    if (factors == NULL)
     {
-        temp[i].x = 0.0f;
-        temp[i].y = 0.0f;
-        temp[i].z = 0.0f;
-        temp[i].w = 0.0f;
+        TRACELOG(LOG_WARNING, "IMAGE: Failed to allocate memory for convolution");
+        return;
     }
 
-    float rRes = 0.0f;
-    float gRes = 0.0f;
-    float bRes = 0.0f;
-    float aRes = 0.0f;
+    ConvolutionData convolution = { 0 };
+    convolution.width = image->width;
+    convolution.height = image->height;
+    convolution.kernel = kernel;
+    convolution.kernelWidth = kernelWidth;
+    convolution.borderMode = borderMode;
 
-    int startRange = 0, endRange = 0;
-
-    if (kernelWidth%2 == 0)
-    {
-        startRange = -kernelWidth/2;
-        endRange = kernelWidth/2;
-    }
-    else
+    // Separable kernels only save work from 3x3 kernels
+    if ((kernelWidth > 2) && GetKernelFactors(kernel, kernelWidth, factors, factors + kernelWidth))
     {
-        startRange = -kernelWidth/2;
-        endRange = kernelWidth/2 + 1;
+        convolution.kernel = factors;
+        convolution.columnKernel = factors + kernelWidth;
     }
 
-    for (int x = 0; x < image->height; x++)
-    {
-        for (int y = 0; y < image->width; y++)
-        {
-            for (int xk = startRange; xk < endRange; xk++)
-            {
-                for (int yk = startRange; yk < endRange; yk++)
-                {
-                    int xkabs = xk + kernelWidth/2;
-                    int ykabs = yk + kernelWidth/2;
-                    unsigned int imgindex = image->width*(x + xk) + (y + yk);
-
-                    if (imgindex >= (unsigned int)(image->width*image->height))
-                    {
-                        temp[kernelWidth*xkabs + ykabs].x = 0.0f;
-                        temp[kernelWidth*xkabs + ykabs].y = 0.0f;
-                        temp[kernelWidth*xkabs + ykabs].z = 0.0f;
-                        temp[kernelWidth*xkabs + ykabs].w = 0.0f;
-                    }
-                    else
-                    {
-                        temp[kernelWidth*xkabs + ykabs].x = ((float)pixels[imgindex].r)/255.0f*kernel[kernelWidth*xkabs + ykabs];
-                        temp[kernelWidth*xkabs + ykabs].y = ((float)pixels[imgindex].g)/255.0f*kernel[kernelWidth*xkabs + ykabs];
-                        temp[kernelWidth*xkabs + ykabs].z = ((float)pixels[imgindex].b)/255.0f*kernel[kernelWidth*xkabs + ykabs];
-                        temp[kernelWidth*xkabs + ykabs].w = ((float)pixels[imgindex].a)/255.0f*kernel[kernelWidth*xkabs + ykabs];
-                    }
-                }
-            }
-
-            for (int i = 0; i < kernelSize; i++)
-            {
-                rRes += temp[i].x;
-                gRes += temp[i].y;
-                bRes += temp[i].z;
-                aRes += temp[i].w;
-            }
-
-            if (rRes < 0.0f) rRes = 0.0f;
-            if (gRes < 0.0f) gRes = 0.0f;
-            if (bRes < 0.0f) bRes = 0.0f;
-
-            if (rRes > 1.0f) rRes = 1.0f;
-            if (gRes > 1.0f) gRes = 1.0f;
-            if (bRes > 1.0f) bRes = 1.0f;
+    // Scratch rows of every task: padded source row, ring of kernelWidth rows and row sums
+    // NOTE: Separable kernels keep row pass results on the ring, without padding
+    int taskCount = GetImageTaskCount(image->height);
+    convolution.paddedSize = (image->width + kernelWidth - 1)*4;
+    convolution.rowSize = (convolution.columnKernel != NULL)? image->width*4 : convolution.paddedSize;
+    convolution.scratchSize = convolution.paddedSize + (size_t)kernelWidth*convolution.rowSize + (size_t)image->width*4;
 
-            imageCopy2[image->width*x + y].x = rRes;
-            imageCopy2[image->width*x + y].y = gRes;
-            imageCopy2[image->width*x + y].z = bRes;
-            imageCopy2[image->width*x + y].w = aRes;
-
-            rRes = 0.0f;
-            gRes = 0.0f;
-            bRes = 0.0f;
-            aRes = 0.0f;
+    Color *pixels = LoadImageColors(*image);
+    Color *result = (Color *)RL_MALLOC((size_t)image->width*image->height*sizeof(Color));
+    convolution.scratch = (float *)RL_MALLOC(taskCount*convolution.scratchSize*sizeof(float));
+    convolution.rowIndices = (int *)RL_MALLOC(taskCount*kernelWidth*sizeof(int));
 
-            for (int i = 0; i < kernelSize; i++)
-            {
-                temp[i].x = 0.0f;
-                temp[i].y = 0.0f;
-                temp[i].z = 0.0f;
-                temp[i].w = 0.0f;
-            }
-        }
+    if ((pixels == NULL) || (result == NULL) || (convolution.scratch == NULL) || (convolution.rowIndices == NULL))
+    {
+        UnloadImageColors(pixels);
+        RL_FREE(result);
+        RL_FREE(convolution.scratch);
+        RL_FREE(convolution.rowIndices);
+        RL_FREE(factors);
+        TRACELOG(LOG_WARNING, "IMAGE: Failed to allocate memory for convolution");
+        return;
     }
 
-    for (int i = 0; i < (image->width*image->height); i++)
-    {
-        float alpha = (float)imageCopy2[i].w;
+    convolution.pixels = pixels;
+    convolution.result = result;
 
-        pixels[i].r = (unsigned char)((imageCopy2[i].x)*255.0f);
-        pixels[i].g = (unsigned char)((imageCopy2[i].y)*255.0f);
-        pixels[i].b = (unsigned char)((imageCopy2[i].z)*255.0f);
-        pixels[i].a = (unsigned char)((alpha)*255.0f);
-    }
+    ProcessImageParallel(ConvolutionRows, &convolution, image->height, taskCount);
 
     int format = image->format;
     RL_FREE(image->data);
-    RL_FREE(imageCopy2);
-    RL_FREE(temp);
+    UnloadImageColors(pixels);
+    RL_FREE(convolution.scratch);
+    RL_FREE(convolution.rowIndices);
+    RL_FREE(factors);
 
-    image->data = pixels;
+    image->data = result;
     image->format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
     ImageFormat(image, format);
 }
@@ -2948,6 +2915,70 @@ void ImageColorReplace(Image *image, Color color, Color replace)
         (format == PIXELFORMAT_COMPRESSED_ETC2_RGB) ||
         (format == PIXELFORMAT_COMPRESSED_PVRT_RGB)) ImageFormat(image, format);
 }
+
+// Modify image color: replace colors by closest palette color
+// NOTE: Transparent pixels are kept, palette can be loaded with LoadImagePaletteQuantized()
+void ImageColorQuantize(Image *image, const Color *palette, int paletteSize)
+{
+    // Security check to avoid program crash
+    if ((image->data == NULL) || (image->width == 0) || (image->height == 0) || (palette == NULL) || (paletteSize <= 0)) return;
+
+    Color *pixels = LoadImageColors(*image);
+
+    // Closest palette color is cached by packed color, on a direct mapped table
+    // NOTE: Transparent pixels are skipped, so key 0 marks an empty entry
+    unsigned int *cacheKeys = (unsigned int *)RL_CALLOC(PALETTE_CACHE_SIZE, sizeof(unsigned int));
+    int *cacheIndices = (int *)RL_MALLOC(PALETTE_CACHE_SIZE*sizeof(int));
+
+    for (int i = 0; i < image->width*image->height; i++)
+    {
+        if (pixels[i].a == 0) continue;
+
+        unsigned int key = 0;
+        memcpy(&key, &pixels[i], sizeof(unsigned int));
+
+        unsigned int slot = GetColorHash(key) & (PALETTE_CACHE_SIZE - 1);
+
+        if (cacheKeys[slot] != key)
+        {
+            int closest = 0;
+            int minDistance = 0;
+
+            for (int j = 0; j < paletteSize; j++)
+            {
+                int dr = pixels[i].r - palette[j].r;
+                int dg = pixels[i].g - palette[j].g;
+                int db = pixels[i].b - palette[j].b;
+                int da = pixels[i].a - palette[j].a;
+                int distance = dr*dr + dg*dg + db*db + da*da;
+
+                if ((j == 0) || (distance < minDistance))
+                {
+                    closest = j;
+                    minDistance = distance;
+
+                    if (distance == 0) break;
+                }
+            }
+
+            cacheKeys[slot] = key;
+            cacheIndices[slot] = closest;
+        }
+
+        pixels[i] = palette[cacheIndices[slot]];
+    }
+
+    RL_FREE(cacheIndices);
+    RL_FREE(cacheKeys);
+
+    int format = image->format;
+    RL_FREE(image->data);
+
+    image->data = pixels;
+    image->format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+    ImageFormat(image, format);
+}
 #endif      // SUPPORT_IMAGE_MANIPULATION
 
 // Load color data from image as a Color array (RGBA - 32bit)
@@ -3104,8 +3135,6 @@ Color *LoadImageColors(Image image)
 // NOTE: Memory allocated should be freed using UnloadImagePalette()
 Color *LoadImagePalette(Image image, int maxPaletteSize, int *colorCount)
 {
-    #define COLOR_EQUAL(col1, col2) ((col1.r == col2.r)&&(col1.g == col2.g)&&(col1.b == col2.b)&&(col1.a == col2.a))
-
     int palCount = 0;
     Color *palette = NULL;
     Color *pixels = LoadImageColors(image);
@@ -3116,36 +3145,139 @@ Color *LoadImagePalette(Image image, int maxPaletteSize, int *colorCount)
 
         for (int i = 0; i < maxPaletteSize; i++) palette[i] = BLANK;   // Set all colors to BLANK
 
-        for (int i = 0; i < image.width*image.height; i++)
+        palCount = GetPaletteColors(pixels, image.width*image.height, palette, maxPaletteSize);
+
+        // We reached the limit of colors supported by palette
+        if (palCount >= maxPaletteSize) TRACELOG(LOG_WARNING, "IMAGE: Palette is greater than %i colors", maxPaletteSize);
+
+        UnloadImageColors(pixels);
+    }
+
+    *colorCount = palCount;
+
+    return palette;
+}
+
+// Load colors palette from image as a Color array (RGBA - 32bit), quantized to palette size
+// NOTE: Images with more colors than palette size are reduced by median cut over a RGB565 histogram,
+// every palette color is the average of the pixels merged, memory should be freed using UnloadImagePalette()
+Color *LoadImagePaletteQuantized(Image image, int maxPaletteSize, int *colorCount)
+{
+    int palCount = 0;
+    Color *palette = NULL;
+    Color *pixels = (maxPaletteSize > 0)? LoadImageColors(image) : NULL;
+
+    if (pixels != NULL)
+    {
+        int pixelCount = image.width*image.height;
+
+        // NOTE: One extra color is allocated to find out if image has more colors than palette size
+        palette = (Color *)RL_MALLOC((maxPaletteSize + 1)*sizeof(Color));
+
+        for (int i = 0; i < maxPaletteSize; i++) palette[i] = BLANK;   // Set all colors to BLANK
+
+        // Images with no more colors than palette size keep their exact colors
+        palCount = GetPaletteColors(pixels, pixelCount, palette, maxPaletteSize + 1);
+
+        if (palCount > maxPaletteSize)
         {
-            if (pixels[i].a > 0)
+            // Histogram of pixels in RGB565 bins, keeping pixels count and channels sum of every bin
+            unsigned int *counts = (unsigned int *)RL_CALLOC(65536, sizeof(unsigned int));
+            unsigned long long *sums = (unsigned long long *)RL_CALLOC(65536*4, sizeof(unsigned long long));
+
+            for (int i = 0; i < pixelCount; i++)
+            {
+                if (pixels[i].a == 0) continue;
+
+                int bin = ((pixels[i].r >> 3) << 11) | ((pixels[i].g >> 2) << 5) | (pixels[i].b >> 3);
+
+                counts[bin]++;
+                sums[bin*4] += pixels[i].r;
+                sums[bin*4 + 1] += pixels[i].g;
+                sums[bin*4 + 2] += pixels[i].b;
+                sums[bin*4 + 3] += pixels[i].a;
+            }
+
+            int *bins = (int *)RL_MALLOC(65536*sizeof(int));
+            int *sorted = (int *)RL_MALLOC(65536*sizeof(int));
+            int binCount = 0;
+
+            for (int i = 0; i < 65536; i++) if (counts[i] > 0) bins[binCount++] = i;
+
+            PaletteBox *boxes = (PaletteBox *)RL_MALLOC(maxPaletteSize*sizeof(PaletteBox));
+            int boxCount = 1;
+
+            boxes[0].start = 0;
+            boxes[0].end = binCount;
+            SetPaletteBox(&boxes[0], bins, counts);
+
+            // Split the box with more pixels over the widest range, until palette is full
+            while (boxCount < maxPaletteSize)
             {
-                bool colorInPalette = false;
+                int split = 0;
 
-                // Check if the color is already on palette
-                for (int j = 0; j < maxPaletteSize; j++)
+                for (int i = 1; i < boxCount; i++) if (boxes[i].score > boxes[split].score) split = i;
+
+                if (boxes[split].score == 0) break;     // No box left with more than one bin
+
+                PaletteBox *box = &boxes[split];
+
+                // Sort box bins by the channel split, counting values up to 6 bit
+                int offsets[65] = { 0 };
+
+                for (int i = box->start; i < box->end; i++) offsets[GetHistogramBinChannel(bins[i], box->channel) + 1]++;
+                for (int i = 1; i < 65; i++) offsets[i] += offsets[i - 1];
+                for (int i = box->start; i < box->end; i++) sorted[offsets[GetHistogramBinChannel(bins[i], box->channel)]++] = bins[i];
+
+                memcpy(bins + box->start, sorted, (box->end - box->start)*sizeof(int));
+
+                // Split at median pixel, keeping at least one bin on every box
+                unsigned long long accum = 0;
+                int median = box->start + 1;
+
+                for (int i = box->start; i < box->end - 1; i++)
                 {
-                    if (COLOR_EQUAL(pixels[i], palette[j]))
-                    {
-                        colorInPalette = true;
-                        break;
-                    }
+                    accum += counts[bins[i]];
+                    median = i + 1;
+
+                    if (2*accum >= box->count) break;
                 }
 
-                // Store color if not on the palette
-                if (!colorInPalette)
-                {
-                    palette[palCount] = pixels[i];      // Add pixels[i] to palette
-                    palCount++;
+                boxes[boxCount].start = median;
+                boxes[boxCount].end = box->end;
+                box->end = median;
 
-                    // We reached the limit of colors supported by palette
-                    if (palCount >= maxPaletteSize)
-                    {
-                        i = image.width*image.height;   // Finish palette get
-                        TRACELOG(LOG_WARNING, "IMAGE: Palette is greater than %i colors", maxPaletteSize);
-                    }
+                SetPaletteBox(box, bins, counts);
+                SetPaletteBox(&boxes[boxCount], bins, counts);
+                boxCount++;
+            }
+
+            // Palette colors are the average color of the pixels on every box
+            for (int i = 0; i < boxCount; i++)
+            {
+                unsigned long long sum[4] = { 0 };
+                unsigned long long count = boxes[i].count;
+
+                for (int j = boxes[i].start; j < boxes[i].end; j++)
+                {
+                    for (int c = 0; c < 4; c++) sum[c] += sums[bins[j]*4 + c];
                 }
+
+                palette[i].r = (unsigned char)((sum[0] + count/2)/count);
+                palette[i].g = (unsigned char)((sum[1] + count/2)/count);
+                palette[i].b = (unsigned char)((sum[2] + count/2)/count);
+                palette[i].a = (unsigned char)((sum[3] + count/2)/count);
             }
+
+            for (int i = boxCount; i < maxPaletteSize; i++) palette[i] = BLANK;
+
+            palCount = boxCount;
+
+            RL_FREE(boxes);
+            RL_FREE(sorted);
+            RL_FREE(bins);
+            RL_FREE(sums);
+            RL_FREE(counts);
         }
 
         UnloadImageColors(pixels);
@@ -3587,43 +3719,62 @@ void ImageDrawLineEx(Image *dst, Vector2 start, Vector2 end, int thick, Color co
     int dx = x2 - x1;
     int dy = y2 - y1;
 
+    // How many additional pixels to draw before (up/left) and after (down/right) the main line
+    int wide = thick - 1;
+    int before = (wide > 0)? wide/2 : 0;
+    int after = (wide + 1)/2;
+
+    if (after < 0) return;
+
+    // NOTE: Main line pixels are walked the same way as ImageDrawLine(),
+    // thickness is added with spans of pixels instead of additional lines
+
     // Determine if the line is more horizontal or vertical
-    if ((dx != 0) && (abs(dy/dx) < 1))
+    if ((dx != 0) && (abs(dy) < abs(dx)))
     {
-        // Line is more horizontal
+        // Line is more horizontal: main line pixels in the same row are joined into one span,
+        // repeated in the rows above and below
+        int sgnInc = (dx < 0)? -1 : 1;
+        int decInc = (dy << 16)/abs(dx);
 
-        // How many additional lines to draw
-        int wy = thick - 1;
+        int spanStart = x1;
+        int spanY = y1;
+        int spanLength = 0;
 
-        // Draw the main line and lower half
-        for (int i = 0; i <= ((wy+1)/2); i++)
+        for (int i = 0, j = 0; i <= abs(dx); i++, j += decInc)
         {
-            ImageDrawLine(dst, x1, y1 + i, x2, y2 + i, color);
-        }
+            int x = x1 + i*sgnInc;
+            int y = y1 + (j >> 16);
 
-        // Draw the upper half
-        for (int i = 1; i <= (wy/2); i++)
-        {
-            ImageDrawLine(dst, x1, y1 - i, x2, y2 - i, color);
+            if ((i == abs(dx)) || (y != spanY))
+            {
+                int spanX = (sgnInc > 0)? spanStart : spanStart - spanLength + 1;
+                for (int k = -before; k <= after; k++) ImageFillSpan(dst, spanX, spanY + k, spanLength, color);
+
+                spanStart = x;
+                spanY = y;
+                spanLength = 0;
+            }
+
+            spanLength++;
         }
     }
     else if (dy != 0)
     {
-        // Line is more vertical or perfectly horizontal
-
-        // How many additional lines to draw
-        int wx = thick - 1;
-
-        //Draw the main line and right half
-        for (int i = 0; i <= ((wx+1)/2); i++)
+        // Line is more vertical or perfectly diagonal: every main line pixel is in a different row,
+        // drawn as one span with the pixels at its left and right
+        bool yLonger = (abs(dy) > abs(dx));
+        int longLen = yLonger? dy : dx;
+        int shortLen = yLonger? dx : dy;
+        int sgnInc = (longLen < 0)? -1 : 1;
+        int decInc = (shortLen << 16)/abs(longLen);
+
+        for (int i = 0, j = 0; i != longLen; i += sgnInc, j += decInc)
         {
-            ImageDrawLine(dst, x1 + i, y1, x2 + i, y2, color);
-        }
+            int x = yLonger? x1 + (j >> 16) : x1 + i;
+            int y = yLonger? y1 + i : y1 + (j >> 16);
 
-        // Draw the left half
-        for (int i = 1; i <= (wx/2); i++)
-        {
-            ImageDrawLine(dst, x1 - i, y1, x2 - i, y2, color);
+            ImageFillSpan(dst, x - before, y, before + after + 1, color);
         }
     }
 }
@@ -3637,10 +3788,11 @@ void ImageDrawCircle(Image* dst, int centerX, int centerY, int radius, Color col
 
     while (y >= x)
     {
-        ImageDrawRectangle(dst, centerX - x, centerY + y, x*2, 1, color);
-        ImageDrawRectangle(dst, centerX - x, centerY - y, x*2, 1, color);
-        ImageDrawRectangle(dst, centerX - y, centerY + x, y*2, 1, color);
-        ImageDrawRectangle(dst, centerX - y, centerY - x, y*2, 1, color);
+        // NOTE: Top and bottom rows are drawn at least one pixel wide
+        ImageFillSpan(dst, centerX - x, centerY + y, (x > 0)? x*2 : 1, color);
+        ImageFillSpan(dst, centerX - x, centerY - y, (x > 0)? x*2 : 1, color);
+        ImageFillSpan(dst, centerX - y, centerY + x, (y > 0)? y*2 : 1, color);
+        ImageFillSpan(dst, centerX - y, centerY - x, (y > 0)? y*2 : 1, color);
         x++;
 
         if (decesionParameter > 0)
@@ -3729,19 +3881,12 @@ void ImageDrawRectangleRec(Image *dst, Rectangle rec, Color color)
 
     int bytesPerPixel = GetPixelDataSize(1, 1, dst->format);
 
-    // Fill in the first pixel of the first row based on image format
-    ImageDrawPixel(dst, sx, sy, color);
+    // Fill in the first row based on image format (at least the first pixel)
+    ImageFillSpan(dst, sx, sy, ((int)rec.width > 0)? (int)rec.width : 1, color);
 
     int bytesOffset = ((sy*dst->width) + sx)*bytesPerPixel;
     unsigned char *pSrcPixel = (unsigned char *)dst->data + bytesOffset;
 
-    // Repeat the first pixel data throughout the row
-    for (int x = 1; x < (int)rec.width; x *= 2)
-    {
-        int pixelsToCopy = MIN(x, (int)rec.width - x);
-        memcpy(pSrcPixel + x*bytesPerPixel, pSrcPixel, pixelsToCopy*bytesPerPixel);
-    }
-
     // Repeat the first row data for all other rows
     int bytesPerRow = bytesPerPixel*(int)rec.width;
     for (int y = 1; y < (int)rec.height; y++)
@@ -3800,24 +3945,18 @@ void ImageDrawTriangle(Image *dst, Vector2 v1, Vector2 v2, Vector2 v3, Color col
     int w3Row = (int)((xMin - v1.x)*w3XStep + w3YStep*(yMin - v1.y));
 
     // Rasterization loop
-    // Iterate through each pixel in the bounding box
+    // Iterate through each row in the bounding box
     for (int y = yMin; y <= yMax; y++)
     {
-        int w1 = w1Row;
-        int w2 = w2Row;
-        int w3 = w3Row;
-
-        for (int x = xMin; x <= xMax; x++)
-        {
-            // Check if the pixel is inside the triangle using barycentric coordinates
-            // If it is then we can draw the pixel with the given color
-            if ((w1 | w2 | w3) >= 0) ImageDrawPixel(dst, x, y, color);
+        // Get the span of pixels inside the triangle, where all barycentric coordinates are positive,
+        // coordinates are linear along the row, so the pixels inside are contiguous
+        int kMin = 0;
+        int kMax = xMax - xMin;
+        ClipEdgeSpan(w1Row, w1XStep, &kMin, &kMax);
+        ClipEdgeSpan(w2Row, w2XStep, &kMin, &kMax);
+        ClipEdgeSpan(w3Row, w3XStep, &kMin, &kMax);
 
-            // Increment the barycentric coordinates for the next pixel
-            w1 += w1XStep;
-            w2 += w2XStep;
-            w3 += w3XStep;
-        }
+        if (kMin <= kMax) ImageFillSpan(dst, xMin + kMin, y, kMax - kMin + 1, color);
 
         // Move to the next row in the bounding box
         w1Row += w1YStep;
@@ -3873,33 +4012,43 @@ void ImageDrawTriangleEx(Image *dst, Vector2 v1, Vector2 v2, Vector2 v3, Color c
     float wInvSum = 255.0f/(w1Row + w2Row + w3Row);
 
     // Rasterization loop
-    // Iterate through each pixel in the bounding box
+    // Iterate through each row in the bounding box
     for (int y = yMin; y <= yMax; y++)
     {
-        int w1 = w1Row;
-        int w2 = w2Row;
-        int w3 = w3Row;
-
-        for (int x = xMin; x <= xMax; x++)
+        // Get the span of pixels inside the triangle, where all barycentric coordinates are positive
+        int kMin = 0;
+        int kMax = xMax - xMin;
+        ClipEdgeSpan(w1Row, w1XStep, &kMin, &kMax);
+        ClipEdgeSpan(w2Row, w2XStep, &kMin, &kMax);
+        ClipEdgeSpan(w3Row, w3XStep, &kMin, &kMax);
+
+        // Clip the span to the image bounds
+        if ((dst->data == NULL) || (y < 0) || (y >= dst->height)) kMax = kMin - 1;
+        if ((xMin + kMin) < 0) kMin = -xMin;
+        if ((xMin + kMax) >= dst->width) kMax = dst->width - 1 - xMin;
+
+        int w1 = w1Row + kMin*w1XStep;
+        int w2 = w2Row + kMin*w2XStep;
+        int w3 = w3Row + kMin*w3XStep;
+
+        for (int x = xMin + kMin; x <= xMin + kMax; x++)
         {
-            // Check if the pixel is inside the triangle using barycentric coordinates
-            if ((w1 | w2 | w3) >= 0)
-            {
-                // Compute the normalized barycentric coordinates
-                unsigned char aW1 = (unsigned char)((float)w1*wInvSum);
-                unsigned char aW2 = (unsigned char)((float)w2*wInvSum);
-                unsigned char aW3 = (unsigned char)((float)w3*wInvSum);
-
-                // Interpolate the color using the barycentric coordinates
-                Color finalColor = { 0 };
-                finalColor.r = (c1.r*aW1 + c2.r*aW2 + c3.r*aW3)/255;
-                finalColor.g = (c1.g*aW1 + c2.g*aW2 + c3.g*aW3)/255;
-                finalColor.b = (c1.b*aW1 + c2.b*aW2 + c3.b*aW3)/255;
-                finalColor.a = (c1.a*aW1 + c2.a*aW2 + c3.a*aW3)/255;
-
-                // Draw the pixel with the interpolated color
-                ImageDrawPixel(dst, x, y, finalColor);
-            }
+            // Compute the normalized barycentric coordinates
+            unsigned char aW1 = (unsigned char)((float)w1*wInvSum);
+            unsigned char aW2 = (unsigned char)((float)w2*wInvSum);
+            unsigned char aW3 = (unsigned char)((float)w3*wInvSum);
+
+            // Interpolate the color using the barycentric coordinates
+            Color finalColor = { 0 };
+            finalColor.r = (c1.r*aW1 + c2.r*aW2 + c3.r*aW3)/255;
+            finalColor.g = (c1.g*aW1 + c2.g*aW2 + c3.g*aW3)/255;
+            finalColor.b = (c1.b*aW1 + c2.b*aW2 + c3.b*aW3)/255;
+            finalColor.a = (c1.a*aW1 + c2.a*aW2 + c3.a*aW3)/255;
+
+            // Draw the pixel with the interpolated color
+            // Fast path: RGBA8 pixels are written directly, skipping format checks
+            if (dst->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) memcpy((unsigned char *)dst->data + ((size_t)y*dst->width + x)*4, &finalColor, 4);
+            else ImageDrawPixel(dst, x, y, finalColor);
 
             // Increment the barycentric coordinates for the next pixel
             w1 += w1XStep;
@@ -4044,6 +4193,11 @@ void ImageDraw(Image *dst, Image src, Rectangle srcRec, Rectangle dstRec, Color
 
             // Fast path: Avoid moving pixel by pixel if no blend required and same format
             if (!blendRequired && (srcPtr->format == dst->format)) memcpy(pDst, pSrc, (int)(srcRec.width)*bytesPerPixelSrc);
+            // Fast path: Blend RGBA8 pixels directly, avoiding per pixel format conversions
+            else if ((srcPtr->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) && (dst->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8))
+            {
+                BlendSpanRGBA8(pDst, pSrc, (int)srcRec.width, tint);
+            }
             else
             {
                 for (int x = 0; x < (int)srcRec.width; x++)
@@ -5606,4 +5760,822 @@ static Vector4 *LoadImageDataNormalized(Image image)
     return pixels;
 }
 
+// Get the bits of the R, G, B and A channels of a format up to 8 bit per channel
+// NOTE: Channels missing from the format are decoded as 8 bit channels at max value,
+// the gray channel is stored in R (destination) or replicated to R, G and B (source)
+static bool GetPixelFormatChannelBits(int format, int bits[4])
+{
+    bool result = true;
+
+    switch (format)
+    {
+        case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+        case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: bits[0] = 8; bits[1] = 8; bits[2] = 8; bits[3] = 8; break;
+        case PIXELFORMAT_UNCOMPRESSED_R5G6B5: bits[0] = 5; bits[1] = 6; bits[2] = 5; bits[3] = 8; break;
+        case PIXELFORMAT_UNCOMPRESSED_R5G5B5A1: bits[0] = 5; bits[1] = 5; bits[2] = 5; bits[3] = 1; break;
+        case PIXELFORMAT_UNCOMPRESSED_R4G4B4A4: bits[0] = 4; bits[1] = 4; bits[2] = 4; bits[3] = 4; break;
+        default: result = false; break;
+    }
+
+    return result;
+}
+
+// Get the normalized value of a channel, as decoded by LoadImageDataNormalized()
+static float GetChannelNormalized(int value, int bits)
+{
+    float result = 0.0f;
+
+    switch (bits)
+    {
+        case 1: result = (value == 0)? 0.0f : 1.0f; break;
+        case 4: result = (float)value*(1.0f/15); break;
+        case 5: result = (float)value*(1.0f/31); break;
+        case 6: result = (float)value*(1.0f/63); break;
+        default: result = (float)value/255.0f; break;
+    }
+
+    return result;
+}
+
+// Get the value of a channel from its normalized value, as encoded by ImageFormat()
+static unsigned char GetChannelEncoded(float value, int bits)
+{
+    unsigned char result = 0;
+
+    switch (bits)
+    {
+        case 1: result = (value > ((float)PIXELFORMAT_UNCOMPRESSED_R5G5B5A1_ALPHA_THRESHOLD/255.0f))? 1 : 0; break;
+        case 4: result = (unsigned char)(round(value*15.0f)); break;
+        case 5: result = (unsigned char)(round(value*31.0f)); break;
+        case 6: result = (unsigned char)(round(value*63.0f)); break;
+        default: result = (unsigned char)(value*255.0f); break;
+    }
+
+    return result;
+}
+
+// Load pixel data from image converted to a format up to 8 bit per channel
+// NOTE: Pixels are decoded into channel values and encoded again row by row, through lookup tables
+// filled with the normalized float conversion, so results are the same without float data per pixel
+static void *LoadImageDataConverted(Image image, int newFormat)
+{
+    int srcBits[4] = { 0 };
+    int dstBits[4] = { 0 };
+
+    if (!GetPixelFormatChannelBits(image.format, srcBits) || !GetPixelFormatChannelBits(newFormat, dstBits)) return NULL;
+
+    int width = image.width;
+    int height = image.height;
+    int srcPixelSize = GetPixelDataSize(1, 1, image.format);
+    int dstPixelSize = GetPixelDataSize(1, 1, newFormat);
+
+    unsigned char *data = (unsigned char *)RL_MALLOC((size_t)width*height*dstPixelSize);
+    unsigned char *channels = (unsigned char *)RL_MALLOC((size_t)width*4);    // RGBA values of a row
+
+    if ((data == NULL) || (channels == NULL))
+    {
+        RL_FREE(data);
+        RL_FREE(channels);
+        return NULL;
+    }
+
+    // Channel values of the source format to channel values of the destination format
+    unsigned char table[4][256] = { 0 };
+    for (int c = 0; c < 4; c++)
+    {
+        for (int v = 0; v < (1 << srcBits[c]); v++) table[c][v] = GetChannelEncoded(GetChannelNormalized(v, srcBits[c]), dstBits[c]);
+    }
+
+    // Gray levels are the sum of the weighted channels, kept as float to get the same rounding
+    float grayWeights[3][256] = { 0 };
+    bool isGray = (newFormat == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) || (newFormat == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA);
+    if (isGray)
+    {
+        const float weights[3] = { 0.299f, 0.587f, 0.114f };
+
+        for (int c = 0; c < 3; c++)
+        {
+            for (int v = 0; v < (1 << srcBits[c]); v++) grayWeights[c][v] = GetChannelNormalized(v, srcBits[c])*weights[c];
+        }
+    }
+
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char *src = (const unsigned char *)image.data + (size_t)y*width*srcPixelSize;
+        unsigned char *dst = data + (size_t)y*width*dstPixelSize;
+
+        // Channels copied as they are, 8 bit channels are kept exactly by the normalized conversion
+        if ((image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) && (newFormat == PIXELFORMAT_UNCOMPRESSED_R8G8B8))
+        {
+            for (int x = 0; x < width; x++) { dst[3*x] = src[4*x]; dst[3*x + 1] = src[4*x + 1]; dst[3*x + 2] = src[4*x + 2]; }
+            continue;
+        }
+        else if ((image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) && (newFormat == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8))
+        {
+            for (int x = 0; x < width; x++) { dst[4*x] = src[3*x]; dst[4*x + 1] = src[3*x + 1]; dst[4*x + 2] = src[3*x + 2]; dst[4*x + 3] = 255; }
+            continue;
+        }
+
+        // Decode the channel values of the row
+        switch (image.format)
+        {
+            case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+            {
+                for (int x = 0; x < width; x++) { channels[4*x] = src[x]; channels[4*x + 1] = src[x]; channels[4*x + 2] = src[x]; channels[4*x + 3] = 255; }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+            {
+                for (int x = 0; x < width; x++) { channels[4*x] = src[2*x]; channels[4*x + 1] = src[2*x]; channels[4*x + 2] = src[2*x]; channels[4*x + 3] = src[2*x + 1]; }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R5G6B5:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    unsigned short pixel = ((const unsigned short *)src)[x];
+                    channels[4*x] = (unsigned char)(pixel >> 11);
+                    channels[4*x + 1] = (unsigned char)((pixel >> 5) & 0x3f);
+                    channels[4*x + 2] = (unsigned char)(pixel & 0x1f);
+                    channels[4*x + 3] = 255;
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R5G5B5A1:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    unsigned short pixel = ((const unsigned short *)src)[x];
+                    channels[4*x] = (unsigned char)(pixel >> 11);
+                    channels[4*x + 1] = (unsigned char)((pixel >> 6) & 0x1f);
+                    channels[4*x + 2] = (unsigned char)((pixel >> 1) & 0x1f);
+                    channels[4*x + 3] = (unsigned char)(pixel & 0x1);
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R4G4B4A4:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    unsigned short pixel = ((const unsigned short *)src)[x];
+                    channels[4*x] = (unsigned char)(pixel >> 12);
+                    channels[4*x + 1] = (unsigned char)((pixel >> 8) & 0xf);
+                    channels[4*x + 2] = (unsigned char)((pixel >> 4) & 0xf);
+                    channels[4*x + 3] = (unsigned char)(pixel & 0xf);
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+            {
+                for (int x = 0; x < width; x++) { channels[4*x] = src[3*x]; channels[4*x + 1] = src[3*x + 1]; channels[4*x + 2] = src[3*x + 2]; channels[4*x + 3] = 255; }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8: memcpy(channels, src, (size_t)width*4); break;
+            default: break;
+        }
+
+        // Encode the channel values into the destination format
+        switch (newFormat)
+        {
+            case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const unsigned char *rgba = &channels[4*x];
+                    dst[x] = (unsigned char)((grayWeights[0][rgba[0]] + grayWeights[1][rgba[1]] + grayWeights[2][rgba[2]])*255.0f);
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const unsigned char *rgba = &channels[4*x];
+                    dst[2*x] = (unsigned char)((grayWeights[0][rgba[0]] + grayWeights[1][rgba[1]] + grayWeights[2][rgba[2]])*255.0f);
+                    dst[2*x + 1] = table[3][rgba[3]];
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R5G6B5:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const unsigned char *rgba = &channels[4*x];
+                    ((unsigned short *)dst)[x] = (unsigned short)(table[0][rgba[0]] << 11 | table[1][rgba[1]] << 5 | table[2][rgba[2]]);
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R5G5B5A1:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const unsigned char *rgba = &channels[4*x];
+                    ((unsigned short *)dst)[x] = (unsigned short)(table[0][rgba[0]] << 11 | table[1][rgba[1]] << 6 | table[2][rgba[2]] << 1 | table[3][rgba[3]]);
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R4G4B4A4:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const unsigned char *rgba = &channels[4*x];
+                    ((unsigned short *)dst)[x] = (unsigned short)(table[0][rgba[0]] << 12 | table[1][rgba[1]] << 8 | table[2][rgba[2]] << 4 | table[3][rgba[3]]);
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const unsigned char *rgba = &channels[4*x];
+                    dst[3*x] = table[0][rgba[0]];
+                    dst[3*x + 1] = table[1][rgba[1]];
+                    dst[3*x + 2] = table[2][rgba[2]];
+                }
+            } break;
+            case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const unsigned char *rgba = &channels[4*x];
+                    dst[4*x] = table[0][rgba[0]];
+                    dst[4*x + 1] = table[1][rgba[1]];
+                    dst[4*x + 2] = table[2][rgba[2]];
+                    dst[4*x + 3] = table[3][rgba[3]];
+                }
+            } break;
+            default: break;
+        }
+    }
+
+    RL_FREE(channels);
+
+    return data;
+}
+
+// Fill horizontal span of pixels within an image (clipped to image bounds)
+// NOTE: Compressed image formats not supported
+static void ImageFillSpan(Image *dst, int x, int y, int length, Color color)
+{
+    // Security check to avoid drawing out of bounds
+    if ((dst->data == NULL) || (y < 0) || (y >= dst->height) || (dst->format >= PIXELFORMAT_COMPRESSED_DXT1_RGB)) return;
+
+    if (x < 0) { length += x; x = 0; }
+    if (length > (dst->width - x)) length = dst->width - x;
+    if (length <= 0) return;
+
+    if (dst->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        // Fast path: Store the color directly as a 32bit value per pixel
+        unsigned char *pixels = (unsigned char *)dst->data + ((size_t)y*dst->width + x)*4;
+        unsigned int value = 0;
+        memcpy(&value, &color, 4);
+
+        for (int i = 0; i < length; i++) memcpy(pixels + i*4, &value, 4);
+    }
+    else
+    {
+        // Fill in the first pixel based on image format
+        ImageDrawPixel(dst, x, y, color);
+
+        int bytesPerPixel = GetPixelDataSize(1, 1, dst->format);
+        unsigned char *pSrcPixel = (unsigned char *)dst->data + ((size_t)y*dst->width + x)*bytesPerPixel;
+
+        // Repeat the first pixel data throughout the span,
+        // doubling the pixels copied on each iteration
+        for (int i = 1; i < length; i *= 2)
+        {
+            int pixelsToCopy = MIN(i, length - i);
+            memcpy(pSrcPixel + i*bytesPerPixel, pSrcPixel, pixelsToCopy*bytesPerPixel);
+        }
+    }
+}
+
+// Blend span of RGBA8 pixels over RGBA8 pixels, applying tint to source
+// NOTE: Results are the same as ColorAlphaBlend()
+static void BlendSpanRGBA8(unsigned char *dst, const unsigned char *src, int count, Color tint)
+{
+    for (int i = 0; i < count; i++, dst += 4, src += 4)
+    {
+        // Apply color tint to source color
+        unsigned int r = ((unsigned int)src[0]*((unsigned int)tint.r + 1)) >> 8;
+        unsigned int g = ((unsigned int)src[1]*((unsigned int)tint.g + 1)) >> 8;
+        unsigned int b = ((unsigned int)src[2]*((unsigned int)tint.b + 1)) >> 8;
+        unsigned int a = ((unsigned int)src[3]*((unsigned int)tint.a + 1)) >> 8;
+
+        // Fast path: Avoid blend if source is fully transparent or opaque
+        if (a == 0) continue;
+        else if (a == 255)
+        {
+            dst[0] = (unsigned char)r;
+            dst[1] = (unsigned char)g;
+            dst[2] = (unsigned char)b;
+            dst[3] = 255;
+        }
+        else if (dst[3] == 255)
+        {
+            // Fast path: Opaque destination stays opaque, so the blend divides by a constant
+            unsigned int alpha = a + 1;
+            dst[0] = (unsigned char)((r*alpha*256 + (unsigned int)dst[0]*255*(256 - alpha))/65280);
+            dst[1] = (unsigned char)((g*alpha*256 + (unsigned int)dst[1]*255*(256 - alpha))/65280);
+            dst[2] = (unsigned char)((b*alpha*256 + (unsigned int)dst[2]*255*(256 - alpha))/65280);
+        }
+        else
+        {
+            Color colSrc = { (unsigned char)r, (unsigned char)g, (unsigned char)b, (unsigned char)a };
+            Color colDst = { dst[0], dst[1], dst[2], dst[3] };
+            Color blend = ColorAlphaBlend(colDst, colSrc, WHITE);
+
+            memcpy(dst, &blend, 4);
+        }
+    }
+}
+
+// Clip span of steps where edge function is not negative
+// NOTE: Edge function value at step k is (w + k*step), span is narrowed to [kMin, kMax]
+static void ClipEdgeSpan(int w, int step, int *kMin, int *kMax)
+{
+    if (step > 0)
+    {
+        // Not negative from step ceil(-w/step)
+        int k = (w >= 0)? -(w/step) : (-w + step - 1)/step;
+        if (k > *kMin) *kMin = k;
+    }
+    else if (step < 0)
+    {
+        // Not negative up to step floor(w/-step)
+        int k = (w >= 0)? w/(-step) : -((-w - step - 1)/(-step));
+        if (k < *kMax) *kMax = k;
+    }
+    else if (w < 0) *kMax = *kMin - 1;  // Negative along the whole row
+}
+
+#if defined(SUPPORT_IMAGE_THREADS)
+// Process image task range (thread entry point)
+static void *ProcessImageTask(void *arg)
+{
+    ImageTask *task = (ImageTask *)arg;
+
+    task->process(task->data, task->index, task->start, task->end);
+
+    return NULL;
+}
+#endif
+
+// Get number of tasks to split a range of rows or columns between threads
+// NOTE: Without SUPPORT_IMAGE_THREADS, ranges are always processed in one task
+static int GetImageTaskCount(int count)
+{
+    int taskCount = 1;
+
+#if defined(SUPPORT_IMAGE_THREADS)
+    int threadCount = MAX_IMAGE_THREADS;
+
+    #if defined(_WIN32)
+        threadCount = pthread_num_processors_np();
+    #elif defined(_SC_NPROCESSORS_ONLN)
+        threadCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+
+    // Avoid splitting small ranges, thread creation would cost more than processing
+    if (threadCount > MAX_IMAGE_THREADS) threadCount = MAX_IMAGE_THREADS;
+    if (threadCount > count/64) threadCount = count/64;
+    if (threadCount > 1) taskCount = threadCount;
+#endif
+
+    return taskCount;
+}
+
+// Process range of rows or columns, split in tasks processed by different threads
+// NOTE: Every task gets its index, so task data can be allocated by caller (taskCount from GetImageTaskCount());
+// without SUPPORT_IMAGE_THREADS, or on thread creation failure, tasks are processed on calling thread
+static void ProcessImageParallel(void (*process)(void *data, int task, int start, int end), void *data, int count, int taskCount)
+{
+#if defined(SUPPORT_IMAGE_THREADS)
+    if (taskCount > MAX_IMAGE_THREADS) taskCount = MAX_IMAGE_THREADS;
+
+    if (taskCount > 1)
+    {
+        pthread_t threads[MAX_IMAGE_THREADS] = { 0 };
+        bool created[MAX_IMAGE_THREADS] = { 0 };
+        ImageTask tasks[MAX_IMAGE_THREADS] = { 0 };
+
+        for (int i = 0; i < taskCount; i++)
+        {
+            tasks[i].process = process;
+            tasks[i].data = data;
+            tasks[i].index = i;
+            tasks[i].start = (int)((long long)count*i/taskCount);
+            tasks[i].end = (int)((long long)count*(i + 1)/taskCount);
+        }
+
+        // First range is processed on calling thread
+        for (int i = 1; i < taskCount; i++)
+        {
+            created[i] = (pthread_create(&threads[i], NULL, ProcessImageTask, &tasks[i]) == 0);
+        }
+
+        process(data, 0, tasks[0].start, tasks[0].end);
+
+        for (int i = 1; i < taskCount; i++)
+        {
+            if (created[i]) pthread_join(threads[i], NULL);
+            else process(data, i, tasks[i].start, tasks[i].end);
+        }
+
+        return;
+    }
+#endif
+
+    for (int i = 0; i < taskCount; i++) process(data, i, (int)((long long)count*i/taskCount), (int)((long long)count*(i + 1)/taskCount));
+}
+
+// Premultiply alpha of blur pixels rows
+static void BlurPremultiplyRows(void *data, int task, int start, int end)
+{
+    BlurPassData *blur = (BlurPassData *)data;
+    unsigned char *pixels = blur->pixels + (size_t)start*blur->width*4;
+
+    for (int i = 0; i < (end - start)*blur->width; i++, pixels += 4)
+    {
+        unsigned int alpha = pixels[3];
+
+        if (alpha < 255)
+        {
+            pixels[0] = (unsigned char)(pixels[0]*alpha/255);
+            pixels[1] = (unsigned char)(pixels[1]*alpha/255);
+            pixels[2] = (unsigned char)(pixels[2]*alpha/255);
+        }
+    }
+}
+
+// Box blur pixels rows into 8.8 fixed point rows
+static void BlurHorizontalRows(void *data, int task, int start, int end)
+{
+    BlurPassData *blur = (BlurPassData *)data;
+    int width = blur->width;
+    int radius = blur->radius;
+    const unsigned int *scales = blur->scales;
+
+    for (int y = start; y < end; y++)
+    {
+        const unsigned char *src = blur->pixels + (size_t)y*width*4;
+        unsigned short *dst = blur->blurred + (size_t)y*width*4;
+        unsigned int sum[4] = { 0 };
+
+        for (int x = 0; (x < radius) && (x < width); x++)
+        {
+            for (int c = 0; c < 4; c++) sum[c] += src[x*4 + c];
+        }
+
+        // Border pixels are split from inner pixels, where the window is inside the row
+        int x = 0;
+        for (; (x <= radius) && (x < width); x++)
+        {
+            if ((x + radius) < width) { for (int c = 0; c < 4; c++) sum[c] += src[(x + radius)*4 + c]; }
+            for (int c = 0; c < 4; c++) dst[x*4 + c] = (unsigned short)((sum[c]*scales[x]) >> 16);
+        }
+
+        for (; (x + radius) < width; x++)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                sum[c] += src[(x + radius)*4 + c] - src[(x - radius - 1)*4 + c];
+                dst[x*4 + c] = (unsigned short)((sum[c]*scales[x]) >> 16);
+            }
+        }
+
+        for (; x < width; x++)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                sum[c] -= src[(x - radius - 1)*4 + c];
+                dst[x*4 + c] = (unsigned short)((sum[c]*scales[x]) >> 16);
+            }
+        }
+    }
+}
+
+// Box blur 8.8 fixed point columns into pixels columns
+// NOTE: Rows are walked in order, keeping a running sum for every column in range
+static void BlurVerticalColumns(void *data, int task, int start, int end)
+{
+    BlurPassData *blur = (BlurPassData *)data;
+    int width = blur->width;
+    int height = blur->height;
+    int radius = blur->radius;
+    size_t stride = (size_t)width*4;
+
+    // Columns are processed in blocks, so running sums stay in cache while walking the rows
+    unsigned int sums[BLUR_COLUMNS_BLOCK*4] = { 0 };
+
+    for (int block = start; block < end; block += BLUR_COLUMNS_BLOCK)
+    {
+        int count = ((end - block) < BLUR_COLUMNS_BLOCK)? (end - block)*4 : BLUR_COLUMNS_BLOCK*4;
+        const unsigned short *src = blur->blurred + (size_t)block*4;
+        unsigned char *dst = blur->pixels + (size_t)block*4;
+
+        for (int i = 0; i < count; i++) sums[i] = 0;
+
+        // Window for row y covers rows [y - radius, y + radius] inside the image
+        for (int y = 0; (y < radius) && (y < height); y++)
+        {
+            for (int i = 0; i < count; i++) sums[i] += src[y*stride + i];
+        }
+
+        for (int y = 0; y < height; y++)
+        {
+            if ((y + radius) < height)
+            {
+                const unsigned short *row = src + (y + radius)*stride;
+                for (int i = 0; i < count; i++) sums[i] += row[i];
+            }
+
+            if ((y - radius - 1) >= 0)
+            {
+                const unsigned short *row = src + (y - radius - 1)*stride;
+                for (int i = 0; i < count; i++) sums[i] -= row[i];
+            }
+
+            // Values are 8.8 fixed point, ((sum >> 8)*scale) >> 24 is sum/(size*256)
+            int size = ((y + radius < height)? y + radius : height - 1) - ((y - radius > 0)? y - radius : 0) + 1;
+            unsigned int scale = ((1U << 24) + size - 1)/size;
+            unsigned char *row = dst + y*stride;
+
+            for (int i = 0; i < count; i++) row[i] = (unsigned char)(((sums[i] >> 8)*scale) >> 24);
+        }
+    }
+}
+
+// Reverse premultiplied alpha of blur pixels rows
+static void BlurUnpremultiplyRows(void *data, int task, int start, int end)
+{
+    BlurPassData *blur = (BlurPassData *)data;
+    unsigned char *pixels = blur->pixels + (size_t)start*blur->width*4;
+
+    // Color reciprocal scale for every alpha, (value*255*scale) >> 24 is value*255/alpha
+    unsigned int scales[256] = { 0 };
+    for (int a = 1; a < 256; a++) scales[a] = ((1U << 24) + a - 1)/a;
+
+    for (int i = 0; i < (end - start)*blur->width; i++, pixels += 4)
+    {
+        unsigned int alpha = pixels[3];
+
+        if (alpha == 0)
+        {
+            pixels[0] = 0;
+            pixels[1] = 0;
+            pixels[2] = 0;
+        }
+        else if (alpha < 255)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                unsigned int value = (unsigned int)(((unsigned long long)pixels[c]*255*scales[alpha]) >> 24);
+                pixels[c] = (unsigned char)((value < 255)? value : 255);
+            }
+        }
+    }
+}
+
+// Get index of pixel read at index, for a border mode (-1 if outside)
+static int GetBorderIndex(int index, int size, int borderMode)
+{
+    if ((index >= 0) && (index < size)) return index;
+
+    int result = -1;
+
+    switch (borderMode)
+    {
+        case IMAGE_BORDER_CLAMP: result = (index < 0)? 0 : size - 1; break;
+        case IMAGE_BORDER_MIRROR:
+        {
+            result = ((index%(size*2)) + size*2)%(size*2);
+            if (result >= size) result = size*2 - 1 - result;
+        } break;
+        case IMAGE_BORDER_WRAP: result = ((index%size) + size)%size; break;
+        default: break;
+    }
+
+    return result;
+}
+
+// Get row and column factors of a separable kernel
+// NOTE: Kernel is separable if every row is a multiple of the row with the largest value
+static bool GetKernelFactors(const float *kernel, int kernelWidth, float *rowKernel, float *columnKernel)
+{
+    int pivot = 0;
+    for (int i = 1; i < kernelWidth*kernelWidth; i++)
+    {
+        if (fabsf(kernel[i]) > fabsf(kernel[pivot])) pivot = i;
+    }
+
+    float pivotValue = kernel[pivot];
+    if (pivotValue == 0.0f) return false;
+
+    int pivotRow = pivot/kernelWidth;
+    int pivotColumn = pivot%kernelWidth;
+
+    for (int i = 0; i < kernelWidth; i++)
+    {
+        rowKernel[i] = kernel[pivotRow*kernelWidth + i];
+        columnKernel[i] = kernel[i*kernelWidth + pivotColumn]/pivotValue;
+    }
+
+    for (int y = 0; y < kernelWidth; y++)
+    {
+        for (int x = 0; x < kernelWidth; x++)
+        {
+            if (fabsf(columnKernel[y]*rowKernel[x] - kernel[y*kernelWidth + x]) > fabsf(pivotValue)*1e-6f) return false;
+        }
+    }
+
+    return true;
+}
+
+// Apply convolution kernel to image rows
+// NOTE: Source rows are converted to normalized float rows, padded with the border pixels,
+// and kept in a ring of kernelWidth rows, so every source row is converted only once per range;
+// for separable kernels, ring rows are the result of the row pass
+static void ConvolutionRows(void *data, int task, int start, int end)
+{
+    ConvolutionData *convolution = (ConvolutionData *)data;
+    int width = convolution->width;
+    int height = convolution->height;
+    int kernelWidth = convolution->kernelWidth;
+    int offset = kernelWidth/2;
+    bool separable = (convolution->columnKernel != NULL);
+    int rowSize = convolution->rowSize;
+
+    // Task scratch values, allocated by caller
+    float *padded = convolution->scratch + (size_t)task*convolution->scratchSize;
+    float *rows = padded + convolution->paddedSize;
+    float *sums = rows + (size_t)kernelWidth*rowSize;
+    int *rowIndices = convolution->rowIndices + task*kernelWidth;
+
+    for (int i = 0; i < kernelWidth; i++) rowIndices[i] = start - kernelWidth;     // Not a row position of the range
+
+    float normalized[256] = { 0 };
+    for (int i = 0; i < 256; i++) normalized[i] = (float)i/255.0f;
+
+    for (int y = start; y < end; y++)
+    {
+        for (int i = 0; i < width*4; i++) sums[i] = 0.0f;
+
+        for (int ky = 0; ky < kernelWidth; ky++)
+        {
+            int index = y + ky - offset;
+            int sourceY = GetBorderIndex(index, height, convolution->borderMode);
+            if (sourceY < 0) continue;
+
+            // Ring slot only depends on the row position, consecutive output rows share kernelWidth - 1 rows
+            int slot = ((index%kernelWidth) + kernelWidth)%kernelWidth;
+            float *row = rows + (size_t)slot*rowSize;
+
+            if (rowIndices[slot] != index)
+            {
+                float *target = separable? padded : row;
+                const Color *source = convolution->pixels + (size_t)sourceY*width;
+
+                // Row pixels are converted directly, border pixels are looked up for the border mode
+                const unsigned char *values = (const unsigned char *)source;
+                for (int i = 0; i < width*4; i++) target[offset*4 + i] = normalized[values[i]];
+
+                for (int x = 0; x < (width + kernelWidth - 1); x++)
+                {
+                    if ((x >= offset) && (x < (width + offset))) continue;
+
+                    int sourceX = GetBorderIndex(x - offset, width, convolution->borderMode);
+
+                    for (int c = 0; c < 4; c++) target[x*4 + c] = (sourceX < 0)? 0.0f : normalized[values[sourceX*4 + c]];
+                }
+
+                if (separable)
+                {
+                    // Row pass, channels of consecutive pixels are processed together
+                    for (int i = 0; i < width*4; i++) row[i] = 0.0f;
+
+                    for (int kx = 0; kx < kernelWidth; kx++)
+                    {
+                        float factor = convolution->kernel[kx];
+                        const float *values = padded + kx*4;
+
+                        if (factor != 0.0f) { for (int i = 0; i < width*4; i++) row[i] += values[i]*factor; }
+                    }
+                }
+
+                rowIndices[slot] = index;
+            }
+
+            if (separable)
+            {
+                // Column pass
+                float factor = convolution->columnKernel[ky];
+
+                if (factor != 0.0f) { for (int i = 0; i < width*4; i++) sums[i] += row[i]*factor; }
+            }
+            else
+            {
+                for (int kx = 0; kx < kernelWidth; kx++)
+                {
+                    float factor = convolution->kernel[ky*kernelWidth + kx];
+                    const float *values = row + kx*4;
+
+                    if (factor != 0.0f) { for (int i = 0; i < width*4; i++) sums[i] += values[i]*factor; }
+                }
+            }
+        }
+
+        unsigned char *result = (unsigned char *)(convolution->result + (size_t)y*width);
+
+        for (int i = 0; i < width*4; i++)
+        {
+            float value = sums[i];
+
+            if (value < 0.0f) value = 0.0f;
+            if (value > 1.0f) value = 1.0f;
+
+            result[i] = (unsigned char)(value*255.0f);
+        }
+    }
+}
+
+// Get hash value of packed RGBA color
+static unsigned int GetColorHash(unsigned int color)
+{
+    color *= 0x9e3779b1u;
+
+    return color ^ (color >> 16);
+}
+
+// Get pixels colors in order of appearance, up to palette size
+// NOTE: Transparent pixels are skipped, colors are looked up on an open addressing hash table
+static int GetPaletteColors(const Color *pixels, int pixelCount, Color *palette, int maxPaletteSize)
+{
+    int colorCount = 0;
+    int capacity = 64;
+
+    while (capacity < 2*maxPaletteSize) capacity *= 2;
+
+    // NOTE: Transparent colors are never stored, so key 0 marks an empty slot
+    unsigned int *keys = (unsigned int *)RL_CALLOC(capacity, sizeof(unsigned int));
+    unsigned int previous = 0;
+
+    for (int i = 0; (i < pixelCount) && (colorCount < maxPaletteSize); i++)
+    {
+        if (pixels[i].a == 0) continue;
+
+        unsigned int key = 0;
+        memcpy(&key, &pixels[i], sizeof(unsigned int));
+
+        if (key == previous) continue;      // Skip runs of the same color
+        previous = key;
+
+        unsigned int slot = GetColorHash(key) & (capacity - 1);
+
+        while ((keys[slot] != 0) && (keys[slot] != key)) slot = (slot + 1) & (capacity - 1);
+
+        if (keys[slot] == 0)
+        {
+            keys[slot] = key;
+            palette[colorCount] = pixels[i];
+            colorCount++;
+        }
+    }
+
+    RL_FREE(keys);
+
+    return colorCount;
+}
+
+// Get channel value of RGB565 histogram bin
+static int GetHistogramBinChannel(int bin, int channel)
+{
+    if (channel == 0) return (bin >> 11);
+    else if (channel == 1) return ((bin >> 5) & 0x3f);
+    else return (bin & 0x1f);
+}
+
+// Set palette box pixels count and split priority
+// NOTE: Channels ranges are compared scaled to 8 bit
+static void SetPaletteBox(PaletteBox *box, const int *bins, const unsigned int *counts)
+{
+    int minValue[3] = { 255, 255, 255 };
+    int maxValue[3] = { 0 };
+
+    box->count = 0;
+
+    for (int i = box->start; i < box->end; i++)
+    {
+        box->count += counts[bins[i]];
+
+        for (int c = 0; c < 3; c++)
+        {
+            int value = GetHistogramBinChannel(bins[i], c);
+
+            if (value < minValue[c]) minValue[c] = value;
+            if (value > maxValue[c]) maxValue[c] = value;
+        }
+    }
+
+    int range[3] = { (maxValue[0] - minValue[0])*8, (maxValue[1] - minValue[1])*4, (maxValue[2] - minValue[2])*8 };
+
+    box->channel = 0;
+    if (range[1] > range[box->channel]) box->channel = 1;
+    if (range[2] > range[box->channel]) box->channel = 2;
+
+    box->score = ((box->end - box->start) > 1)? box->count*range[box->channel] : 0;
+}
+
 #endif      // SUPPORT_MODULE_RTEXTURES